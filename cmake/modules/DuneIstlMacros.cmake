@@ -6,6 +6,9 @@
 #    This modules content is executed whenever a module required or suggests dune-istl!
 #
 
+# the threaded kernels use std::thread
+find_package(Threads REQUIRED)
+
 find_package(METIS)
 find_package(ParMETIS)
 include(AddParMETISFlags)
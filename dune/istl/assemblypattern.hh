@@ -0,0 +1,274 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_ISTL_ASSEMBLYPATTERN_HH
+#define DUNE_ISTL_ASSEMBLYPATTERN_HH
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/istlexception.hh>
+
+/** \file
+ * \brief Precomputed entry positions for repeated assembly into a BCRSMatrix
+ */
+
+namespace Dune {
+
+  /**
+   * @addtogroup ISTL_SPMV
+   * @{
+   */
+
+  /**
+   * \brief Positions of the matrix entries touched by a fixed sequence of local index lists.
+   *
+   * Finite element assembly adds small local matrices into the global matrix,
+   * where the rows and columns of the local matrix are given by lists of global
+   * indices (e.g. the degrees of freedom of an element). Writing
+   * `A[rows[i]][cols[j]] += local[i][j]` searches each column in the row.
+   * If the sparsity pattern does not change (e.g. in a time-stepping loop),
+   * the positions of the entries can be computed once:
+   *
+   * \code
+   * Dune::AssemblyPattern<Matrix> pattern(A);
+   * for (const auto& element : elements)
+   *   pattern.addElement(A, dofs(element));
+   *
+   * // in each time step
+   * A = 0;
+   * for (std::size_t e = 0; e < pattern.size(); ++e)
+   *   pattern.scatterAdd(A, e, localMatrix(e));
+   * \endcode
+   *
+   * scatterAdd() adds the local matrix without any search, the local entries
+   * are added to the stored blocks of the global rows directly.
+   *
+   * The pattern refers only to the sparsity pattern, not to a particular
+   * matrix object. It can be used with any fully built matrix of the same
+   * pattern, independent of the build mode, e.g. with matrices created by
+   * MatrixIndexSet::exportIdx() or with copies of the matrix it was created with.
+   *
+   * \warning addElement() and scatterAdd() only check the sizes of the matrix,
+   *          i.e. N(), M() and nonzeroes(), because comparing the whole pattern
+   *          costs as much as the assembly itself. Using the pattern with a matrix
+   *          rebuilt with the same number of nonzeroes but different column indices
+   *          silently adds into wrong entries. Call matches() once after rebuilding
+   *          a matrix, or reset() the pattern.
+   *
+   * Calling scatterAdd() concurrently is only safe for elements that do not
+   * share global rows.
+   *
+   * \tparam M The matrix type, a BCRSMatrix.
+   */
+  template<class M>
+  class AssemblyPattern
+  {
+  public:
+    //! The matrix type
+    typedef M Matrix;
+
+    //! The type of the matrix blocks
+    typedef typename Matrix::block_type block_type;
+
+    //! The type for indices and sizes
+    typedef typename Matrix::size_type size_type;
+
+    //! Create an empty pattern.
+    AssemblyPattern ()
+      : n_(0), m_(0), nnz_(0), hash_(0)
+    {
+      elementOffset_.push_back(0);
+      positionOffset_.push_back(0);
+    }
+
+    //! Create an empty pattern for the sparsity pattern of a matrix.
+    explicit AssemblyPattern (const Matrix& matrix)
+      : AssemblyPattern()
+    {
+      reset(matrix);
+    }
+
+    //! Remove all elements and use the sparsity pattern of a (fully built) matrix.
+    void reset (const Matrix& matrix)
+    {
+      if (matrix.buildStage() != Matrix::built)
+        DUNE_THROW(BCRSMatrixError, "AssemblyPattern requires a fully built matrix");
+      n_ = matrix.N();
+      m_ = matrix.M();
+      nnz_ = matrix.nonzeroes();
+      hash_ = patternHash(matrix);
+      elementOffset_.assign(1, 0);
+      positionOffset_.assign(1, 0);
+      cols_.clear();
+      rows_.clear();
+      positions_.clear();
+    }
+
+    /**
+     * \brief Compute the positions of the entries `(rowIndices[i], colIndices[j])`.
+     *
+     * \param matrix A matrix with the pattern given to the constructor or reset().
+     * \param rowIndices The global row indices of the local matrix.
+     * \param colIndices The global column indices of the local matrix.
+     * \returns The number of the element, to be passed to scatterAdd().
+     *
+     * \throws BCRSMatrixError if an entry is not part of the sparsity pattern.
+     *         The pattern is left unchanged in this case.
+     */
+    template<class RowIndices, class ColIndices>
+    size_type addElement (const Matrix& matrix, const RowIndices& rowIndices, const ColIndices& colIndices)
+    {
+      checkPattern(matrix);
+      const size_type nCols = std::size(colIndices);
+      // on errors the entries of this element are removed again, so the pattern stays usable
+      const size_type rowsSize = rows_.size();
+      const size_type positionsSize = positions_.size();
+      auto discardElement = [&] {
+        rows_.resize(rowsSize);
+        positions_.resize(positionsSize);
+      };
+      for (auto&& row : rowIndices)
+      {
+#ifdef DUNE_ISTL_WITH_CHECKING
+        if (size_type(row) >= n_)
+        {
+          discardElement();
+          DUNE_THROW(BCRSMatrixError, "row index " << row << " out of range");
+        }
+#endif
+        const auto& matrixRow = matrix[row];
+        rows_.push_back(row);
+        for (auto&& col : colIndices)
+        {
+          auto it = matrixRow.find(col);
+          if (it == matrixRow.end())
+          {
+            discardElement();
+            DUNE_THROW(BCRSMatrixError, "entry (" << row << ", " << col << ") is not in the sparsity pattern");
+          }
+          positions_.push_back(it.offset());
+        }
+      }
+      cols_.push_back(nCols);
+      elementOffset_.push_back(rows_.size());
+      positionOffset_.push_back(positions_.size());
+      return size() - 1;
+    }
+
+    /**
+     * \brief Compute the positions of the entries `(dofs[i], dofs[j])`.
+     *
+     * \copydetails addElement(const Matrix&,const RowIndices&,const ColIndices&)
+     */
+    template<class Indices>
+    size_type addElement (const Matrix& matrix, const Indices& dofs)
+    {
+      return addElement(matrix, dofs, dofs);
+    }
+
+    /**
+     * \brief Whether a matrix has the sparsity pattern of this AssemblyPattern.
+     *
+     * Compares the row sizes and a hash of the column indices, which takes
+     * one pass over the column indices of the matrix.
+     */
+    bool matches (const Matrix& matrix) const
+    {
+      return matrix.buildStage() == Matrix::built && matrix.N() == n_ && matrix.M() == m_
+        && matrix.nonzeroes() == nnz_ && patternHash(matrix) == hash_;
+    }
+
+    //! The number of elements
+    size_type size () const
+    {
+      return cols_.size();
+    }
+
+    //! The number of rows of the local matrix of an element
+    size_type rows (size_type element) const
+    {
+      return elementOffset_[element+1] - elementOffset_[element];
+    }
+
+    //! The number of columns of the local matrix of an element
+    size_type cols (size_type element) const
+    {
+      return cols_[element];
+    }
+
+    /**
+     * \brief Add a local matrix to the entries recorded for an element.
+     *
+     * Performs `matrix[rowIndices[i]][colIndices[j]] += local[i][j]` for the index lists
+     * passed to addElement(). `local[i][j]` has to be addable to a block of
+     * the matrix, e.g. a DynamicMatrix of scalars for scalar or 1x1 blocks, or
+     * a nested container of FieldMatrix blocks.
+     */
+    template<class LocalMatrix>
+    void scatterAdd (Matrix& matrix, size_type element, const LocalMatrix& local) const
+    {
+#ifdef DUNE_ISTL_WITH_CHECKING
+      checkPattern(matrix);
+      if (element >= size())
+        DUNE_THROW(BCRSMatrixError, "element " << element << " is not in the pattern");
+#endif
+      const size_type nCols = cols_[element];
+      const size_type* position = positions_.data() + positionOffset_[element];
+      for (size_type i = 0, k = elementOffset_[element]; k < elementOffset_[element+1]; ++i, ++k)
+      {
+        block_type* values = matrix[rows_[k]].getptr();
+        const auto& localRow = local[i];
+        for (size_type j = 0; j < nCols; ++j, ++position)
+          values[*position] += localRow[j];
+      }
+    }
+
+  private:
+    // FNV-1a hash of the row sizes and column indices
+    static std::uint64_t patternHash (const Matrix& matrix)
+    {
+      std::uint64_t hash = 14695981039346656037ull;
+      auto add = [&](std::uint64_t value) {
+        hash = (hash ^ value) * 1099511628211ull;
+      };
+      for (auto row = matrix.begin(); row != matrix.end(); ++row)
+      {
+        add(row->size());
+        for (auto entry = row->begin(); entry != row->end(); ++entry)
+          add(entry.index());
+      }
+      return hash;
+    }
+
+    void checkPattern (const Matrix& matrix) const
+    {
+      if (matrix.buildStage() != Matrix::built || matrix.N() != n_
+          || matrix.M() != m_ || matrix.nonzeroes() != nnz_)
+        DUNE_THROW(BCRSMatrixError, "the matrix does not match the sparsity pattern of the AssemblyPattern");
+    }
+
+    size_type n_;
+    size_type m_;
+    size_type nnz_;
+    std::uint64_t hash_;
+
+    // the global row indices of the elements, rows_[elementOffset_[e]] is the first row of element e
+    std::vector<size_type> elementOffset_;
+    std::vector<size_type> rows_;
+    // the number of local columns of each element
+    std::vector<size_type> cols_;
+    // position of each local entry in its global row, row-major per element
+    std::vector<size_type> positionOffset_;
+    std::vector<size_type> positions_;
+  };
+
+  /** @} end documentation */
+
+} // end namespace Dune
+
+#endif
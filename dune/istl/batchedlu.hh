@@ -0,0 +1,241 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_ISTL_BATCHEDLU_HH
+#define DUNE_ISTL_BATCHEDLU_HH
+
+#include <cmath>
+#include <cstddef>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/precision.hh>
+
+#include <dune/istl/common/threadpool.hh>
+
+/** \file
+ * \brief  LU decompositions of many small dense matrices at once
+ */
+
+namespace Dune {
+
+  /** @addtogroup ISTL_Kernel
+          @{
+   */
+
+  /**
+   * \brief The LU decompositions of a batch of small dense matrices.
+   *
+   * Matrices of the same size are stored in packs of \p lanes matrices. Within a pack
+   * the entries are interleaved, i.e. the same entry of all matrices of the pack is
+   * stored contiguously, so the elimination of a pack is vectorized across its
+   * matrices. The packs are decomposed by the threads of the ThreadPool.
+   *
+   * The decomposition uses partial pivoting for each matrix separately.
+   *
+   * \tparam K The field type of the matrices.
+   * \tparam lanes The number of matrices per pack.
+   */
+  template<class K, std::size_t lanes = 8>
+  class BatchedLU
+  {
+  public:
+    typedef std::size_t size_type;
+
+    BatchedLU() = default;
+
+    /**
+     * \brief Allocate the matrices.
+     *
+     * \param sizes The number of rows and columns of each matrix.
+     *
+     * All entries are set to zero.
+     */
+    void resize (const std::vector<size_type>& sizes)
+    {
+      // the matrices of each size are packed in the order they are given
+      std::map<size_type, std::vector<size_type> > bySize;
+      for (size_type m=0; m<sizes.size(); ++m)
+        bySize[sizes[m]].push_back(m);
+
+      location_.resize(sizes.size());
+      packs_.clear();
+      size_type offset = 0, pivotOffset = 0;
+      for (const auto& group : bySize)
+      {
+        const size_type n = group.first;
+        for (size_type k=0; k<group.second.size(); k+=lanes)
+        {
+          packs_.push_back({n, offset, pivotOffset});
+          for (size_type l=0; l<lanes && k+l<group.second.size(); ++l)
+            location_[group.second[k+l]] = std::make_pair(packs_.size()-1, l);
+          offset += n*n*lanes;
+          pivotOffset += n*lanes;
+        }
+      }
+      values_.assign(offset, K(0));
+      pivots_.assign(pivotOffset, 0);
+
+      // unused lanes hold identity matrices
+      std::vector<bool> used(packs_.size()*lanes, false);
+      for (const auto& location : location_)
+        used[location.first*lanes + location.second] = true;
+      for (size_type p=0; p<packs_.size(); ++p)
+        for (size_type l=0; l<lanes; ++l)
+          if (!used[p*lanes + l])
+            for (size_type i=0; i<packs_[p].n; ++i)
+              values_[packs_[p].offset + (i*packs_[p].n + i)*lanes + l] = K(1);
+    }
+
+    //! \brief The number of matrices.
+    size_type size () const
+    {
+      return location_.size();
+    }
+
+    //! \brief The number of rows and columns of matrix m.
+    size_type size (size_type m) const
+    {
+      return packs_[location_[m].first].n;
+    }
+
+    //! \brief Entry (i,j) of matrix m, after decompose() its LU decomposition.
+    K& entry (size_type m, size_type i, size_type j)
+    {
+      const Pack& pack = packs_[location_[m].first];
+      return values_[pack.offset + (i*pack.n + j)*lanes + location_[m].second];
+    }
+
+    //! \brief Entry (i,j) of matrix m, after decompose() its LU decomposition.
+    const K& entry (size_type m, size_type i, size_type j) const
+    {
+      const Pack& pack = packs_[location_[m].first];
+      return values_[pack.offset + (i*pack.n + j)*lanes + location_[m].second];
+    }
+
+    /**
+     * \brief Replace all matrices by their LU decompositions.
+     *
+     * \throws FMatrixError if one of the matrices is singular.
+     */
+    void decompose ()
+    {
+      ThreadPool::instance().parallelFor(0, packs_.size(), [&](std::size_t first, std::size_t last)
+      {
+        for (std::size_t p=first; p<last; ++p)
+          decomposePack(packs_[p]);
+      });
+    }
+
+    /**
+     * \brief Solve with the decomposition of matrix m.
+     *
+     * \param m The index of the matrix.
+     * \param x The solution, the first size(m) entries are set.
+     * \param b The right hand side, only the first size(m) entries are used.
+     */
+    template<class V1, class V2>
+    void solve (size_type m, V1& x, const V2& b) const
+    {
+      const Pack& pack = packs_[location_[m].first];
+      const size_type l = location_[m].second;
+      const size_type n = pack.n;
+      const K* a = values_.data() + pack.offset + l;
+      const size_type* pivot = pivots_.data() + pack.pivotOffset + l;
+      auto A = [&](size_type i, size_type j) { return a[(i*n + j)*lanes]; };
+
+      for (size_type i=0; i<n; ++i)
+        x[i] = b[i];
+      for (size_type k=0; k<n; ++k)
+        std::swap(x[k], x[pivot[k*lanes]]);
+
+      // forward substitution with the unit lower triangle
+      for (size_type i=0; i<n; ++i)
+        for (size_type j=0; j<i; ++j)
+          x[i] -= A(i,j) * x[j];
+
+      // backward substitution with the upper triangle
+      for (size_type i=n; i-- > 0;)
+      {
+        for (size_type j=i+1; j<n; ++j)
+          x[i] -= A(i,j) * x[j];
+        x[i] /= A(i,i);
+      }
+    }
+
+  private:
+    struct Pack
+    {
+      //! the number of rows and columns of the matrices of the pack
+      size_type n;
+      //! the position of the entries in values_
+      size_type offset;
+      //! the position of the pivots in pivots_
+      size_type pivotOffset;
+    };
+
+    void decomposePack (const Pack& pack)
+    {
+      using std::abs;
+      typedef typename FieldTraits<K>::real_type real_type;
+      const size_type n = pack.n;
+      K* a = values_.data() + pack.offset;
+      size_type* pivot = pivots_.data() + pack.pivotOffset;
+      auto A = [&](size_type i, size_type j) { return a + (i*n + j)*lanes; };
+
+      for (size_type k=0; k<n; ++k)
+      {
+        // pivot search and row interchange, separately for each matrix
+        for (size_type l=0; l<lanes; ++l)
+        {
+          size_type r = k;
+          real_type max = abs(A(k,k)[l]);
+          for (size_type i=k+1; i<n; ++i)
+            if (abs(A(i,k)[l]) > max)
+            {
+              max = abs(A(i,k)[l]);
+              r = i;
+            }
+          if (max < FMatrixPrecision<real_type>::absolute_limit())
+            DUNE_THROW(FMatrixError, "matrix is singular");
+          pivot[k*lanes + l] = r;
+          if (r != k)
+            for (size_type j=0; j<n; ++j)
+              std::swap(A(k,j)[l], A(r,j)[l]);
+        }
+
+        // elimination, vectorized across the matrices
+        K inverse[lanes];
+        for (size_type l=0; l<lanes; ++l)
+          inverse[l] = K(1) / A(k,k)[l];
+        for (size_type i=k+1; i<n; ++i)
+        {
+          K* aik = A(i,k);
+          for (size_type l=0; l<lanes; ++l)
+            aik[l] *= inverse[l];
+          for (size_type j=k+1; j<n; ++j)
+          {
+            K* aij = A(i,j);
+            const K* akj = A(k,j);
+            for (size_type l=0; l<lanes; ++l)
+              aij[l] -= aik[l] * akj[l];
+          }
+        }
+      }
+    }
+
+    //! the pack and the lane of each matrix
+    std::vector<std::pair<size_type,size_type> > location_;
+    std::vector<Pack> packs_;
+    std::vector<K> values_;
+    std::vector<size_type> pivots_;
+  };
+
+  /** @} end documentation */
+
+} // end namespace Dune
+
+#endif
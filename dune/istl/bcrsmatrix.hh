@@ -11,10 +11,12 @@
 #include <set>
 #include <iostream>
 #include <algorithm>
+#include <atomic>
 #include <numeric>
 #include <vector>
 #include <map>
 #include <memory>
+#include <mutex>
 
 #include "istlexception.hh"
 #include "bvector.hh"
@@ -27,6 +29,7 @@
 #include <dune/common/scalarmatrixview.hh>
 
 #include <dune/istl/blocklevel.hh>
+#include <dune/istl/common/threadpool.hh>
 
 /*! \file
  * \brief Implementation of the BCRSMatrix class
@@ -225,6 +228,323 @@ namespace Dune {
 
   };
 
+  //! A thread-safe builder for the pattern of a BCRSMatrix in implicit build mode.
+  /**
+   * This builder allows several threads to insert entries into the same matrix
+   * concurrently, e.g. during a threaded finite element assembly. It uses the
+   * storage layout of the implicit build mode: every row owns `avg` slots,
+   * entries that do not fit go to an overflow area.
+   *
+   * - A free slot of a row is claimed by an atomic compare-and-swap of its column
+   *   index, so inserting into the slots is lock-free and every pair (i,j) is stored
+   *   only once, even if several threads insert it at the same time.
+   * - The overflow area is split into shards protected by separate mutexes.
+   *
+   * After all threads have finished inserting, compress() of this builder (not the one
+   * of the matrix!) has to be called from a single thread. It sorts and compacts the rows
+   * in parallel using ThreadPool::instance() and moves the matrix into the built stage.
+   * In contrast to BCRSMatrix::compress(), it copies the entries into a new array of
+   * exactly the needed size, so the overflow area cannot be exhausted.
+   *
+   * \note Memory: the column indices of the slots are kept in a separate array of
+   *       `avg*N()` `std::atomic<size_type>` (usually 8 bytes each) in addition to the
+   *       storage of the matrix in implicit build mode, because the plain column index
+   *       array of the matrix cannot be accessed atomically before C++20. During
+   *       compress() the final arrays of the values and column indices are allocated
+   *       before the build storage is freed, so the peak usage is about twice that of
+   *       the sequential implicit build mode. The slots and the overflow area are
+   *       released at the end of compress().
+   *
+   * \note entry() only synchronizes the sparsity pattern. If several threads write to
+   *       the value of the same entry, the caller has to synchronize these writes
+   *       (e.g. by coloring the elements). The newly created entries are not initialized,
+   *       just as in the sequential implicit build mode.
+   *
+   * \code
+   * BCRSMatrix<FieldMatrix<double,1,1>> A;
+   * ConcurrentImplicitMatrixBuilder<decltype(A)> builder(A, n, n, 5, 0.1);
+   * // in each thread
+   * builder.entry(i,j) = 0.0;
+   * // after joining the threads
+   * builder.compress();
+   * \endcode
+   *
+   * \tparam M_ the matrix type
+   */
+  template<class M_>
+  class ConcurrentImplicitMatrixBuilder
+  {
+
+  public:
+
+    //! The underlying matrix.
+    typedef M_ Matrix;
+
+    //! The block_type of the underlying matrix.
+    typedef typename Matrix::block_type block_type;
+
+    //! The size_type of the underlying matrix.
+    typedef typename Matrix::size_type size_type;
+
+    //! Proxy row object for entry access.
+    class row_object
+    {
+
+    public:
+
+      //! Returns entry in column j.
+      block_type& operator[](size_type j) const
+      {
+        return _b.entry(_i,j);
+      }
+
+#ifndef DOXYGEN
+
+      row_object(ConcurrentImplicitMatrixBuilder& b, size_type i)
+        : _b(b)
+        , _i(i)
+      {}
+
+#endif
+
+    private:
+
+      ConcurrentImplicitMatrixBuilder& _b;
+      size_type _i;
+
+    };
+
+    //! Creates a ConcurrentImplicitMatrixBuilder for matrix m.
+    /**
+     * \note The matrix has to be in implicit build mode with its size set, and no
+     *       entries must have been inserted yet.
+     */
+    ConcurrentImplicitMatrixBuilder(Matrix& m)
+      : _m(m)
+    {
+      if (m.buildMode() != Matrix::implicit)
+        DUNE_THROW(BCRSMatrixError,"You can only create a ConcurrentImplicitMatrixBuilder for a matrix in implicit build mode");
+      if (m.buildStage() != Matrix::building)
+        DUNE_THROW(BCRSMatrixError,"You can only create a ConcurrentImplicitMatrixBuilder for a matrix with set size that has not been compressed() yet");
+      setup();
+    }
+
+    //! Sets up matrix m for implicit construction and creates a ConcurrentImplicitMatrixBuilder for it.
+    /**
+     * \param m                 the matrix to be built
+     * \param rows              the number of matrix rows
+     * \param cols              the number of matrix columns
+     * \param avg_cols_per_row  the average number of non-zero columns per row
+     * \param overflow_fraction the amount of overflow to reserve in the matrix
+     *
+     * \sa ImplicitMatrixBuilder
+     */
+    ConcurrentImplicitMatrixBuilder(Matrix& m, size_type rows, size_type cols, size_type avg_cols_per_row, double overflow_fraction)
+      : _m(m)
+    {
+      if (m.buildStage() != Matrix::notAllocated)
+        DUNE_THROW(BCRSMatrixError,"You can only set up a matrix for this ConcurrentImplicitMatrixBuilder if it has no memory allocated yet");
+      m.setBuildMode(Matrix::implicit);
+      m.setImplicitBuildModeParameters(avg_cols_per_row,overflow_fraction);
+      m.setSize(rows,cols);
+      setup();
+    }
+
+    //! Returns entry (row,col), inserting it into the pattern if necessary. Thread safe.
+    block_type& entry(size_type row, size_type col)
+    {
+#ifdef DUNE_ISTL_WITH_CHECKING
+      if (_m.buildStage() != Matrix::building)
+        DUNE_THROW(BCRSMatrixError,"You may only use entry() during the 'building' stage");
+      if (row >= _m.N())
+        DUNE_THROW(BCRSMatrixError,"row index exceeds matrix size");
+      if (col >= _m.M())
+        DUNE_THROW(BCRSMatrixError,"column index exceeds matrix size");
+#endif
+      std::atomic<size_type>* slot = _slots.get() + row*_avg;
+      block_type* values = _m.r[row].getptr();
+      for (size_type k=0; k<_avg; ++k)
+      {
+        size_type c = slot[k].load(std::memory_order_acquire);
+        // claim an empty slot; on failure c holds the column inserted by another thread
+        if (c == _empty && slot[k].compare_exchange_strong(c, col, std::memory_order_acq_rel))
+          return values[k];
+        if (c == col)
+          return values[k];
+      }
+
+      OverflowShard& shard = _overflow[row % overflowShards];
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      return shard.entries[std::make_pair(row,col)];
+    }
+
+    //! Returns a proxy for entries in row i.
+    row_object operator[](size_type i)
+    {
+      return row_object(*this,i);
+    }
+
+    //! The number of rows in the matrix.
+    size_type N() const
+    {
+      return _m.N();
+    }
+
+    //! The number of columns in the matrix.
+    size_type M() const
+    {
+      return _m.M();
+    }
+
+    //! Finishes the build stage, sorting and compacting the rows in parallel.
+    /**
+     * Must be called from a single thread after all insertions have finished.
+     * Afterwards the matrix is fully built.
+     */
+    typename Matrix::CompressionStatistics compress()
+    {
+      if (_m.buildStage() != Matrix::building)
+        DUNE_THROW(InvalidStateException,"You may only call compress() at the end of the 'building' stage");
+
+      const size_type n = _m.N();
+      ThreadPool& pool = ThreadPool::instance();
+
+      // gather the overflow entries sorted by (row,col)
+      std::vector<std::pair<std::pair<size_type,size_type>, const block_type*> > overflow;
+      for (size_type s=0; s<overflowShards; ++s)
+        for (const auto& entry : _overflow[s].entries)
+          overflow.emplace_back(entry.first, &entry.second);
+      std::sort(overflow.begin(), overflow.end(),
+                [](const auto& a, const auto& b){ return a.first < b.first; });
+      std::vector<size_type> overflowOffset(n+1, 0);
+      for (const auto& entry : overflow)
+        ++overflowOffset[entry.first.first+1];
+      for (size_type i=0; i<n; ++i)
+        overflowOffset[i+1] += overflowOffset[i];
+
+      // row sizes and their prefix sum, computed blockwise in parallel
+      std::vector<size_type> rowOffset(n+1, 0);
+      pool.parallelFor(0, n, [&](size_type first, size_type last){
+        for (size_type i=first; i<last; ++i)
+          rowOffset[i+1] = slotsUsed(i) + overflowOffset[i+1] - overflowOffset[i];
+      }, 4096);
+      for (size_type i=0; i<n; ++i)
+        rowOffset[i+1] += rowOffset[i];
+      const size_type nnz = rowOffset[n];
+
+      // copy the sorted rows into new arrays of exactly the needed size
+      auto& allocator = _m.allocator_;
+      auto& sizeAllocator = _m.sizeAllocator_;
+      block_type* a = (nnz>0) ? allocator.allocate(nnz) : nullptr;
+      size_type* j = (nnz>0) ? sizeAllocator.allocate(nnz) : nullptr;
+      pool.parallelFor(0, n, [&](size_type first, size_type last){
+        std::vector<std::pair<size_type, const block_type*> > row;
+        for (size_type i=first; i<last; ++i)
+        {
+          row.clear();
+          const block_type* values = _m.r[i].getptr();
+          for (size_type k=0, s=slotsUsed(i); k<s; ++k)
+            row.emplace_back(_slots[i*_avg+k].load(std::memory_order_relaxed), values+k);
+          for (size_type k=overflowOffset[i]; k<overflowOffset[i+1]; ++k)
+            row.emplace_back(overflow[k].first.second, overflow[k].second);
+          std::sort(row.begin(), row.end(),
+                    [](const auto& x, const auto& y){ return x.first < y.first; });
+
+          size_type offset = rowOffset[i];
+          for (const auto& entry : row)
+          {
+            j[offset] = entry.first;
+            std::allocator_traits<std::decay_t<decltype(allocator)> >::construct(allocator, a+offset, *entry.second);
+            ++offset;
+          }
+        }
+      }, 1024);
+
+      // statistics
+      typename Matrix::CompressionStatistics stats;
+      stats.overflow_total = overflow.size();
+      stats.maximum = 0;
+      for (size_type i=0; i<n; ++i)
+        stats.maximum = std::max(stats.maximum, rowOffset[i+1]-rowOffset[i]);
+      stats.avg = (n == 0) ? 0.0 : double(nnz) / double(n);
+      stats.mem_ratio = (_m.allocationSize_ == 0) ? 1.0 : double(nnz) / double(_m.allocationSize_);
+
+      // release the build storage and switch the matrix to the new arrays
+      if (_m.a)
+      {
+        for (size_type k=0; k<_m.allocationSize_; ++k)
+          std::allocator_traits<std::decay_t<decltype(allocator)> >::destroy(allocator, _m.a+k);
+        allocator.deallocate(_m.a, _m.allocationSize_);
+      }
+      _m.a = a;
+      if (nnz>0)
+        _m.j_.reset(j, [alloc = sizeAllocator, size = nnz](auto ptr) mutable {
+            alloc.deallocate(ptr, size);
+          });
+      else
+        _m.j_.reset();
+      _m.allocationSize_ = nnz;
+      _m.nnz_ = nnz;
+      for (size_type i=0; i<n; ++i)
+      {
+        size_type size = rowOffset[i+1]-rowOffset[i];
+        if (size > 0)
+          _m.r[i].set(size, a+rowOffset[i], j+rowOffset[i]);
+        else
+          _m.r[i].set(0, nullptr, nullptr);
+      }
+
+      _slots.reset();
+      _overflow.reset();
+      _m.ready = Matrix::built;
+
+      return stats;
+    }
+
+  private:
+
+    //! number of independently locked parts of the overflow area
+    static constexpr size_type overflowShards = 64;
+
+    struct OverflowShard
+    {
+      std::mutex mutex;
+      std::map<std::pair<size_type,size_type>, block_type> entries;
+    };
+
+    void setup()
+    {
+      const size_type n = _m.N();
+      for (size_type i=0; i<n; ++i)
+        if (_m.r[i].getsize() > 0)
+          DUNE_THROW(BCRSMatrixError,"A ConcurrentImplicitMatrixBuilder can only be used for a matrix without entries");
+      _avg = _m.avg;
+      _empty = _m.M();
+      _slots.reset(new std::atomic<size_type>[n*_avg]);
+      ThreadPool::instance().parallelFor(0, n*_avg, [&](size_type first, size_type last){
+        for (size_type k=first; k<last; ++k)
+          _slots[k].store(_empty, std::memory_order_relaxed);
+      }, 1<<16);
+      _overflow.reset(new OverflowShard[overflowShards]);
+    }
+
+    //! the slots of a row are filled from the front, so count until the first empty one
+    size_type slotsUsed(size_type i) const
+    {
+      size_type k = 0;
+      while (k<_avg && _slots[i*_avg+k].load(std::memory_order_relaxed) != _empty)
+        ++k;
+      return k;
+    }
+
+    Matrix& _m;
+    size_type _avg;
+    size_type _empty;
+    std::unique_ptr<std::atomic<size_type>[]> _slots;
+    std::unique_ptr<OverflowShard[]> _overflow;
+
+  };
+
   /**
      \brief A sparse block matrix with compressed row storage
 
@@ -465,6 +785,7 @@ namespace Dune {
   class BCRSMatrix
   {
     friend struct MatrixDimension<BCRSMatrix>;
+    template<class> friend class ConcurrentImplicitMatrixBuilder;
   public:
     enum BuildStage {
       /** @brief Matrix is not built at all, no memory has been allocated, build mode and size can still be set. */
@@ -1636,6 +1957,13 @@ namespace Dune {
 
     //===== linear maps
 
+    /*
+     * The products mv, umv, mmv and usmv process the rows concurrently if the
+     * global ThreadPool uses more than one thread (see DUNE_ISTL_NUM_THREADS).
+     * Every row is still computed by a single thread, so the result does not
+     * depend on the number of threads.
+     */
+
     //! y = A x
     template<class X, class Y>
     void mv (const X& x, Y& y) const
@@ -1648,18 +1976,20 @@ namespace Dune {
       if (y.N()!=N()) DUNE_THROW(BCRSMatrixError,
                                  "Size mismatch: M: " << N() << "x" << M() << " y: " << y.N());
 #endif
-      ConstRowIterator endi=end();
-      for (ConstRowIterator i=this->begin(); i!=endi; ++i)
+      forEachRowRange([&](size_type first, size_type last)
       {
-        y[i.index()]=0;
-        ConstColIterator endj = (*i).end();
-        for (ConstColIterator j=(*i).begin(); j!=endj; ++j)
+        for (size_type i=first; i<last; ++i)
         {
-          auto&& xj = Impl::asVector(x[j.index()]);
-          auto&& yi = Impl::asVector(y[i.index()]);
-          Impl::asMatrix(*j).umv(xj, yi);
+          y[i]=0;
+          ConstColIterator endj = r[i].end();
+          for (ConstColIterator j=r[i].begin(); j!=endj; ++j)
+          {
+            auto&& xj = Impl::asVector(x[j.index()]);
+            auto&& yi = Impl::asVector(y[i]);
+            Impl::asMatrix(*j).umv(xj, yi);
+          }
         }
-      }
+      });
     }
 
     //! y += A x
@@ -1672,17 +2002,19 @@ namespace Dune {
       if (x.N()!=M()) DUNE_THROW(BCRSMatrixError,"index out of range");
       if (y.N()!=N()) DUNE_THROW(BCRSMatrixError,"index out of range");
 #endif
-      ConstRowIterator endi=end();
-      for (ConstRowIterator i=this->begin(); i!=endi; ++i)
+      forEachRowRange([&](size_type first, size_type last)
       {
-        ConstColIterator endj = (*i).end();
-        for (ConstColIterator j=(*i).begin(); j!=endj; ++j)
+        for (size_type i=first; i<last; ++i)
         {
-          auto&& xj = Impl::asVector(x[j.index()]);
-          auto&& yi = Impl::asVector(y[i.index()]);
-          Impl::asMatrix(*j).umv(xj,yi);
+          ConstColIterator endj = r[i].end();
+          for (ConstColIterator j=r[i].begin(); j!=endj; ++j)
+          {
+            auto&& xj = Impl::asVector(x[j.index()]);
+            auto&& yi = Impl::asVector(y[i]);
+            Impl::asMatrix(*j).umv(xj,yi);
+          }
         }
-      }
+      });
     }
 
     //! y -= A x
@@ -1695,17 +2027,19 @@ namespace Dune {
       if (x.N()!=M()) DUNE_THROW(BCRSMatrixError,"index out of range");
       if (y.N()!=N()) DUNE_THROW(BCRSMatrixError,"index out of range");
 #endif
-      ConstRowIterator endi=end();
-      for (ConstRowIterator i=this->begin(); i!=endi; ++i)
+      forEachRowRange([&](size_type first, size_type last)
       {
-        ConstColIterator endj = (*i).end();
-        for (ConstColIterator j=(*i).begin(); j!=endj; ++j)
+        for (size_type i=first; i<last; ++i)
         {
-          auto&& xj = Impl::asVector(x[j.index()]);
-          auto&& yi = Impl::asVector(y[i.index()]);
-          Impl::asMatrix(*j).mmv(xj,yi);
+          ConstColIterator endj = r[i].end();
+          for (ConstColIterator j=r[i].begin(); j!=endj; ++j)
+          {
+            auto&& xj = Impl::asVector(x[j.index()]);
+            auto&& yi = Impl::asVector(y[i]);
+            Impl::asMatrix(*j).mmv(xj,yi);
+          }
         }
-      }
+      });
     }
 
     //! y += alpha A x
@@ -1718,17 +2052,19 @@ namespace Dune {
       if (x.N()!=M()) DUNE_THROW(BCRSMatrixError,"index out of range");
       if (y.N()!=N()) DUNE_THROW(BCRSMatrixError,"index out of range");
 #endif
-      ConstRowIterator endi=end();
-      for (ConstRowIterator i=this->begin(); i!=endi; ++i)
+      forEachRowRange([&](size_type first, size_type last)
       {
-        ConstColIterator endj = (*i).end();
-        for (ConstColIterator j=(*i).begin(); j!=endj; ++j)
+        for (size_type i=first; i<last; ++i)
         {
-          auto&& xj = Impl::asVector(x[j.index()]);
-          auto&& yi = Impl::asVector(y[i.index()]);
-          Impl::asMatrix(*j).usmv(alpha,xj,yi);
+          ConstColIterator endj = r[i].end();
+          for (ConstColIterator j=r[i].begin(); j!=endj; ++j)
+          {
+            auto&& xj = Impl::asVector(x[j.index()]);
+            auto&& yi = Impl::asVector(y[i]);
+            Impl::asMatrix(*j).usmv(alpha,xj,yi);
+          }
         }
-      }
+      });
     }
 
     //! y = A^T x
@@ -2078,6 +2414,86 @@ namespace Dune {
     typedef std::map<std::pair<size_type,size_type>, B> OverflowType;
     OverflowType overflow;
 
+    //! Row ranges used by the threaded matrix-vector products.
+    struct RowPartition
+    {
+      //! number of threads the partition was computed for
+      std::size_t threads;
+      //! the k-th range consists of the rows [offsets[k], offsets[k+1])
+      std::vector<size_type> offsets;
+    };
+
+    // cached row partition, computed on first use and reset whenever the structure changes
+    mutable std::shared_ptr<const RowPartition> rowPartition_;
+    // guards rowPartition_, products on the same matrix may be called concurrently
+    mutable std::mutex rowPartitionMutex_;
+
+    //! Drop the cached row partition after the structure has changed.
+    void resetRowPartition ()
+    {
+      std::lock_guard<std::mutex> lock(rowPartitionMutex_);
+      rowPartition_.reset();
+    }
+
+    //! Minimal number of blocks per row range before threads are used.
+    static constexpr size_type minBlocksPerRowRange = 4096;
+
+    /**
+     * \brief Split the rows into ranges holding approximately the same number of blocks.
+     *
+     * The result only depends on the sparsity pattern and the number of threads.
+     */
+    std::shared_ptr<const RowPartition> computeRowPartition (std::size_t threads) const
+    {
+      auto partition = std::make_shared<RowPartition>();
+      partition->threads = threads;
+
+      size_type total = 0;
+      for (size_type i=0; i<n; ++i)
+        total += r[i].getsize();
+      size_type ranges = std::max<size_type>(1, std::min<size_type>(threads, total / minBlocksPerRowRange));
+
+      partition->offsets.reserve(ranges+1);
+      partition->offsets.push_back(0);
+      size_type blocks = 0;
+      for (size_type i=0; i<n && partition->offsets.size()<ranges; ++i)
+      {
+        blocks += r[i].getsize();
+        if (blocks * ranges >= total * partition->offsets.size())
+          partition->offsets.push_back(i+1);
+      }
+      partition->offsets.push_back(n);
+      return partition;
+    }
+
+    /**
+     * \brief Call `kernel(first, last)` for disjoint row ranges covering all rows.
+     *
+     * If the global ThreadPool uses more than one thread, the ranges are balanced by
+     * the number of blocks and processed concurrently. Each row is handled by exactly
+     * one thread in the same order as in the sequential loop, so the results are
+     * bitwise identical to the sequential ones.
+     */
+    template<class Kernel>
+    void forEachRowRange (Kernel&& kernel) const
+    {
+      ThreadPool& pool = ThreadPool::instance();
+      if (pool.numThreads() == 1 || n == 0)
+        return kernel(size_type(0), n);
+
+      std::shared_ptr<const RowPartition> partition;
+      {
+        std::lock_guard<std::mutex> lock(rowPartitionMutex_);
+        if (!rowPartition_ || rowPartition_->threads != pool.numThreads())
+          rowPartition_ = computeRowPartition(pool.numThreads());
+        partition = rowPartition_;
+      }
+      const auto& offsets = partition->offsets;
+      pool.run(offsets.size()-1, [&](std::size_t k){
+        kernel(offsets[k], offsets[k+1]);
+      });
+    }
+
     void setWindowPointers(ConstRowIterator row)
     {
       row_type current_row(a,j_.get(),0); // Pointers to current row data
@@ -2211,6 +2627,7 @@ namespace Dune {
 
       // Mark matrix as not built at all.
       ready=notAllocated;
+      resetRowPartition();
 
     }
 
@@ -2239,6 +2656,7 @@ namespace Dune {
       m = columns;
       nnz_ = allocationSize;
       allocationSize_ = allocationSize;
+      resetRowPartition();
 
       // allocate rows
       if(allocateRows) {
@@ -0,0 +1,398 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+/** \file \brief Micro-benchmarks of the core kernels of dune-istl.
+
+    Each kernel is repeated until a measurement takes at least `mintime`
+    seconds. The fastest of `repetitions` measurements is reported together
+    with the estimated GFLOP/s and GB/s, as JSON or CSV. If a baseline written
+    by a previous run is given, the times are compared with it and the program
+    fails if a kernel became slower by more than the relative `tolerance`.
+
+    Options are given as `-key value`:
+    \verbatim
+    size        = 300           # grid nodes per direction of the Laplacian
+    matrix      =               # MatrixMarket file replacing the Laplacian in the scalar kernels
+    threads     = 1             # threads of the ThreadPool
+    repetitions = 5
+    mintime     = 0.05
+    filter      =               # run only the kernels whose name contains this string
+    format      = json          # or csv
+    output      =               # file name, the standard output if empty
+    baseline    =               # JSON output of a previous run
+    tolerance   = 0.1
+    \endverbatim
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/common/parametertree.hh>
+#include <dune/common/parametertreeparser.hh>
+#include <dune/common/propertymap.hh>
+
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/matrixmarket.hh>
+#include <dune/istl/matrixmatrix.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/preconditioners.hh>
+#include <dune/istl/common/threadpool.hh>
+#include <dune/istl/paamg/amg.hh>
+#include <dune/istl/paamg/galerkin.hh>
+#include <dune/istl/paamg/pinfo.hh>
+#include <dune/istl/test/laplacian.hh>
+
+struct Result
+{
+  std::string name;
+  //! seconds per call
+  double time;
+  double flops;
+  double bytes;
+  //! seconds per call of the baseline, negative if unknown
+  double baseline = -1.0;
+};
+
+class Benchmark
+{
+public:
+  explicit Benchmark (const Dune::ParameterTree& config)
+    : repetitions_(config.get("repetitions", 5))
+    , mintime_(config.get("mintime", 0.05))
+    , filter_(config.get("filter", std::string()))
+  {}
+
+  //! \brief Whether the kernels of the given name are to be run.
+  bool selected (const std::string& name) const
+  {
+    return name.find(filter_) != std::string::npos;
+  }
+
+  /**
+   * \brief Measure the time per call of f.
+   *
+   * \param flops The estimated floating point operations of a call, zero if unknown.
+   * \param bytes The estimated bytes moved by a call, zero if unknown.
+   */
+  template<class F>
+  void run (const std::string& name, double flops, double bytes, F&& f)
+  {
+    if (!selected(name))
+      return;
+    f();
+
+    // the number of calls per measurement such that it takes at least mintime
+    std::size_t calls = 1;
+    double elapsed = measure(f, calls);
+    while (elapsed < mintime_)
+    {
+      calls = std::max<std::size_t>(2*calls, std::size_t(1.2*calls*mintime_/std::max(elapsed, 1e-9)));
+      elapsed = measure(f, calls);
+    }
+
+    double best = elapsed/calls;
+    for (int r=1; r<repetitions_; ++r)
+      best = std::min(best, measure(f, calls)/calls);
+    results_.push_back({name, best, flops, bytes});
+    std::cerr << name << ": " << best << " s" << std::endl;
+  }
+
+  std::vector<Result>& results ()
+  {
+    return results_;
+  }
+
+private:
+  template<class F>
+  static double measure (F& f, std::size_t calls)
+  {
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i=0; i<calls; ++i)
+      f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  int repetitions_;
+  double mintime_;
+  std::string filter_;
+  std::vector<Result> results_;
+};
+
+// the bytes of a matrix-vector product: all blocks, their column indices and both vectors
+template<class Matrix>
+double mvBytes (const Matrix& A, std::size_t blockSize)
+{
+  return A.nonzeroes()*(blockSize*blockSize*sizeof(double) + sizeof(typename Matrix::size_type))
+    + (A.N() + A.M())*blockSize*sizeof(double);
+}
+
+template<int b>
+void benchmarkMatrixVector (Benchmark& benchmark, int size)
+{
+  using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double,b,b>>;
+  using Vector = Dune::BlockVector<Dune::FieldVector<double,b>>;
+  const std::string suffix = " b=" + std::to_string(b);
+  if (!benchmark.selected("bcrs mv" + suffix) && !benchmark.selected("bcrs umv" + suffix))
+    return;
+
+  Matrix A;
+  setupLaplacian(A, size);
+  Vector x(A.M()), y(A.N());
+  x = 1.0;
+  y = 0.0;
+  const double flops = 2.0*A.nonzeroes()*b*b;
+  const double bytes = mvBytes(A, b);
+  benchmark.run("bcrs mv" + suffix, flops, bytes, [&]{ A.mv(x, y); });
+  benchmark.run("bcrs umv" + suffix, flops, bytes + A.N()*b*sizeof(double), [&]{ A.umv(x, y); });
+}
+
+template<class Matrix, class Vector>
+void benchmarkScalar (Benchmark& benchmark, const Matrix& A)
+{
+  const double n = A.N();
+  Vector x(A.M()), y(A.N()), v(A.N());
+  x = 1.0;
+  y = 0.5;
+  v = 0.0;
+  double sum = 0.0;
+
+  // BLAS-1
+  benchmark.run("bvector axpy", 2*n, 3*n*sizeof(double), [&]{ y.axpy(1e-8, x); });
+  benchmark.run("bvector dot", 2*n, 2*n*sizeof(double), [&]{ sum += x.dot(y); });
+  benchmark.run("bvector two_norm", 2*n, n*sizeof(double), [&]{ sum += y.two_norm(); });
+  benchmark.run("bvector scale", n, 2*n*sizeof(double), [&]{ y *= 1.0; });
+  if (sum < 0.0)
+    std::cerr << sum << std::endl;
+
+  // preconditioners, both sweeps read the matrix once
+  const double matrixBytes = A.nonzeroes()*(sizeof(double) + sizeof(typename Matrix::size_type));
+  if (benchmark.selected("ilu0 apply"))
+  {
+    Dune::SeqILU<Matrix,Vector,Vector> ilu(A, 1.0);
+    benchmark.run("ilu0 apply", 2.0*A.nonzeroes(), matrixBytes + 3*n*sizeof(double), [&]{ ilu.apply(v, y); });
+  }
+  if (benchmark.selected("ssor apply"))
+  {
+    Dune::SeqSSOR<Matrix,Vector,Vector> ssor(A, 1, 1.0);
+    benchmark.run("ssor apply", 4.0*A.nonzeroes(), 2*matrixBytes + 4*n*sizeof(double), [&]{ ssor.apply(v, y); });
+  }
+
+  // sparse matrix product A*A, two operations per product of entries
+  if (benchmark.selected("matmultmat"))
+  {
+    double products = 0.0;
+    for (auto row = A.begin(); row != A.end(); ++row)
+      for (auto entry = row->begin(); entry != row->end(); ++entry)
+        products += A[entry.index()].getsize();
+    benchmark.run("matmultmat", 2.0*products, 0.0, [&]{
+      Matrix C;
+      Dune::matMultMat(C, A, A);
+    });
+  }
+
+  // MatrixMarket output and input, the bytes are the size of the file
+  if (benchmark.selected("matrixmarket"))
+  {
+    const std::string fileName = "istlbenchmark.mm";
+    Dune::storeMatrixMarket(A, fileName);
+    const double fileSize = std::filesystem::file_size(fileName);
+    benchmark.run("matrixmarket store", 0.0, fileSize, [&]{ Dune::storeMatrixMarket(A, fileName); });
+    benchmark.run("matrixmarket load", 0.0, fileSize, [&]{
+      Matrix B;
+      Dune::loadMatrixMarket(B, fileName);
+    });
+    std::filesystem::remove(fileName);
+  }
+}
+
+template<class Matrix, class Vector>
+void benchmarkAMG (Benchmark& benchmark, const Matrix& A)
+{
+  using Operator = Dune::MatrixAdapter<Matrix,Vector,Vector>;
+  using Smoother = Dune::SeqSSOR<Matrix,Vector,Vector>;
+  using Criterion = Dune::Amg::CoarsenCriterion<Dune::Amg::SymmetricCriterion<Matrix,Dune::Amg::FirstDiagonal>>;
+  using AMG = Dune::Amg::AMG<Operator,Vector,Smoother>;
+
+  Criterion criterion;
+  criterion.setDefaultValuesIsotropic(2);
+  criterion.setDebugLevel(0);
+
+  // the Galerkin product of the first level
+  if (benchmark.selected("galerkin"))
+  {
+    using MatrixGraph = Dune::Amg::MatrixGraph<const Matrix>;
+    using SubGraph = Dune::Amg::SubGraph<MatrixGraph,std::vector<bool>>;
+    using PropertiesGraph = Dune::Amg::PropertiesGraph<SubGraph,Dune::Amg::VertexProperties,
+        Dune::Amg::EdgeProperties,Dune::IdentityMap,typename SubGraph::EdgeIndexMap>;
+    using Vertex = typename PropertiesGraph::VertexDescriptor;
+    using VisitedMap = Dune::IteratorPropertyMap<std::vector<bool>::iterator,Dune::IdentityMap>;
+    using OverlapFlags = Dune::NegateSet<Dune::Amg::SequentialInformation::OwnerSet>;
+
+    MatrixGraph mg(A);
+    std::vector<bool> excluded(A.N(), false);
+    SubGraph sg(mg, excluded);
+    PropertiesGraph pg(sg, Dune::IdentityMap(), sg.getEdgeIndexMap());
+    Dune::Amg::AggregatesMap<Vertex> aggregatesMap(pg.noVertices());
+    int noAggregates, isoAggregates, oneAggregates, skipped;
+    std::tie(noAggregates, isoAggregates, oneAggregates, skipped) = aggregatesMap.buildAggregates(A, pg, criterion, true);
+
+    Dune::Amg::SequentialInformation pinfo;
+    Dune::Amg::GalerkinProduct<Dune::Amg::SequentialInformation> productBuilder;
+    std::vector<bool> visited(A.N());
+    benchmark.run("galerkin", 0.0, 0.0, [&]{
+      std::fill(visited.begin(), visited.end(), false);
+      VisitedMap visitedMap(visited.begin(), Dune::IdentityMap());
+      std::unique_ptr<Matrix> coarse(productBuilder.build(mg, visitedMap, pinfo, aggregatesMap, noAggregates, OverlapFlags()));
+      productBuilder.calculate(A, aggregatesMap, *coarse, pinfo, OverlapFlags());
+    });
+  }
+
+  if (!benchmark.selected("amg"))
+    return;
+  Operator op(A);
+  typename Dune::Amg::SmootherTraits<Smoother>::Arguments smootherArgs;
+  smootherArgs.iterations = 1;
+  smootherArgs.relaxationFactor = 1.0;
+  benchmark.run("amg setup", 0.0, 0.0, [&]{ AMG amg(op, criterion, smootherArgs); });
+
+  AMG amg(op, criterion, smootherArgs);
+  Vector v(A.N()), d(A.N());
+  v = 0.0;
+  d = 1.0;
+  benchmark.run("amg apply", 0.0, 0.0, [&]{ amg.apply(v, d); });
+}
+
+// read the times of a previous run, written by writeJSON
+std::map<std::string,double> readBaseline (const std::string& fileName)
+{
+  std::ifstream file(fileName);
+  if (!file)
+    DUNE_THROW(Dune::IOError, "Could not open the baseline " << fileName);
+  std::map<std::string,double> baseline;
+  std::string line;
+  while (std::getline(file, line))
+  {
+    const std::string nameKey = "\"name\": \"", timeKey = "\"time\": ";
+    const auto name = line.find(nameKey);
+    const auto time = line.find(timeKey);
+    if (name == std::string::npos || time == std::string::npos)
+      continue;
+    const auto nameBegin = name + nameKey.size();
+    baseline[line.substr(nameBegin, line.find('"', nameBegin) - nameBegin)] = std::stod(line.substr(time + timeKey.size()));
+  }
+  return baseline;
+}
+
+double rate (double amount, double time)
+{
+  return amount/time*1e-9;
+}
+
+void writeJSON (std::ostream& os, const std::vector<Result>& results, int size, std::size_t threads)
+{
+  os.precision(std::numeric_limits<double>::max_digits10);
+  os << "{\n  \"size\": " << size << ",\n  \"threads\": " << threads << ",\n  \"benchmarks\": [\n";
+  for (std::size_t i=0; i<results.size(); ++i)
+  {
+    const Result& r = results[i];
+    os << "    {\"name\": \"" << r.name << "\", \"time\": " << r.time
+       << ", \"gflops\": " << rate(r.flops, r.time) << ", \"gbs\": " << rate(r.bytes, r.time);
+    if (r.baseline > 0.0)
+      os << ", \"baseline\": " << r.baseline << ", \"ratio\": " << r.time/r.baseline;
+    os << "}" << (i+1 < results.size() ? "," : "") << "\n";
+  }
+  os << "  ]\n}\n";
+}
+
+void writeCSV (std::ostream& os, const std::vector<Result>& results)
+{
+  os.precision(std::numeric_limits<double>::max_digits10);
+  os << "name,time,gflops,gbs,baseline,ratio\n";
+  for (const Result& r : results)
+  {
+    os << r.name << "," << r.time << "," << rate(r.flops, r.time) << "," << rate(r.bytes, r.time) << ",";
+    if (r.baseline > 0.0)
+      os << r.baseline << "," << r.time/r.baseline;
+    else
+      os << ",";
+    os << "\n";
+  }
+}
+
+int main (int argc, char** argv)
+{
+  Dune::MPIHelper::instance(argc, argv);
+  Dune::ParameterTree config;
+  Dune::ParameterTreeParser::readOptions(argc, argv, config);
+
+  const int size = config.get("size", 300);
+  const std::size_t threads = config.get("threads", 1);
+  Dune::ThreadPool::instance().setNumThreads(threads);
+  Benchmark benchmark(config);
+
+  benchmarkMatrixVector<1>(benchmark, size);
+  benchmarkMatrixVector<2>(benchmark, size);
+  benchmarkMatrixVector<3>(benchmark, size);
+  benchmarkMatrixVector<4>(benchmark, size);
+
+  using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double,1,1>>;
+  using Vector = Dune::BlockVector<Dune::FieldVector<double,1>>;
+  Matrix A;
+  const std::string matrixFile = config.get("matrix", std::string());
+  if (matrixFile.empty())
+    setupLaplacian(A, size);
+  else
+    Dune::loadMatrixMarket(A, matrixFile);
+  benchmarkScalar<Matrix,Vector>(benchmark, A);
+  benchmarkAMG<Matrix,Vector>(benchmark, A);
+
+  // compare with the baseline
+  bool regression = false;
+  const std::string baselineFile = config.get("baseline", std::string());
+  if (!baselineFile.empty())
+  {
+    const double tolerance = config.get("tolerance", 0.1);
+    const auto baseline = readBaseline(baselineFile);
+    for (Result& r : benchmark.results())
+    {
+      auto b = baseline.find(r.name);
+      if (b == baseline.end())
+        continue;
+      r.baseline = b->second;
+      if (r.time > (1.0 + tolerance)*r.baseline)
+      {
+        std::cerr << "Regression: " << r.name << " takes " << r.time << " s, "
+                  << r.baseline << " s in the baseline" << std::endl;
+        regression = true;
+      }
+    }
+  }
+
+  const std::string output = config.get("output", std::string());
+  std::ofstream file;
+  if (!output.empty())
+    file.open(output);
+  std::ostream& os = output.empty() ? std::cout : file;
+  if (config.get("format", std::string("json")) == "csv")
+    writeCSV(os, benchmark.results());
+  else
+    writeJSON(os, benchmark.results(), size, threads);
+
+  return regression ? 1 : 0;
+}
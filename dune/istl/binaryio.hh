@@ -0,0 +1,661 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_ISTL_BINARYIO_HH
+#define DUNE_ISTL_BINARYIO_HH
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <ostream>
+#include <type_traits>
+#include <string>
+#include <vector>
+
+#if __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define DUNE_ISTL_BINARYIO_MMAP 1
+#endif
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/typetraits.hh>
+
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/matrixmarket.hh>
+
+namespace Dune
+{
+
+  /**
+   * @addtogroup ISTL_IO
+   * @{
+   */
+
+  /** @file
+   * @brief A binary file format for matrices and vectors that can be memory mapped.
+   *
+   * A file starts with a header describing the object, see BinaryIOImpl::Header,
+   * followed by the arrays of the compressed row storage of a BCRSMatrix,
+   * i.e. the row pointers, the column indices and the block values, or by the
+   * blocks of a BlockVector. All integers are 64 bit wide, the values are stored
+   * as in memory, each block row by row. Every array starts at a multiple of 64
+   * bytes, so a memory mapped file can be used without copying the values.
+   * The byte order is that of the writing machine and is checked on reading.
+   */
+
+  //! @brief Exception thrown if a binary file does not match the requested type.
+  class BinaryFormatError : public Dune::IOError {};
+
+  namespace BinaryIOImpl
+  {
+    //! the alignment of the arrays in the file
+    constexpr std::uint64_t alignment = 64;
+    constexpr std::uint64_t byteOrder = 0x0102030405060708;
+    constexpr std::uint32_t version = 1;
+
+    enum Kind : std::uint32_t { matrix = 0, vector = 1 };
+
+    //! @brief The description of the object stored in a binary file.
+    struct Header
+    {
+      char magic[8];
+      //! byteOrder as written by the machine writing the file
+      std::uint64_t byteOrder;
+      std::uint32_t version;
+      std::uint32_t kind;
+      //! the field type, see FieldTypeId
+      std::uint32_t fieldType;
+      std::uint32_t fieldSize;
+      //! the number of rows and columns of a block, a vector block has one column
+      std::uint64_t blockRows;
+      std::uint64_t blockCols;
+      //! the number of block rows and block columns, a vector has one column
+      std::uint64_t rows;
+      std::uint64_t cols;
+      //! the number of blocks
+      std::uint64_t nonzeroes;
+    };
+
+    inline const char* magic ()
+    {
+      return "DUNEISTL";
+    }
+
+    //! @brief Identifies the field types in the header.
+    template<class K>
+    struct FieldTypeId;
+
+    template<> struct FieldTypeId<float> { static constexpr std::uint32_t value = 1; };
+    template<> struct FieldTypeId<double> { static constexpr std::uint32_t value = 2; };
+    template<> struct FieldTypeId<long double> { static constexpr std::uint32_t value = 3; };
+    template<> struct FieldTypeId<std::complex<float> > { static constexpr std::uint32_t value = 4; };
+    template<> struct FieldTypeId<std::complex<double> > { static constexpr std::uint32_t value = 5; };
+    template<> struct FieldTypeId<std::complex<long double> > { static constexpr std::uint32_t value = 6; };
+    template<> struct FieldTypeId<std::int32_t> { static constexpr std::uint32_t value = 7; };
+    template<> struct FieldTypeId<std::int64_t> { static constexpr std::uint32_t value = 8; };
+
+    //! @brief The size of the blocks that can be stored, numbers are 1x1 blocks.
+    template<class B, class = void>
+    struct BlockSize
+    {
+      static constexpr std::uint64_t rows = 1;
+      static constexpr std::uint64_t cols = 1;
+      using field_type = B;
+      static_assert(IsNumber<B>::value, "Only numbers, FieldVectors and FieldMatrices can be stored in binary files");
+    };
+
+    template<class K, int n, int m>
+    struct BlockSize<FieldMatrix<K,n,m> >
+    {
+      static constexpr std::uint64_t rows = n;
+      static constexpr std::uint64_t cols = m;
+      using field_type = K;
+    };
+
+    template<class K, int n>
+    struct BlockSize<FieldVector<K,n> >
+    {
+      static constexpr std::uint64_t rows = n;
+      static constexpr std::uint64_t cols = 1;
+      using field_type = K;
+    };
+
+    //! @brief Whether a block has the same memory layout as its entries in the file.
+    template<class B>
+    constexpr bool isContiguous ()
+    {
+      using K = typename BlockSize<B>::field_type;
+      return sizeof(B) == BlockSize<B>::rows*BlockSize<B>::cols*sizeof(K)
+        && alignof(B) <= alignment;
+    }
+
+    inline std::uint64_t alignUp (std::uint64_t offset)
+    {
+      return (offset + alignment - 1)/alignment*alignment;
+    }
+
+    //! @brief The offsets of the arrays in a file.
+    struct Layout
+    {
+      std::uint64_t rowPointers, columnIndices, values, size;
+
+      explicit Layout (const Header& header)
+      {
+        const std::uint64_t blockBytes = header.blockRows*header.blockCols*header.fieldSize;
+        rowPointers = alignUp(sizeof(Header));
+        if (header.kind == matrix)
+        {
+          columnIndices = alignUp(rowPointers + (header.rows+1)*sizeof(std::uint64_t));
+          values = alignUp(columnIndices + header.nonzeroes*sizeof(std::uint64_t));
+        }
+        else
+          columnIndices = values = rowPointers;
+        size = values + header.nonzeroes*blockBytes;
+      }
+    };
+
+    template<class B>
+    Header makeHeader (Kind kind, std::uint64_t rows, std::uint64_t cols, std::uint64_t nonzeroes)
+    {
+      using K = typename BlockSize<B>::field_type;
+      Header header;
+      std::memset(&header, 0, sizeof(Header));
+      std::memcpy(header.magic, magic(), sizeof(header.magic));
+      header.byteOrder = byteOrder;
+      header.version = version;
+      header.kind = kind;
+      header.fieldType = FieldTypeId<K>::value;
+      header.fieldSize = sizeof(K);
+      header.blockRows = BlockSize<B>::rows;
+      header.blockCols = BlockSize<B>::cols;
+      header.rows = rows;
+      header.cols = cols;
+      header.nonzeroes = nonzeroes;
+      return header;
+    }
+
+    inline void pad (std::ostream& os, std::uint64_t& offset, std::uint64_t target)
+    {
+      static const char zeros[alignment] = {};
+      os.write(zeros, target - offset);
+      offset = target;
+    }
+
+    template<class T>
+    void writeArray (std::ostream& os, std::uint64_t& offset, const T* data, std::size_t n)
+    {
+      os.write(reinterpret_cast<const char*>(data), n*sizeof(T));
+      offset += n*sizeof(T);
+    }
+
+    //! write the entries of the blocks row by row
+    template<class Iterator>
+    void writeBlocks (std::ostream& os, std::uint64_t& offset, Iterator begin, Iterator end)
+    {
+      using B = std::decay_t<decltype(*begin)>;
+      using K = typename BlockSize<B>::field_type;
+      constexpr std::size_t entries = BlockSize<B>::rows*BlockSize<B>::cols;
+      // buffer the entries to write larger chunks
+      std::vector<K> buffer;
+      buffer.reserve(entries*4096);
+      auto flush = [&] {
+        writeArray(os, offset, buffer.data(), buffer.size());
+        buffer.clear();
+      };
+      for (Iterator it = begin; it != end; ++it)
+      {
+        if constexpr (IsNumber<B>::value)
+          buffer.push_back(*it);
+        else if constexpr (BlockSize<B>::cols == 1)
+          for (std::size_t i=0; i<BlockSize<B>::rows; ++i)
+            buffer.push_back((*it)[i]);
+        else
+          for (std::size_t i=0; i<BlockSize<B>::rows; ++i)
+            for (std::size_t j=0; j<BlockSize<B>::cols; ++j)
+              buffer.push_back((*it)[i][j]);
+        if (buffer.size() + entries > buffer.capacity())
+          flush();
+      }
+      flush();
+    }
+
+    //! copy the entries of a block from the file
+    template<class B>
+    void readBlock (B& block, const typename BlockSize<B>::field_type* data)
+    {
+      if constexpr (IsNumber<B>::value)
+        block = data[0];
+      else if constexpr (BlockSize<B>::cols == 1)
+        for (std::size_t i=0; i<BlockSize<B>::rows; ++i)
+          block[i] = data[i];
+      else
+        for (std::size_t i=0; i<BlockSize<B>::rows; ++i)
+          for (std::size_t j=0; j<BlockSize<B>::cols; ++j)
+            block[i][j] = data[i*BlockSize<B>::cols + j];
+    }
+
+  } // end namespace BinaryIOImpl
+
+  /**
+   * @brief A vector referring to the blocks of a BinaryFile, see BinaryFile::vector().
+   *
+   * The view has the interface of a BlockVector that cannot be resized, i.e.
+   * the element access, the iterators and the vector space operations. Copies
+   * of the view refer to the same memory, which is owned by the BinaryFile
+   * and only valid during its lifetime.
+   */
+  template<class B>
+  class BinaryVectorView : public Imp::BlockVectorWindow<B, std::allocator<B> >
+  {
+    typedef Imp::BlockVectorWindow<B, std::allocator<B> > Base;
+
+  public:
+    //! @brief View the n blocks starting at data.
+    BinaryVectorView (B* data, std::size_t n)
+      : Base(data, n)
+    {}
+
+    using Base::operator=;
+  };
+
+  /**
+   * @brief A binary matrix or vector file, mapped into memory.
+   *
+   * The file is mapped privately, i.e. changes of the mapped values are not
+   * written to the file. If memory mapping is not available, the file is read
+   * into memory instead.
+   *
+   * The arrays of the file can be accessed without copying. A vector can be
+   * used directly as a vector view, while a BCRSMatrix manages its own memory
+   * and has to be filled by readBinary().
+   */
+  class BinaryFile
+  {
+  public:
+    typedef BinaryIOImpl::Header Header;
+
+    //! @brief Map the given file and check its header.
+    explicit BinaryFile (const std::string& filename)
+      : filename_(filename)
+    {
+#if DUNE_ISTL_BINARYIO_MMAP
+      int fd = ::open(filename.c_str(), O_RDONLY);
+      if (fd < 0)
+        DUNE_THROW(IOError, "Could not open file: " << filename);
+      struct stat status;
+      if (::fstat(fd, &status) != 0)
+      {
+        ::close(fd);
+        DUNE_THROW(IOError, "Could not determine the size of file: " << filename);
+      }
+      size_ = status.st_size;
+      if (size_ > 0)
+      {
+        void* data = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED)
+        {
+          ::close(fd);
+          DUNE_THROW(IOError, "Could not map file: " << filename);
+        }
+        data_ = static_cast<char*>(data);
+      }
+      ::close(fd);
+#else
+      std::ifstream file(filename, std::ios::binary | std::ios::ate);
+      if (!file)
+        DUNE_THROW(IOError, "Could not open file: " << filename);
+      size_ = file.tellg();
+      // the buffer is aligned like the arrays in the file
+      buffer_.resize(size_/BinaryIOImpl::alignment + 1);
+      data_ = reinterpret_cast<char*>(buffer_.data());
+      file.seekg(0);
+      file.read(data_, size_);
+#endif
+      checkHeader();
+    }
+
+    BinaryFile (const BinaryFile&) = delete;
+    BinaryFile& operator= (const BinaryFile&) = delete;
+
+    ~BinaryFile ()
+    {
+#if DUNE_ISTL_BINARYIO_MMAP
+      if (data_)
+        ::munmap(data_, size_);
+#endif
+    }
+
+    const Header& header () const
+    {
+      return *reinterpret_cast<const Header*>(data_);
+    }
+
+    bool isMatrix () const
+    {
+      return header().kind == BinaryIOImpl::matrix;
+    }
+
+    //! @brief The number of block rows.
+    std::size_t N () const
+    {
+      return header().rows;
+    }
+
+    //! @brief The number of block columns, 1 for a vector.
+    std::size_t M () const
+    {
+      return header().cols;
+    }
+
+    //! @brief The number of stored blocks.
+    std::size_t nonzeroes () const
+    {
+      return header().nonzeroes;
+    }
+
+    //! @brief The offsets of the rows in columnIndices() and values() of a matrix, N()+1 entries.
+    const std::uint64_t* rowPointers () const
+    {
+      checkKind(BinaryIOImpl::matrix);
+      return reinterpret_cast<const std::uint64_t*>(data_ + layout_->rowPointers);
+    }
+
+    //! @brief The column indices of the blocks of a matrix.
+    const std::uint64_t* columnIndices () const
+    {
+      checkKind(BinaryIOImpl::matrix);
+      return reinterpret_cast<const std::uint64_t*>(data_ + layout_->columnIndices);
+    }
+
+    /**
+     * @brief The entries of the blocks, block by block and each block row by row.
+     *
+     * @tparam B The block type, its field type and size are checked against the header.
+     */
+    template<class B>
+    typename BinaryIOImpl::BlockSize<B>::field_type* values ()
+    {
+      checkBlock<B>();
+      return reinterpret_cast<typename BinaryIOImpl::BlockSize<B>::field_type*>(data_ + layout_->values);
+    }
+
+    /**
+     * @brief The blocks of a vector, without copying.
+     *
+     * The view refers to the memory of this object. Its blocks can be changed,
+     * which does not affect the file.
+     */
+    template<class B>
+    BinaryVectorView<B> vector ()
+    {
+      static_assert(BinaryIOImpl::isContiguous<B>(), "The blocks do not have the memory layout of the file");
+      checkKind(BinaryIOImpl::vector);
+      return BinaryVectorView<B>(reinterpret_cast<B*>(values<B>()), N());
+    }
+
+    //! @brief Throw a BinaryFormatError if the blocks of the file are not of type B.
+    template<class B>
+    void checkBlock () const
+    {
+      using K = typename BinaryIOImpl::BlockSize<B>::field_type;
+      const Header& h = header();
+      if (h.fieldType != BinaryIOImpl::FieldTypeId<K>::value || h.fieldSize != sizeof(K))
+        DUNE_THROW(BinaryFormatError, "The field type of file " << filename_ << " does not match");
+      if (h.blockRows != BinaryIOImpl::BlockSize<B>::rows || h.blockCols != BinaryIOImpl::BlockSize<B>::cols)
+        DUNE_THROW(BinaryFormatError, "The file " << filename_ << " contains blocks of size "
+                   << h.blockRows << "x" << h.blockCols << " instead of "
+                   << BinaryIOImpl::BlockSize<B>::rows << "x" << BinaryIOImpl::BlockSize<B>::cols);
+    }
+
+  private:
+    void checkHeader ()
+    {
+      if (size_ < sizeof(Header) || std::memcmp(header().magic, BinaryIOImpl::magic(), sizeof(header().magic)) != 0)
+        DUNE_THROW(BinaryFormatError, "The file " << filename_ << " is not a dune-istl binary file");
+      if (header().byteOrder != BinaryIOImpl::byteOrder)
+        DUNE_THROW(BinaryFormatError, "The file " << filename_ << " was written with a different byte order");
+      if (header().version != BinaryIOImpl::version)
+        DUNE_THROW(BinaryFormatError, "The file " << filename_ << " has the unsupported version " << header().version);
+      layout_ = std::make_unique<BinaryIOImpl::Layout>(header());
+      if (size_ < layout_->size)
+        DUNE_THROW(BinaryFormatError, "The file " << filename_ << " is truncated");
+    }
+
+    void checkKind (BinaryIOImpl::Kind kind) const
+    {
+      if (header().kind != kind)
+        DUNE_THROW(BinaryFormatError, "The file " << filename_ << " does not contain a "
+                   << (kind == BinaryIOImpl::matrix ? "matrix" : "vector"));
+    }
+
+    std::string filename_;
+    char* data_ = nullptr;
+    std::size_t size_ = 0;
+#if !DUNE_ISTL_BINARYIO_MMAP
+    struct alignas(BinaryIOImpl::alignment) Chunk { char data[BinaryIOImpl::alignment]; };
+    std::vector<Chunk> buffer_;
+#endif
+    std::unique_ptr<BinaryIOImpl::Layout> layout_;
+  };
+
+  /**
+   * @brief Write a matrix in the binary format to a stream.
+   *
+   * The stream has to be opened in binary mode.
+   */
+  template<class B, class A>
+  void writeBinary (const BCRSMatrix<B,A>& matrix, std::ostream& os)
+  {
+    using namespace BinaryIOImpl;
+    const Header header = makeHeader<B>(BinaryIOImpl::matrix, matrix.N(), matrix.M(), matrix.nonzeroes());
+    const Layout layout(header);
+    std::uint64_t offset = 0;
+    writeArray(os, offset, &header, 1);
+
+    pad(os, offset, layout.rowPointers);
+    std::vector<std::uint64_t> indices;
+    indices.reserve(matrix.N()+1);
+    indices.push_back(0);
+    for (auto row = matrix.begin(); row != matrix.end(); ++row)
+      indices.push_back(indices.back() + row->getsize());
+    writeArray(os, offset, indices.data(), indices.size());
+
+    pad(os, offset, layout.columnIndices);
+    indices.clear();
+    indices.reserve(matrix.nonzeroes());
+    for (auto row = matrix.begin(); row != matrix.end(); ++row)
+      for (auto entry = row->begin(); entry != row->end(); ++entry)
+        indices.push_back(entry.index());
+    writeArray(os, offset, indices.data(), indices.size());
+
+    pad(os, offset, layout.values);
+    for (auto row = matrix.begin(); row != matrix.end(); ++row)
+      writeBlocks(os, offset, row->begin(), row->end());
+    if (!os)
+      DUNE_THROW(IOError, "Could not write the matrix");
+  }
+
+  /**
+   * @brief Write a vector in the binary format to a stream.
+   *
+   * The stream has to be opened in binary mode.
+   */
+  template<class B, class A>
+  void writeBinary (const BlockVector<B,A>& vector, std::ostream& os)
+  {
+    using namespace BinaryIOImpl;
+    const Header header = makeHeader<B>(BinaryIOImpl::vector, vector.N(), 1, vector.N());
+    const Layout layout(header);
+    std::uint64_t offset = 0;
+    writeArray(os, offset, &header, 1);
+    pad(os, offset, layout.values);
+    writeBlocks(os, offset, vector.begin(), vector.end());
+    if (!os)
+      DUNE_THROW(IOError, "Could not write the vector");
+  }
+
+  /**
+   * @brief Copy a matrix from a binary file.
+   *
+   * @throws BinaryFormatError if the file does not contain a matrix with blocks of type B
+   *         or its row pointers or column indices are invalid, including column indices
+   *         that are not strictly increasing within a row.
+   */
+  template<class B, class A>
+  void readBinary (BCRSMatrix<B,A>& matrix, BinaryFile& file)
+  {
+    typedef BCRSMatrix<B,A> Matrix;
+    using K = typename BinaryIOImpl::BlockSize<B>::field_type;
+    constexpr std::size_t entries = BinaryIOImpl::BlockSize<B>::rows*BinaryIOImpl::BlockSize<B>::cols;
+    const std::uint64_t* rowPointers = file.rowPointers();
+    const std::uint64_t* columnIndices = file.columnIndices();
+    const K* values = file.values<B>();
+    const std::size_t n = file.N();
+
+    // the arrays index each other, so check them before building the matrix
+    if (rowPointers[0] != 0)
+      DUNE_THROW(BinaryFormatError, "The first row pointer is " << rowPointers[0] << " instead of 0");
+    for (std::size_t i=0; i<n; ++i)
+      if (rowPointers[i+1] < rowPointers[i])
+        DUNE_THROW(BinaryFormatError, "The row pointers decrease in row " << i);
+    if (rowPointers[n] != file.nonzeroes())
+      DUNE_THROW(BinaryFormatError, "The row pointers describe " << rowPointers[n]
+                 << " blocks, but the file stores " << file.nonzeroes());
+    for (std::size_t i=0; i<n; ++i)
+      for (std::uint64_t k=rowPointers[i]; k<rowPointers[i+1]; ++k)
+      {
+        if (columnIndices[k] >= file.M())
+          DUNE_THROW(BinaryFormatError, "The column index " << columnIndices[k]
+                     << " exceeds the " << file.M() << " columns");
+        // the rows of a BCRSMatrix are sorted and free of duplicates
+        if (k > rowPointers[i] && columnIndices[k] <= columnIndices[k-1])
+          DUNE_THROW(BinaryFormatError, "The column indices of row " << i << " are not strictly increasing");
+      }
+
+    matrix.setSize(n, file.M());
+    matrix.setBuildMode(Matrix::random);
+    for (std::size_t i=0; i<n; ++i)
+      matrix.setrowsize(i, rowPointers[i+1] - rowPointers[i]);
+    matrix.endrowsizes();
+    for (std::size_t i=0; i<n; ++i)
+      matrix.setIndicesNoSort(i, columnIndices + rowPointers[i], columnIndices + rowPointers[i+1]);
+    matrix.endindices();
+
+    for (auto row = matrix.begin(); row != matrix.end(); ++row)
+    {
+      const K* data = values + rowPointers[row.index()]*entries;
+      for (auto entry = row->begin(); entry != row->end(); ++entry, data += entries)
+        BinaryIOImpl::readBlock(*entry, data);
+    }
+  }
+
+  /**
+   * @brief Copy a vector from a binary file.
+   *
+   * Use BinaryFile::vector() to access the vector without copying.
+   *
+   * @throws BinaryFormatError if the file does not contain a vector with blocks of type B.
+   */
+  template<class B, class A>
+  void readBinary (BlockVector<B,A>& vector, BinaryFile& file)
+  {
+    using K = typename BinaryIOImpl::BlockSize<B>::field_type;
+    constexpr std::size_t entries = BinaryIOImpl::BlockSize<B>::rows;
+    if (file.isMatrix())
+      DUNE_THROW(BinaryFormatError, "The file does not contain a vector");
+    const K* values = file.values<B>();
+    vector.resize(file.N());
+    for (std::size_t i=0; i<vector.N(); ++i)
+      BinaryIOImpl::readBlock(vector[i], values + i*entries);
+  }
+
+  /**
+   * @brief Store a matrix or vector in the binary format in a file.
+   *
+   * @param object The BCRSMatrix or BlockVector to store.
+   * @param filename The name of the file.
+   */
+  template<typename M>
+  void storeBinary (const M& object, const std::string& filename)
+  {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file)
+      DUNE_THROW(IOError, "Could not open file for storage: " << filename);
+    writeBinary(object, file);
+  }
+
+  /**
+   * @brief Load a matrix or vector stored in the binary format.
+   *
+   * The file is memory mapped and the values are copied into the object.
+   */
+  template<typename M>
+  void loadBinary (M& object, const std::string& filename)
+  {
+    BinaryFile file(filename);
+    readBinary(object, file);
+  }
+
+#if HAVE_MPI
+  /**
+   * @brief Store a parallel matrix/vector in the binary format.
+   *
+   * Like the corresponding storeMatrixMarket(), rank i writes the file
+   * filename_i with the extension of filename (".bin" if it has none) and
+   * the index information to filename_i.idx, in the format of storeMatrixMarket().
+   *
+   * @param object The matrix/vector to store.
+   * @param filename The name of the file (without rank).
+   * @param comm The information about the data distribution.
+   * @param storeIndices Whether to store the parallel index information.
+   */
+  template<typename M, typename G, typename L>
+  void storeBinary (const M& object,
+                    const std::string& filename,
+                    const OwnerOverlapCopyCommunication<G,L>& comm,
+                    bool storeIndices=true)
+  {
+    const std::string rank = std::to_string(comm.communicator().rank());
+    auto [pureFilename, extension] = MatrixMarketImpl::splitFilename(filename);
+    storeBinary(object, pureFilename + "_" + rank + (extension.empty() ? std::string(".bin") : extension));
+    if (storeIndices)
+      MatrixMarketImpl::storeParallelIndices(pureFilename + "_" + rank + ".idx", comm);
+  }
+
+  /**
+   * @brief Load a parallel matrix/vector stored by the parallel storeBinary().
+   *
+   * @param object Where to store the matrix/vector.
+   * @param filename The name of the file (without rank).
+   * @param comm The information about the data distribution.
+   * @param readIndices Whether to read the parallel index information
+   *        and build the remote indices.
+   */
+  template<typename M, typename G, typename L>
+  void loadBinary (M& object,
+                   const std::string& filename,
+                   OwnerOverlapCopyCommunication<G,L>& comm,
+                   bool readIndices=true)
+  {
+    const std::string rank = std::to_string(comm.communicator().rank());
+    auto [pureFilename, extension] = MatrixMarketImpl::splitFilename(filename);
+    loadBinary(object, pureFilename + "_" + rank + (extension.empty() ? std::string(".bin") : extension));
+    if (readIndices)
+      MatrixMarketImpl::loadParallelIndices(pureFilename + "_" + rank + ".idx", comm);
+  }
+#endif
+
+  /** @} */
+}
+
+#endif
@@ -0,0 +1,720 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_ISTL_BLOCKKRYLOV_HH
+#define DUNE_ISTL_BLOCKKRYLOV_HH
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include <dune/common/dynmatrix.hh>
+#include <dune/common/exceptions.hh>
+#include <dune/common/scalarvectorview.hh>
+#include <dune/common/simd/simd.hh>
+
+#include <dune/istl/istlexception.hh>
+#include <dune/istl/scalarproducts.hh>
+#include <dune/istl/solver.hh>
+#include <dune/istl/solvers.hh>
+
+/** \file
+ * \brief Block Krylov methods for several right hand sides
+ */
+
+namespace Dune {
+
+  /** @addtogroup ISTL_Solvers
+      @{
+   */
+
+  namespace Impl {
+
+    //! apply f to the corresponding entries of two vectors with blocks of a SIMD field type
+    template<class X, class Y, class F>
+    void forEachLaneEntry (X& x, Y& y, F&& f)
+    {
+      for (std::size_t i=0; i<x.N(); ++i)
+      {
+        auto&& xi = Impl::asVector(x[i]);
+        auto&& yi = Impl::asVector(y[i]);
+        for (std::size_t c=0; c<xi.size(); ++c)
+          f(xi[c], yi[c]);
+      }
+    }
+
+    /* \brief The lanes of vectors with a SIMD field type as a block of vectors
+
+       Lane a of a vector of type X holds the a-th vector of a block. This class
+       computes the matrices of dot products between the lanes of two vectors
+       and linear combinations of lanes, the basic operations of block Krylov methods.
+
+       The dot products of the lanes are computed directly if the scalar product
+       is a SeqScalarProduct. Otherwise they are computed by ScalarProduct::idot()
+       from lane-rotated copies of the second vector, with a single reduction for
+       all products requested at once.
+     */
+    template<class X>
+    class LaneBlock
+    {
+    public:
+      using field_type = typename X::field_type;
+      using scalar_type = Simd::Scalar<field_type>;
+      using real_type = typename FieldTraits<scalar_type>::real_type;
+      using Matrix = DynamicMatrix<scalar_type>;
+
+      explicit LaneBlock (const ScalarProduct<X>& sp)
+        : sp_(sp)
+        , sequential_(dynamic_cast<const SeqScalarProduct<X>*>(&sp) != nullptr)
+      {}
+
+      //! the number of vectors in a block
+      static constexpr std::size_t lanes ()
+      {
+        return Simd::lanes<field_type>();
+      }
+
+      /* \brief Dot products of lanes, `gram[p][a][b] = dot(lane a of *x[p], lane b of *y[p])`,
+         and the lane-wise squared norms of the vectors in z, with one reduction
+       */
+      void products (const std::vector<const X*>& x, const std::vector<const X*>& y,
+                     const std::vector<const X*>& z, std::vector<Matrix>& gram,
+                     std::vector<field_type>& norms2)
+      {
+        using std::abs;
+        const std::size_t k = lanes();
+        gram.resize(x.size());
+        norms2.resize(z.size());
+        if (sequential_)
+        {
+          for (std::size_t p=0; p<x.size(); ++p)
+          {
+            gram[p].resize(k,k);
+            gram[p] = scalar_type(0);
+            forEachLaneEntry(*x[p], *y[p], [&](const auto& xv, const auto& yv) {
+              for (std::size_t a=0; a<k; ++a)
+              {
+                const scalar_type xa = conjugate(scalar_type(Simd::lane(a,xv)));
+                for (std::size_t b=0; b<k; ++b)
+                  gram[p][a][b] += xa*Simd::lane(b,yv);
+              }
+            });
+          }
+          for (std::size_t l=0; l<z.size(); ++l)
+          {
+            norms2[l] = field_type(0);
+            forEachLaneEntry(*z[l], *z[l], [&](const auto& zv, const auto&) {
+              for (std::size_t a=0; a<k; ++a)
+              {
+                const real_type za = abs(scalar_type(Simd::lane(a,zv)));
+                Simd::lane(a,norms2[l]) += za*za;
+              }
+            });
+          }
+          return;
+        }
+
+        // lane a of rotated copy s of y holds lane (a+s)%k of y
+        if (rotated_.size() < x.size()*(k-1))
+          rotated_.resize(x.size()*(k-1), *y[0]);
+        left_.clear();
+        right_.clear();
+        for (std::size_t p=0; p<x.size(); ++p)
+          for (std::size_t s=0; s<k; ++s)
+          {
+            left_.push_back(x[p]);
+            if (s == 0)
+              right_.push_back(y[p]);
+            else
+            {
+              X& r = rotated_[p*(k-1) + s-1];
+              forEachLaneEntry(r, *y[p], [&](auto& rv, const auto& yv) {
+                for (std::size_t a=0; a<k; ++a)
+                  Simd::lane(a,rv) = Simd::lane((a+s)%k,yv);
+              });
+              right_.push_back(&r);
+            }
+          }
+        auto result = sp_.idot(left_,right_,z).get();
+        for (std::size_t p=0; p<x.size(); ++p)
+        {
+          gram[p].resize(k,k);
+          for (std::size_t s=0; s<k; ++s)
+            for (std::size_t a=0; a<k; ++a)
+              gram[p][a][(a+s)%k] = Simd::lane(a,result[p*k + s]);
+        }
+        for (std::size_t l=0; l<z.size(); ++l)
+          norms2[l] = result[x.size()*k + l];
+      }
+
+      //! Linear combination of lanes, `lane b of y = sum_a (lane a of x) T[a][b]`, or `+=` if add is true
+      static void multiply (X& y, const X& x, const Matrix& T, bool add)
+      {
+        const std::size_t k = lanes();
+        forEachLaneEntry(y, x, [&](auto& yv, const auto& xv) {
+          for (std::size_t b=0; b<k; ++b)
+          {
+            scalar_type sum = add ? scalar_type(Simd::lane(b,yv)) : scalar_type(0);
+            for (std::size_t a=0; a<k; ++a)
+              sum += Simd::lane(a,xv)*T[a][b];
+            Simd::lane(b,yv) = sum;
+          }
+        });
+      }
+
+      //! Set the lanes of x to zero for which mask is true
+      static void zeroLanes (X& x, const std::vector<bool>& mask)
+      {
+        forEachLaneEntry(x, x, [&](auto& xv, const auto&) {
+          for (std::size_t a=0; a<lanes(); ++a)
+            if (mask[a])
+              Simd::lane(a,xv) = scalar_type(0);
+        });
+      }
+
+    private:
+      const ScalarProduct<X>& sp_;
+      bool sequential_;
+      std::vector<X> rotated_;
+      std::vector<const X*> left_, right_;
+    };
+
+    /* \brief Cholesky factorization G = L L^H of a Hermitian positive semi-definite matrix
+       that drops the columns which are numerically linearly dependent on the previous ones
+
+       A column is dropped if its pivot is not larger than `tolerance` times its
+       diagonal entry. Dropped columns of L are zero except for a unit diagonal entry.
+
+       \returns the mask of the columns that are kept
+     */
+    template<class K, class T>
+    std::vector<bool> deflatingCholesky (const DynamicMatrix<K>& G, DynamicMatrix<K>& L, const T& tolerance)
+    {
+      using std::abs;
+      using std::sqrt;
+      const std::size_t n = G.N();
+      L.resize(n,n);
+      L = K(0);
+      std::vector<bool> kept(n,false);
+      for (std::size_t i=0; i<n; ++i)
+      {
+        const T diagonal = realPart(G[i][i]);
+        T d = diagonal;
+        for (std::size_t k=0; k<i; ++k)
+          d -= abs(L[i][k])*abs(L[i][k]);
+        if (!(d > tolerance*diagonal))
+        {
+          L[i][i] = K(1);
+          continue;
+        }
+        kept[i] = true;
+        L[i][i] = sqrt(d);
+        for (std::size_t j=i+1; j<n; ++j)
+        {
+          K t = G[j][i];
+          for (std::size_t k=0; k<i; ++k)
+            t -= L[j][k]*conjugate(L[i][k]);
+          L[j][i] = t/L[i][i];
+        }
+      }
+      return kept;
+    }
+
+    /* \brief The upper triangular matrix T with `W T = Q` for a factor G = L L^H from
+       deflatingCholesky() of the Gram matrix of W
+
+       The kept columns of Q are orthonormal with respect to the inner product
+       of G, the dropped columns of T, and hence of Q, are zero.
+     */
+    template<class K>
+    void deflatedInverseAdjoint (const DynamicMatrix<K>& L, const std::vector<bool>& kept, DynamicMatrix<K>& T)
+    {
+      const std::size_t n = L.N();
+      T.resize(n,n);
+      T = K(0);
+      for (std::size_t c=0; c<n; ++c)
+      {
+        if (!kept[c])
+          continue;
+        for (std::size_t a=0; a<=c; ++a)
+        {
+          K t = (a == c) ? K(1) : K(0);
+          for (std::size_t b=a; b<c; ++b)
+            t -= T[a][b]*conjugate(L[c][b]);
+          T[a][c] = t/L[c][c];
+        }
+      }
+    }
+
+  } // end namespace Impl
+
+  /*!
+     \brief Block conjugate gradient method for several right hand sides
+
+     Solves a symmetric positive definite system for several right hand sides
+     at once, stored in the lanes of a vector with a SIMD field type, e.g.
+     `BlockVector<FieldVector<LoopSIMD<double,k>,n>>`. In contrast to CGSolver,
+     which treats the lanes as independent systems, the search space is shared
+     between all right hand sides (D. P. O'Leary, 'The block conjugate gradient
+     algorithm and related methods', Linear Algebra Appl. 29 (1980)). The
+     operator and the preconditioner are applied to all right hand sides at
+     once, so the matrix entries are read once for all of them, and the
+     number of iterations is usually smaller than for the independent systems.
+
+     The search directions are A-orthonormalized by a Cholesky factorization
+     that drops numerically dependent directions, following the breakdown-free
+     block CG of H. Ji and Y. Li, 'A breakdown-free block conjugate gradient
+     method', BIT Numer. Math. 57 (2017). Columns that have converged are
+     deflated, i.e. their solution is no longer updated and they do not
+     contribute to the search space any more. The convergence test uses the
+     defect norm of each column.
+
+     The lanes of the vectors must be accessible with Simd::lane() in the entries
+     of the blocks, which holds for BlockVector with FieldVector or scalar blocks.
+   */
+  template<class X>
+  class BlockCGSolver : public IterativeSolver<X,X> {
+  public:
+    using typename IterativeSolver<X,X>::domain_type;
+    using typename IterativeSolver<X,X>::range_type;
+    using typename IterativeSolver<X,X>::field_type;
+    using typename IterativeSolver<X,X>::real_type;
+
+    // copy base class constructors
+    using IterativeSolver<X,X>::IterativeSolver;
+
+    // don't shadow four-argument version of apply defined in the base class
+    using IterativeSolver<X,X>::apply;
+
+    /*!
+       \brief Apply inverse operator.
+
+       \copydoc InverseOperator::apply(X&,Y&,InverseOperatorResult&)
+
+       \note The BlockCGSolver aborts when all search directions of an iteration
+             are linearly dependent before convergence.
+     */
+    virtual void apply (X& x, X& b, InverseOperatorResult& res)
+    {
+      using std::sqrt;
+      using Block = Impl::LaneBlock<X>;
+      using Matrix = typename Block::Matrix;
+      using scalar_type = typename Block::scalar_type;
+      const std::size_t k = Block::lanes();
+      // below this relative size, a search direction is considered linearly dependent
+      const scalar_real_type tolerance = sqrt(std::numeric_limits<scalar_real_type>::epsilon());
+
+      Iteration iteration(*this,res);
+      _prec->pre(x,b);             // prepare preconditioner
+
+      _op->applyscaleadd(-1,x,b);  // overwrite b with defect
+      X& r = b;
+
+      real_type def = _sp->norm(r); // compute norm
+      if(iteration.step(0, def)){
+        _prec->post(x);
+        return;
+      }
+      const real_type def0 = def;
+
+      X z(x), w(x), aw(x), p(x), q(x);
+      Block block(*_sp);
+      std::vector<Matrix> gram;
+      std::vector<field_type> norms2;
+      Matrix L, T, alpha(k,k), beta(k,k);
+      std::vector<bool> converged(k,false);
+
+      z = 0;
+      _prec->apply(z,r);
+      w = z;
+
+      for (int i=1; i<=_maxit; i++)
+      {
+        _op->apply(w,aw);
+
+        // G = W^H A W and W^H R with one reduction
+        block.products({&w,&w},{&aw,&r},{},gram,norms2);
+
+        // A-orthonormal search directions P = W T, Q = A P
+        auto kept = Impl::deflatingCholesky(gram[0],L,tolerance);
+        if (std::none_of(kept.begin(), kept.end(), [](bool kk){ return kk; }))
+          DUNE_THROW(SolverAbort,
+                     "breakdown in block CG - no independent search direction after " << i << " iterations");
+        Impl::deflatedInverseAdjoint(L,kept,T);
+        Block::multiply(p,w,T,false);
+        Block::multiply(q,aw,T,false);
+
+        // alpha = P^H R = T^H W^H R, the converged columns are not updated
+        for (std::size_t c=0; c<k; c++)
+          for (std::size_t b=0; b<k; b++)
+          {
+            alpha[c][b] = scalar_type(0);
+            if (!converged[b])
+              for (std::size_t a=0; a<=c; a++)
+                alpha[c][b] += Impl::conjugate(T[a][c])*gram[1][a][b];
+          }
+        Block::multiply(x,p,alpha,true);  // update solution
+        alpha *= scalar_type(-1);
+        Block::multiply(r,q,alpha,true);  // update defect
+
+        z = 0;
+        _prec->apply(z,r);
+
+        // Q^H Z and the defect norms with one reduction
+        block.products({&q},{&z},{&r},gram,norms2);
+        for (std::size_t b=0; b<k; b++)
+          Simd::lane(b,def) = sqrt(Impl::realPart(scalar_type(Simd::lane(b,norms2[0]))));
+        if (iteration.step(i, def))
+          break;
+
+        // deflate the converged columns
+        for (std::size_t b=0; b<k; b++)
+          converged[b] = converged[b]
+            || Simd::lane(b,def) < Simd::lane(b,def0)*_reduction
+            || Simd::lane(b,def) < scalar_real_type(1e-30);
+        Block::zeroLanes(z,converged);
+
+        // W = Z - P beta with beta = Q^H Z
+        for (std::size_t a=0; a<k; a++)
+          for (std::size_t b=0; b<k; b++)
+            beta[a][b] = converged[b] ? scalar_type(0) : scalar_type(-gram[0][a][b]);
+        w = z;
+        Block::multiply(w,p,beta,true);
+      }
+
+      _prec->post(x);                  // postprocess preconditioner
+    }
+
+  protected:
+    using typename IterativeSolver<X,X>::scalar_real_type;
+    using IterativeSolver<X,X>::_op;
+    using IterativeSolver<X,X>::_prec;
+    using IterativeSolver<X,X>::_sp;
+    using IterativeSolver<X,X>::_reduction;
+    using IterativeSolver<X,X>::_maxit;
+    using Iteration = typename IterativeSolver<X,X>::template Iteration<unsigned int>;
+  };
+
+  /*!
+     \brief Restarted block GMRes method for several right hand sides
+
+     Left preconditioned block GMRes (Y. Saad, 'Iterative methods for sparse
+     linear systems', 2nd ed., SIAM 2003, section 6.12) for several right hand
+     sides stored in the lanes of a vector with a SIMD field type, see
+     BlockCGSolver. Each iteration extends the Krylov basis by one vector per
+     right hand side, so the solution of every right hand side is sought in the
+     Krylov space of all of them. The operator and the preconditioner are
+     applied to all right hand sides at once.
+
+     The block Arnoldi method uses block modified Gram-Schmidt and a Cholesky QR
+     factorization of the new block, which drops numerically dependent vectors.
+     The least squares problem is solved by Givens rotations, which yields the
+     defect norm of every column after each iteration. The columns are
+     treated as converged all at once, when each of them has been reduced by
+     the required factor.
+
+     \tparam X vector type of the solution and the right hand side
+   */
+  template<class X>
+  class BlockGMResSolver : public IterativeSolver<X,X>
+  {
+  public:
+    using typename IterativeSolver<X,X>::domain_type;
+    using typename IterativeSolver<X,X>::range_type;
+    using typename IterativeSolver<X,X>::field_type;
+    using typename IterativeSolver<X,X>::real_type;
+
+  protected:
+    using typename IterativeSolver<X,X>::scalar_real_type;
+
+  public:
+    // don't shadow four-argument version of apply defined in the base class
+    using IterativeSolver<X,X>::apply;
+
+    /*!
+       \brief Set up BlockGMResSolver solver.
+
+       \copydoc LoopSolver::LoopSolver(const L&,P&,double,int,int)
+       \param restart number of iterations before restart
+     */
+    BlockGMResSolver (const LinearOperator<X,X>& op, Preconditioner<X,X>& prec, scalar_real_type reduction, int restart, int maxit, int verbose) :
+      IterativeSolver<X,X>::IterativeSolver(op,prec,reduction,maxit,verbose),
+      _restart(restart)
+    {}
+
+    /*!
+       \brief Set up BlockGMResSolver solver.
+
+       \copydoc LoopSolver::LoopSolver(const L&, const S&,P&,double,int,int)
+       \param restart number of iterations before restart
+     */
+    BlockGMResSolver (const LinearOperator<X,X>& op, const ScalarProduct<X>& sp, Preconditioner<X,X>& prec, scalar_real_type reduction, int restart, int maxit, int verbose) :
+      IterativeSolver<X,X>::IterativeSolver(op,sp,prec,reduction,maxit,verbose),
+      _restart(restart)
+    {}
+
+    /*!
+       \brief Constructor.
+
+       \copydoc IterativeSolver::IterativeSolver(const L&, const S&,P&,const ParameterTree&)
+
+       Additional parameter:
+       ParameterTree Key | Meaning
+       ------------------|------------
+       restart           | number of iterations before restart
+
+       See \ref ISTL_Factory for the ParameterTree layout and examples.
+     */
+    BlockGMResSolver (std::shared_ptr<const LinearOperator<X,X> > op, std::shared_ptr<Preconditioner<X,X> > prec, const ParameterTree& configuration) :
+      IterativeSolver<X,X>::IterativeSolver(op,prec,configuration),
+      _restart(configuration.get<int>("restart"))
+    {}
+
+    BlockGMResSolver (std::shared_ptr<const LinearOperator<X,X> > op, std::shared_ptr<const ScalarProduct<X> > sp, std::shared_ptr<Preconditioner<X,X> > prec, const ParameterTree& configuration) :
+      IterativeSolver<X,X>::IterativeSolver(op,sp,prec,configuration),
+      _restart(configuration.get<int>("restart"))
+    {}
+
+    /*!
+       \brief Set up BlockGMResSolver solver.
+
+       \copydoc LoopSolver::LoopSolver(std::shared_ptr<const L>,std::shared_ptr<const S>,std::shared_ptr<P>,double,int,int)
+       \param restart number of iterations before restart
+     */
+    BlockGMResSolver (std::shared_ptr<const LinearOperator<X,X>> op,
+                      std::shared_ptr<const ScalarProduct<X>> sp,
+                      std::shared_ptr<Preconditioner<X,X>> prec,
+                      scalar_real_type reduction, int restart, int maxit, int verbose) :
+      IterativeSolver<X,X>::IterativeSolver(op,sp,prec,reduction,maxit,verbose),
+      _restart(restart)
+    {}
+
+    /*!
+       \brief Apply inverse operator.
+
+       \copydoc InverseOperator::apply(X&,Y&,InverseOperatorResult&)
+     */
+    virtual void apply (X& x, X& b, InverseOperatorResult& res)
+    {
+      using std::abs;
+      using std::sqrt;
+      using Block = Impl::LaneBlock<X>;
+      using Matrix = typename Block::Matrix;
+      using scalar_type = typename Block::scalar_type;
+      const std::size_t k = Block::lanes();
+      // below this relative size, a basis vector is considered linearly dependent
+      const scalar_real_type tolerance = sqrt(std::numeric_limits<scalar_real_type>::epsilon());
+      const std::size_t m = _restart;
+
+      // need copy of rhs if GMRes has to be restarted
+      X b2(b);
+      // helper vector
+      X w(b);
+      std::vector<X> v(m+1,b);
+      Block block(*_sp);
+      std::vector<Matrix> gram;
+      std::vector<field_type> norms2;
+      Matrix L, T, coefficients;
+      // the block Hessenberg matrix with Givens rotations applied, and the rotated right hand sides
+      Matrix H((m+1)*k, m*k), S((m+1)*k, k);
+      // the indices (i*k + lane) of the basis vectors that were not dropped
+      std::vector<std::size_t> basis;
+      // the Givens rotations of the rows (basis[row-1], basis[row]), in the order of application
+      std::vector<std::size_t> rotationRow;
+      std::vector<scalar_real_type> cs;
+      std::vector<scalar_type> sn;
+      int j = 1;
+
+      Iteration iteration(*this,res);
+
+      // clear solver statistics and set res.converged to false
+      _prec->pre(x,b);
+
+      // calculate defect and overwrite rhs with it
+      _op->applyscaleadd(-1.0,x,b); // b -= Ax
+      // calculate preconditioned defect
+      v[0] = 0.0; _prec->apply(v[0],b); // r = W^-1 b
+      real_type def = _sp->norm(v[0]);
+      if(iteration.step(0, def)){
+        _prec->post(x);
+        return;
+      }
+
+      while(j <= _maxit && res.converged != true) {
+
+        // V_0 S_0 = R by a Cholesky QR factorization
+        block.products({&v[0]},{&v[0]},{},gram,norms2);
+        auto kept = Impl::deflatingCholesky(gram[0],L,tolerance);
+        Impl::deflatedInverseAdjoint(L,kept,T);
+        w = v[0];
+        Block::multiply(v[0],w,T,false);
+        H = scalar_type(0);
+        S = scalar_type(0);
+        for(std::size_t a=0; a<k; a++)
+          for(std::size_t c=a; c<k && kept[a]; c++)
+            S[a][c] = Impl::conjugate(L[c][a]);
+        basis.clear();
+        rotationRow.clear();
+        cs.clear();
+        sn.clear();
+        for(std::size_t a=0; a<k; a++)
+          if (kept[a])
+            basis.push_back(a);
+
+        // number of columns of the least squares problem, i.e. of basis vectors with a processed product A v
+        std::size_t columns = 0;
+        std::size_t i = 0;
+        for(; i<m && j<=_maxit && res.converged != true; i++, j++) {
+          // w = M^-1 A v[i], using v[i+1] as temporary vector
+          v[i+1] = 0.0;
+          _op->apply(v[i],v[i+1]);
+          w = 0.0;
+          _prec->apply(w,v[i+1]);
+
+          // block modified Gram-Schmidt
+          for(std::size_t l=0; l<=i; l++) {
+            block.products({&v[l]},{&w},{},gram,norms2);
+            for(std::size_t a=0; a<k; a++)
+              for(std::size_t c=0; c<k; c++)
+                H[l*k+a][i*k+c] = gram[0][a][c];
+            gram[0] *= scalar_type(-1);
+            Block::multiply(w,v[l],gram[0],true);
+          }
+
+          // v[i+1] H_{i+1,i} = w by a Cholesky QR factorization
+          block.products({&w},{&w},{},gram,norms2);
+          kept = Impl::deflatingCholesky(gram[0],L,tolerance);
+          Impl::deflatedInverseAdjoint(L,kept,T);
+          Block::multiply(v[i+1],w,T,false);
+          for(std::size_t a=0; a<k; a++)
+            for(std::size_t c=a; c<k && kept[a]; c++)
+              H[(i+1)*k+a][i*k+c] = Impl::conjugate(L[c][a]);
+
+          // QR factorization of the new columns, the dropped basis vectors
+          // have vanishing rows and columns and are left out
+          const std::size_t rows = basis.size();
+          for(std::size_t a=0; a<k; a++)
+            if (kept[a])
+              basis.push_back((i+1)*k+a);
+          for(; columns<rows; columns++) {
+            const std::size_t c = basis[columns];
+            for(std::size_t r=0; r<rotationRow.size(); r++)
+              applyPlaneRotation(H[basis[rotationRow[r]-1]][c],H[basis[rotationRow[r]]][c],cs[r],sn[r]);
+            for(std::size_t row=basis.size()-1; row>columns; row--) {
+              scalar_real_type rotationCs;
+              scalar_type rotationSn;
+              generatePlaneRotation(H[basis[row-1]][c],H[basis[row]][c],rotationCs,rotationSn);
+              applyPlaneRotation(H[basis[row-1]][c],H[basis[row]][c],rotationCs,rotationSn);
+              for(std::size_t col=0; col<k; col++)
+                applyPlaneRotation(S[basis[row-1]][col],S[basis[row]][col],rotationCs,rotationSn);
+              rotationRow.push_back(row);
+              cs.push_back(rotationCs);
+              sn.push_back(rotationSn);
+            }
+          }
+
+          // the defect norms are the norms of the remaining rows of S
+          for(std::size_t col=0; col<k; col++) {
+            scalar_real_type norm2(0);
+            for(std::size_t row=columns; row<basis.size(); row++)
+              norm2 += abs(S[basis[row]][col])*abs(S[basis[row]][col]);
+            Simd::lane(col,def) = sqrt(norm2);
+          }
+          iteration.step(j, def);
+        }
+
+        // solve the triangular system and update the solution
+        coefficients.resize(i*k,k);
+        coefficients = scalar_type(0);
+        for(std::size_t row=columns; row-- > 0;)
+          for(std::size_t col=0; col<k; col++) {
+            scalar_type rhs = S[basis[row]][col];
+            for(std::size_t c=row+1; c<columns; c++)
+              rhs -= H[basis[row]][basis[c]]*coefficients[basis[c]][col];
+            const scalar_type diagonal = H[basis[row]][basis[row]];
+            coefficients[basis[row]][col] = (diagonal == scalar_type(0)) ? scalar_type(0) : scalar_type(rhs/diagonal);
+          }
+        for(std::size_t l=0; l<i; l++) {
+          for(std::size_t a=0; a<k; a++)
+            for(std::size_t col=0; col<k; col++)
+              T[a][col] = coefficients[l*k+a][col];
+          Block::multiply(x,v[l],T,true);
+        }
+
+        // restart GMRes if convergence was not achieved,
+        // i.e. linear defect has not reached desired reduction
+        // and if j < _maxit (do not restart on last iteration)
+        if( res.converged != true && j < _maxit ) {
+
+          if(_verbose > 0)
+            std::cout << "=== BlockGMRes::restart" << std::endl;
+          // get saved rhs
+          b = b2;
+          // calculate new defect
+          _op->applyscaleadd(-1.0,x,b); // b -= Ax;
+          // calculate preconditioned defect
+          v[0] = 0.0;
+          _prec->apply(v[0],b);
+        }
+
+      } //end while
+
+      // postprocess preconditioner
+      _prec->post(x);
+    }
+
+  private:
+    using scalar_type = Simd::Scalar<field_type>;
+
+    // rotation [cs sn; -conj(sn) cs] that maps (dx,dy) to (r,0)
+    static void generatePlaneRotation (const scalar_type& dx, const scalar_type& dy, scalar_real_type& cs, scalar_type& sn)
+    {
+      using std::abs;
+      using std::sqrt;
+      const scalar_real_type norm_dx = abs(dx);
+      const scalar_real_type norm_dy = abs(dy);
+      if (norm_dy == scalar_real_type(0))
+      {
+        cs = 1.0;
+        sn = 0.0;
+      }
+      else if (norm_dx == scalar_real_type(0))
+      {
+        cs = 0.0;
+        sn = Impl::conjugate(dy)/norm_dy;
+      }
+      else
+      {
+        const scalar_real_type norm = sqrt(norm_dx*norm_dx + norm_dy*norm_dy);
+        cs = norm_dx/norm;
+        sn = dx/norm_dx*Impl::conjugate(dy)/norm;
+      }
+    }
+
+    static void applyPlaneRotation (scalar_type& dx, scalar_type& dy, const scalar_real_type& cs, const scalar_type& sn)
+    {
+      const scalar_type temp = cs*dx + sn*dy;
+      dy = -Impl::conjugate(sn)*dx + cs*dy;
+      dx = temp;
+    }
+
+  protected:
+    using IterativeSolver<X,X>::_op;
+    using IterativeSolver<X,X>::_prec;
+    using IterativeSolver<X,X>::_sp;
+    using IterativeSolver<X,X>::_maxit;
+    using IterativeSolver<X,X>::_verbose;
+    using Iteration = typename IterativeSolver<X,X>::template Iteration<unsigned int>;
+    int _restart;
+  };
+
+  /** @} end documentation */
+
+} // end namespace Dune
+
+#endif
@@ -210,6 +210,94 @@ namespace Imp {
       return sum;
     }
 
+    //===== fused operations
+    //
+    // The following methods combine several of the operations above in a
+    // single sweep over the vectors, which saves memory bandwidth in the
+    // Krylov solvers. Each block is processed exactly as by the separate
+    // calls, so the results are identical.
+
+    //! vector space operation \f$ x = b x + a y \f$, same as `x *= b; x.axpy(a,y);`
+    block_vector_unmanaged& axpby (const field_type& a, const block_vector_unmanaged& y, const field_type& b)
+    {
+#ifdef DUNE_ISTL_WITH_CHECKING
+      if (this->n!=y.N()) DUNE_THROW(ISTLError,"vector size mismatch");
+#endif
+      for (size_type i=0; i<this->n; ++i)
+      {
+        (*this)[i] *= b;
+        Impl::asVector((*this)[i]).axpy(a,Impl::asVector(y[i]));
+      }
+      return *this;
+    }
+
+    /**
+     * \brief axpy followed by a dot product, same as `x.axpy(a,y); return z.dot(x);`
+     *
+     * Reads x, y, and z only once.
+     */
+    field_type axpy_dot (const field_type& a, const block_vector_unmanaged& y, const block_vector_unmanaged& z)
+    {
+#ifdef DUNE_ISTL_WITH_CHECKING
+      if (this->n!=y.N() || this->n!=z.N()) DUNE_THROW(ISTLError,"vector size mismatch");
+#endif
+      field_type sum(0);
+      for (size_type i=0; i<this->n; ++i)
+      {
+        Impl::asVector((*this)[i]).axpy(a,Impl::asVector(y[i]));
+        sum += Impl::asVector(z[i]).dot(Impl::asVector((*this)[i]));
+      }
+      return sum;
+    }
+
+    /**
+     * \brief axpy followed by the square of the two norm, same as `x.axpy(a,y); return x.two_norm2();`
+     *
+     * Reads x and y only once.
+     */
+    typename FieldTraits<field_type>::real_type axpy_two_norm2 (const field_type& a, const block_vector_unmanaged& y)
+    {
+#ifdef DUNE_ISTL_WITH_CHECKING
+      if (this->n!=y.N()) DUNE_THROW(ISTLError,"vector size mismatch");
+#endif
+      typename FieldTraits<field_type>::real_type sum=0;
+      for (size_type i=0; i<this->n; ++i)
+      {
+        Impl::asVector((*this)[i]).axpy(a,Impl::asVector(y[i]));
+        sum += Impl::asVector((*this)[i]).two_norm2();
+      }
+      return sum;
+    }
+
+    /**
+     * \brief Dot products with several vectors, `result[k] = x.dot(*y[k])` for `k < count`
+     *
+     * The vectors y are processed in groups of four, such that x is read only
+     * once per group.
+     */
+    template<class V, class R>
+    void multi_dot (const V* const* y, std::size_t count, R* result) const
+    {
+      for (std::size_t k=0; k<count; ++k)
+      {
+#ifdef DUNE_ISTL_WITH_CHECKING
+        if (this->n!=y[k]->N()) DUNE_THROW(ISTLError,"vector size mismatch");
+#endif
+        result[k] = R(0);
+      }
+
+      for (std::size_t k=0; k<count; k+=4)
+      {
+        const std::size_t m = std::min<std::size_t>(count-k, 4);
+        for (size_type i=0; i<this->n; ++i)
+        {
+          const auto& xi = Impl::asVector((*this)[i]);
+          for (std::size_t l=0; l<m; ++l)
+            result[k+l] += xi.dot(Impl::asVector((*y[k+l])[i]));
+        }
+      }
+    }
+
     //===== norms
 
     //! one norm (sum over absolute values of entries)
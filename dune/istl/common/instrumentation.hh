@@ -0,0 +1,312 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_ISTL_COMMON_INSTRUMENTATION_HH
+#define DUNE_ISTL_COMMON_INSTRUMENTATION_HH
+
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/** \file
+ * \brief Hierarchical timers with call, FLOP and memory traffic counters.
+ */
+
+namespace Dune {
+
+  /** @addtogroup ISTL_Kernel
+          @{
+   */
+
+  /**
+   * \brief A tree of timers recording the time, the number of calls, the
+   *        estimated floating point operations and the bytes moved per component.
+   *
+   * The components are marked by Instrumentation::Scope objects. Scopes only
+   * record something while an instrumentation is activated in the current
+   * thread by an Instrumentation::Activation object, otherwise they do nothing
+   * but check a thread local pointer. Scopes opened while another scope is
+   * open become its children, so the tree mirrors the call hierarchy, e.g.
+   * the levels of a multigrid cycle within the preconditioner application.
+   * The time of a node includes the time of its children.
+   *
+   * Scopes opened by the worker threads of the ThreadPool do not record
+   * anything, the time spent in threaded kernels is attributed to the scope
+   * of the calling thread.
+   */
+  class Instrumentation
+  {
+  public:
+    //! \brief The statistics of one component.
+    struct Node
+    {
+      std::string name;
+      //! the number of times the scope was entered
+      std::size_t calls = 0;
+      //! the accumulated wall time in seconds
+      double time = 0.0;
+      //! the estimated number of floating point operations
+      double flops = 0.0;
+      //! the estimated number of bytes read from and written to memory or sent to other processes
+      double bytes = 0.0;
+      std::vector<Node> children;
+
+      //! \brief The child with the given name, created if it does not exist yet.
+      Node& child (const std::string& childName)
+      {
+        for (Node& c : children)
+          if (c.name == childName)
+            return c;
+        children.emplace_back();
+        children.back().name = childName;
+        return children.back();
+      }
+
+      //! \brief The child with the given name, or nullptr if it does not exist.
+      const Node* find (const std::string& childName) const
+      {
+        for (const Node& c : children)
+          if (c.name == childName)
+            return &c;
+        return nullptr;
+      }
+    };
+
+    /**
+     * \brief Make an instrumentation the active one of the current thread.
+     *
+     * The time during which an activation exists is accumulated in the root
+     * node. Activations may be nested, the previously active instrumentation is
+     * restored on destruction.
+     */
+    class Activation
+    {
+    public:
+      explicit Activation (Instrumentation& instrumentation)
+        : instrumentation_(instrumentation), previous_(current())
+        , start_(std::chrono::steady_clock::now())
+      {
+        current() = &instrumentation_;
+        ++instrumentation_.root_.calls;
+      }
+
+      Activation (const Activation&) = delete;
+      Activation& operator= (const Activation&) = delete;
+
+      ~Activation ()
+      {
+        instrumentation_.root_.time += seconds(start_);
+        current() = previous_;
+      }
+
+    private:
+      Instrumentation& instrumentation_;
+      Instrumentation* previous_;
+      std::chrono::steady_clock::time_point start_;
+    };
+
+    /**
+     * \brief Record the time of the enclosing block in a child of the innermost open scope.
+     *
+     * Does nothing if no instrumentation is active in the current thread.
+     */
+    class Scope
+    {
+    public:
+      /**
+       * \param name The name of the component.
+       * \param flops The estimated number of floating point operations of the block.
+       * \param bytes The estimated number of bytes moved by the block.
+       */
+      explicit Scope (const char* name, double flops = 0.0, double bytes = 0.0)
+        : instrumentation_(current())
+      {
+        if (instrumentation_)
+          open(name, flops, bytes);
+      }
+
+      /**
+       * \brief A scope whose name is followed by an index, e.g. the level of a hierarchy.
+       *
+       * The name is only assembled if an instrumentation is active.
+       */
+      Scope (const char* name, std::size_t index, double flops = 0.0, double bytes = 0.0)
+        : instrumentation_(current())
+      {
+        if (instrumentation_)
+          open(std::string(name) + " " + std::to_string(index), flops, bytes);
+      }
+
+      Scope (const Scope&) = delete;
+      Scope& operator= (const Scope&) = delete;
+
+      ~Scope ()
+      {
+        if (instrumentation_)
+        {
+          node_->time += seconds(start_);
+          instrumentation_->stack_.pop_back();
+        }
+      }
+
+      //! \brief Whether the scope records anything.
+      explicit operator bool () const
+      {
+        return instrumentation_ != nullptr;
+      }
+
+      //! \brief Add floating point operations that are only known within the block.
+      void addFlops (double flops)
+      {
+        if (instrumentation_)
+          node_->flops += flops;
+      }
+
+      //! \brief Add moved bytes that are only known within the block.
+      void addBytes (double bytes)
+      {
+        if (instrumentation_)
+          node_->bytes += bytes;
+      }
+
+    private:
+      void open (const std::string& name, double flops, double bytes)
+      {
+        node_ = &instrumentation_->stack_.back()->child(name);
+        instrumentation_->stack_.push_back(node_);
+        ++node_->calls;
+        node_->flops += flops;
+        node_->bytes += bytes;
+        start_ = std::chrono::steady_clock::now();
+      }
+
+      Instrumentation* instrumentation_;
+      Node* node_ = nullptr;
+      std::chrono::steady_clock::time_point start_;
+    };
+
+    //! \brief Create an empty instrumentation whose root node has the given name.
+    explicit Instrumentation (std::string name = "solve")
+    {
+      root_.name = std::move(name);
+      stack_.push_back(&root_);
+    }
+
+    // the stack of open scopes points into the tree
+    Instrumentation (const Instrumentation&) = delete;
+    Instrumentation& operator= (const Instrumentation&) = delete;
+
+    //! \brief The instrumentation active in the current thread, or nullptr.
+    static Instrumentation* active ()
+    {
+      return current();
+    }
+
+    //! \brief Discard all recorded statistics. Must not be called while a scope is open.
+    void reset ()
+    {
+      std::string name = std::move(root_.name);
+      root_ = Node();
+      root_.name = std::move(name);
+      stack_.assign(1, &root_);
+    }
+
+    //! \brief The root of the tree.
+    const Node& root () const
+    {
+      return root_;
+    }
+
+    /**
+     * \brief Write the tree as a JSON object.
+     *
+     * Each node is written as
+     * `{"name": ..., "calls": ..., "time": ..., "flops": ..., "bytes": ..., "children": [...]}`
+     * with the time in seconds. Non-finite numbers are written as null.
+     */
+    void writeJSON (std::ostream& os) const
+    {
+      writeJSON(os, root_);
+    }
+
+    //! \brief The tree as a JSON object, see writeJSON().
+    std::string json () const
+    {
+      std::ostringstream os;
+      writeJSON(os);
+      return os.str();
+    }
+
+    //! \brief Write a string as a JSON string literal.
+    static void writeJSONString (std::ostream& os, const std::string& s)
+    {
+      os << '"';
+      for (char c : s)
+      {
+        if (c == '"' || c == '\\')
+          os << '\\' << c;
+        else if (static_cast<unsigned char>(c) < 0x20)
+          os << ' ';
+        else
+          os << c;
+      }
+      os << '"';
+    }
+
+    //! \brief Write a number as JSON, which has no literals for nan and inf, so these are written as null.
+    static void writeJSONNumber (std::ostream& os, double value)
+    {
+      if (std::isfinite(value))
+        os << value;
+      else
+        os << "null";
+    }
+
+  private:
+    static Instrumentation*& current ()
+    {
+      thread_local Instrumentation* instrumentation = nullptr;
+      return instrumentation;
+    }
+
+    static double seconds (std::chrono::steady_clock::time_point start)
+    {
+      return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    static void writeJSON (std::ostream& os, const Node& node)
+    {
+      os << "{\"name\": ";
+      writeJSONString(os, node.name);
+      os << ", \"calls\": " << node.calls << ", \"time\": ";
+      writeJSONNumber(os, node.time);
+      os << ", \"flops\": ";
+      writeJSONNumber(os, node.flops);
+      os << ", \"bytes\": ";
+      writeJSONNumber(os, node.bytes);
+      os << ", \"children\": [";
+      for (std::size_t i=0; i<node.children.size(); ++i)
+      {
+        if (i > 0)
+          os << ", ";
+        writeJSON(os, node.children[i]);
+      }
+      os << "]}";
+    }
+
+    Node root_;
+    //! the open scopes, the innermost one last
+    std::vector<Node*> stack_;
+  };
+
+  /** @} end documentation */
+
+} // end namespace Dune
+
+#endif // DUNE_ISTL_COMMON_INSTRUMENTATION_HH
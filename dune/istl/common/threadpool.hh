@@ -0,0 +1,247 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_ISTL_COMMON_THREADPOOL_HH
+#define DUNE_ISTL_COMMON_THREADPOOL_HH
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdlib>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/** \file
+ * \brief A small fork-join thread pool used by the threaded kernels of dune-istl.
+ */
+
+namespace Dune {
+
+  /** @addtogroup ISTL_Kernel
+          @{
+   */
+
+  /**
+   * \brief A fork-join thread pool for the optional threaded kernels.
+   *
+   * The pool executes a fixed number of tasks `0,...,nTasks-1` and returns
+   * once all of them are finished. The calling thread takes part in the work.
+   * Threading is opt-in: the global instance uses a single thread
+   * (i.e. runs everything in the calling thread) unless the environment variable
+   * `DUNE_ISTL_NUM_THREADS` is set or setNumThreads() is called.
+   *
+   * The mapping of tasks to threads is dynamic, so kernels that need
+   * reproducible results have to make the result of each task independent of
+   * the thread executing it, e.g. by combining per-task partial results in
+   * task order.
+   *
+   * If run() is called from within a task, or while another thread is
+   * currently using the pool, the tasks are executed sequentially by the
+   * calling thread. Hence it is safe to use threaded kernels from several
+   * user threads at once.
+   */
+  class ThreadPool
+  {
+  public:
+    //! \brief Create a pool using the given number of threads (including the calling thread).
+    explicit ThreadPool (std::size_t numThreads = 1)
+    {
+      setNumThreads(numThreads);
+    }
+
+    ThreadPool (const ThreadPool&) = delete;
+    ThreadPool& operator= (const ThreadPool&) = delete;
+
+    ~ThreadPool ()
+    {
+      stop();
+    }
+
+    //! \brief The global pool used by the threaded kernels.
+    static ThreadPool& instance ()
+    {
+      static ThreadPool pool(defaultNumThreads());
+      return pool;
+    }
+
+    //! \brief The number of threads read from `DUNE_ISTL_NUM_THREADS` (defaults to 1).
+    static std::size_t defaultNumThreads ()
+    {
+      const char* value = std::getenv("DUNE_ISTL_NUM_THREADS");
+      if (!value)
+        return 1;
+      long n = std::strtol(value, nullptr, 10);
+      return (n > 0) ? std::size_t(n) : 1;
+    }
+
+    //! \brief The number of threads taking part in run(), including the calling thread.
+    std::size_t numThreads () const
+    {
+      return workers_.size() + 1;
+    }
+
+    /**
+     * \brief Change the number of threads.
+     *
+     * Must not be called while the pool is executing tasks.
+     */
+    void setNumThreads (std::size_t numThreads)
+    {
+      stop();
+      stop_ = false;
+      for (std::size_t i = 1; i < numThreads; ++i)
+        workers_.emplace_back([this]{ workerLoop(); });
+    }
+
+    /**
+     * \brief Execute `f(task)` for all `task` in `[0,nTasks)` and wait for completion.
+     *
+     * The first exception thrown by any task is rethrown in the calling thread.
+     */
+    template<class F>
+    void run (std::size_t nTasks, F&& f)
+    {
+      if (nTasks == 0)
+        return;
+      if (nTasks == 1 || workers_.empty() || insideTask() || busy_.exchange(true))
+      {
+        for (std::size_t i = 0; i < nTasks; ++i)
+          f(i);
+        return;
+      }
+
+      std::function<void(std::size_t)> task = std::ref(f);
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        task_ = &task;
+        nTasks_ = nTasks;
+        next_ = 0;
+        pending_ = nTasks;
+        error_ = nullptr;
+        ++generation_;
+      }
+      wakeup_.notify_all();
+
+      work();
+
+      std::exception_ptr error;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this]{ return pending_ == 0 && active_ == 0; });
+        task_ = nullptr;
+        error = error_;
+      }
+      busy_ = false;
+      if (error)
+        std::rethrow_exception(error);
+    }
+
+    /**
+     * \brief Split `[begin,end)` into contiguous chunks and call `f(chunkBegin, chunkEnd)` for each.
+     *
+     * The number of chunks only depends on the range and the number of threads,
+     * and each chunk is processed by exactly one thread.
+     *
+     * \param minChunkSize Minimum number of indices per chunk; smaller ranges are processed serially.
+     */
+    template<class F>
+    void parallelFor (std::size_t begin, std::size_t end, F&& f, std::size_t minChunkSize = 1)
+    {
+      if (end <= begin)
+        return;
+      const std::size_t size = end - begin;
+      std::size_t nChunks = std::min(numThreads(), std::max<std::size_t>(size / std::max<std::size_t>(minChunkSize, 1), 1));
+      run(nChunks, [&](std::size_t chunk){
+        f(begin + (size * chunk) / nChunks, begin + (size * (chunk+1)) / nChunks);
+      });
+    }
+
+  private:
+    static bool& insideTask ()
+    {
+      thread_local bool inside = false;
+      return inside;
+    }
+
+    void work ()
+    {
+      const bool wasInside = insideTask();
+      insideTask() = true;
+      for (std::size_t i = next_.fetch_add(1); i < nTasks_; i = next_.fetch_add(1))
+      {
+        try {
+          (*task_)(i);
+        }
+        catch (...) {
+          std::lock_guard<std::mutex> lock(mutex_);
+          if (!error_)
+            error_ = std::current_exception();
+        }
+        if (pending_.fetch_sub(1) == 1)
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          done_.notify_all();
+        }
+      }
+      insideTask() = wasInside;
+    }
+
+    void workerLoop ()
+    {
+      std::size_t generation = 0;
+      while (true)
+      {
+        {
+          std::unique_lock<std::mutex> lock(mutex_);
+          wakeup_.wait(lock, [&]{ return stop_ || (generation != generation_ && task_); });
+          if (stop_)
+            return;
+          generation = generation_;
+          ++active_;
+        }
+        work();
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          --active_;
+        }
+        done_.notify_all();
+      }
+    }
+
+    void stop ()
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+      }
+      wakeup_.notify_all();
+      for (auto& worker : workers_)
+        worker.join();
+      workers_.clear();
+    }
+
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable wakeup_;
+    std::condition_variable done_;
+    std::atomic<bool> busy_{false};
+    bool stop_ = false;
+    std::size_t generation_ = 0;
+    std::size_t active_ = 0;
+    const std::function<void(std::size_t)>* task_ = nullptr;
+    std::size_t nTasks_ = 0;
+    std::atomic<std::size_t> next_{0};
+    std::atomic<std::size_t> pending_{0};
+    std::exception_ptr error_;
+  };
+
+  /** @} */
+
+} // end namespace Dune
+
+#endif // DUNE_ISTL_COMMON_THREADPOOL_HH
@@ -0,0 +1,229 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_ISTL_FSAI_HH
+#define DUNE_ISTL_FSAI_HH
+
+#include <algorithm>
+#include <cstddef>
+#include <variant>
+#include <vector>
+
+#include <dune/common/dynmatrix.hh>
+#include <dune/common/fmatrix.hh>
+#include <dune/common/scalarmatrixview.hh>
+
+#include <dune/istl/common/threadpool.hh>
+
+#include "istlexception.hh"
+#include "matrixindexset.hh"
+
+/** \file
+ * \brief  The factorized sparse approximate inverse kernels
+ */
+
+namespace Dune {
+
+  /** @addtogroup ISTL_Kernel
+          @{
+   */
+
+  namespace FSAI {
+
+    /** \brief The lower triangular part of the sparsity pattern of A^level
+
+        The diagonal is always part of the pattern, hence level 0 yields
+        the diagonal only. The rows are computed by the threads of the ThreadPool.
+        Previous entries of pattern are discarded.
+     */
+    template<class M>
+    void lowerPattern (const M& A, int level, MatrixIndexSet& pattern)
+    {
+      typedef typename MatrixIndexSet::size_type size_type;
+      const size_type n = A.N();
+      // rows per thread below which the work is not split
+      const std::size_t minChunkSize = 256;
+
+      // pattern of A^k for k < level, the power is applied row by row
+      MatrixIndexSet power(n, n);
+      for (size_type i=0; i<n; ++i)
+        power.add(i, i);
+      for (int k=1; k<level; ++k)
+      {
+        MatrixIndexSet next(n, n);
+        ThreadPool::instance().parallelFor(0, n, [&](std::size_t first, std::size_t last)
+        {
+          for (std::size_t i=first; i<last; ++i)
+            std::visit([&](const auto& columns) {
+                for (auto j : columns)
+                  for (auto jk = A[j].begin(); jk != A[j].end(); ++jk)
+                    next.add(i, jk.index());
+              }, power.columnIndices(i));
+        }, minChunkSize);
+        power = std::move(next);
+      }
+
+      // the last factor only contributes to the lower triangle
+      pattern = MatrixIndexSet(n, n);
+      ThreadPool::instance().parallelFor(0, n, [&](std::size_t first, std::size_t last)
+      {
+        for (std::size_t i=first; i<last; ++i)
+        {
+          pattern.add(i, i);
+          if (level > 0)
+            std::visit([&](const auto& columns) {
+                for (auto j : columns)
+                  for (auto jk = A[j].begin(); jk != A[j].end() && jk.index() < i; ++jk)
+                    pattern.add(i, jk.index());
+              }, power.columnIndices(i));
+        }
+      }, minChunkSize);
+    }
+
+    /** \brief The lower triangular part of a given sparsity pattern, including the diagonal
+
+        Previous entries of pattern are discarded.
+     */
+    inline void lowerPattern (const MatrixIndexSet& indices, MatrixIndexSet& pattern)
+    {
+      typedef typename MatrixIndexSet::size_type size_type;
+      const size_type n = indices.rows();
+      pattern = MatrixIndexSet(n, n);
+      for (size_type i=0; i<n; ++i)
+      {
+        pattern.add(i, i);
+        std::visit([&](const auto& columns) {
+            for (auto j : columns)
+              if (j < i)
+                pattern.add(i, j);
+          }, indices.columnIndices(i));
+      }
+    }
+
+    /** \brief Compute the factorized sparse approximate inverse of a symmetric positive definite matrix
+
+        For each row i with the lower triangular pattern P_i the small dense system
+        \f$ A_{P_i,P_i} x = e_i \f$ is solved. The rows \f$ x^T \f$ form the lower
+        triangular matrix G and the diagonal blocks \f$ x_i \f$ the block diagonal
+        matrix D, such that \f$ A^{-1} \approx G^T D^{-1} G \f$.
+
+        Both factors are stored as matrices with the structure of a BCRSMatrix:
+        G and \f$ H = G^T D^{-1} \f$, so the approximate inverse is applied by
+        two matrix-vector products. The rows of both are computed by the threads
+        of the ThreadPool.
+
+        \param A The matrix to approximate the inverse of.
+        \param pattern The lower triangular sparsity pattern of G, including the diagonal.
+        \param G The lower factor, resized to the pattern.
+        \param H The upper factor, resized to the transposed pattern.
+     */
+    template<class M>
+    void decompose (const M& A, const MatrixIndexSet& pattern, M& G, M& H)
+    {
+      typedef typename M::size_type size_type;
+      typedef typename M::block_type block_type;
+      typedef typename FieldTraits<block_type>::field_type K;
+      const size_type n = A.N();
+      // rows per thread below which the work is not split
+      const std::size_t minChunkSize = 16;
+
+      if (n == 0)
+        return;
+      const size_type b = Impl::asMatrix(*(*A.begin()).begin()).N();
+
+      // the lower factor and its transposed pattern
+      pattern.exportIdx(G);
+      MatrixIndexSet transposed(n, n);
+      for (size_type i=0; i<n; ++i)
+        std::visit([&](const auto& columns) {
+            for (auto j : columns)
+              transposed.add(j, i);
+          }, pattern.columnIndices(i));
+      transposed.exportIdx(H);
+
+      // the inverse diagonal blocks D^{-1}
+      std::vector<block_type> inverseDiagonal(n);
+
+      ThreadPool::instance().parallelFor(0, n, [&](std::size_t first, std::size_t last)
+      {
+        std::vector<size_type> columns;
+        for (std::size_t i=first; i<last; ++i)
+        {
+          columns.clear();
+          for (auto ij = G[i].begin(); ij != G[i].end(); ++ij)
+            columns.push_back(ij.index());
+          const size_type p = columns.size();
+
+          // gather A_{P_i,P_i}
+          DynamicMatrix<K> local(p*b, p*b, K(0));
+          for (size_type r=0; r<p; ++r)
+            for (auto jk = A[columns[r]].begin(); jk != A[columns[r]].end(); ++jk)
+            {
+              auto c = std::lower_bound(columns.begin(), columns.end(), jk.index());
+              if (c == columns.end() || *c != jk.index())
+                continue;
+              const size_type s = c - columns.begin();
+              for (size_type k=0; k<b; ++k)
+                for (size_type l=0; l<b; ++l)
+                  local[r*b+k][s*b+l] = Impl::asMatrix(*jk)[k][l];
+            }
+
+          try {
+            local.invert();
+          }
+          catch (Dune::FMatrixError & e) {
+            DUNE_THROW(MatrixBlockError, "FSAI failed to invert the local matrix of row " << i << " " << e.what();
+                       th__ex.r=i; th__ex.c=i;);
+          }
+
+          // G_ij = x_j^T, where x consists of the last block column of the local inverse
+          auto ij = G[i].begin();
+          for (size_type r=0; r<p; ++r, ++ij)
+            for (size_type k=0; k<b; ++k)
+              for (size_type l=0; l<b; ++l)
+                Impl::asMatrix(*ij)[k][l] = local[r*b+l][(p-1)*b+k];
+
+          block_type& d = inverseDiagonal[i];
+          for (size_type k=0; k<b; ++k)
+            for (size_type l=0; l<b; ++l)
+              Impl::asMatrix(d)[k][l] = local[(p-1)*b+k][(p-1)*b+l];
+          try {
+            Impl::asMatrix(d).invert();
+          }
+          catch (Dune::FMatrixError & e) {
+            DUNE_THROW(MatrixBlockError, "FSAI failed to invert the diagonal block of row " << i << " " << e.what();
+                       th__ex.r=i; th__ex.c=i;);
+          }
+        }
+      }, minChunkSize);
+
+      // H_ji = G_ij^T D_i^{-1}, computed row by row of H
+      ThreadPool::instance().parallelFor(0, n, [&](std::size_t first, std::size_t last)
+      {
+        for (std::size_t j=first; j<last; ++j)
+          for (auto ji = H[j].begin(); ji != H[j].end(); ++ji)
+          {
+            const size_type i = ji.index();
+            const auto& g = Impl::asMatrix(G[i][j]);
+            const auto& d = Impl::asMatrix(inverseDiagonal[i]);
+            auto&& h = Impl::asMatrix(*ji);
+            for (size_type k=0; k<b; ++k)
+              for (size_type l=0; l<b; ++l)
+              {
+                K sum(0);
+                for (size_type m=0; m<b; ++m)
+                  sum += g[m][k] * d[m][l];
+                h[k][l] = sum;
+              }
+          }
+      }, 256);
+    }
+
+  } // end namespace FSAI
+
+  /** @} end documentation */
+
+} // end namespace Dune
+
+#endif
@@ -7,12 +7,16 @@
 
 #include <cmath>
 #include <complex>
+#include <cstddef>
 #include <iostream>
 #include <iomanip>
 #include <string>
+#include <vector>
 
 #include <dune/common/hybridutilities.hh>
 
+#include <dune/istl/common/threadpool.hh>
+
 #include "multitypeblockvector.hh"
 #include "multitypeblockmatrix.hh"
 
@@ -667,6 +671,159 @@ namespace Dune {
   }
 
 
+  //============================================================
+  // multicoloured iterative solver steps
+  // the rows are coloured such that rows of the same colour are
+  // not coupled, the rows of one colour are updated concurrently
+  //============================================================
+
+  /**
+   * \brief A colouring of the rows of a matrix.
+   *
+   * Two rows of the same colour are not coupled by the matrix, i.e.
+   * a_ij = a_ji = 0 for all rows i != j of the same colour.
+   */
+  struct MatrixColoring
+  {
+    typedef std::size_t size_type;
+
+    //! number of colours
+    size_type colors() const { return colors_.empty() ? 0 : colors_.size() - 1; }
+
+    //! rows of colour c are rows_[colors_[c]], ..., rows_[colors_[c+1]-1] in ascending order
+    std::vector<size_type> colors_;
+    std::vector<size_type> rows_;
+  };
+
+  //! compute a greedy colouring of the rows of the square matrix A
+  template<class M>
+  void computeColoring (const M& A, MatrixColoring& coloring)
+  {
+    typedef MatrixColoring::size_type size_type;
+    const size_type n = A.N();
+
+    // symmetrised adjacency of the matrix graph
+    std::vector<size_type> adjStart(n+1, 0), adj;
+    for (auto i=A.begin(); i!=A.end(); ++i)
+      for (auto j=(*i).begin(); j!=(*i).end(); ++j)
+        if (j.index()!=i.index())
+        {
+          ++adjStart[i.index()+1];
+          ++adjStart[j.index()+1];
+        }
+    for (size_type i=0; i<n; ++i)
+      adjStart[i+1] += adjStart[i];
+    adj.resize(adjStart[n]);
+    std::vector<size_type> next(adjStart.begin(), adjStart.end()-1);
+    for (auto i=A.begin(); i!=A.end(); ++i)
+      for (auto j=(*i).begin(); j!=(*i).end(); ++j)
+        if (j.index()!=i.index())
+        {
+          adj[next[i.index()]++] = j.index();
+          adj[next[j.index()]++] = i.index();
+        }
+
+    // assign the smallest colour not used by a neighbour
+    const size_type none = size_type(-1);
+    std::vector<size_type> color(n, none), usedBy;
+    size_type nColors = 0;
+    for (size_type i=0; i<n; ++i)
+    {
+      for (size_type k=adjStart[i]; k<adjStart[i+1]; ++k)
+        if (color[adj[k]]!=none)
+          usedBy[color[adj[k]]] = i;
+      size_type c = 0;
+      while (c<nColors && usedBy[c]==i)
+        ++c;
+      if (c==nColors)
+      {
+        ++nColors;
+        usedBy.push_back(none);
+      }
+      color[i] = c;
+    }
+
+    // sort the rows by colour
+    coloring.colors_.assign(nColors+1, 0);
+    for (size_type i=0; i<n; ++i)
+      ++coloring.colors_[color[i]+1];
+    for (size_type c=0; c<nColors; ++c)
+      coloring.colors_[c+1] += coloring.colors_[c];
+    std::vector<size_type> pos(coloring.colors_.begin(), coloring.colors_.end()-1);
+    coloring.rows_.resize(n);
+    for (size_type i=0; i<n; ++i)
+      coloring.rows_[pos[color[i]]++] = i;
+  }
+
+  namespace Impl {
+
+    //! SOR update of row i, x_i += w a_ii^{-1} (b_i - sum_j a_ij x_j)
+    template<class Row, class X, class Y, class K>
+    void sorRowUpdate (const Row& A_i, std::size_t i, X& x, const Y& b, const K& w)
+    {
+      typedef std::decay_t<decltype(*A_i.begin())> block;
+      typename Y::block_type rhs = b[i];
+      auto diag = A_i.end();
+      for (auto j=A_i.begin(); j!=A_i.end(); ++j)
+      {
+        if (j.index()==i)
+          diag = j;
+        if constexpr (IsNumber<block>())
+          rhs -= (*j) * x[j.index()];
+        else
+          (*j).mmv(x[j.index()],rhs);
+      }
+      if constexpr (IsNumber<block>())
+        x[i] += w*(rhs / (*diag));
+      else
+      {
+        typename X::block_type v = x[i];
+        algmeta_itsteps<0,block>::bsorf(*diag,v,rhs,w);
+        x[i].axpy(w,v);
+      }
+    }
+
+    //! SOR updates of all rows of colour c
+    template<class M, class X, class Y, class K>
+    void sorColorUpdate (const M& A, X& x, const Y& b, const K& w,
+                         const MatrixColoring& coloring, std::size_t c)
+    {
+      // rows per thread below which a colour is not split
+      const std::size_t minChunkSize = 256;
+      ThreadPool::instance().parallelFor(coloring.colors_[c], coloring.colors_[c+1],
+        [&](std::size_t first, std::size_t last)
+        {
+          for (std::size_t k=first; k<last; ++k)
+            sorRowUpdate(A[coloring.rows_[k]], coloring.rows_[k], x, b, w);
+        }, minChunkSize);
+    }
+
+  } // end namespace Impl
+
+  /**
+   * \brief multicoloured SOR step
+   *
+   * Updates the rows colour by colour in ascending order. The rows of each
+   * colour are processed by the threads of the ThreadPool, the result does
+   * not depend on the number of threads. Only the first block level is
+   * inverted.
+   */
+  template<class M, class X, class Y, class K>
+  void bsorf (const M& A, X& x, const Y& b, const K& w, const MatrixColoring& coloring)
+  {
+    for (std::size_t c=0; c<coloring.colors(); ++c)
+      Impl::sorColorUpdate(A,x,b,w,coloring,c);
+  }
+
+  //! multicoloured backward SOR step, updates the colours in descending order
+  template<class M, class X, class Y, class K>
+  void bsorb (const M& A, X& x, const Y& b, const K& w, const MatrixColoring& coloring)
+  {
+    for (std::size_t c=coloring.colors(); c>0; --c)
+      Impl::sorColorUpdate(A,x,b,w,coloring,c-1);
+  }
+
+
   /** @} end documentation */
 
 } // end namespace
@@ -3,6 +3,9 @@
 #ifndef DUNE_ISTL_ILDL_HH
 #define DUNE_ISTL_ILDL_HH
 
+#include <cstddef>
+#include <vector>
+
 #include <dune/common/scalarvectorview.hh>
 #include <dune/common/scalarmatrixview.hh>
 #include "ilu.hh"
@@ -217,6 +220,101 @@ namespace Dune
     }
   }
 
+
+  // bildl_convertToCRS
+  // ------------------
+
+  /**
+   * \brief store an ILDL decomposition in CRS format
+   *
+   * \param[in]   A      ILDL decomposition as computed by bildl_decompose
+   * \param[out]  lower  strictly lower triangular part L
+   * \param[out]  upper  L^T, the rows are stored in reverse order (cf. ILU::convertToCRS)
+   *                     and hold the untransposed blocks of L
+   * \param[out]  inv    inverse diagonal blocks D^{-1}
+   *
+   * \note Only the lower half of A is used.
+   **/
+  template< class Matrix, class CRS, class InvVector >
+  inline void bildl_convertToCRS ( const Matrix &A, CRS &lower, CRS &upper, InvVector &inv )
+  {
+    typedef typename CRS::size_type size_type;
+
+    const size_type nRows = A.N();
+    const size_type lastRow = nRows - 1;
+    lower.resize( nRows );
+    upper.resize( nRows );
+    inv.resize( nRows );
+
+    // store L and D^{-1} and count the entries in each column of L
+    std::vector< size_type > colSize( nRows, 0 );
+    size_type colcount = 0;
+    lower.rows_[ 0 ] = colcount;
+    for( auto i = A.begin(), iend = A.end(); i != iend; ++i )
+    {
+      const auto &A_i = *i;
+      auto ij = A_i.begin();
+      for( ; (ij != A_i.end()) && (ij.index() < i.index()); ++ij )
+      {
+        lower.push_back( *ij, ij.index() );
+        ++colSize[ ij.index() ];
+        ++colcount;
+      }
+      if( (ij == A_i.end()) || (ij.index() != i.index()) )
+        DUNE_THROW( ISTLError, "diagonal entry missing" );
+      inv[ i.index() ] = *ij;
+      lower.rows_[ i.index()+1 ] = colcount;
+    }
+
+    // store the columns of L from right to left, each from bottom to top
+    upper.rows_[ 0 ] = 0;
+    for( size_type k = 0; k < nRows; ++k )
+      upper.rows_[ k+1 ] = upper.rows_[ k ] + colSize[ lastRow - k ];
+    upper.values_.resize( colcount );
+    upper.cols_.resize( colcount );
+
+    std::vector< size_type > next( upper.rows_.begin(), upper.rows_.end() - 1 );
+    for( auto i = A.beforeEnd(), iend = A.beforeBegin(); i != iend; --i )
+    {
+      const auto &A_i = *i;
+      for( auto ij = A_i.begin(); ij.index() < i.index(); ++ij )
+      {
+        const size_type pos = next[ lastRow - ij.index() ]++;
+        upper.values_[ pos ] = *ij;
+        upper.cols_[ pos ] = i.index();
+      }
+    }
+  }
+
+  /**
+   * \brief level scheduled ILDL backsolve in CRS format
+   *
+   * Solves L D L^T v = d with the factors computed by bildl_convertToCRS. The
+   * rows of each level are processed by the threads of the ThreadPool and the
+   * result is identical to bildl_backsolve on the decomposed matrix.
+   **/
+  template< class CRS, class InvVector, class X, class Y >
+  inline void bildl_backsolve ( const CRS &lower, const CRS &upper, const InvVector &inv,
+                                const ILU::LevelSchedule &lowerSchedule, const ILU::LevelSchedule &upperSchedule,
+                                X &v, const Y &d )
+  {
+    // solve L v = d, note: Lii = I
+    ILU::forEachLevel( lowerSchedule, [ & ] ( std::size_t i ) { ILU::lowerRowBacksolve( lower, v, d, i ); } );
+
+    // solve D w = v and L^T v = w row by row, note: the rows of L^T are stored in reverse order
+    const std::size_t lastRow = upper.rows() - 1;
+    ILU::forEachLevel( upperSchedule, [ & ] ( std::size_t k )
+    {
+      const std::size_t i = lastRow - k;
+      auto rhsValue = v[ i ];
+      auto&& rhs = Impl::asVector(rhsValue);
+      auto&& vi = Impl::asVector( v[ i ] );
+      Impl::asMatrix(inv[ i ]).mv(rhs, vi);
+      for( std::size_t col = upper.rows_[ k ]; col < upper.rows_[ k+1 ]; ++col )
+        Impl::asMatrix(upper.values_[ col ]).mmtv(Impl::asVector( v[ upper.cols_[ col ] ] ), vi);
+    } );
+  }
+
 } // namespace Dune
 
 #endif // #ifndef DUNE_ISTL_ILDL_HH
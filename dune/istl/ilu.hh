@@ -5,8 +5,11 @@
 #ifndef DUNE_ISTL_ILU_HH
 #define DUNE_ISTL_ILU_HH
 
+#include <algorithm>
+#include <cassert>
 #include <cmath>
 #include <complex>
+#include <cstddef>
 #include <map>
 #include <vector>
 
@@ -14,6 +17,8 @@
 #include <dune/common/scalarvectorview.hh>
 #include <dune/common/scalarmatrixview.hh>
 
+#include <dune/istl/common/threadpool.hh>
+
 #include "istlexception.hh"
 
 /** \file
@@ -157,14 +162,13 @@ namespace Dune {
       return A[0][0];
     }
 
-    /*! ILU decomposition of order n
-            Computes ILU decomposition of order n. The matrix ILU should
-        be an empty matrix in row_wise creation mode. This allows the user
-        to either specify the number of nonzero elements or to
-            determine it automatically at run-time.
+    /*! Symbolic ILU decomposition of order n
+            Computes the sparsity pattern of the ILU decomposition of order n
+        and copies the entries of A into it. The matrix ILU should
+        be an empty matrix in row_wise creation mode.
      */
     template<class M>
-    void blockILUDecomposition (const M& A, int n, M& ILU)
+    void blockILUSymbolicDecomposition (const M& A, int n, M& ILU)
     {
       // iterator types
       typedef typename M::ColIterator coliterator;
@@ -249,10 +253,233 @@ namespace Dune {
         }
       }
 
+    }
+
+    /*! ILU decomposition of order n
+            Computes ILU decomposition of order n. The matrix ILU should
+        be an empty matrix in row_wise creation mode. This allows the user
+        to either specify the number of nonzero elements or to
+            determine it automatically at run-time.
+     */
+    template<class M>
+    void blockILUDecomposition (const M& A, int n, M& ILU)
+    {
+      blockILUSymbolicDecomposition(A, n, ILU);
+
       // call decomposition on pattern
       blockILU0Decomposition(ILU);
     }
 
+    /*! \brief Iterative (fixed-point) ILU decomposition
+
+        Computes the ILU decomposition on the sparsity pattern of ILU by the fine-grained
+        fixed-point iteration of Chow and Patel. Each sweep updates all entries
+
+          L_ij = (A_ij - sum_{k<j} L_ik U_kj) U_jj^{-1}  for i > j,
+          U_ij =  A_ij - sum_{k<i} L_ik U_kj              for i <= j,
+
+        from the values of the previous sweep, starting with L = lower(A) diag(A)^{-1}
+        and U = upper(A). The entries are processed in parallel by the threads of the
+        ThreadPool and the result does not depend on the number of threads. After as
+        many sweeps as the triangular factors have levels, the result is the exact
+        ILU decomposition on the pattern, but a few sweeps are usually sufficient.
+
+        \param ILU     On entry the entries of A on the sparsity pattern of the decomposition,
+                       on exit the decomposition in the format of blockILU0Decomposition.
+        \param sweeps  The number of fixed-point sweeps.
+     */
+    template<class M>
+    void blockILUIterativeDecomposition (M& ILU, int sweeps)
+    {
+      typedef typename M::block_type block;
+      typedef typename M::size_type size_type;
+
+      // entries per thread below which the work is not split
+      const size_type minChunkSize = 256;
+      const size_type nRows = ILU.N();
+
+      // flat copy of A with row and column of each entry
+      std::vector<size_type> rowStart(nRows+1), rows, cols, diag(nRows);
+      std::vector<block> a;
+      rows.reserve(ILU.nonzeroes());
+      cols.reserve(ILU.nonzeroes());
+      a.reserve(ILU.nonzeroes());
+      for (auto i=ILU.begin(); i!=ILU.end(); ++i)
+      {
+        rowStart[i.index()] = a.size();
+        diag[i.index()] = size_type(-1);
+        for (auto ij=(*i).begin(); ij!=(*i).end(); ++ij)
+        {
+          if (ij.index()==i.index())
+            diag[i.index()] = a.size();
+          rows.push_back(i.index());
+          cols.push_back(ij.index());
+          a.push_back(*ij);
+        }
+        if (diag[i.index()]==size_type(-1))
+          DUNE_THROW(ISTLError,"diagonal entry missing");
+      }
+      rowStart[nRows] = a.size();
+      const size_type nonZeros = a.size();
+
+      // entries of U in each column, sorted by row
+      std::vector<size_type> colStart(nRows+1, 0), colEntries;
+      for (size_type p=0; p<nonZeros; ++p)
+        if (rows[p]<=cols[p])
+          ++colStart[cols[p]+1];
+      for (size_type j=0; j<nRows; ++j)
+        colStart[j+1] += colStart[j];
+      colEntries.resize(colStart[nRows]);
+      std::vector<size_type> next(colStart.begin(), colStart.end()-1);
+      for (size_type p=0; p<nonZeros; ++p)
+        if (rows[p]<=cols[p])
+          colEntries[next[cols[p]]++] = p;
+
+      // inverse diagonal blocks of the current U
+      std::vector<block> invDiag(nRows);
+      auto invertDiagonal = [&](const std::vector<block>& f)
+      {
+        ThreadPool::instance().parallelFor(0, nRows, [&](size_type first, size_type last)
+        {
+          for (size_type i=first; i<last; ++i)
+          {
+            invDiag[i] = f[diag[i]];
+            try {
+              Impl::asMatrix(invDiag[i]).invert();
+            }
+            catch (Dune::FMatrixError & e) {
+              DUNE_THROW(MatrixBlockError, "ILU failed to invert matrix block A["
+                         << i << "][" << i << "]" << e.what();
+                         th__ex.r=i; th__ex.c=i;);
+            }
+          }
+        }, minChunkSize);
+      };
+
+      // initial guess
+      std::vector<block> f(a), fNew(nonZeros);
+      invertDiagonal(f);
+      ThreadPool::instance().parallelFor(0, nonZeros, [&](size_type first, size_type last)
+      {
+        for (size_type p=first; p<last; ++p)
+          if (rows[p]>cols[p])
+            Impl::asMatrix(f[p]).rightmultiply(Impl::asMatrix(invDiag[cols[p]]));
+      }, minChunkSize);
+
+      for (int sweep=0; sweep<sweeps; ++sweep)
+      {
+        ThreadPool::instance().parallelFor(0, nonZeros, [&](size_type first, size_type last)
+        {
+          for (size_type p=first; p<last; ++p)
+          {
+            const size_type i = rows[p];
+            const size_type j = cols[p];
+            const size_type m = std::min(i, j);
+
+            // subtract sum_{k<min(i,j)} L_ik U_kj
+            block s(a[p]);
+            size_type ik = rowStart[i];
+            size_type kj = colStart[j];
+            while (ik<rowStart[i+1] && kj<colStart[j+1] && cols[ik]<m && rows[colEntries[kj]]<m)
+              if (cols[ik]==rows[colEntries[kj]])
+              {
+                block B(f[colEntries[kj]]);
+                Impl::asMatrix(B).leftmultiply(Impl::asMatrix(f[ik]));
+                s -= B;
+                ++ik; ++kj;
+              }
+              else
+              {
+                if (cols[ik]<rows[colEntries[kj]])
+                  ++ik;
+                else
+                  ++kj;
+              }
+
+            if (i>j)
+              Impl::asMatrix(s).rightmultiply(Impl::asMatrix(invDiag[j]));
+            fNew[p] = s;
+          }
+        }, minChunkSize);
+
+        std::swap(f, fNew);
+        invertDiagonal(f);
+      }
+
+      // store L, U and the inverse diagonal of U as blockILU0Decomposition does
+      size_type p = 0;
+      for (auto i=ILU.begin(); i!=ILU.end(); ++i)
+        for (auto ij=(*i).begin(); ij!=(*i).end(); ++ij, ++p)
+          *ij = (ij.index()==i.index()) ? invDiag[i.index()] : f[p];
+    }
+
+    /*! \brief LU backsolve with Jacobi iterations
+
+        Approximates both triangular solves of blockILUBacksolve by the given number
+        of Jacobi sweeps, which are processed in parallel by the threads of the
+        ThreadPool. With as many sweeps as the triangular factors have levels
+        the result is the exact backsolve.
+     */
+    template<class M, class X, class Y>
+    void blockILUJacobiBacksolve (const M& A, X& v, const Y& d, int sweeps)
+    {
+      typedef typename Y::block_type dblock;
+      typedef typename X::block_type vblock;
+      typedef typename M::size_type size_type;
+
+      // rows per thread below which the work is not split
+      const size_type minChunkSize = 256;
+      const size_type nRows = A.N();
+      auto forEachRow = [&](auto&& f)
+      {
+        ThreadPool::instance().parallelFor(0, nRows, [&](size_type first, size_type last)
+        {
+          for (size_type i=first; i<last; ++i)
+            f(i, A[i]);
+        }, minChunkSize);
+      };
+
+      // lower triangular solve, Lii = I, starting from v = d
+      forEachRow([&](size_type i, const auto&)
+      {
+        dblock rhsValue(d[i]);
+        Impl::asVector(v[i]) = Impl::asVector(rhsValue);
+      });
+      X w(v);
+      for (int sweep=0; sweep<sweeps; ++sweep)
+      {
+        w = v;
+        forEachRow([&](size_type i, const auto& A_i)
+        {
+          dblock rhsValue(d[i]);
+          auto&& rhs = Impl::asVector(rhsValue);
+          for (auto j=A_i.begin(); j.index()<i; ++j)
+            Impl::asMatrix(*j).mmv(Impl::asVector(w[j.index()]),rhs);
+          Impl::asVector(v[i]) = rhs;
+        });
+      }
+
+      // upper triangular solve, the diagonal stores the inverse, starting from v = D^{-1} z
+      const X z(v);
+      auto upperRow = [&](size_type i, const auto& A_i, bool offDiagonal)
+      {
+        vblock rhsValue(z[i]);
+        auto&& rhs = Impl::asVector(rhsValue);
+        auto j = A_i.beforeEnd();
+        for (; j.index()>i; --j)
+          if (offDiagonal)
+            Impl::asMatrix(*j).mmv(Impl::asVector(w[j.index()]),rhs);
+        auto&& vi = Impl::asVector(v[i]);
+        Impl::asMatrix(*j).mv(rhs,vi);
+      };
+      forEachRow([&](size_type i, const auto& A_i) { upperRow(i, A_i, false); });
+      for (int sweep=0; sweep<sweeps; ++sweep)
+      {
+        w = v;
+        forEachRow([&](size_type i, const auto& A_i) { upperRow(i, A_i, true); });
+      }
+    }
+
     //! a simple compressed row storage matrix class
     template <class B, class Alloc = std::allocator<B>>
     struct CRS
@@ -368,6 +595,43 @@ namespace Dune {
       }
     } // end convertToCRS
 
+    //! forward substitution for row i of the lower triangular CRS factor (Lii = I)
+    template<class CRS, class X, class Y>
+    void lowerRowBacksolve (const CRS& lower, X& v, const Y& d, const std::size_t i)
+    {
+      typedef typename Y :: block_type  dblock;
+
+      dblock rhsValue( d[ i ] );
+      auto&& rhs = Impl::asVector(rhsValue);
+      const std::size_t rowI     = lower.rows_[ i ];
+      const std::size_t rowINext = lower.rows_[ i+1 ];
+
+      for( std::size_t col = rowI; col < rowINext; ++ col )
+        Impl::asMatrix(lower.values_[ col ]).mmv( Impl::asVector(v[ lower.cols_[ col ] ] ), rhs );
+
+      Impl::asVector(v[ i ]) = rhs;  // Lii = I
+    }
+
+    //! backward substitution for the i-th stored (i.e. reversed) row of the upper triangular CRS factor
+    template<class CRS, class InvVector, class X>
+    void upperRowBacksolve (const CRS& upper, const InvVector& inv, X& v, const std::size_t i)
+    {
+      typedef typename X :: block_type  vblock;
+
+      const std::size_t lastRow = upper.rows() - 1;
+      auto&& vBlock = Impl::asVector(v[ lastRow - i ]);
+      vblock rhsValue ( v[ lastRow - i ] );
+      auto&& rhs = Impl::asVector(rhsValue);
+      const std::size_t rowI     = upper.rows_[ i ];
+      const std::size_t rowINext = upper.rows_[ i+1 ];
+
+      for( std::size_t col = rowI; col < rowINext; ++ col )
+        Impl::asMatrix(upper.values_[ col ]).mmv( Impl::asVector(v[ upper.cols_[ col ] ]), rhs );
+
+      // apply inverse and store result
+      Impl::asMatrix(inv[ i ]).mv(rhs, vBlock);
+    }
+
     //! LU backsolve with stored inverse in CRS format for lower and upper triangular
     template<class CRS, class InvVector, class X, class Y>
     void blockILUBacksolve (const CRS& lower,
@@ -375,13 +639,9 @@ namespace Dune {
                             const InvVector& inv,
                             X& v, const Y& d)
     {
-      // iterator types
-      typedef typename Y :: block_type  dblock;
-      typedef typename X :: block_type  vblock;
       typedef typename X :: size_type   size_type ;
 
       const size_type iEnd = lower.rows();
-      const size_type lastRow = iEnd - 1;
       if( iEnd != upper.rows() )
       {
         DUNE_THROW(ISTLError,"ILU::blockILUBacksolve: lower and upper rows must be the same");
@@ -389,33 +649,116 @@ namespace Dune {
 
       // lower triangular solve
       for( size_type i=0; i<iEnd; ++ i )
-      {
-        dblock rhsValue( d[ i ] );
-        auto&& rhs = Impl::asVector(rhsValue);
-        const size_type rowI     = lower.rows_[ i ];
-        const size_type rowINext = lower.rows_[ i+1 ];
-
-        for( size_type col = rowI; col < rowINext; ++ col )
-          Impl::asMatrix(lower.values_[ col ]).mmv( Impl::asVector(v[ lower.cols_[ col ] ] ), rhs );
-
-        Impl::asVector(v[ i ]) = rhs;  // Lii = I
-      }
+        lowerRowBacksolve( lower, v, d, i );
 
       // upper triangular solve
       for( size_type i=0; i<iEnd; ++ i )
+        upperRowBacksolve( upper, inv, v, i );
+    }
+
+    /** \brief The rows of a triangular CRS factor grouped into levels.
+
+        The rows of one level only depend on rows of previous levels, hence
+        the substitution can process all rows of a level concurrently.
+        Row indices refer to the storage order of the CRS factor.
+     */
+    struct LevelSchedule
+    {
+      typedef std::size_t size_type;
+
+      //! number of levels
+      size_type levels() const { return levels_.empty() ? 0 : levels_.size() - 1; }
+
+      //! rows of level l are rows_[levels_[l]], ..., rows_[levels_[l+1]-1]
+      std::vector< size_type > levels_;
+      std::vector< size_type > rows_;
+    };
+
+    /** \brief compute the level schedule of a triangular CRS factor
+
+        \param crs       The triangular factor, each stored row may only depend on previous stored rows.
+        \param schedule  The resulting schedule.
+        \param reversed  True if the rows of crs are stored in reverse order (as the upper factor of convertToCRS).
+     */
+    template<class CRS>
+    void buildLevelSchedule (const CRS& crs, LevelSchedule& schedule, const bool reversed)
+    {
+      typedef LevelSchedule::size_type size_type;
+
+      const size_type nRows = crs.rows();
+      const size_type lastRow = nRows - 1;
+
+      // the level of a row is one more than the maximal level of the rows it depends on
+      std::vector< size_type > level( nRows, 0 );
+      size_type nLevels = 0;
+      for( size_type i=0; i<nRows; ++i )
       {
-        auto&& vBlock = Impl::asVector(v[ lastRow - i ]);
-        vblock rhsValue ( v[ lastRow - i ] );
-        auto&& rhs = Impl::asVector(rhsValue);
-        const size_type rowI     = upper.rows_[ i ];
-        const size_type rowINext = upper.rows_[ i+1 ];
+        size_type l = 0;
+        for( size_type col = crs.rows_[ i ]; col < crs.rows_[ i+1 ]; ++col )
+        {
+          const size_type j = reversed ? lastRow - crs.cols_[ col ] : crs.cols_[ col ];
+          assert( j < i );
+          l = std::max( l, level[ j ] + 1 );
+        }
+        level[ i ] = l;
+        nLevels = std::max( nLevels, l + 1 );
+      }
+
+      // sort the rows by level, keeping the storage order within each level
+      schedule.levels_.assign( nLevels + 1, 0 );
+      for( size_type i=0; i<nRows; ++i )
+        ++schedule.levels_[ level[ i ] + 1 ];
+      for( size_type l=0; l<nLevels; ++l )
+        schedule.levels_[ l+1 ] += schedule.levels_[ l ];
+
+      std::vector< size_type > next( schedule.levels_.begin(), schedule.levels_.end() - 1 );
+      schedule.rows_.resize( nRows );
+      for( size_type i=0; i<nRows; ++i )
+        schedule.rows_[ next[ level[ i ] ]++ ] = i;
+    }
+
+    /** \brief process the rows of each level of a schedule concurrently
+
+        Calls f(i) for every row i of the schedule, the levels one after another.
+        Levels with few rows are processed serially.
+     */
+    template<class F>
+    void forEachLevel (const LevelSchedule& schedule, F&& f)
+    {
+      // rows per thread below which a level is not split
+      const std::size_t minChunkSize = 64;
+      for( std::size_t l=0; l<schedule.levels(); ++l )
+        ThreadPool::instance().parallelFor( schedule.levels_[ l ], schedule.levels_[ l+1 ],
+          [&]( std::size_t first, std::size_t last )
+          {
+            for( std::size_t k=first; k<last; ++k )
+              f( schedule.rows_[ k ] );
+          }, minChunkSize );
+    }
 
-        for( size_type col = rowI; col < rowINext; ++ col )
-          Impl::asMatrix(upper.values_[ col ]).mmv( Impl::asVector(v[ upper.cols_[ col ] ]), rhs );
+    /** \brief LU backsolve in CRS format with level scheduled triangular solves
 
-        // apply inverse and store result
-        Impl::asMatrix(inv[ i ]).mv(rhs, vBlock);
+        The result is identical to the sequential blockILUBacksolve, the rows
+        of each level are processed by the threads of the ThreadPool.
+     */
+    template<class CRS, class InvVector, class X, class Y>
+    void blockILUBacksolve (const CRS& lower,
+                            const CRS& upper,
+                            const InvVector& inv,
+                            const LevelSchedule& lowerSchedule,
+                            const LevelSchedule& upperSchedule,
+                            X& v, const Y& d)
+    {
+      if( lower.rows() != upper.rows() )
+      {
+        DUNE_THROW(ISTLError,"ILU::blockILUBacksolve: lower and upper rows must be the same");
       }
+
+      // lower triangular solve
+      forEachLevel( lowerSchedule, [&]( std::size_t i ) { lowerRowBacksolve( lower, v, d, i ); } );
+
+      // upper triangular solve
+      forEachLevel( upperSchedule, [&]( std::size_t i ) { upperRowBacksolve( upper, inv, v, i ); } );
     }
 
   } // end namespace ILU
@@ -0,0 +1,385 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_ISTL_INSTRUMENTED_HH
+#define DUNE_ISTL_INSTRUMENTED_HH
+
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/typetraits.hh>
+
+#include <dune/istl/common/instrumentation.hh>
+
+#include "matrixutils.hh"
+#include "operators.hh"
+#include "preconditioner.hh"
+#include "scalarproducts.hh"
+#include "solver.hh"
+
+/** \file
+ * \brief Decorators recording the components of a solve in an Instrumentation.
+ */
+
+namespace Dune {
+
+  /** @addtogroup ISTL_Solvers
+          @{
+   */
+
+  namespace Impl {
+
+    /* \brief The number of scalar entries of vectors with the same number of blocks as the last one
+
+       dim() visits all blocks of a BlockVector, hence the result is cached.
+     */
+    template<class X>
+    class InstrumentedDimension
+    {
+    public:
+      double operator() (const X& x) const
+      {
+        if (x.N() != blocks_)
+        {
+          blocks_ = x.N();
+          dim_ = x.dim();
+        }
+        return dim_;
+      }
+
+    private:
+      mutable std::size_t blocks_ = std::size_t(-1);
+      mutable double dim_ = 0.0;
+    };
+
+  } // end namespace Impl
+
+  /**
+   * \brief A linear operator recording its applications as "operator apply".
+   *
+   * The cost of an application is estimated from the number of scalar nonzeroes
+   * and blocks of the matrix, see the constructor taking the matrix.
+   */
+  template<class X, class Y>
+  class InstrumentedOperator : public LinearOperator<X,Y>
+  {
+  public:
+    typedef X domain_type;
+    typedef Y range_type;
+    typedef typename X::field_type field_type;
+
+    /**
+     * \param op The operator to decorate.
+     * \param flops The estimated floating point operations of an application.
+     * \param bytes The estimated bytes of the operator read by an application,
+     *              the vectors are accounted for separately.
+     */
+    InstrumentedOperator (std::shared_ptr<LinearOperator<X,Y> > op, double flops = 0.0, double bytes = 0.0)
+      : op_(std::move(op)), flops_(flops), bytes_(bytes)
+    {}
+
+    /**
+     * \brief Estimate the cost from an assembled matrix.
+     *
+     * An application performs two floating point operations per scalar nonzero
+     * and reads all of them as well as one column index per block.
+     */
+    template<class M, std::enable_if_t<!IsNumber<M>::value, int> = 0>
+    InstrumentedOperator (std::shared_ptr<LinearOperator<X,Y> > op, const M& matrix)
+      : op_(std::move(op))
+    {
+      const double scalars = countNonZeros(matrix);
+      flops_ = 2.0*scalars;
+      bytes_ = scalars*sizeof(field_type) + matrix.nonzeroes()*sizeof(typename M::size_type);
+    }
+
+    void apply (const X& x, Y& y) const override
+    {
+      Instrumentation::Scope scope("operator apply", flops_, bytes_);
+      if (scope)
+        scope.addBytes((dim_(x) + dim_(y))*sizeof(field_type));
+      op_->apply(x, y);
+    }
+
+    void applyscaleadd (field_type alpha, const X& x, Y& y) const override
+    {
+      Instrumentation::Scope scope("operator apply", flops_, bytes_);
+      if (scope)
+        scope.addBytes((dim_(x) + 2*dim_(y))*sizeof(field_type));
+      op_->applyscaleadd(alpha, x, y);
+    }
+
+    SolverCategory::Category category () const override
+    {
+      return op_->category();
+    }
+
+  private:
+    std::shared_ptr<LinearOperator<X,Y> > op_;
+    double flops_;
+    double bytes_;
+    Impl::InstrumentedDimension<X> dim_;
+  };
+
+  /**
+   * \brief A preconditioner recording its methods as "preconditioner pre",
+   *        "preconditioner apply" and "preconditioner post".
+   */
+  template<class X, class Y>
+  class InstrumentedPreconditioner : public Preconditioner<X,Y>
+  {
+  public:
+    typedef X domain_type;
+    typedef Y range_type;
+    typedef typename X::field_type field_type;
+
+    explicit InstrumentedPreconditioner (std::shared_ptr<Preconditioner<X,Y> > prec)
+      : prec_(std::move(prec))
+    {}
+
+    void pre (X& x, Y& b) override
+    {
+      Instrumentation::Scope scope("preconditioner pre");
+      prec_->pre(x, b);
+    }
+
+    void apply (X& v, const Y& d) override
+    {
+      Instrumentation::Scope scope("preconditioner apply");
+      prec_->apply(v, d);
+    }
+
+    void post (X& x) override
+    {
+      Instrumentation::Scope scope("preconditioner post");
+      prec_->post(x);
+    }
+
+    SolverCategory::Category category () const override
+    {
+      return prec_->category();
+    }
+
+  private:
+    std::shared_ptr<Preconditioner<X,Y> > prec_;
+  };
+
+  /**
+   * \brief A scalar product recording dot products as "dot" and norms as "norm".
+   *
+   * The fused and batched products are recorded under their own names. The
+   * global reductions of parallel scalar products appear as their children.
+   */
+  template<class X>
+  class InstrumentedScalarProduct : public ScalarProduct<X>
+  {
+  public:
+    typedef X domain_type;
+    typedef typename X::field_type field_type;
+    typedef typename FieldTraits<field_type>::real_type real_type;
+
+    explicit InstrumentedScalarProduct (std::shared_ptr<ScalarProduct<X> > sp)
+      : sp_(std::move(sp))
+    {}
+
+    field_type dot (const X& x, const X& y) const override
+    {
+      Instrumentation::Scope scope("dot");
+      if (scope)
+        count(scope, x, 2, 2);
+      return sp_->dot(x, y);
+    }
+
+    real_type norm (const X& x) const override
+    {
+      Instrumentation::Scope scope("norm");
+      if (scope)
+        count(scope, x, 2, 1);
+      return sp_->norm(x);
+    }
+
+    real_type axpyNorm (X& x, const field_type& a, const X& y) const override
+    {
+      Instrumentation::Scope scope("axpy norm");
+      if (scope)
+        count(scope, x, 4, 3);
+      return sp_->axpyNorm(x, a, y);
+    }
+
+    field_type axpyDot (X& x, const field_type& a, const X& y, const X& z) const override
+    {
+      Instrumentation::Scope scope("axpy dot");
+      if (scope)
+        count(scope, x, 4, 4);
+      return sp_->axpyDot(x, a, y, z);
+    }
+
+    void multiDot (const X& x, const std::vector<const X*>& y, std::vector<field_type>& result) const override
+    {
+      Instrumentation::Scope scope("multi dot");
+      if (scope)
+        count(scope, x, 2*y.size(), 1+y.size());
+      sp_->multiDot(x, y, result);
+    }
+
+    Future<std::vector<field_type> > idot (const std::vector<const X*>& x, const std::vector<const X*>& y,
+                                           const std::vector<const X*>& z) const override
+    {
+      Instrumentation::Scope scope("idot");
+      if (scope && !(x.empty() && z.empty()))
+        count(scope, x.empty() ? *z[0] : *x[0], 2*(x.size()+z.size()), 2*x.size()+z.size());
+      return sp_->idot(x, y, z);
+    }
+
+    void blockDot (const std::vector<const X*>& x, const std::vector<const X*>& y, std::vector<field_type>& result) const override
+    {
+      Instrumentation::Scope scope("block dot");
+      if (scope && !x.empty())
+        count(scope, *x[0], 2*x.size()*y.size(), x.size()+y.size());
+      sp_->blockDot(x, y, result);
+    }
+
+    SolverCategory::Category category () const override
+    {
+      return sp_->category();
+    }
+
+  private:
+    // operations and vector accesses per scalar entry
+    void count (Instrumentation::Scope& scope, const X& x, std::size_t flops, std::size_t vectors) const
+    {
+      const double n = dim_(x);
+      scope.addFlops(flops*n);
+      scope.addBytes(vectors*n*sizeof(field_type));
+    }
+
+    std::shared_ptr<ScalarProduct<X> > sp_;
+    Impl::InstrumentedDimension<X> dim_;
+  };
+
+  /**
+   * \brief An inverse operator recording each solve in an Instrumentation.
+   *
+   * Each call of apply() discards the statistics of the previous solve and
+   * activates the instrumentation in the calling thread while the decorated
+   * solver runs. Hence the scopes of the operator, the preconditioner, the
+   * scalar product and everything they call are recorded, provided they are
+   * decorated or contain scopes themselves.
+   *
+   * The report of the last solve is available as JSON from report(). If a file
+   * name is given, the report of every solve is appended to it as one line.
+   */
+  template<class X, class Y>
+  class InstrumentedInverseOperator : public InverseOperator<X,Y>
+  {
+  public:
+    typedef X domain_type;
+    typedef Y range_type;
+    typedef typename X::field_type field_type;
+
+    /**
+     * \param solver The solver to decorate.
+     * \param name The name of the solver in the report.
+     * \param fileName If not empty, the reports are appended to this file.
+     */
+    InstrumentedInverseOperator (std::shared_ptr<InverseOperator<X,Y> > solver,
+                                 std::string name = "solver", std::string fileName = "")
+      : solver_(std::move(solver)), name_(std::move(name)), fileName_(std::move(fileName))
+    {}
+
+    void apply (X& x, Y& b, InverseOperatorResult& res) override
+    {
+      instrumentation_.reset();
+      {
+        Instrumentation::Activation activation(instrumentation_);
+        solver_->apply(x, b, res);
+      }
+      finish(res);
+    }
+
+    void apply (X& x, Y& b, double reduction, InverseOperatorResult& res) override
+    {
+      instrumentation_.reset();
+      {
+        Instrumentation::Activation activation(instrumentation_);
+        solver_->apply(x, b, reduction, res);
+      }
+      finish(res);
+    }
+
+    SolverCategory::Category category () const override
+    {
+      return solver_->category();
+    }
+
+    //! \brief The statistics of the last solve.
+    const Instrumentation& instrumentation () const
+    {
+      return instrumentation_;
+    }
+
+    /**
+     * \brief Write the report of the last solve as a JSON object.
+     *
+     * The object contains the name of the solver, the InverseOperatorResult
+     * and the tree of the instrumentation under the key "timers". A
+     * reduction or convergence rate that is nan or inf, e.g. after a
+     * breakdown, is written as null.
+     */
+    void report (std::ostream& os) const
+    {
+      os << "{\"solver\": ";
+      Instrumentation::writeJSONString(os, name_);
+      os << ", \"iterations\": " << result_.iterations
+         << ", \"converged\": " << (result_.converged ? "true" : "false")
+         << ", \"reduction\": ";
+      Instrumentation::writeJSONNumber(os, result_.reduction);
+      os << ", \"conv_rate\": ";
+      Instrumentation::writeJSONNumber(os, result_.conv_rate);
+      os << ", \"elapsed\": ";
+      Instrumentation::writeJSONNumber(os, result_.elapsed);
+      os << ", \"timers\": ";
+      instrumentation_.writeJSON(os);
+      os << "}";
+    }
+
+    //! \brief The report of the last solve, see report(std::ostream&).
+    std::string report () const
+    {
+      std::ostringstream os;
+      report(os);
+      return os.str();
+    }
+
+  private:
+    void finish (const InverseOperatorResult& res)
+    {
+      result_ = res;
+      if (fileName_.empty())
+        return;
+      std::ofstream file(fileName_, std::ios::app);
+      if (!file)
+        DUNE_THROW(IOError, "Could not open the instrumentation report " << fileName_);
+      report(file);
+      file << "\n";
+    }
+
+    std::shared_ptr<InverseOperator<X,Y> > solver_;
+    std::string name_;
+    std::string fileName_;
+    Instrumentation instrumentation_;
+    InverseOperatorResult result_;
+  };
+
+  /** @} end documentation */
+
+} // end namespace Dune
+
+#endif // DUNE_ISTL_INSTRUMENTED_HH
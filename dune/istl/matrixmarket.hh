@@ -1177,6 +1177,89 @@ namespace Dune
   }
 
 #if HAVE_MPI
+  namespace MatrixMarketImpl
+  {
+    /**
+     * @brief Store the parallel index set and the neighbours of a communication in a file.
+     *
+     * Each line contains the global index, the local index, the attribute and
+     * whether the index is public, followed by a line with the neighbours.
+     */
+    template<typename G, typename L>
+    void storeParallelIndices(const std::string& filename,
+                              const OwnerOverlapCopyCommunication<G,L>& comm)
+    {
+      std::ofstream file(filename.c_str());
+      if(!file)
+        DUNE_THROW(IOError, "Could not open file for storage: " << filename.c_str());
+      file.setf(std::ios::scientific,std::ios::floatfield);
+      typedef typename OwnerOverlapCopyCommunication<G,L>::ParallelIndexSet IndexSet;
+      typedef typename IndexSet::const_iterator Iterator;
+      for(Iterator iter = comm.indexSet().begin();
+          iter != comm.indexSet().end(); ++iter) {
+        file << iter->global()<<" "<<(std::size_t)iter->local()<<" "
+             <<(int)iter->local().attribute()<<" "<<(int)iter->local().isPublic()<<std::endl;
+      }
+      // Store neighbour information for efficient remote indices setup.
+      file<<"neighbours:";
+      const std::set<int>& neighbours=comm.remoteIndices().getNeighbours();
+      typedef std::set<int>::const_iterator SIter;
+      for(SIter neighbour=neighbours.begin(); neighbour != neighbours.end(); ++neighbour) {
+        file<<" "<< *neighbour;
+      }
+      file.close();
+    }
+
+    /**
+     * @brief Load the parallel index set written by storeParallelIndices() and build the remote indices.
+     */
+    template<typename G, typename L>
+    void loadParallelIndices(const std::string& filename,
+                             OwnerOverlapCopyCommunication<G,L>& comm)
+    {
+      using LocalIndexT = typename OwnerOverlapCopyCommunication<G,L>::ParallelIndexSet::LocalIndex;
+      typedef typename LocalIndexT::Attribute Attribute;
+      typedef typename OwnerOverlapCopyCommunication<G,L>::ParallelIndexSet IndexSet;
+      IndexSet& pis=comm.indexSet();
+      std::ifstream file(filename.c_str());
+      if(!file)
+        DUNE_THROW(IOError, "Could not open file: " << filename.c_str());
+      if(pis.size()!=0)
+        DUNE_THROW(InvalidIndexSetState, "Index set is not empty!");
+
+      pis.beginResize();
+      while(!file.eof() && file.peek()!='n') {
+        G g;
+        file >>g;
+        std::size_t l;
+        file >>l;
+        int c;
+        file >>c;
+        bool b;
+        file >> b;
+        pis.add(g,LocalIndexT(l,Attribute(c),b));
+        lineFeed(file);
+      }
+      pis.endResize();
+      if(!file.eof()) {
+        // read neighbours
+        std::string s;
+        file>>s;
+        if(s!="neighbours:")
+          DUNE_THROW(MatrixMarketFormatError, "was expecting the string: \"neighbours:\"");
+        std::set<int> nb;
+        while(!file.eof()) {
+          int i;
+          file >> i;
+          nb.insert(i);
+        }
+        file.close();
+        comm.remoteIndices().setNeighbours(nb);
+      }
+      comm.remoteIndices().template rebuild<false>();
+    }
+  } // end namespace MatrixMarketImpl
+
   /**
    * @brief Stores a parallel matrix/vector in matrix market format in a file.
    *
@@ -1229,26 +1312,7 @@ namespace Dune
       return;
 
     // Write the global to local index mapping
-    rfilename = pureFilename + "_" + std::to_string(rank) + ".idx";
-    file.open(rfilename.c_str());
-    if(!file)
-      DUNE_THROW(IOError, "Could not open file for storage: " << rfilename.c_str());
-    file.setf(std::ios::scientific,std::ios::floatfield);
-    typedef typename OwnerOverlapCopyCommunication<G,L>::ParallelIndexSet IndexSet;
-    typedef typename IndexSet::const_iterator Iterator;
-    for(Iterator iter = comm.indexSet().begin();
-        iter != comm.indexSet().end(); ++iter) {
-      file << iter->global()<<" "<<(std::size_t)iter->local()<<" "
-           <<(int)iter->local().attribute()<<" "<<(int)iter->local().isPublic()<<std::endl;
-    }
-    // Store neighbour information for efficient remote indices setup.
-    file<<"neighbours:";
-    const std::set<int>& neighbours=comm.remoteIndices().getNeighbours();
-    typedef std::set<int>::const_iterator SIter;
-    for(SIter neighbour=neighbours.begin(); neighbour != neighbours.end(); ++neighbour) {
-      file<<" "<< *neighbour;
-    }
-    file.close();
+    MatrixMarketImpl::storeParallelIndices(pureFilename + "_" + std::to_string(rank) + ".idx", comm);
   }
 
   /**
@@ -1273,8 +1337,6 @@ namespace Dune
   {
     using namespace MatrixMarketImpl;
 
-    using LocalIndexT = typename OwnerOverlapCopyCommunication<G,L>::ParallelIndexSet::LocalIndex;
-    typedef typename LocalIndexT::Attribute Attribute;
     // Get our rank
     int rank = comm.communicator().rank();
     // load local matrix
@@ -1307,45 +1369,7 @@ namespace Dune
       return;
 
     // read indices
-    typedef typename OwnerOverlapCopyCommunication<G,L>::ParallelIndexSet IndexSet;
-    IndexSet& pis=comm.pis;
-    rfilename = pureFilename + "_" + std::to_string(rank) + ".idx";
-    file.open(rfilename.c_str());
-    if(!file)
-      DUNE_THROW(IOError, "Could not open file: " << rfilename.c_str());
-    if(pis.size()!=0)
-      DUNE_THROW(InvalidIndexSetState, "Index set is not empty!");
-
-    pis.beginResize();
-    while(!file.eof() && file.peek()!='n') {
-      G g;
-      file >>g;
-      std::size_t l;
-      file >>l;
-      int c;
-      file >>c;
-      bool b;
-      file >> b;
-      pis.add(g,LocalIndexT(l,Attribute(c),b));
-      lineFeed(file);
-    }
-    pis.endResize();
-    if(!file.eof()) {
-      // read neighbours
-      std::string s;
-      file>>s;
-      if(s!="neighbours:")
-        DUNE_THROW(MatrixMarketFormatError, "was expecting the string: \"neighbours:\"");
-      std::set<int> nb;
-      while(!file.eof()) {
-        int i;
-        file >> i;
-        nb.insert(i);
-      }
-      file.close();
-      comm.ri.setNeighbours(nb);
-    }
-    comm.ri.template rebuild<false>();
+    MatrixMarketImpl::loadParallelIndices(pureFilename + "_" + std::to_string(rank) + ".idx", comm);
   }
 
   #endif
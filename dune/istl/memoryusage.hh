@@ -0,0 +1,83 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_ISTL_MEMORYUSAGE_HH
+#define DUNE_ISTL_MEMORYUSAGE_HH
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include <dune/common/std/type_traits.hh>
+
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+
+/** \file
+ * \brief Estimates of the memory held by matrices, vectors and solver components.
+ */
+
+namespace Dune {
+
+  /** @addtogroup ISTL_SPMV
+          @{
+   */
+
+  namespace Impl {
+
+    template<class T>
+    using HasMemoryUsage = decltype(std::declval<const T&>().memoryUsage());
+
+  } // end namespace Impl
+
+  /**
+   * \brief The memory in bytes allocated by an object.
+   *
+   * Objects providing a member function memoryUsage() report its result,
+   * e.g. SeqILU. For all other objects 0 is returned, i.e. they are
+   * assumed to not own memory apart from their own size, like preconditioners
+   * referencing a matrix. The overloads for containers count the allocated
+   * capacity.
+   */
+  template<class T>
+  std::size_t memoryUsage (const T& t)
+  {
+    if constexpr (Std::is_detected_v<Impl::HasMemoryUsage, T>)
+      return t.memoryUsage();
+    else
+      return 0;
+  }
+
+  //! \brief The memory in bytes allocated by a std::vector of flat entries.
+  template<class T, class A>
+  std::size_t memoryUsage (const std::vector<T,A>& v)
+  {
+    return v.capacity()*sizeof(T);
+  }
+
+  //! \brief The memory in bytes allocated by a BlockVector of flat blocks.
+  template<class B, class A>
+  std::size_t memoryUsage (const BlockVector<B,A>& v)
+  {
+    return v.capacity()*sizeof(B);
+  }
+
+  /**
+   * \brief The memory in bytes allocated by a BCRSMatrix of flat blocks.
+   *
+   * Counts the blocks, the column indices and the row descriptors.
+   */
+  template<class B, class A>
+  std::size_t memoryUsage (const BCRSMatrix<B,A>& matrix)
+  {
+    typedef BCRSMatrix<B,A> Matrix;
+    return matrix.nonzeroes()*(sizeof(B) + sizeof(typename Matrix::size_type))
+      + matrix.N()*sizeof(typename Matrix::row_type);
+  }
+
+  /** @} end documentation */
+
+} // end namespace Dune
+
+#endif
@@ -0,0 +1,170 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_ISTL_MIXEDPRECISION_HH
+#define DUNE_ISTL_MIXEDPRECISION_HH
+
+#include <memory>
+#include <type_traits>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/typetraits.hh>
+
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/istlexception.hh>
+
+/** \file
+ * \brief Storing a BCRSMatrix in reduced precision
+ *
+ * Sparse matrix-vector products are limited by memory bandwidth, and most of
+ * the transferred data are the matrix entries. Preconditioner matrices often
+ * do not need the full precision of the vectors they are applied to. This file
+ * provides the type MixedPrecisionMatrix to store the entries of a BCRSMatrix
+ * in a smaller field type and functions to convert a matrix.
+ *
+ * A BCRSMatrix with `float` entries can directly be applied to vectors with
+ * `double` entries: the block kernels multiply a `float` entry with a `double`
+ * vector entry and accumulate the result in the (`double`) range vector. Hence
+ * `MatrixAdapter<MixedPrecisionMatrix<M>,X,Y>` is a LinearOperator on the
+ * double precision vectors X and Y, and the preconditioners SeqILU, SeqSSOR,
+ * SeqSOR, SeqJac, and Amg::AMG (using the above operator) can be set up with
+ * the reduced precision matrix and applied to double precision vectors.
+ * Factorizations computed during the setup (e.g. the ILU factors or the AMG
+ * coarse grid matrices) are stored in the reduced precision as well. The AMG
+ * coarsest level is solved iteratively in this case, as the direct solvers
+ * require the matrix and vector field types to agree.
+ *
+ * Any field type \f$T\f$ for which `Dune::IsNumber<T>` holds and a
+ * `FieldTraits` specialization exists can be used for the storage,
+ * e.g. `float` or a half precision type provided by the user.
+ */
+
+namespace Dune {
+
+  /** @addtogroup ISTL_SPMV
+          @{
+   */
+
+  namespace Impl {
+
+    //! Replace the field type of a (nested) matrix block type by T.
+    template<class B, class T, class = void>
+    struct RebindFieldType
+    {
+      static_assert(IsNumber<B>::value, "Only scalars, FieldMatrix, and BCRSMatrix can be rebound to another field type");
+      using type = T;
+    };
+
+    template<class K, int n, int m, class T>
+    struct RebindFieldType<FieldMatrix<K,n,m>, T>
+    {
+      using type = FieldMatrix<typename RebindFieldType<K,T>::type, n, m>;
+    };
+
+    template<class B, class A, class T>
+    struct RebindFieldType<BCRSMatrix<B,A>, T>
+    {
+      using block_type = typename RebindFieldType<B,T>::type;
+      using type = BCRSMatrix<block_type, typename std::allocator_traits<A>::template rebind_alloc<block_type> >;
+    };
+
+    //! Copy a block entry-wise, converting the field type.
+    template<class S, class D>
+    void convertBlock (const S& source, D& target)
+    {
+      if constexpr (IsNumber<S>::value)
+        target = static_cast<D>(source);
+      else
+        for (std::size_t i = 0; i < source.N(); ++i)
+          for (std::size_t j = 0; j < source.M(); ++j)
+            convertBlock(source[i][j], target[i][j]);
+    }
+
+  } // end namespace Impl
+
+  /**
+   * \brief The BCRSMatrix type with the same block structure as M but entries of type T.
+   *
+   * E.g. `MixedPrecisionMatrix<BCRSMatrix<FieldMatrix<double,2,2>>>` is
+   * `BCRSMatrix<FieldMatrix<float,2,2>>`.
+   */
+  template<class M, class T = float>
+  using MixedPrecisionMatrix = typename Impl::RebindFieldType<M,T>::type;
+
+  /**
+   * \brief Update the entries of a converted matrix after the entries of the source changed.
+   *
+   * Both matrices must have the same sparsity pattern, e.g. because target was
+   * created by convertMatrix(source, target).
+   */
+  template<class B1, class A1, class B2, class A2>
+  void convertMatrixEntries (const BCRSMatrix<B1,A1>& source, BCRSMatrix<B2,A2>& target)
+  {
+#ifdef DUNE_ISTL_WITH_CHECKING
+    if (source.N() != target.N() || source.M() != target.M() || source.nonzeroes() != target.nonzeroes())
+      DUNE_THROW(ISTLError, "The sparsity patterns of the matrices do not match");
+#endif
+    auto row = source.begin();
+    for (auto targetRow = target.begin(); targetRow != target.end(); ++targetRow, ++row)
+    {
+      auto entry = row->begin();
+      for (auto targetEntry = targetRow->begin(); targetEntry != targetRow->end(); ++targetEntry, ++entry)
+        Impl::convertBlock(*entry, *targetEntry);
+    }
+  }
+
+  /**
+   * \brief Copy the sparsity pattern and the (converted) entries of a matrix.
+   *
+   * The target matrix is built in row-wise mode and afterwards holds the same
+   * pattern as the source. The entries are converted with `static_cast`, i.e.
+   * rounded if the target field type has less precision.
+   *
+   * The blocks have to be scalars or FieldMatrix objects.
+   *
+   * \param source A fully built matrix.
+   * \param target An empty (not yet allocated) matrix. Use convertMatrixEntries()
+   *               to update the entries of a matrix that was converted before.
+   */
+  template<class B1, class A1, class B2, class A2>
+  void convertMatrix (const BCRSMatrix<B1,A1>& source, BCRSMatrix<B2,A2>& target)
+  {
+    using Target = BCRSMatrix<B2,A2>;
+    if (source.buildStage() != BCRSMatrix<B1,A1>::built)
+      DUNE_THROW(ISTLError, "Only fully built matrices can be converted");
+    if (target.buildStage() != Target::notAllocated)
+      DUNE_THROW(ISTLError, "The target matrix has to be empty, use convertMatrixEntries() to update its entries");
+
+    target.setBuildMode(Target::row_wise);
+    target.setSize(source.N(), source.M(), source.nonzeroes());
+    auto row = source.begin();
+    for (auto create = target.createbegin(); create != target.createend(); ++create, ++row)
+      for (auto entry = row->begin(); entry != row->end(); ++entry)
+        create.insert(entry.index());
+
+    convertMatrixEntries(source, target);
+  }
+
+  /**
+   * \brief Create a copy of a matrix that stores its entries as T.
+   *
+   * \code
+   * auto Af = Dune::toMixedPrecision(A); // BCRSMatrix<FieldMatrix<float,n,n>>
+   * Dune::MatrixAdapter<decltype(Af),Vector,Vector> op(Af);
+   * Dune::SeqILU<decltype(Af),Vector,Vector> ilu(Af, 1.0);
+   * \endcode
+   */
+  template<class T = float, class B, class A>
+  MixedPrecisionMatrix<BCRSMatrix<B,A>,T> toMixedPrecision (const BCRSMatrix<B,A>& source)
+  {
+    MixedPrecisionMatrix<BCRSMatrix<B,A>,T> target;
+    convertMatrix(source, target);
+    return target;
+  }
+
+  /** @} end documentation */
+
+} // end namespace Dune
+
+#endif
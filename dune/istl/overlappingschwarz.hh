@@ -8,12 +8,15 @@
 #include <algorithm>
 #include <functional>
 #include <memory>
+#include <type_traits>
 #include <vector>
 #include <set>
 #include <dune/common/dynmatrix.hh>
 #include <dune/common/sllist.hh>
 
+#include <dune/istl/batchedlu.hh>
 #include <dune/istl/bccsmatrixinitializer.hh>
+#include <dune/istl/common/threadpool.hh>
 #include "preconditioners.hh"
 #include "superlu.hh"
 #include "umfpack.hh"
@@ -210,6 +213,104 @@ namespace Dune
     DynamicMatrix<K> A;
   };
 
+  /**
+   * @brief Exact subdomain solver using the LU decompositions of a BatchedLU.
+   *
+   * If the local problems are not set up on the fly, the dense matrices of all
+   * subdomains are stored in one BatchedLU, which is decomposed at once in
+   * SeqOverlappingSchwarz. Each solver then refers to its matrix in the batch.
+   *
+   * @tparam M The type of the matrix.
+   */
+  template<class M, class X, class Y>
+  class BatchedLUSubdomainSolver;
+
+  // Specialization for BCRSMatrix
+  template<class K, class Al, class X, class Y>
+  class BatchedLUSubdomainSolver< BCRSMatrix< K, Al>, X, Y >
+  {
+    typedef BCRSMatrix< K, Al> M;
+  public:
+    //! \brief The matrix type the preconditioner is for.
+    typedef typename std::remove_const<M>::type matrix_type;
+    typedef typename X::field_type field_type;
+    //! \brief The domain type of the preconditioner.
+    typedef X domain_type;
+    //! \brief The range type of the preconditioner.
+    typedef Y range_type;
+    //! \brief The batch of dense LU decompositions.
+    typedef BatchedLU<field_type> batch_type;
+    static constexpr size_t n = std::decay_t<decltype(Impl::asMatrix(std::declval<K>()))>::rows;
+
+    /**
+     * @brief Apply the subdomain solver.
+     * @copydoc ILUSubdomainSolver::apply
+     */
+    void apply (DynamicVector<field_type>& v, DynamicVector<field_type>& d)
+    {
+      assert(batch_);
+      assert(batch_->size(index_) <= v.size());
+      batch_->solve(index_, v, d);
+    }
+
+    /**
+     * @brief Set the data of the local problem and decompose it.
+     *
+     * @param BCRS The global matrix.
+     * @param rowset The global indices of the local problem.
+     * @tparam S The type of the set with the indices.
+     */
+    template<class S>
+    void setSubMatrix(const M& BCRS, S& rowset)
+    {
+      auto batch = std::make_shared<batch_type>();
+      batch->resize({rowset.size()*n});
+      copySubMatrix(BCRS, rowset, *batch, 0);
+      batch->decompose();
+      setBatch(batch, 0);
+    }
+
+    /**
+     * @brief Refer to a matrix of a batch.
+     *
+     * @param batch The batch holding the decomposed local matrix.
+     * @param index The index of the local matrix in the batch.
+     */
+    void setBatch(const std::shared_ptr<const batch_type>& batch, std::size_t index)
+    {
+      batch_ = batch;
+      index_ = index;
+    }
+
+    /**
+     * @brief Copy the local problem into a matrix of a batch.
+     *
+     * @param BCRS The global matrix.
+     * @param rowset The global indices of the local problem.
+     * @param batch The batch, its matrix with the given index has to be of matching size.
+     * @param index The index of the local matrix in the batch.
+     */
+    template<class S>
+    static void copySubMatrix(const M& BCRS, const S& rowset, batch_type& batch, std::size_t index)
+    {
+      const std::vector<typename S::value_type> rows(rowset.begin(), rowset.end());
+      for(size_t r = 0; r < rows.size(); ++r)
+        for(auto col = BCRS[rows[r]].begin(); col != BCRS[rows[r]].end(); ++col)
+        {
+          auto c = std::lower_bound(rows.begin(), rows.end(), col.index());
+          if (c == rows.end() || *c != col.index())
+            continue;
+          for (size_t i=0; i<n; i++)
+            for (size_t j=0; j<n; j++)
+              batch.entry(index, r*n+i, std::size_t(c-rows.begin())*n+j) = Impl::asMatrix(*col)[i][j];
+        }
+    }
+
+  private:
+    std::shared_ptr<const batch_type> batch_;
+    std::size_t index_ = 0;
+  };
+
   template<typename T, bool tag>
   class OverlappingAssignerHelper
   {};
@@ -307,6 +408,24 @@ namespace Dune
     std::size_t maxlength_;
   };
 
+  // the batched solver uses the same local vectors as the DynamicMatrix solver
+  template<class K, class Al, class X, class Y>
+  class OverlappingAssignerHelper< BatchedLUSubdomainSolver< BCRSMatrix<K, Al>, X, Y >,false>
+    : public OverlappingAssignerHelper< DynamicMatrixSubdomainSolver< BCRSMatrix<K, Al>, X, Y >,false>
+  {
+  public:
+    /**
+     * @brief Constructor.
+     * @param maxlength The maximum entries over all subdomains.
+     * @param mat_ The global matrix.
+     * @param b_ the global right hand side.
+     * @param x_ the global left hand side.
+     */
+    OverlappingAssignerHelper(std::size_t maxlength, const BCRSMatrix<K, Al>& mat_, const X& b_, Y& x_)
+      : OverlappingAssignerHelper< DynamicMatrixSubdomainSolver< BCRSMatrix<K, Al>, X, Y >,false>(maxlength, mat_, b_, x_)
+    {}
+  };
+
 #if HAVE_SUPERLU || HAVE_SUITESPARSE_UMFPACK
   template<template<class> class S, typename T, typename A>
   struct OverlappingAssignerHelper<S<BCRSMatrix<T, A>>, true>
@@ -707,6 +826,17 @@ namespace Dune
                                              bool onTheFly);
   };
 
+  template<class K, class Al, class X, class Y>
+  struct SeqOverlappingSchwarzAssemblerHelper< BatchedLUSubdomainSolver< BCRSMatrix< K, Al>, X, Y >,false>
+  {
+    typedef BCRSMatrix< K, Al> matrix_type;
+    static constexpr size_t n = std::decay_t<decltype(Impl::asMatrix(std::declval<K>()))>::rows;
+    template<class RowToDomain, class Solvers, class SubDomains>
+    static std::size_t assembleLocalProblems(const RowToDomain& rowToDomain, const matrix_type& mat,
+                                             Solvers& solvers, const SubDomains& domains,
+                                             bool onTheFly);
+  };
+
   template<template<class> class S, typename T, typename A>
   struct SeqOverlappingSchwarzAssemblerHelper<S<BCRSMatrix<T,A>>,true>
   {
@@ -747,6 +877,15 @@ namespace Dune
    * MultiplicativeSchwarzMode, and SymmetricMultiplicativeSchwarzMode. (Default values is AdditiveSchwarzMode)
    * @tparam TD The type of the local subdomain solver to be used.
    * @tparam TA The type of the allocator to use.
+   *
+   * If constructed as threaded, the subdomains are distributed among the threads
+   * of the ThreadPool, each with its own local right and left hand sides and, if the
+   * local problems are set up on the fly, its own subdomain solver. In additive mode
+   * all subdomains are solved concurrently and the result is the same as for the
+   * sequential method. In the multiplicative modes the subdomains are coloured such
+   * that subdomains of the same colour are not coupled by the matrix. The sweep
+   * visits the colours one after another and solves the subdomains of each colour
+   * concurrently. The result does not depend on the number of threads.
    */
   template<class M, class X, class TM=AdditiveSchwarzMode,
       class TD=ILU0SubdomainSolver<M,X,X>, class TA=std::allocator<X> >
@@ -819,10 +958,12 @@ namespace Dune
      * iteration step. If false all decompositions are computed in pre and
      * only forward and backward substitution takes place
      * in the iteration steps.
+     * @param threaded_ If true the subdomains are solved by the threads of the ThreadPool.
      * @warning Each rowindex should be part of at least one subdomain!
      */
     SeqOverlappingSchwarz(const matrix_type& mat, const subdomain_vector& subDomains,
-                          field_type relaxationFactor=1, bool onTheFly_=true);
+                          field_type relaxationFactor=1, bool onTheFly_=true,
+                          bool threaded_=false);
 
     /**
      * Construct the overlapping Schwarz method
@@ -834,9 +975,11 @@ namespace Dune
      * iteration step. If false all decompositions are computed in pre and
      * only forward and backward substitution takes place
      * in the iteration steps.
+     * @param threaded_ If true the subdomains are solved by the threads of the ThreadPool.
      */
     SeqOverlappingSchwarz(const matrix_type& mat, const rowtodomain_vector& rowToDomain,
-                          field_type relaxationFactor=1, bool onTheFly_=true);
+                          field_type relaxationFactor=1, bool onTheFly_=true,
+                          bool threaded_=false);
 
     /*!
        \brief Prepare the preconditioner.
@@ -870,7 +1013,28 @@ namespace Dune
       return SolverCategory::sequential;
     }
 
+    /**
+     * @brief The number of colours of the subdomains.
+     *
+     * Only the threaded multiplicative modes colour the subdomains, otherwise
+     * zero is returned.
+     */
+    size_type colors() const
+    {
+      return colors_.empty() ? 0 : colors_.size()-1;
+    }
+
   private:
+    //! Set up the colouring or the gathering of the local solutions for the threaded application
+    void setupThreading();
+
+    //! Compute the local defect of the i-th subdomain and solve the local problem
+    template<class Assigner>
+    void solveLocalProblem(size_type i, Assigner& assigner);
+
+    template<bool forward>
+    void applyThreaded(X& x, const X& b);
+
     const M& mat;
     slu_vector solvers;
     subdomain_vector subDomains;
@@ -879,6 +1043,18 @@ namespace Dune
     typename M::size_type maxlength;
 
     bool onTheFly;
+
+    bool threaded;
+
+    // the subdomains of colour c are colorDomains_[colors_[c]], ..., colorDomains_[colors_[c+1]-1]
+    std::vector<size_type> colors_;
+    std::vector<size_type> colorDomains_;
+
+    // the local solutions of the additive mode are stored one subdomain after another,
+    // starting at domainOffsets_, and row r gathers them from rowPositions_[rowOffsets_[r]], ...
+    std::vector<size_type> domainOffsets_;
+    std::vector<size_type> rowOffsets_;
+    std::vector<size_type> rowPositions_;
   };
 
 
@@ -1007,8 +1183,9 @@ namespace Dune
 
   template<class M, class X, class TM, class TD, class TA>
   SeqOverlappingSchwarz<M,X,TM,TD,TA>::SeqOverlappingSchwarz(const matrix_type& mat_, const rowtodomain_vector& rowToDomain,
-                                                             field_type relaxationFactor, bool fly)
-    : mat(mat_), relax(relaxationFactor), onTheFly(fly)
+                                                             field_type relaxationFactor, bool fly,
+                                                             bool threaded_)
+    : mat(mat_), relax(relaxationFactor), onTheFly(fly), threaded(threaded_)
   {
     typedef typename rowtodomain_vector::const_iterator RowDomainIterator;
     typedef typename subdomain_list::const_iterator DomainIterator;
@@ -1050,15 +1227,18 @@ namespace Dune
 #endif
     maxlength = SeqOverlappingSchwarzAssembler<slu>
                 ::assembleLocalProblems(rowToDomain, mat, solvers, subDomains, onTheFly);
+    if(threaded)
+      setupThreading();
   }
 
   template<class M, class X, class TM, class TD, class TA>
   SeqOverlappingSchwarz<M,X,TM,TD,TA>::SeqOverlappingSchwarz(const matrix_type& mat_,
                                                              const subdomain_vector& sd,
                                                              field_type relaxationFactor,
-                                                             bool fly)
+                                                             bool fly,
+                                                             bool threaded_)
     :  mat(mat_), solvers(sd.size()), subDomains(sd), relax(relaxationFactor),
-      onTheFly(fly)
+      onTheFly(fly), threaded(threaded_)
   {
     typedef typename subdomain_vector::const_iterator DomainIterator;
 
@@ -1091,6 +1271,8 @@ namespace Dune
 
     maxlength = SeqOverlappingSchwarzAssembler<slu>
                 ::assembleLocalProblems(rowToDomain, mat, solvers, subDomains, onTheFly);
+    if(threaded)
+      setupThreading();
   }
 
   /**
@@ -1137,6 +1319,42 @@ namespace Dune
     return maxlength;
   }
 
+  template<class K, class Al, class X, class Y>
+  template<class RowToDomain, class Solvers, class SubDomains>
+  std::size_t
+  SeqOverlappingSchwarzAssemblerHelper< BatchedLUSubdomainSolver< BCRSMatrix< K, Al>, X, Y >,false>::
+  assembleLocalProblems([[maybe_unused]] const RowToDomain& rowToDomain,
+                        const matrix_type& mat,
+                        Solvers& solvers,
+                        const SubDomains& subDomains,
+                        bool onTheFly)
+  {
+    typedef typename Solvers::value_type Solver;
+    typedef typename Solver::batch_type Batch;
+    std::size_t maxlength = 0;
+
+    std::vector<std::size_t> sizes;
+    for(const auto& domain : subDomains) {
+      sizes.push_back(domain.size()*n);
+      maxlength = std::max(maxlength, sizes.back());
+    }
+
+    if(!onTheFly) {
+      // copy all local matrices into one batch and decompose them at once
+      auto batch = std::make_shared<Batch>();
+      batch->resize(sizes);
+      ThreadPool::instance().parallelFor(0, subDomains.size(), [&](std::size_t first, std::size_t last){
+        for(std::size_t i=first; i < last; ++i)
+          Solver::copySubMatrix(mat, subDomains[i], *batch, i);
+      });
+      batch->decompose();
+      for(std::size_t i=0; i < solvers.size(); ++i)
+        solvers[i].setBatch(batch, i);
+    }
+
+    return maxlength;
+  }
+
 #if HAVE_SUPERLU || HAVE_SUITESPARSE_UMFPACK
   template<template<class> class S, typename T, typename A>
   template<class RowToDomain, class Solvers, class SubDomains>
@@ -1229,10 +1447,159 @@ namespace Dune
     SeqOverlappingSchwarzApplier<SeqOverlappingSchwarz>::apply(*this, x, b);
   }
 
+  template<class M, class X, class TM, class TD, class TA>
+  void SeqOverlappingSchwarz<M,X,TM,TD,TA>::setupThreading()
+  {
+    const size_type domains = subDomains.size();
+
+    // the subdomains of each row
+    std::vector<std::vector<size_type> > rowDomains(mat.N());
+    for(size_type d=0; d < domains; ++d)
+      for(const auto& row : subDomains[d])
+        rowDomains[row].push_back(d);
+
+    if constexpr (std::is_same_v<TM,AdditiveSchwarzMode>) {
+      // position of each row of a subdomain in the storage of the local solutions
+      domainOffsets_.resize(domains+1);
+      domainOffsets_[0] = 0;
+      for(size_type d=0; d < domains; ++d)
+        domainOffsets_[d+1] = domainOffsets_[d] + subDomains[d].size();
+
+      rowOffsets_.assign(mat.N()+1, 0);
+      for(size_type row=0; row < mat.N(); ++row)
+        rowOffsets_[row+1] = rowOffsets_[row] + rowDomains[row].size();
+      rowPositions_.resize(rowOffsets_[mat.N()]);
+      std::vector<size_type> next(rowOffsets_.begin(), rowOffsets_.end()-1);
+      for(size_type d=0; d < domains; ++d) {
+        size_type position = domainOffsets_[d];
+        for(const auto& row : subDomains[d])
+          rowPositions_[next[row]++] = position++;
+      }
+      return;
+    }
+
+    // Two subdomains are coupled if one of them contains a row that the local defect
+    // of the other one depends on.
+    std::vector<std::vector<size_type> > neighbours(domains);
+    for(size_type d=0; d < domains; ++d)
+      for(const auto& row : subDomains[d])
+        for(auto col = mat[row].begin(); col != mat[row].end(); ++col)
+          for(const auto& e : rowDomains[col.index()])
+            if(e != d) {
+              neighbours[d].push_back(e);
+              neighbours[e].push_back(d);
+            }
+    for(auto& n : neighbours) {
+      std::sort(n.begin(), n.end());
+      n.erase(std::unique(n.begin(), n.end()), n.end());
+    }
+
+    // greedy colouring in the order of the subdomains
+    const size_type none = domains;
+    std::vector<size_type> color(domains, none);
+    std::vector<size_type> forbidden(domains+1, none);
+    size_type noColors = 0;
+    for(size_type d=0; d < domains; ++d) {
+      for(const auto& e : neighbours[d])
+        if(color[e] != none)
+          forbidden[color[e]] = d;
+      size_type c = 0;
+      while(forbidden[c] == d)
+        ++c;
+      color[d] = c;
+      noColors = std::max(noColors, c+1);
+    }
+
+    colors_.assign(noColors+1, 0);
+    for(size_type d=0; d < domains; ++d)
+      ++colors_[color[d]+1];
+    for(size_type c=0; c < noColors; ++c)
+      colors_[c+1] += colors_[c];
+    colorDomains_.resize(domains);
+    std::vector<size_type> next(colors_.begin(), colors_.end()-1);
+    for(size_type d=0; d < domains; ++d)
+      colorDomains_[next[color[d]]++] = d;
+  }
+
+  template<class M, class X, class TM, class TD, class TA>
+  template<class Assigner>
+  void SeqOverlappingSchwarz<M,X,TM,TD,TA>::solveLocalProblem(size_type i, Assigner& assigner)
+  {
+    const subdomain_type& domain = subDomains[i];
+    //Copy rhs to C-array for SuperLU
+    std::for_each(domain.begin(), domain.end(), assigner);
+    assigner.resetIndexForNextDomain();
+    if(onTheFly) {
+      // Create the subdomain solver
+      slu sdsolver;
+      sdsolver.setSubMatrix(mat, domain);
+      // Apply
+      sdsolver.apply(assigner.lhs(), assigner.rhs());
+    }else{
+      solvers[i].apply(assigner.lhs(), assigner.rhs());
+    }
+  }
+
+  template<class M, class X, class TM, class TD, class TA>
+  template<bool forward>
+  void SeqOverlappingSchwarz<M,X,TM,TD,TA>::applyThreaded(X& x, const X& b)
+  {
+    ThreadPool& pool = ThreadPool::instance();
+
+    if constexpr (std::is_same_v<TM,AdditiveSchwarzMode>) {
+      // solve all local problems concurrently, each thread with its own local vectors
+      X local(domainOffsets_.back());
+      local = 0;
+      pool.parallelFor(0, subDomains.size(), [&](std::size_t first, std::size_t last){
+        OverlappingAssigner<TD> assigner(maxlength, mat, b, x);
+        for(std::size_t i=first; i < last; ++i) {
+          solveLocalProblem(i, assigner);
+          for(size_type k=domainOffsets_[i]; k < domainOffsets_[i+1]; ++k)
+            assigner.assignResult(local[k]);
+          assigner.resetIndexForNextDomain();
+        }
+        assigner.deallocate();
+      });
+
+      // sum up the local solutions of each row in the order of the subdomains
+      X v(x);
+      pool.parallelFor(0, x.N(), [&](std::size_t first, std::size_t last){
+        for(std::size_t row=first; row < last; ++row) {
+          v[row] = 0;
+          for(size_type k=rowOffsets_[row]; k < rowOffsets_[row+1]; ++k)
+            v[row] += local[rowPositions_[k]];
+        }
+      }, 1024);
+      x.axpy(relax, v);
+      return;
+    }
+
+    // the subdomains of one colour do not depend on each other's updates
+    for(size_type k=0; k < colors(); ++k) {
+      const size_type c = forward ? k : colors()-1-k;
+      pool.parallelFor(colors_[c], colors_[c+1], [&](std::size_t first, std::size_t last){
+        OverlappingAssigner<TD> assigner(maxlength, mat, b, x);
+        MultiplicativeAdder<TD,X> adder(x, x, assigner, relax);
+        for(std::size_t j=first; j < last; ++j) {
+          const size_type i = colorDomains_[j];
+          solveLocalProblem(i, assigner);
+          std::for_each(subDomains[i].begin(), subDomains[i].end(), adder);
+          assigner.resetIndexForNextDomain();
+        }
+        assigner.deallocate();
+      });
+    }
+  }
+
   template<class M, class X, class TM, class TD, class TA>
   template<bool forward>
   void SeqOverlappingSchwarz<M,X,TM,TD,TA>::apply(X& x, const X& b)
   {
+    if(threaded) {
+      applyThreaded<forward>(x, b);
+      return;
+    }
+
     typedef slu_vector solver_vector;
     typedef typename IteratorDirectionSelector<solver_vector,subdomain_vector,forward>::solver_iterator iterator;
     typedef typename IteratorDirectionSelector<solver_vector,subdomain_vector,forward>::domain_iterator
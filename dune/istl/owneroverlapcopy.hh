@@ -12,6 +12,7 @@
 #include <map>
 #include <set>
 #include <tuple>
+#include <type_traits>
 
 #include <cmath>
 
@@ -31,6 +32,7 @@
 
 #include "solvercategory.hh"
 #include "istlexception.hh"
+#include <dune/istl/common/instrumentation.hh>
 #include <dune/common/parallel/communication.hh>
 #include <dune/istl/matrixmarket.hh>
 
@@ -312,6 +314,9 @@ namespace Dune {
     {
       if (!OwnerToAllInterfaceBuilt)
         buildOwnerToAllInterface ();
+      Instrumentation::Scope scope("communication");
+      if (scope)
+        scope.addBytes(communicatedBytes(OwnerToAllInterface, source, dest));
       BC communicator;
       communicator.template build<T>(OwnerToAllInterface);
       communicator.template forward<CopyGatherScatter<T> >(source,dest);
@@ -329,6 +334,9 @@ namespace Dune {
     {
       if (!CopyToAllInterfaceBuilt)
         buildCopyToAllInterface ();
+      Instrumentation::Scope scope("communication");
+      if (scope)
+        scope.addBytes(communicatedBytes(CopyToAllInterface, source, dest));
       BC communicator;
       communicator.template build<T>(CopyToAllInterface);
       communicator.template forward<CopyGatherScatter<T> >(source,dest);
@@ -346,6 +354,9 @@ namespace Dune {
     {
       if (!OwnerOverlapToAllInterfaceBuilt)
         buildOwnerOverlapToAllInterface ();
+      Instrumentation::Scope scope("communication");
+      if (scope)
+        scope.addBytes(communicatedBytes(OwnerOverlapToAllInterface, source, dest));
       BC communicator;
       communicator.template build<T>(OwnerOverlapToAllInterface);
       communicator.template forward<AddGatherScatter<T> >(source,dest);
@@ -363,6 +374,9 @@ namespace Dune {
     {
       if (!OwnerCopyToAllInterfaceBuilt)
         buildOwnerCopyToAllInterface ();
+      Instrumentation::Scope scope("communication");
+      if (scope)
+        scope.addBytes(communicatedBytes(OwnerCopyToAllInterface, source, dest));
       BC communicator;
       communicator.template build<T>(OwnerCopyToAllInterface);
       communicator.template forward<AddGatherScatter<T> >(source,dest);
@@ -380,6 +394,9 @@ namespace Dune {
     {
       if (!OwnerCopyToOwnerCopyInterfaceBuilt)
         buildOwnerCopyToOwnerCopyInterface ();
+      Instrumentation::Scope scope("communication");
+      if (scope)
+        scope.addBytes(communicatedBytes(OwnerCopyToOwnerCopyInterface, source, dest));
       BC communicator;
       communicator.template build<T>(OwnerCopyToOwnerCopyInterface);
       communicator.template forward<AddGatherScatter<T> >(source,dest);
@@ -396,23 +413,32 @@ namespace Dune {
      */
     template<class T1, class T2>
     void dot (const T1& x, const T1& y, T2& result) const
+    {
+      localDot(x,y,result);
+      Instrumentation::Scope scope("global sum");
+      result = cc.sum(result);
+    }
+
+    /**
+     * @brief Compute the contribution of this process to a global dot product.
+     *
+     * Only the entries owned by this process are taken into account, such that
+     * the sum of the local results over all processes is the global dot product.
+     * No communication takes place.
+     *
+     * @param x The first vector of the product.
+     * @param y The second vector of the product.
+     * @param result Reference to store the result in.
+     */
+    template<class T1, class T2>
+    void localDot (const T1& x, const T1& y, T2& result) const
     {
       using real_type = typename FieldTraits<typename T1::field_type>::real_type;
-      // set up mask vector
-      if (mask.size()!=static_cast<typename std::vector<double>::size_type>(x.size()))
-      {
-        mask.resize(x.size());
-        for (typename std::vector<double>::size_type i=0; i<mask.size(); i++)
-          mask[i] = 1;
-        for (typename PIS::const_iterator i=pis.begin(); i!=pis.end(); ++i)
-          if (i->local().attribute()!=OwnerOverlapCopyAttributeSet::owner)
-            mask[i->local().local()] = 0;
-      }
+      updateMask(x.size());
       result = T2(0.0);
 
       for (typename T1::size_type i=0; i<x.size(); i++)
         result += (x[i]*(y[i]))*static_cast<real_type>(mask[i]);
-      result = cc.sum(result);
     }
 
     /**
@@ -424,23 +450,28 @@ namespace Dune {
     template<class T1>
     typename FieldTraits<typename T1::field_type>::real_type norm (const T1& x) const
     {
-      using real_type = typename FieldTraits<typename T1::field_type>::real_type;
+      using std::sqrt;
+      const auto localNorm = localNorm2(x);
+      Instrumentation::Scope scope("global sum");
+      return sqrt(cc.sum(localNorm));
+    }
 
-      // set up mask vector
-      if (mask.size()!=static_cast<typename std::vector<double>::size_type>(x.size()))
-      {
-        mask.resize(x.size());
-        for (typename std::vector<double>::size_type i=0; i<mask.size(); i++)
-          mask[i] = 1;
-        for (typename PIS::const_iterator i=pis.begin(); i!=pis.end(); ++i)
-          if (i->local().attribute()!=OwnerOverlapCopyAttributeSet::owner)
-            mask[i->local().local()] = 0;
-      }
+    /**
+     * @brief Compute the contribution of this process to the square of the global Euclidean norm.
+     *
+     * No communication takes place.
+     *
+     * @param x The vector to compute the norm of.
+     */
+    template<class T1>
+    typename FieldTraits<typename T1::field_type>::real_type localNorm2 (const T1& x) const
+    {
+      using real_type = typename FieldTraits<typename T1::field_type>::real_type;
+      updateMask(x.size());
       auto result = real_type(0.0);
       for (typename T1::size_type i=0; i<x.size(); i++)
         result += Impl::asVector(x[i]).two_norm2()*mask[i];
-      using std::sqrt;
-      return sqrt(cc.sum(result));
+      return result;
     }
 
     typedef Dune::EnumItem<AttributeSet,OwnerOverlapCopyAttributeSet::copy> CopyFlags;
@@ -687,6 +718,43 @@ namespace Dune {
     mutable IF CopyToAllInterface;
     mutable bool CopyToAllInterfaceBuilt;
     mutable std::vector<double> mask;
+
+    // set up mask vector, which is 1 for the owned entries and 0 otherwise
+    void updateMask (std::size_t size) const
+    {
+      if (mask.size()!=static_cast<typename std::vector<double>::size_type>(size))
+      {
+        mask.resize(size);
+        for (typename std::vector<double>::size_type i=0; i<mask.size(); i++)
+          mask[i] = 1;
+        for (typename PIS::const_iterator i=pis.begin(); i!=pis.end(); ++i)
+          if (i->local().attribute()!=OwnerOverlapCopyAttributeSet::owner)
+            mask[i->local().local()] = 0;
+      }
+    }
+
+    // the estimated number of bytes sent and received by a communication of T over an interface
+    template<class T>
+    static double communicatedBytes (const IF& interface, const T& source, const T& dest)
+    {
+      typedef CommPolicy<T> Policy;
+      std::size_t entries = 0;
+      for (const auto& remote : interface.interfaces())
+      {
+        if constexpr (std::is_same<typename Policy::IndexedTypeFlag,SizeOne>::value)
+          entries += remote.second.first.size() + remote.second.second.size();
+        else
+        {
+          // variable sized entries, e.g. of a VariableBlockVector
+          for (std::size_t i=0; i<remote.second.first.size(); ++i)
+            entries += Policy::getSize(source, remote.second.first[i]);
+          for (std::size_t i=0; i<remote.second.second.size(); ++i)
+            entries += Policy::getSize(dest, remote.second.second[i]);
+        }
+      }
+      return double(entries)*sizeof(typename Policy::IndexedType);
+    }
+
     int oldseqNo;
     GlobalLookupIndexSet* globalLookup_;
     const SolverCategory::Category category_;
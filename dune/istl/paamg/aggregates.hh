@@ -18,13 +18,18 @@
 #include <dune/common/ftraits.hh>
 #include <dune/common/scalarmatrixview.hh>
 
+#include <dune/istl/common/threadpool.hh>
+
 #include <utility>
 #include <set>
 #include <algorithm>
+#include <atomic>
 #include <complex>
+#include <cstdint>
 #include <limits>
 #include <ostream>
 #include <tuple>
+#include <vector>
 
 namespace Dune
 {
@@ -1393,6 +1398,104 @@ namespace Dune
       void growIsolatedAggregate(const Vertex& vertex, const AggregatesMap<Vertex>& aggregates, const C& c);
     };
 
+    /**
+     * @brief Class for building the aggregates with the threads of the global ThreadPool.
+     *
+     * The aggregates are built around the vertices of a maximal distance-two
+     * independent set (MIS-2) of the graph of strong connections, which is
+     * computed in synchronous rounds using pseudo-random vertex priorities
+     * (N. Bell, S. Dalton, L. Olson, "Exposing fine-grained parallelism in
+     * algebraic multigrid methods", SIAM J. Sci. Comput. 34, 2012).
+     * Each vertex of the set is aggregated with its strongly connected
+     * neighbours. The remaining vertices join the aggregate of a strongly
+     * connected neighbour. Isolated vertices are aggregated among each other
+     * in the same way, using all connections between them.
+     *
+     * All steps are Jacobi-like sweeps over the vertices, hence the aggregates
+     * do not depend on the number of threads. For isotropic problems their
+     * size is comparable to the ones built by Aggregator, but the limits for
+     * the size, the distance and the connectivity of the aggregates are not
+     * enforced. The dependency graph is computed sequentially.
+     *
+     * Used by AggregatesMap::buildAggregates() if
+     * AggregationParameters::threadedAggregation() is set.
+     */
+    template<class G>
+    class MISAggregator
+    {
+    public:
+
+      /**
+       * @brief The matrix graph type used.
+       */
+      typedef G MatrixGraph;
+
+      /**
+       * @brief The vertex identifier
+       */
+      typedef typename MatrixGraph::VertexDescriptor Vertex;
+
+      /** @brief The type of the aggregate descriptor. */
+      typedef typename MatrixGraph::VertexDescriptor AggregateDescriptor;
+
+      /**
+       * @brief Build the aggregates.
+       *
+       * \copydetails Aggregator::build
+       */
+      template<class M, class C>
+      std::tuple<int,int,int,int> build(const M& m, G& graph,
+                                        AggregatesMap<Vertex>& aggregates, const C& c,
+                                        bool finestLevel);
+
+    private:
+      /**
+       * @brief The kind of a vertex. Only vertices of the same kind are connected.
+       */
+      enum Kind : unsigned char { skipped, isolated, connected };
+
+      /**
+       * @brief The state of a vertex during the computation of the independent set.
+       */
+      enum State : unsigned char { removed, undecided, root };
+
+      /**
+       * @brief The ordering of the vertices, lexicographically by state, priority, and vertex.
+       */
+      typedef std::tuple<unsigned char,std::uint32_t,Vertex> Key;
+
+      /**
+       * @brief The minimum number of vertices processed by a thread.
+       */
+      static constexpr std::size_t minChunkSize = 1024;
+
+      /**
+       * @brief A pseudo-random priority of a vertex.
+       */
+      static std::uint32_t priority(const Vertex& vertex);
+
+      /**
+       * @brief Whether an edge starting at a vertex of a kind connects it to a vertex of its aggregate.
+       */
+      template<class E>
+      bool connects(const E& edge, Kind kind) const;
+
+      /**
+       * @brief Set the key of each vertex to the maximum of its key and the keys of its neighbours.
+       */
+      void propagate(G& graph, const std::vector<Key>& keys, std::vector<Key>& maxKeys) const;
+
+      /**
+       * @brief The vertices of the graph.
+       */
+      std::vector<Vertex> vertices_;
+
+      /**
+       * @brief The kind of each vertex.
+       */
+      std::vector<Kind> kind_;
+    };
+
 #ifndef DOXYGEN
 
     template<class M, class N>
@@ -2390,6 +2493,10 @@ namespace Dune
     std::tuple<int,int,int,int> AggregatesMap<V>::buildAggregates(const M& matrix, G& graph, const C& criterion,
                                                                   bool finestLevel)
     {
+      if (criterion.threadedAggregation()) {
+        MISAggregator<G> aggregator;
+        return aggregator.build(matrix, graph, *this, criterion, finestLevel);
+      }
       Aggregator<G> aggregator;
       return aggregator.build(matrix, graph, *this, criterion, finestLevel);
     }
@@ -2577,6 +2684,177 @@ namespace Dune
         return NullEntry;
     }
 
+    template<class G>
+    std::uint32_t MISAggregator<G>::priority(const Vertex& vertex)
+    {
+      // the output function of the splitmix64 generator
+      std::uint64_t z = static_cast<std::uint64_t>(vertex) + 0x9e3779b97f4a7c15ull;
+      z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+      z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+      return static_cast<std::uint32_t>((z ^ (z >> 31)) >> 32);
+    }
+
+    template<class G>
+    template<class E>
+    inline bool MISAggregator<G>::connects(const E& edge, Kind kind) const
+    {
+      return kind_[edge.target()] == kind && (kind == isolated || edge.properties().isStrong());
+    }
+
+    template<class G>
+    void MISAggregator<G>::propagate(G& graph, const std::vector<Key>& keys, std::vector<Key>& maxKeys) const
+    {
+      ThreadPool::instance().parallelFor(0, vertices_.size(), [&](std::size_t first, std::size_t last){
+        for(std::size_t i=first; i<last; ++i) {
+          const Vertex vertex = vertices_[i];
+          const Kind kind = kind_[vertex];
+          Key key = keys[vertex];
+          if(kind != skipped) {
+            const auto end = graph.endEdges(vertex);
+            for(auto edge = graph.beginEdges(vertex); edge != end; ++edge)
+              if(connects(edge, kind))
+                key = std::max(key, keys[edge.target()]);
+          }
+          maxKeys[vertex] = key;
+        }
+      }, minChunkSize);
+    }
+
+    template<class G>
+    template<class M, class C>
+    std::tuple<int,int,int,int> MISAggregator<G>::build(const M& m, G& graph, AggregatesMap<Vertex>& aggregates, const C& c,
+                                                        bool finestLevel)
+    {
+      ThreadPool& pool = ThreadPool::instance();
+      const Vertex none = AggregatesMap<Vertex>::UNAGGREGATED;
+
+      Timer watch;
+      watch.reset();
+
+      buildDependency(graph, m, c, finestLevel);
+
+      dverb<<"Build dependency took "<< watch.elapsed()<<" seconds."<<std::endl;
+
+      int skippedAggregates = 0;
+      vertices_.clear();
+      kind_.assign(aggregates.noVertices(), skipped);
+      std::vector<unsigned char> state(aggregates.noVertices(), removed);
+      typedef typename G::VertexIterator VertexIterator;
+      for(VertexIterator vertex = graph.begin(); vertex != graph.end(); ++vertex) {
+        vertices_.push_back(*vertex);
+        if(vertex.properties().excludedBorder() || (vertex.properties().isolated() && c.skipIsolated())) {
+          aggregates[*vertex] = AggregatesMap<Vertex>::ISOLATED;
+          ++skippedAggregates;
+        }else{
+          kind_[*vertex] = vertex.properties().isolated() ? isolated : connected;
+          state[*vertex] = undecided;
+        }
+      }
+
+      // Compute the independent set. In each round, the undecided vertices with the
+      // largest key within distance two become roots, and the undecided vertices
+      // within distance two of a root are removed.
+      std::vector<Key> keys(aggregates.noVertices()), maxKeys(aggregates.noVertices());
+      std::size_t rounds = 0;
+      for(std::atomic<bool> undecidedLeft(true); undecidedLeft; ++rounds) {
+        undecidedLeft = false;
+        pool.parallelFor(0, vertices_.size(), [&](std::size_t first, std::size_t last){
+          for(std::size_t i=first; i<last; ++i) {
+            const Vertex vertex = vertices_[i];
+            keys[vertex] = Key(state[vertex], state[vertex] == undecided ? priority(vertex) : 0, vertex);
+          }
+        }, minChunkSize);
+        propagate(graph, keys, maxKeys);
+        propagate(graph, maxKeys, keys);
+        pool.parallelFor(0, vertices_.size(), [&](std::size_t first, std::size_t last){
+          bool left = false;
+          for(std::size_t i=first; i<last; ++i) {
+            const Vertex vertex = vertices_[i];
+            if(state[vertex] != undecided)
+              continue;
+            if(std::get<2>(keys[vertex]) == vertex)
+              state[vertex] = root;
+            else if(std::get<0>(keys[vertex]) == root)
+              state[vertex] = removed;
+            else
+              left = true;
+          }
+          if(left)
+            undecidedLeft = true;
+        }, minChunkSize);
+      }
+
+      dverb<<"Independent set took "<<rounds<<" rounds and "<<watch.elapsed()<<" seconds."<<std::endl;
+
+      // Aggregate the roots with their neighbours, and the remaining vertices with
+      // an aggregated neighbour. Ties are broken by the priority of the roots.
+      std::vector<Vertex> rootOf(aggregates.noVertices(), none);
+      auto join = [&](const std::vector<Vertex>& roots, std::vector<Vertex>& newRoots, bool neighbours){
+        pool.parallelFor(0, vertices_.size(), [&](std::size_t first, std::size_t last){
+          for(std::size_t i=first; i<last; ++i) {
+            const Vertex vertex = vertices_[i];
+            const Kind kind = kind_[vertex];
+            if(kind == skipped || roots[vertex] != none)
+              continue;
+            Key best(removed, 0, none);
+            const auto end = graph.endEdges(vertex);
+            for(auto edge = graph.beginEdges(vertex); edge != end; ++edge) {
+              const Vertex candidate = neighbours ? roots[edge.target()] : edge.target();
+              if(connects(edge, kind) && candidate != none && (neighbours || state[candidate] == root))
+                best = std::max(best, Key(root, priority(candidate), candidate));
+            }
+            newRoots[vertex] = std::get<2>(best);
+          }
+        }, minChunkSize);
+      };
+      for(const Vertex& vertex : vertices_)
+        if(state[vertex] == root)
+          rootOf[vertex] = vertex;
+      join(rootOf, rootOf, false);
+      std::vector<Vertex> neighbourRootOf(rootOf);
+      join(rootOf, neighbourRootOf, true);
+
+      // Number the aggregates in the order of their first vertex. Vertices without
+      // aggregated neighbour form an aggregate on their own.
+      std::vector<Vertex> number(aggregates.noVertices(), none);
+      std::vector<std::size_t> sizes;
+      int conAggregates = 0, isoAggregates = 0, oneAggregates = 0;
+      for(const Vertex& vertex : vertices_) {
+        if(kind_[vertex] == skipped)
+          continue;
+        const Vertex r = neighbourRootOf[vertex] != none ? neighbourRootOf[vertex] : vertex;
+        if(number[r] == none) {
+          number[r] = sizes.size();
+          sizes.push_back(0);
+          if(kind_[vertex] == isolated)
+            ++isoAggregates;
+          else
+            ++conAggregates;
+        }
+        aggregates[vertex] = number[r];
+        ++sizes[number[r]];
+      }
+
+      std::size_t maxA=0, minA=1000000, avg=0;
+      for(std::size_t size : sizes) {
+        maxA = std::max(maxA, size);
+        minA = std::min(minA, size);
+        avg += size;
+        if(size == 1)
+          ++oneAggregates;
+      }
+
+      Dune::dinfo<<"connected aggregates: "<<conAggregates;
+      Dune::dinfo<<" isolated aggregates: "<<isoAggregates;
+      if(conAggregates+isoAggregates>0)
+        Dune::dinfo<<" one node aggregates: "<<oneAggregates<<" min size="
+                   <<minA<<" max size="<<maxA
+                   <<" avg="<<avg/(conAggregates+isoAggregates)<<std::endl;
+
+      return std::make_tuple(conAggregates+isoAggregates,isoAggregates,
+                             oneAggregates,skippedAggregates);
+    }
+
 #endif // DOXYGEN
 
     template<class V>
@@ -16,6 +16,7 @@
 #include <dune/istl/superlu.hh>
 #include <dune/istl/umfpack.hh>
 #include <dune/istl/solvertype.hh>
+#include <dune/istl/common/instrumentation.hh>
 #include <dune/common/typetraits.hh>
 #include <dune/common/exceptions.hh>
 #include <dune/common/scalarvectorview.hh>
@@ -174,6 +175,8 @@ namespace Dune
                                    | one vertex to another within the aggregate).
           minAggregateSize         | Minimum number of vertices an aggregate should consist of.
           maxAggregateSize         | Maximum number of vertices an aggregate should consist of.
+          threadedAggregation      | Whether to build the aggregates with the threaded MISAggregator
+                                   | (default false).
 
          See \ref ISTL_Factory for the ParameterTree layout and examples.
        */
@@ -216,19 +219,68 @@ namespace Dune
        * It is assumed that the coarsening for the changed fine level
        * matrix would yield the same aggregates. In this case it suffices
        * to recalculate all the Galerkin products for the matrices of the
-       * coarser levels.
+       * coarser levels. The smoothers and the coarse solver are not set up
+       * again, see updateMatrix() for that.
        */
       void recalculateHierarchy()
       {
         matrices_->recalculateGalerkin(NegateSet<typename PI::OwnerSet>());
       }
 
+      /**
+       * @brief Update the preconditioner for a new fine level matrix with the same sparsity pattern.
+       *
+       * The aggregates, the data redistribution and the sparsity patterns of
+       * the coarse level matrices are kept. Only the Galerkin products, the
+       * smoothers and the coarse solver are computed again. This is much cheaper
+       * than setting up a new AMG, e.g. for the matrices of a Newton iteration,
+       * but the convergence deteriorates if the aggregates built for the old
+       * matrix no longer fit the new one.
+       *
+       * Must not be called between pre() and post(). Copies of this AMG share
+       * the matrix hierarchy and have to be updated, too.
+       *
+       * @param fineOperator The operator of the new matrix. It has to use the
+       * parallel information the AMG was set up with.
+       * @throws ISTLError if the sparsity pattern of the new matrix differs from the old one.
+       */
+      void updateMatrix(std::shared_ptr<const Operator> fineOperator);
+
+      /**
+       * @copydoc updateMatrix(std::shared_ptr<const Operator>)
+       *
+       * The operator has to live as long as the AMG uses it.
+       */
+      void updateMatrix(const Operator& fineOperator);
+
+      /**
+       * @brief Update the preconditioner after the entries of the fine level matrix were changed in place.
+       *
+       * See updateMatrix(std::shared_ptr<const Operator>). The sparsity pattern
+       * cannot be checked here, i.e. it is an unchecked precondition that the
+       * matrix was not rebuilt with a different pattern.
+       */
+      void updateMatrix();
+
       /**
        * @brief Check whether the coarse solver used is a direct solver.
        * @return True if the coarse level solver is a direct solver.
        */
       bool usesDirectCoarseLevelSolver() const;
 
+      /**
+       * @brief Get the memory held by the preconditioner.
+       *
+       * Besides the matrices, aggregates maps and redistributions of the
+       * matrix hierarchy the smoothers and the coarse solver are included.
+       * The vectors of the cycle are only allocated between pre() and post().
+       * The aggregates maps cannot be freed as the transfer between the
+       * levels uses them.
+       *
+       * @return The memory of each level, starting with the finest one.
+       */
+      std::vector<LevelMemoryUsage> memoryUsage() const;
+
     private:
       /*
        * @brief Helper function to create hierarchies with parameter tree.
@@ -264,6 +316,11 @@ namespace Dune
       void createHierarchies(C& criterion,
                              const std::shared_ptr<const Operator>& matrixptr,
                              const PI& pinfo);
+
+      /**
+       * @brief Create the smoother and the solver of the coarsest level.
+       */
+      void createCoarseSolver();
       /**
        * @brief A struct that holds the context of the current level.
        *
@@ -591,6 +648,9 @@ namespace Dune
       if (configuration.hasKey("maxAggregateConnectivity"))
         criterion.setMaxConnectivity(configuration.get<std::size_t>("maxAggregateConnectivity"));
 
+      if (configuration.hasKey("threadedAggregation"))
+        criterion.setThreadedAggregation(configuration.get<bool>("threadedAggregation"));
+
       if (configuration.hasKey ("alpha"))
         criterion.setAlpha (configuration.get<double> ("alpha"));
 
@@ -626,13 +686,19 @@ namespace Dune
       typedef typename Matrix :: field_type field_type;
       enum SolverType { umfpack, superlu, none };
 
+      // The direct solvers operate on vectors with the field type of the matrix.
+      // If the matrix is stored in a different precision than the vectors
+      // (see MixedPrecisionMatrix), the iterative coarse solver is used.
+      static constexpr bool matchingFieldType =
+        std::is_same<field_type, typename Vector :: field_type>::value;
+
       static constexpr SolverType solver =
 #if DISABLE_AMG_DIRECTSOLVER
         none;
 #elif HAVE_SUITESPARSE_UMFPACK
-        UMFPackMethodChooser< field_type > :: valid ? umfpack : none ;
+        UMFPackMethodChooser< field_type > :: valid && matchingFieldType ? umfpack : none ;
 #elif HAVE_SUPERLU
-        superlu ;
+        matchingFieldType ? superlu : none ;
 #else
         none;
 #endif
@@ -700,6 +766,16 @@ namespace Dune
       // build the necessary smoother hierarchies
       matrices_->coarsenSmoother(*smoothers_, smootherArgs_);
 
+      createCoarseSolver();
+
+      if(verbosity_>0 && matrices_->parallelInformation().finest()->communicator().rank()==0)
+        std::cout<<"Building hierarchy of "<<matrices_->maxlevels()<<" levels "
+                 <<"(including coarse solver) took "<<watch.elapsed()<<" seconds."<<std::endl;
+    }
+
+    template<class M, class X, class S, class PI, class A>
+    void AMG<M,X,S,PI,A>::createCoarseSolver()
+    {
       // test whether we should solve on the coarse level. That is the case if we
       // have that level and if there was a redistribution on this level then our
       // communicator has to be valid (size()>0) as the smoother might try to communicate
@@ -723,8 +799,9 @@ namespace Dune
           cargs.setComm(*matrices_->parallelInformation().coarsest());
         }
 
-        coarseSmoother_ = ConstructionTraits<Smoother>::construct(cargs);
         scalarProduct_ = createScalarProduct<X>(cargs.getComm(),category());
+        // a smoother of the coarsest level is only needed by the iterative solver
+        coarseSmoother_.reset();
 
         typedef DirectSolverSelector< typename M::matrix_type, X > SolverSelector;
 
@@ -756,6 +833,7 @@ namespace Dune
         }
         else
         {
+          coarseSmoother_ = ConstructionTraits<Smoother>::construct(cargs);
           if(matrices_->parallelInformation().coarsest().isRedistributed())
           {
             if(matrices_->matrices().coarsest().getRedistributed().getmat().N()>0)
@@ -790,9 +868,35 @@ namespace Dune
           }
         }
       }
+    }
+
+    template<class M, class X, class S, class PI, class A>
+    void AMG<M,X,S,PI,A>::updateMatrix(std::shared_ptr<const Operator> fineOperator)
+    {
+      matrices_->replaceFineMatrix(std::const_pointer_cast<Operator>(fineOperator));
+      updateMatrix();
+    }
+
+    template<class M, class X, class S, class PI, class A>
+    void AMG<M,X,S,PI,A>::updateMatrix(const Operator& fineOperator)
+    {
+      updateMatrix(stackobject_to_shared_ptr(fineOperator));
+    }
+
+    template<class M, class X, class S, class PI, class A>
+    void AMG<M,X,S,PI,A>::updateMatrix()
+    {
+      Timer watch;
+      matrices_->recalculateGalerkin(NegateSet<typename PI::OwnerSet>());
+
+      // the smoothers and the coarse solver keep their own copies or
+      // factorizations of the matrices, hence they have to be set up again
+      smoothers_ = std::make_shared<Hierarchy<Smoother,A> >();
+      matrices_->coarsenSmoother(*smoothers_, smootherArgs_);
+      createCoarseSolver();
 
       if(verbosity_>0 && matrices_->parallelInformation().finest()->communicator().rank()==0)
-        std::cout<<"Building hierarchy of "<<matrices_->maxlevels()<<" levels "
+        std::cout<<"Updating hierarchy of "<<matrices_->maxlevels()<<" levels "
                  <<"(including coarse solver) took "<<watch.elapsed()<<" seconds."<<std::endl;
     }
 
@@ -1026,10 +1130,42 @@ namespace Dune
       return IsDirectSolver< CoarseSolver>::value;
     }
 
+    template<class M, class X, class S, class PI, class A>
+    std::vector<LevelMemoryUsage> AMG<M,X,S,PI,A>::memoryUsage() const
+    {
+      std::vector<LevelMemoryUsage> usage = matrices_->memoryUsage();
+
+      typename Hierarchy<Smoother,A>::ConstIterator smoother = smoothers_->finest();
+      for(std::size_t level=0; level < smoothers_->levels(); ++level, ++smoother)
+        usage[level].smoother = Dune::memoryUsage(*smoother);
+
+      if(lhs_) {
+        auto addVectors = [&](const auto& hierarchy) {
+          auto vector = hierarchy.finest();
+          for(std::size_t level=0; level < hierarchy.levels(); ++level, ++vector) {
+            usage[level].vectors += Dune::memoryUsage(*vector);
+            if(vector.isRedistributed())
+              usage[level].vectors += Dune::memoryUsage(vector.getRedistributed());
+          }
+        };
+        addVectors(*rhs_);
+        addVectors(*lhs_);
+        addVectors(*update_);
+      }
+
+      if(solver_)
+        usage.back().coarseSolver += Dune::memoryUsage(*solver_);
+      if(coarseSmoother_)
+        usage.back().coarseSolver += Dune::memoryUsage(*coarseSmoother_);
+      return usage;
+    }
+
     template<class M, class X, class S, class PI, class A>
     void AMG<M,X,S,PI,A>::mgc(LevelContext& levelContext){
+      Instrumentation::Scope levelScope("level", levelContext.level);
       if(levelContext.matrix == matrices_->matrices().coarsest() && levels()==maxlevels()) {
         // Solve directly
+        Instrumentation::Scope scope("coarse solve");
         InverseOperatorResult res;
         res.converged=true; // If we do not compute this flag will not get updated
         if(levelContext.redist->isSetup()) {
@@ -1052,10 +1188,17 @@ namespace Dune
           coarsesolverconverged = false;
       }else{
         // presmoothing
-        presmooth(levelContext, preSteps_);
+        {
+          Instrumentation::Scope scope("presmooth");
+          presmooth(levelContext, preSteps_);
+        }
 
 #ifndef DUNE_AMG_NO_COARSEGRIDCORRECTION
-        bool processNextLevel = moveToCoarseLevel(levelContext);
+        bool processNextLevel;
+        {
+          Instrumentation::Scope scope("restriction");
+          processNextLevel = moveToCoarseLevel(levelContext);
+        }
 
         if(processNextLevel) {
           // next level
@@ -1069,7 +1212,10 @@ namespace Dune
           }
         }
 
-        moveToFineLevel(levelContext, processNextLevel);
+        {
+          Instrumentation::Scope scope("prolongation");
+          moveToFineLevel(levelContext, processNextLevel);
+        }
 #else
         *lhs=0;
 #endif
@@ -1080,7 +1226,10 @@ namespace Dune
             DUNE_THROW(MathError, "Coarse solver did not converge");
         }
         // postsmoothing
-        postsmooth(levelContext, postSteps_);
+        {
+          Instrumentation::Scope scope("postsmooth");
+          postsmooth(levelContext, postSteps_);
+        }
 
       }
     }
@@ -1192,6 +1341,14 @@ namespace Dune
         return std::make_shared<Amg::AMG<OP, X, SeqJac<M,X,Y>>>(op, config);
       if(smoother == "gs")
         return std::make_shared<Amg::AMG<OP, X, SeqGS<M,X,Y>>>(op, config);
+      if(smoother == "multicolorssor")
+        return std::make_shared<Amg::AMG<OP, X, SeqMulticolorSSOR<M,X,Y>>>(op, config);
+      if(smoother == "multicolorsor")
+        return std::make_shared<Amg::AMG<OP, X, SeqMulticolorSOR<M,X,Y>>>(op, config);
+      if(smoother == "chebyshev")
+        return std::make_shared<Amg::AMG<OP, X, SeqChebyshev<M,X,Y>>>(op, config);
+      if(smoother == "fsai")
+        return std::make_shared<Amg::AMG<OP, X, SeqFSAI<M,X,Y>>>(op, config);
       if(smoother == "ilu")
         return std::make_shared<Amg::AMG<OP, X, SeqILU<M,X,Y>>>(op, config);
       else
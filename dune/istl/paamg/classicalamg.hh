@@ -0,0 +1,805 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_AMG_CLASSICALAMG_HH
+#define DUNE_AMG_CLASSICALAMG_HH
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <queue>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/fmatrix.hh>
+#include <dune/common/timer.hh>
+
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/istlexception.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/preconditioner.hh>
+#include <dune/istl/scalarproducts.hh>
+#include <dune/istl/solvers.hh>
+#include <dune/istl/common/instrumentation.hh>
+#include <dune/istl/paamg/amg.hh>
+#include <dune/istl/paamg/parameters.hh>
+#include <dune/istl/paamg/smoothedaggregation.hh>
+#include <dune/istl/paamg/smoother.hh>
+
+/** @file
+ * @brief A sequential classical (Ruge-Stüben) algebraic multigrid.
+ *
+ * The unknowns are split into coarse (C) and fine (F) points based on the
+ * strong negative couplings of the matrix. The coarse points are kept on the
+ * next level and the fine points are interpolated from them.
+ */
+
+namespace Dune
+{
+  namespace Amg
+  {
+    /**
+     * @addtogroup ISTL_PAAMG
+     *
+     * @{
+     */
+
+    /**
+     * @brief The strong connections of a matrix in compressed row storage.
+     *
+     * Row i contains the unknowns j that i strongly depends on.
+     */
+    struct StrongConnections
+    {
+      std::vector<std::size_t> offsets;
+      std::vector<std::size_t> columns;
+
+      //! @brief The number of rows.
+      std::size_t size() const
+      {
+        return offsets.empty() ? 0 : offsets.size()-1;
+      }
+
+      const std::size_t* begin(std::size_t i) const
+      {
+        return columns.data() + offsets[i];
+      }
+
+      const std::size_t* end(std::size_t i) const
+      {
+        return columns.data() + offsets[i+1];
+      }
+
+      //! @brief The number of unknowns i strongly depends on.
+      std::size_t count(std::size_t i) const
+      {
+        return offsets[i+1] - offsets[i];
+      }
+
+      //! @brief The transposed connections, row i contains the unknowns depending on i.
+      StrongConnections transposed() const
+      {
+        StrongConnections t;
+        t.offsets.assign(size()+1, 0);
+        for (std::size_t j : columns)
+          ++t.offsets[j+1];
+        for (std::size_t i=0; i<size(); ++i)
+          t.offsets[i+1] += t.offsets[i];
+        t.columns.resize(columns.size());
+        std::vector<std::size_t> position(t.offsets.begin(), t.offsets.end()-1);
+        for (std::size_t i=0; i<size(); ++i)
+          for (const std::size_t* j=begin(i); j!=end(i); ++j)
+            t.columns[position[*j]++] = i;
+        return t;
+      }
+    };
+
+    //! @brief The classification of the unknowns by the coarsening.
+    enum class CFMarker : signed char { undecided = 0, coarse = 1, fine = -1 };
+
+    //! @brief The algorithms for the C/F splitting.
+    enum class ClassicalCoarsening { rugeStueben, pmis };
+
+    //! @brief The interpolation of the fine points from the coarse points.
+    enum class ClassicalInterpolation { direct, extendedPlusI };
+
+    /**
+     * @brief The parameters of the classical AMG.
+     *
+     * Extends the Parameters of the aggregation based AMG, of which the
+     * coarsening limits and the number of smoothing steps are used, by
+     * the parameters of the C/F splitting and of the interpolation.
+     */
+    class ClassicalCriterion : public Parameters
+    {
+    public:
+      /**
+       * @param maxLevel The maximum number of levels.
+       * @param coarsenTarget The coarsening stops below this number of unknowns.
+       * @param minCoarsenRate The coarsening stops if the rate falls below this threshold.
+       */
+      ClassicalCriterion(int maxLevel=100, int coarsenTarget=1000, double minCoarsenRate=1.2)
+        : Parameters(maxLevel, coarsenTarget, minCoarsenRate),
+          strengthThreshold_(0.25), coarsening_(ClassicalCoarsening::rugeStueben),
+          interpolation_(ClassicalInterpolation::direct)
+      {}
+
+      /**
+       * @brief Set the threshold of strong couplings.
+       *
+       * Unknown i strongly depends on j if \f$-a_{ij} \geq \theta \max_{k\neq i} -a_{ik}\f$.
+       * The default is 0.25, for three-dimensional problems 0.5 is often better.
+       */
+      void setStrengthThreshold(double theta)
+      {
+        strengthThreshold_ = theta;
+      }
+
+      double strengthThreshold() const
+      {
+        return strengthThreshold_;
+      }
+
+      /**
+       * @brief Set the algorithm of the C/F splitting.
+       *
+       * Ruge-Stüben coarsening (the default) ensures that strongly connected
+       * fine points share a coarse point, as direct interpolation needs.
+       * PMIS produces far fewer coarse points, but should be combined with
+       * the extended+i interpolation.
+       */
+      void setCoarsening(ClassicalCoarsening coarsening)
+      {
+        coarsening_ = coarsening;
+      }
+
+      ClassicalCoarsening coarsening() const
+      {
+        return coarsening_;
+      }
+
+      //! @brief Set the interpolation, direct by default.
+      void setInterpolation(ClassicalInterpolation interpolation)
+      {
+        interpolation_ = interpolation;
+      }
+
+      ClassicalInterpolation interpolation() const
+      {
+        return interpolation_;
+      }
+
+    private:
+      double strengthThreshold_;
+      ClassicalCoarsening coarsening_;
+      ClassicalInterpolation interpolation_;
+    };
+
+    namespace ClassicalAMGImpl
+    {
+      // The scalar entry of a 1x1 block
+      template<class B>
+      auto value (const B& block)
+      {
+        return block[0][0];
+      }
+
+      // Build a matrix with 1x1 blocks from compressed row storage
+      template<class K, class A>
+      void buildMatrix(BCRSMatrix<FieldMatrix<K,1,1>,A>& matrix, std::size_t cols,
+                       const std::vector<std::size_t>& offsets, const std::vector<std::size_t>& columns,
+                       const std::vector<K>& values)
+      {
+        typedef BCRSMatrix<FieldMatrix<K,1,1>,A> Matrix;
+        const std::size_t rows = offsets.size()-1;
+        matrix.setSize(rows, cols);
+        matrix.setBuildMode(Matrix::random);
+        for (std::size_t i=0; i<rows; ++i)
+          matrix.setrowsize(i, offsets[i+1]-offsets[i]);
+        matrix.endrowsizes();
+        for (std::size_t i=0; i<rows; ++i)
+          matrix.setIndices(i, columns.begin()+offsets[i], columns.begin()+offsets[i+1]);
+        matrix.endindices();
+        for (std::size_t i=0; i<rows; ++i)
+          for (std::size_t p=offsets[i]; p<offsets[i+1]; ++p)
+            matrix[i][columns[p]] = values[p];
+      }
+
+      // A reproducible pseudo random number in [0,1)
+      inline double random(std::size_t i)
+      {
+        std::uint64_t x = i + 0x9e3779b97f4a7c15ull;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+        x = x ^ (x >> 31);
+        return double(x >> 11) / double(std::uint64_t(1) << 53);
+      }
+    } // end namespace ClassicalAMGImpl
+
+    /**
+     * @brief Determine the strong negative couplings of a matrix with 1x1 blocks.
+     *
+     * Unknown i strongly depends on j if \f$-a_{ij} \geq \theta \max_{k\neq i} -a_{ik}\f$.
+     */
+    template<class M>
+    StrongConnections strongConnections(const M& matrix, double theta)
+    {
+      using ClassicalAMGImpl::value;
+      typedef typename FieldTraits<typename M::field_type>::real_type real_type;
+      StrongConnections s;
+      s.offsets.reserve(matrix.N()+1);
+      s.offsets.push_back(0);
+      for (auto row = matrix.begin(); row != matrix.end(); ++row)
+      {
+        real_type maximum = 0;
+        for (auto entry = row->begin(); entry != row->end(); ++entry)
+          if (entry.index() != row.index())
+            maximum = std::max(maximum, real_type(-value(*entry)));
+        if (maximum > 0)
+          for (auto entry = row->begin(); entry != row->end(); ++entry)
+            if (entry.index() != row.index() && -value(*entry) >= theta*maximum)
+              s.columns.push_back(entry.index());
+        s.offsets.push_back(s.columns.size());
+      }
+      return s;
+    }
+
+    /**
+     * @brief The classical Ruge-Stüben C/F splitting.
+     *
+     * The first pass repeatedly makes the undecided unknown that most other
+     * undecided unknowns strongly depend on a coarse point and the unknowns
+     * depending on it fine points. The optional second pass turns fine points
+     * into coarse points until each pair of strongly connected fine points
+     * shares a coarse point. Unknowns without strong connections become fine
+     * points without interpolation.
+     *
+     * @param s The strong connections.
+     * @param secondPass Whether to perform the second pass.
+     * @return The markers of the unknowns.
+     */
+    inline std::vector<CFMarker> rugeStuebenSplitting(const StrongConnections& s, bool secondPass=true)
+    {
+      const std::size_t n = s.size();
+      const StrongConnections st = s.transposed();
+      std::vector<CFMarker> marker(n, CFMarker::undecided);
+      std::vector<std::size_t> measure(n);
+      std::priority_queue<std::pair<std::size_t,std::size_t> > queue;
+      for (std::size_t i=0; i<n; ++i)
+      {
+        if (s.count(i) == 0 && st.count(i) == 0)
+          marker[i] = CFMarker::fine;
+        else
+        {
+          measure[i] = st.count(i);
+          queue.emplace(measure[i], n-i);
+        }
+      }
+
+      // first pass, the queue may contain outdated measures which are skipped
+      while (!queue.empty())
+      {
+        const auto [lambda, key] = queue.top();
+        queue.pop();
+        const std::size_t i = n-key;
+        if (marker[i] != CFMarker::undecided || lambda != measure[i])
+          continue;
+        if (lambda == 0 && s.count(i) == 0)
+        {
+          marker[i] = CFMarker::fine;
+          continue;
+        }
+        marker[i] = CFMarker::coarse;
+        for (const std::size_t* j=st.begin(i); j!=st.end(i); ++j)
+          if (marker[*j] == CFMarker::undecided)
+          {
+            marker[*j] = CFMarker::fine;
+            for (const std::size_t* k=s.begin(*j); k!=s.end(*j); ++k)
+              if (marker[*k] == CFMarker::undecided)
+                queue.emplace(++measure[*k], n-*k);
+          }
+        for (const std::size_t* j=s.begin(i); j!=s.end(i); ++j)
+          if (marker[*j] == CFMarker::undecided && measure[*j] > 0)
+            queue.emplace(--measure[*j], n-*j);
+      }
+
+      if (!secondPass)
+        return marker;
+
+      // second pass: strongly connected fine points need a common coarse point
+      std::vector<std::size_t> owner(n, std::size_t(-1));
+      for (std::size_t i=0; i<n; ++i)
+      {
+        if (marker[i] != CFMarker::fine)
+          continue;
+        for (const std::size_t* j=s.begin(i); j!=s.end(i); ++j)
+          if (marker[*j] == CFMarker::coarse)
+            owner[*j] = i;
+        std::size_t tentative = std::size_t(-1);
+        for (const std::size_t* j=s.begin(i); j!=s.end(i); ++j)
+        {
+          if (marker[*j] != CFMarker::fine)
+            continue;
+          bool common = false;
+          for (const std::size_t* k=s.begin(*j); k!=s.end(*j) && !common; ++k)
+            common = owner[*k] == i;
+          if (common)
+            continue;
+          if (tentative != std::size_t(-1))
+          {
+            // a second neighbour without common coarse point, i becomes coarse instead
+            marker[i] = CFMarker::coarse;
+            tentative = std::size_t(-1);
+            break;
+          }
+          tentative = *j;
+          owner[*j] = i;
+        }
+        if (tentative != std::size_t(-1))
+          marker[tentative] = CFMarker::coarse;
+        // tentative coarse points may be marked as owned by i, reset them
+        for (const std::size_t* j=s.begin(i); j!=s.end(i); ++j)
+          owner[*j] = std::size_t(-1);
+      }
+      return marker;
+    }
+
+    /**
+     * @brief The parallel modified independent set (PMIS) C/F splitting.
+     *
+     * Each unknown gets the weight of the number of unknowns strongly
+     * depending on it plus a reproducible random number. Unknowns that
+     * nobody depends on become fine points. Then the undecided unknowns
+     * with a weight larger than the ones of all their undecided strong
+     * neighbours become coarse points and the unknowns depending on them
+     * fine points, until all unknowns are decided. As the selection of each
+     * round only depends on the previous round, it can be done in parallel.
+     *
+     * @param s The strong connections.
+     * @return The markers of the unknowns.
+     */
+    inline std::vector<CFMarker> pmisSplitting(const StrongConnections& s)
+    {
+      const std::size_t n = s.size();
+      const StrongConnections st = s.transposed();
+      std::vector<CFMarker> marker(n, CFMarker::undecided);
+      std::vector<double> weight(n);
+      std::vector<std::size_t> undecided;
+      for (std::size_t i=0; i<n; ++i)
+      {
+        weight[i] = st.count(i) + ClassicalAMGImpl::random(i);
+        if (weight[i] < 1.0)
+          marker[i] = CFMarker::fine;
+        else
+          undecided.push_back(i);
+      }
+
+      std::vector<std::size_t> selected;
+      while (!undecided.empty())
+      {
+        selected.clear();
+        auto isMaximal = [&](std::size_t i, const StrongConnections& c) {
+          for (const std::size_t* j=c.begin(i); j!=c.end(i); ++j)
+            if (marker[*j] == CFMarker::undecided && weight[*j] >= weight[i] && *j != i)
+              return false;
+          return true;
+        };
+        for (std::size_t i : undecided)
+          if (isMaximal(i, s) && isMaximal(i, st))
+            selected.push_back(i);
+        for (std::size_t i : selected)
+          marker[i] = CFMarker::coarse;
+        for (std::size_t i : selected)
+          for (const std::size_t* j=st.begin(i); j!=st.end(i); ++j)
+            if (marker[*j] == CFMarker::undecided)
+              marker[*j] = CFMarker::fine;
+        undecided.erase(std::remove_if(undecided.begin(), undecided.end(),
+                                       [&](std::size_t i) { return marker[i] != CFMarker::undecided; }),
+                        undecided.end());
+      }
+      return marker;
+    }
+
+    /**
+     * @brief Number the coarse points consecutively.
+     *
+     * @return The coarse index of each coarse point, std::size_t(-1) for fine points.
+     */
+    inline std::vector<std::size_t> coarseIndices(const std::vector<CFMarker>& marker, std::size_t& coarseSize)
+    {
+      std::vector<std::size_t> index(marker.size(), std::size_t(-1));
+      coarseSize = 0;
+      for (std::size_t i=0; i<marker.size(); ++i)
+        if (marker[i] == CFMarker::coarse)
+          index[i] = coarseSize++;
+      return index;
+    }
+
+    /**
+     * @brief The direct interpolation of classical AMG.
+     *
+     * A fine point i is interpolated from its strongly coupled coarse points
+     * \f$P_i\f$ with \f$w_{ij} = -\alpha_i a_{ij}/a_{ii}\f$ for negative and
+     * \f$w_{ij} = -\beta_i a_{ij}/a_{ii}\f$ for positive couplings, where
+     * \f$\alpha_i\f$ and \f$\beta_i\f$ are the ratios of the sums of all
+     * negative and positive couplings to the ones to \f$P_i\f$. Positive
+     * couplings are added to the diagonal if \f$P_i\f$ has none.
+     *
+     * @param matrix The matrix with 1x1 blocks.
+     * @param s The strong connections of the matrix.
+     * @param marker The C/F splitting.
+     * @param prolongation An empty matrix filled with the interpolation.
+     */
+    template<class M, class P>
+    void directInterpolation(const M& matrix, const StrongConnections& s,
+                             const std::vector<CFMarker>& marker, P& prolongation)
+    {
+      using ClassicalAMGImpl::value;
+      typedef typename M::field_type K;
+      std::size_t coarseSize;
+      const std::vector<std::size_t> index = coarseIndices(marker, coarseSize);
+      std::vector<bool> strong(matrix.N(), false);
+      std::vector<std::size_t> offsets(1, 0), columns;
+      std::vector<K> values;
+
+      for (auto row = matrix.begin(); row != matrix.end(); ++row)
+      {
+        const std::size_t i = row.index();
+        if (marker[i] == CFMarker::coarse)
+        {
+          columns.push_back(index[i]);
+          values.push_back(1);
+          offsets.push_back(columns.size());
+          continue;
+        }
+        for (const std::size_t* j=s.begin(i); j!=s.end(i); ++j)
+          strong[*j] = marker[*j] == CFMarker::coarse;
+
+        K diagonal = 0, negative = 0, positive = 0, negativeP = 0, positiveP = 0;
+        for (auto entry = row->begin(); entry != row->end(); ++entry)
+        {
+          const K a = value(*entry);
+          if (entry.index() == i)
+            diagonal = a;
+          else
+          {
+            (a < 0 ? negative : positive) += a;
+            if (strong[entry.index()])
+              (a < 0 ? negativeP : positiveP) += a;
+          }
+        }
+        if (positiveP == K(0))
+          diagonal += positive;
+        const K alpha = negativeP != K(0) ? negative/negativeP : K(0);
+        const K beta = positiveP != K(0) ? positive/positiveP : K(0);
+        for (auto entry = row->begin(); entry != row->end(); ++entry)
+          if (strong[entry.index()])
+          {
+            const K a = value(*entry);
+            columns.push_back(index[entry.index()]);
+            values.push_back(-(a < 0 ? alpha : beta)*a/diagonal);
+          }
+        offsets.push_back(columns.size());
+        for (const std::size_t* j=s.begin(i); j!=s.end(i); ++j)
+          strong[*j] = false;
+      }
+      ClassicalAMGImpl::buildMatrix(prolongation, coarseSize, offsets, columns, values);
+    }
+
+    /**
+     * @brief The extended+i interpolation.
+     *
+     * A fine point i is interpolated from the set \f$\hat C_i\f$ of its strongly
+     * coupled coarse points and the strongly coupled coarse points of its
+     * strongly coupled fine points. The couplings to a strong fine neighbour k
+     * are distributed to \f$\hat C_i\cup\{i\}\f$ proportionally to the couplings
+     * of k with the opposite sign of its diagonal, the weak couplings are added
+     * to the diagonal (De Sterck, Falgout, Nolting, Yang, 2008). It is suitable
+     * for the sparse C/F splittings of PMIS.
+     *
+     * @param matrix The matrix with 1x1 blocks.
+     * @param s The strong connections of the matrix.
+     * @param marker The C/F splitting.
+     * @param prolongation An empty matrix filled with the interpolation.
+     */
+    template<class M, class P>
+    void extendedPlusIInterpolation(const M& matrix, const StrongConnections& s,
+                                    const std::vector<CFMarker>& marker, P& prolongation)
+    {
+      using ClassicalAMGImpl::value;
+      typedef typename M::field_type K;
+      const std::size_t n = matrix.N();
+      std::size_t coarseSize;
+      const std::vector<std::size_t> index = coarseIndices(marker, coarseSize);
+      // the position of an unknown of the interpolation set in the current row
+      std::vector<std::size_t> position(n, std::size_t(-1));
+      std::vector<bool> strongFine(n, false);
+      std::vector<std::size_t> offsets(1, 0), columns, set;
+      std::vector<K> values, weights;
+
+      for (auto row = matrix.begin(); row != matrix.end(); ++row)
+      {
+        const std::size_t i = row.index();
+        if (marker[i] == CFMarker::coarse)
+        {
+          columns.push_back(index[i]);
+          values.push_back(1);
+          offsets.push_back(columns.size());
+          continue;
+        }
+
+        // the interpolation set and the strong fine neighbours
+        set.clear();
+        auto insert = [&](std::size_t j) {
+          if (marker[j] == CFMarker::coarse && position[j] == std::size_t(-1))
+          {
+            position[j] = set.size();
+            set.push_back(j);
+          }
+        };
+        for (const std::size_t* j=s.begin(i); j!=s.end(i); ++j)
+        {
+          insert(*j);
+          if (marker[*j] == CFMarker::fine)
+          {
+            strongFine[*j] = true;
+            for (const std::size_t* k=s.begin(*j); k!=s.end(*j); ++k)
+              insert(*k);
+          }
+        }
+        weights.assign(set.size(), K(0));
+
+        K diagonal = 0;
+        for (auto entry = row->begin(); entry != row->end(); ++entry)
+        {
+          const std::size_t j = entry.index();
+          const K a = value(*entry);
+          if (j == i)
+            diagonal += a;
+          else if (position[j] != std::size_t(-1))
+            weights[position[j]] += a;
+          else if (strongFine[j])
+          {
+            // distribute the coupling to the neighbours of j in the set and to i
+            const auto& rowK = matrix[j];
+            const K akk = value(rowK[j]);
+            auto opposite = [&](const K& akl) { return (akl < 0) != (akk < 0) ? akl : K(0); };
+            K sum = 0;
+            for (auto l = rowK.begin(); l != rowK.end(); ++l)
+              if (l.index() != j && (position[l.index()] != std::size_t(-1) || l.index() == i))
+                sum += opposite(value(*l));
+            if (sum == K(0))
+            {
+              diagonal += a;
+              continue;
+            }
+            for (auto l = rowK.begin(); l != rowK.end(); ++l)
+            {
+              if (l.index() == j)
+                continue;
+              if (position[l.index()] != std::size_t(-1))
+                weights[position[l.index()]] += a*opposite(value(*l))/sum;
+              else if (l.index() == i)
+                diagonal += a*opposite(value(*l))/sum;
+            }
+          }
+          else
+            diagonal += a;
+        }
+
+        for (std::size_t p=0; p<set.size(); ++p)
+          if (weights[p] != K(0))
+          {
+            columns.push_back(index[set[p]]);
+            values.push_back(-weights[p]/diagonal);
+          }
+        offsets.push_back(columns.size());
+
+        for (std::size_t j : set)
+          position[j] = std::size_t(-1);
+        for (const std::size_t* j=s.begin(i); j!=s.end(i); ++j)
+          strongFine[*j] = false;
+      }
+      ClassicalAMGImpl::buildMatrix(prolongation, coarseSize, offsets, columns, values);
+    }
+
+    /**
+     * @brief Compute the C/F splitting and the interpolation of a level.
+     *
+     * @param matrix The matrix with 1x1 blocks.
+     * @param criterion The parameters of the coarsening and the interpolation.
+     * @param prolongation An empty matrix filled with the interpolation.
+     * @return The number of coarse points.
+     */
+    template<class M, class P>
+    std::size_t classicalCoarsening(const M& matrix, const ClassicalCriterion& criterion, P& prolongation)
+    {
+      const StrongConnections s = strongConnections(matrix, criterion.strengthThreshold());
+      const std::vector<CFMarker> marker = criterion.coarsening() == ClassicalCoarsening::rugeStueben
+        ? rugeStuebenSplitting(s) : pmisSplitting(s);
+      if (criterion.interpolation() == ClassicalInterpolation::direct)
+        directInterpolation(matrix, s, marker, prolongation);
+      else
+        extendedPlusIInterpolation(matrix, s, marker, prolongation);
+      return prolongation.M();
+    }
+
+    /**
+     * @brief A sequential classical algebraic multigrid.
+     *
+     * The levels are built by a C/F splitting of the strong negative
+     * couplings, see ClassicalCriterion, with an explicit sparse interpolation
+     * P and the Galerkin products \f$P^TAP\f$ computed by matMultMat() and
+     * transposeMatMultMat(). The restriction is applied as \f$P^T\f$. All
+     * levels but the coarsest one use the smoother S, the coarsest level a
+     * direct solver if one is available, otherwise BiCGSTAB preconditioned
+     * with S. The hierarchy always has at least two levels. One V-cycle is
+     * performed per application.
+     *
+     * Classical AMG is mostly used for scalar elliptic problems with strongly
+     * varying coefficients, where it typically needs fewer iterations than
+     * aggregation.
+     *
+     * \tparam M The matrix operator type, e.g. MatrixAdapter, its matrix has
+     *           to be a BCRSMatrix with FieldMatrix<K,1,1> blocks.
+     * \tparam X The vector type.
+     * \tparam S The smoother, e.g. SeqSSOR or SeqJac.
+     */
+    template<class M, class X, class S>
+    class ClassicalAMG : public Preconditioner<X,X>
+    {
+    public:
+      /** @brief The matrix operator type. */
+      typedef M Operator;
+      /** @brief The matrix type. */
+      typedef typename M::matrix_type Matrix;
+      /** @brief The domain type. */
+      typedef X Domain;
+      /** @brief The range type. */
+      typedef X Range;
+      typedef typename X::field_type field_type;
+      /** @brief The smoother type. */
+      typedef S Smoother;
+      typedef typename SmootherTraits<Smoother>::Arguments SmootherArgs;
+      /** @brief The type of the interpolation. */
+      typedef Matrix Prolongation;
+
+      static_assert(Matrix::block_type::rows == 1 && Matrix::block_type::cols == 1,
+                    "Classical AMG needs a matrix with 1x1 blocks");
+
+      /**
+       * @brief Set up the multigrid hierarchy.
+       *
+       * @param fineOperator The operator on the fine level.
+       * @param criterion The parameters of the coarsening and the cycle.
+       * @param smootherArgs The arguments of the smoothers.
+       */
+      ClassicalAMG(std::shared_ptr<const Operator> fineOperator,
+                   const ClassicalCriterion& criterion,
+                   const SmootherArgs& smootherArgs = SmootherArgs())
+        : operator_(std::move(fineOperator)), criterion_(criterion), smootherArgs_(smootherArgs)
+      {
+        build();
+      }
+
+      /**
+       * @copydoc ClassicalAMG(std::shared_ptr<const Operator>,const ClassicalCriterion&,const SmootherArgs&)
+       *
+       * The operator has to live as long as the preconditioner.
+       */
+      ClassicalAMG(const Operator& fineOperator,
+                   const ClassicalCriterion& criterion,
+                   const SmootherArgs& smootherArgs = SmootherArgs())
+        : ClassicalAMG(stackobject_to_shared_ptr(fineOperator), criterion, smootherArgs)
+      {}
+
+      /** \copydoc Preconditioner::pre */
+      void pre(Domain& x, Range& b) override
+      {
+        levels_.smoothers[0]->pre(x, b);
+        for (std::size_t l=1; l<levels_.smoothers.size(); ++l)
+          levels_.smoothers[l]->pre(levels_.corrections[l], levels_.defects[l]);
+      }
+
+      /** \copydoc Preconditioner::apply */
+      void apply(Domain& v, const Range& d) override
+      {
+        levels_.defects[0] = d;
+        levels_.cycle(0, criterion_.getNoPreSmoothSteps(), criterion_.getNoPostSmoothSteps(), 0);
+        v = levels_.corrections[0];
+      }
+
+      /** \copydoc Preconditioner::post */
+      void post(Domain& x) override
+      {
+        levels_.smoothers[0]->post(x);
+        for (std::size_t l=1; l<levels_.smoothers.size(); ++l)
+          levels_.smoothers[l]->post(levels_.corrections[l]);
+      }
+
+      //! Category of the preconditioner (see SolverCategory::Category)
+      SolverCategory::Category category() const override
+      {
+        return SolverCategory::sequential;
+      }
+
+      //! @brief The number of levels including the finest one.
+      std::size_t levels() const
+      {
+        return levels_.matrices.size();
+      }
+
+      /**
+       * @brief The matrix of a level.
+       * @param level The level, from 0 for the finest to levels()-1.
+       */
+      const Matrix& matrix(std::size_t level) const
+      {
+        return *levels_.matrices.at(level);
+      }
+
+      /**
+       * @brief The interpolation from a level to the next finer one.
+       * @param level The finer level, from 0 to levels()-2.
+       */
+      const Prolongation& prolongation(std::size_t level) const
+      {
+        return *levels_.prolongations.at(level);
+      }
+
+    private:
+      typedef Impl::ExplicitTransferLevels<Matrix,X,Smoother> Levels;
+
+      void build()
+      {
+        Timer watch;
+        // the fine matrix is owned by the operator
+        levels_.matrices.emplace_back(operator_, &operator_->getmat());
+        while (true)
+        {
+          const Matrix& fine = *levels_.matrices.back();
+          auto prolongation = std::make_shared<Prolongation>();
+          const std::size_t coarseSize = classicalCoarsening(fine, criterion_, *prolongation);
+          if (coarseSize == 0 || (levels() > 1 && double(fine.N())/coarseSize < criterion_.minCoarsenRate()))
+            break;
+          auto coarse = std::make_shared<Matrix>();
+          galerkinProduct(fine, *prolongation, *coarse);
+
+          levels_.smoothers.push_back(Levels::createSmoother(fine, smootherArgs_));
+          levels_.prolongations.push_back(prolongation);
+          levels_.matrices.push_back(coarse);
+
+          if (levels() >= std::size_t(criterion_.maxLevel())
+              || coarse->N() <= std::size_t(criterion_.coarsenTarget()))
+            break;
+        }
+        if (levels() == 1)
+          DUNE_THROW(ISTLError, "Classical AMG could not coarsen the matrix");
+
+        // the restrictions are the transposed prolongations
+        levels_.finish(smootherArgs_);
+
+        if (criterion_.debugLevel() > 0)
+          std::cout << "Building classical AMG hierarchy of " << levels() << " levels took "
+                    << watch.elapsed() << " seconds." << std::endl;
+      }
+
+      std::shared_ptr<const Operator> operator_;
+      ClassicalCriterion criterion_;
+      SmootherArgs smootherArgs_;
+
+      //! All levels, starting with the finest one
+      Levels levels_;
+    };
+
+    /** @} */
+  } // namespace Amg
+} // namespace Dune
+
+#endif // DUNE_AMG_CLASSICALAMG_HH
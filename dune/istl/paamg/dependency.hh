@@ -7,6 +7,7 @@
 
 
 #include <bitset>
+#include <cstddef>
 #include <ostream>
 
 #include "graph.hh"
@@ -28,6 +29,53 @@ namespace Dune
      * @brief Provides classes for initializing the link attributes of a matrix graph.
      */
 
+    /**
+     * @brief Reference to a single bit of the flags of a vertex or edge.
+     *
+     * Behaves like std::bitset::reference, but refers to a plain byte.
+     */
+    class PropertyFlagReference
+    {
+    public:
+      PropertyFlagReference(unsigned char& flags, std::size_t bit)
+        : flags_(&flags), mask_(static_cast<unsigned char>(1u<<bit))
+      {}
+
+      PropertyFlagReference& operator=(bool value)
+      {
+        if(value)
+          *flags_ |= mask_;
+        else
+          *flags_ &= static_cast<unsigned char>(~mask_);
+        return *this;
+      }
+
+      PropertyFlagReference& operator=(const PropertyFlagReference& other)
+      {
+        return *this = bool(other);
+      }
+
+      operator bool() const
+      {
+        return *flags_ & mask_;
+      }
+
+      bool operator~() const
+      {
+        return !bool(*this);
+      }
+
+      PropertyFlagReference& flip()
+      {
+        *flags_ ^= mask_;
+        return *this;
+      }
+
+    private:
+      unsigned char* flags_;
+      unsigned char mask_;
+    };
+
     /**
      * @brief Class representing the properties of an edge in the matrix graph.
      *
@@ -42,15 +90,24 @@ namespace Dune
       /** @brief Flags of the link.*/
       enum {INFLUENCE, DEPEND, SIZE};
 
+      /** @brief The reference to a single flag. */
+      typedef PropertyFlagReference Reference;
+
     private:
 
-      std::bitset<SIZE> flags_;
+      /**
+       * @brief The flags, one bit each.
+       *
+       * A plain byte instead of std::bitset keeps the edge properties,
+       * of which there is one per matrix entry, at one byte each.
+       */
+      unsigned char flags_;
     public:
       /** @brief Constructor. */
       EdgeProperties();
 
       /** @brief Access the bits directly */
-      std::bitset<SIZE>::reference operator[](std::size_t v);
+      Reference operator[](std::size_t v);
 
       /** @brief Access the bits directly */
       bool operator[](std::size_t v) const;
@@ -127,17 +184,20 @@ namespace Dune
       friend std::ostream& operator<<(std::ostream& os, const VertexProperties& props);
     public:
       enum { ISOLATED, VISITED, FRONT, BORDER, SIZE };
+
+      /** @brief The reference to a single flag. */
+      typedef PropertyFlagReference Reference;
     private:
 
-      /** @brief The attribute flags. */
-      std::bitset<SIZE> flags_;
+      /** @brief The attribute flags, one bit each. */
+      unsigned char flags_;
 
     public:
       /** @brief Constructor. */
       VertexProperties();
 
       /** @brief Access the bits directly */
-      std::bitset<SIZE>::reference operator[](std::size_t v);
+      Reference operator[](std::size_t v);
 
       /** @brief Access the bits directly */
       bool operator[](std::size_t v) const;
@@ -215,7 +275,7 @@ namespace Dune
 
     template<typename G, std::size_t i>
     class PropertyGraphVertexPropertyMap
-      : public RAPropertyMapHelper<typename std::bitset<VertexProperties::SIZE>::reference,
+      : public RAPropertyMapHelper<VertexProperties::Reference,
             PropertyGraphVertexPropertyMap<G,i> >
     {
     public:
@@ -223,7 +283,7 @@ namespace Dune
       typedef ReadWritePropertyMapTag Category;
 
       enum {
-        /** @brief the index to access in the bitset. */
+        /** @brief the index to access in the flags. */
         index = i
       };
 
@@ -232,15 +292,10 @@ namespace Dune
        */
       typedef G Graph;
 
-      /**
-       * @brief The type of the bitset.
-       */
-      typedef std::bitset<VertexProperties::SIZE> BitSet;
-
       /**
        * @brief The reference type.
        */
-      typedef typename BitSet::reference Reference;
+      typedef VertexProperties::Reference Reference;
 
       /**
        * @brief The value type.
@@ -299,60 +354,57 @@ namespace Dune
   {
     inline std::ostream& operator<<(std::ostream& os, const EdgeProperties& props)
     {
-      return os << props.flags_;
+      return os << std::bitset<EdgeProperties::SIZE>(props.flags_);
     }
 
     inline EdgeProperties::EdgeProperties()
       : flags_()
     {}
 
-    inline std::bitset<EdgeProperties::SIZE>::reference
+    inline EdgeProperties::Reference
     EdgeProperties::operator[](std::size_t v)
     {
-      return flags_[v];
+      return Reference(flags_, v);
     }
 
     inline bool EdgeProperties::operator[](std::size_t i) const
     {
-      return flags_[i];
+      return flags_ & (1<<i);
     }
 
     inline void EdgeProperties::reset()
     {
-      flags_.reset();
+      flags_ = 0;
     }
 
     inline void EdgeProperties::setInfluences()
     {
       // Set the INFLUENCE bit
-      //flags_ |= (1<<INFLUENCE);
-      flags_.set(INFLUENCE);
+      flags_ |= (1<<INFLUENCE);
     }
 
     inline bool EdgeProperties::influences() const
     {
       // Test the INFLUENCE bit
-      return flags_.test(INFLUENCE);
+      return flags_ & (1<<INFLUENCE);
     }
 
     inline void EdgeProperties::setDepends()
     {
       // Set the first bit.
-      //flags_ |= (1<<DEPEND);
-      flags_.set(DEPEND);
+      flags_ |= (1<<DEPEND);
     }
 
     inline void EdgeProperties::resetDepends()
     {
       // reset the first bit.
-      //flags_ &= ~(1<<DEPEND);
-      flags_.reset(DEPEND);
+      flags_ &= ~(1<<DEPEND);
     }
 
     inline bool EdgeProperties::depends() const
     {
       // Return the first bit.
-      return flags_.test(DEPEND);
+      return flags_ & (1<<DEPEND);
     }
 
     inline void EdgeProperties::resetInfluences()
@@ -364,26 +416,25 @@ namespace Dune
     inline bool EdgeProperties::isOneWay() const
     {
       // Test whether only the first bit is set
-      //return isStrong() && !isTwoWay();
-      return ((flags_) & std::bitset<SIZE>((1<<INFLUENCE)|(1<<DEPEND)))==(1<<DEPEND);
+      return (flags_ & ((1<<INFLUENCE)|(1<<DEPEND)))==(1<<DEPEND);
     }
 
     inline bool EdgeProperties::isTwoWay() const
     {
       // Test whether the first and second bit is set
-      return ((flags_) & std::bitset<SIZE>((1<<INFLUENCE)|(1<<DEPEND)))==((1<<INFLUENCE)|(1<<DEPEND));
+      return (flags_ & ((1<<INFLUENCE)|(1<<DEPEND)))==((1<<INFLUENCE)|(1<<DEPEND));
     }
 
     inline bool EdgeProperties::isStrong() const
     {
       // Test whether the first or second bit is set
-      return ((flags_) & std::bitset<SIZE>((1<<INFLUENCE)|(1<<DEPEND))).to_ulong();
+      return flags_ & ((1<<INFLUENCE)|(1<<DEPEND));
     }
 
 
     inline std::ostream& operator<<(std::ostream& os, const VertexProperties& props)
     {
-      return os << props.flags_;
+      return os << std::bitset<VertexProperties::SIZE>(props.flags_);
     }
 
     inline VertexProperties::VertexProperties()
@@ -391,80 +442,80 @@ namespace Dune
     {}
 
 
-    inline std::bitset<VertexProperties::SIZE>::reference
+    inline VertexProperties::Reference
     VertexProperties::operator[](std::size_t v)
     {
-      return flags_[v];
+      return Reference(flags_, v);
     }
 
     inline bool VertexProperties::operator[](std::size_t v) const
     {
-      return flags_[v];
+      return flags_ & (1<<v);
     }
 
     inline void VertexProperties::setIsolated()
     {
-      flags_.set(ISOLATED);
+      flags_ |= (1<<ISOLATED);
     }
 
     inline bool VertexProperties::isolated() const
     {
-      return flags_.test(ISOLATED);
+      return flags_ & (1<<ISOLATED);
     }
 
     inline void VertexProperties::resetIsolated()
     {
-      flags_.reset(ISOLATED);
+      flags_ &= ~(1<<ISOLATED);
     }
 
     inline void VertexProperties::setVisited()
     {
-      flags_.set(VISITED);
+      flags_ |= (1<<VISITED);
     }
 
     inline bool VertexProperties::visited() const
     {
-      return flags_.test(VISITED);
+      return flags_ & (1<<VISITED);
     }
 
     inline void VertexProperties::resetVisited()
     {
-      flags_.reset(VISITED);
+      flags_ &= ~(1<<VISITED);
     }
 
     inline void VertexProperties::setFront()
     {
-      flags_.set(FRONT);
+      flags_ |= (1<<FRONT);
     }
 
     inline bool VertexProperties::front() const
     {
-      return flags_.test(FRONT);
+      return flags_ & (1<<FRONT);
     }
 
     inline void VertexProperties::resetFront()
     {
-      flags_.reset(FRONT);
+      flags_ &= ~(1<<FRONT);
     }
 
     inline void VertexProperties::setExcludedBorder()
     {
-      flags_.set(BORDER);
+      flags_ |= (1<<BORDER);
     }
 
     inline bool VertexProperties::excludedBorder() const
     {
-      return flags_.test(BORDER);
+      return flags_ & (1<<BORDER);
     }
 
     inline void VertexProperties::resetExcludedBorder()
     {
-      flags_.reset(BORDER);
+      flags_ &= ~(1<<BORDER);
     }
 
     inline void VertexProperties::reset()
     {
-      flags_.reset();
+      flags_ = 0;
     }
 
     /** @} */
@@ -9,9 +9,12 @@
 #include "pinfo.hh"
 #include <dune/common/poolallocator.hh>
 #include <dune/common/enumset.hh>
+#include <dune/istl/common/threadpool.hh>
 #include <set>
 #include <limits>
 #include <algorithm>
+#include <numeric>
+#include <vector>
 
 namespace Dune
 {
@@ -100,6 +103,11 @@ namespace Dune
     public:
       /**
        * @brief Calculate the galerkin product.
+       *
+       * If the global ThreadPool uses more than one thread, the rows of the
+       * coarse matrix are computed in parallel. The result is the same as
+       * for a single thread.
+       *
        * @param fine The fine matrix.
        * @param aggregates The aggregate mapping.
        * @param coarse The coarse Matrix.
@@ -646,19 +654,52 @@ namespace Dune
 
       typedef typename M::ConstIterator RowIterator;
       RowIterator endRow = fine.end();
-
-      for(RowIterator row = fine.begin(); row != endRow; ++row)
-        if(aggregates[row.index()] != AggregatesMap<V>::ISOLATED) {
-          assert(aggregates[row.index()]!=AggregatesMap<V>::UNAGGREGATED);
-          typedef typename M::ConstColIterator ColIterator;
-          ColIterator endCol = row->end();
-
-          for(ColIterator col = row->begin(); col != endCol; ++col)
-            if(aggregates[col.index()] != AggregatesMap<V>::ISOLATED) {
-              assert(aggregates[row.index()]!=AggregatesMap<V>::UNAGGREGATED);
-              coarse[aggregates[row.index()]][aggregates[col.index()]]+=*col;
+      typedef typename M::ConstColIterator ColIterator;
+
+      ThreadPool& pool = ThreadPool::instance();
+      if(pool.numThreads() > 1) {
+        // Group the fine rows by aggregate, in increasing order. Then each
+        // thread adds the fine rows of a range of coarse rows, and all entries
+        // are summed up in the same order as in the sequential loop below.
+        typedef typename M::size_type size_type;
+        std::vector<size_type> offset(coarse.N()+1, 0);
+        for(RowIterator row = fine.begin(); row != endRow; ++row)
+          if(aggregates[row.index()] != AggregatesMap<V>::ISOLATED) {
+            assert(aggregates[row.index()]!=AggregatesMap<V>::UNAGGREGATED);
+            ++offset[aggregates[row.index()]+1];
+          }
+        std::partial_sum(offset.begin(), offset.end(), offset.begin());
+        std::vector<size_type> fineRows(offset.back());
+        std::vector<size_type> next(offset.begin(), offset.end()-1);
+        for(RowIterator row = fine.begin(); row != endRow; ++row)
+          if(aggregates[row.index()] != AggregatesMap<V>::ISOLATED)
+            fineRows[next[aggregates[row.index()]]++] = row.index();
+
+        pool.parallelFor(0, coarse.N(), [&](std::size_t first, std::size_t last){
+          for(std::size_t i=first; i<last; ++i) {
+            auto&& coarseRow = coarse[i];
+            for(size_type k=offset[i]; k<offset[i+1]; ++k) {
+              const auto& row = fine[fineRows[k]];
+              ColIterator endCol = row.end();
+              for(ColIterator col = row.begin(); col != endCol; ++col)
+                if(aggregates[col.index()] != AggregatesMap<V>::ISOLATED)
+                  coarseRow[aggregates[col.index()]]+=*col;
             }
-        }
+          }
+        }, 256);
+      }else{
+        for(RowIterator row = fine.begin(); row != endRow; ++row)
+          if(aggregates[row.index()] != AggregatesMap<V>::ISOLATED) {
+            assert(aggregates[row.index()]!=AggregatesMap<V>::UNAGGREGATED);
+            ColIterator endCol = row->end();
+
+            for(ColIterator col = row->begin(); col != endCol; ++col)
+              if(aggregates[col.index()] != AggregatesMap<V>::ISOLATED) {
+                assert(aggregates[row.index()]!=AggregatesMap<V>::UNAGGREGATED);
+                coarse[aggregates[row.index()]][aggregates[col.index()]]+=*col;
+              }
+          }
+      }
 
       // get the right diagonal matrix values on copy lines from owner processes
       typedef typename M::block_type BlockType;
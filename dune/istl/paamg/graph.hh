@@ -1984,7 +1984,23 @@ namespace Dune
     {
       start_ = new std::ptrdiff_t[graph.noVertices()];
       end_ = new std::ptrdiff_t[graph.noVertices()];
-      edges_ = new VertexDescriptor[graph.noEdges()];
+
+      typedef typename Graph::ConstVertexIterator Iterator;
+      Iterator endVertex=graph.end();
+
+      // Count the edges between included vertices first to only allocate
+      // the memory actually needed.
+      std::size_t noEdges=0;
+      for(Iterator vertex = graph.begin(); vertex != endVertex; ++vertex)
+        if(!excluded_[*vertex]) {
+          auto endEdge = vertex.end();
+          for(auto iter=vertex.begin(); iter!= endEdge; ++iter)
+            if(!excluded[iter.target()])
+              ++noEdges;
+        }
+
+      edges_ = new VertexDescriptor[noEdges];
+      noEdges_ = noEdges;
 
       VertexDescriptor* edge=edges_;
 
@@ -1993,9 +2009,6 @@ namespace Dune
       if ( graph.noVertices() == 0)
         return;
 
-      typedef typename Graph::ConstVertexIterator Iterator;
-      Iterator endVertex=graph.end();
-
       for(Iterator vertex = graph.begin(); vertex != endVertex; ++vertex)
         if(excluded_[*vertex])
           start_[*vertex]=end_[*vertex]=-1;
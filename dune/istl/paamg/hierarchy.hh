@@ -108,6 +108,14 @@ namespace Dune
        */
       void addFiner(Arguments& args);
 
+      /**
+       * @brief Replace the element on the finest level.
+       *
+       * The coarser levels are kept.
+       * @param first std::shared_ptr to the new first element in the hierarchy.
+       */
+      void replaceFinest(const std::shared_ptr<MemberType>& first);
+
       /**
        * @brief Iterator over the levels in the hierarchy.
        *
@@ -373,6 +381,15 @@ namespace Dune
       ++levels_;
     }
 
+    template<class T, class A>
+    void Hierarchy<T,A>::replaceFinest(const std::shared_ptr<MemberType>& first)
+    {
+      assert(finest_);
+      if(finest_->element_ == originalFinest_)
+        originalFinest_ = first;
+      finest_->element_ = first;
+    }
+
     template<class T, class A>
     typename Hierarchy<T,A>::Iterator Hierarchy<T,A>::finest()
     {
@@ -6,7 +6,9 @@
 #define DUNE_AMG_MATRIXHIERARCHY_HH
 
 #include <algorithm>
+#include <cstddef>
 #include <tuple>
+#include <vector>
 #include "aggregates.hh"
 #include "graph.hh"
 #include "galerkin.hh"
@@ -16,6 +18,7 @@
 #include <dune/istl/bvector.hh>
 #include <dune/common/parallel/indexset.hh>
 #include <dune/istl/matrixutils.hh>
+#include <dune/istl/memoryusage.hh>
 #include <dune/istl/matrixredistribute.hh>
 #include <dune/istl/paamg/dependency.hh>
 #include <dune/istl/paamg/graph.hh>
@@ -50,6 +53,35 @@ namespace Dune
       MAX_PROCESSES = 72000
     };
 
+    /**
+     * @brief The memory in bytes held by one level of an AMG.
+     *
+     * The sizes are estimates of the allocated storage, see Dune::memoryUsage().
+     * Components that do not report their memory, e.g. most direct solvers,
+     * are counted as 0.
+     */
+    struct LevelMemoryUsage
+    {
+      /** @brief The matrix, on the finest level the one provided by the user. */
+      std::size_t matrix = 0;
+      /** @brief The mapping of the unknowns onto the aggregates of the next coarser level. */
+      std::size_t aggregates = 0;
+      /** @brief The matrix redistributed to fewer processes. */
+      std::size_t redistribution = 0;
+      /** @brief The smoother, e.g. the factorization of SeqILU. */
+      std::size_t smoother = 0;
+      /** @brief The vectors of the cycle. */
+      std::size_t vectors = 0;
+      /** @brief The solver of the coarsest level. */
+      std::size_t coarseSolver = 0;
+
+      /** @brief The memory of all components. */
+      std::size_t total() const
+      {
+        return matrix + aggregates + redistribution + smoother + vectors + coarseSolver;
+      }
+    };
+
     /**
      * @brief The hierarchies build by the coarsening process.
      *
@@ -124,6 +156,21 @@ namespace Dune
       template<class F>
       void recalculateGalerkin(const F& copyFlags);
 
+      /**
+       * @brief Replace the matrix of the finest level.
+       *
+       * The new matrix has to have the sparsity pattern of the old one and
+       * the same parallel information. The coarser levels are not changed,
+       * call recalculateGalerkin() to update them.
+       *
+       * @throws ISTLError if the sparsity patterns differ. This compares the
+       * column indices of all rows, which is cheap compared to the Galerkin
+       * products.
+       *
+       * @param fineMatrix The new matrix of the finest level.
+       */
+      void replaceFineMatrix(std::shared_ptr<MatrixOperator> fineMatrix);
+
       /**
        * @brief Coarsen the vector hierarchy according to the matrix hierarchy.
        * @param hierarchy The vector hierarchy to coarsen.
@@ -202,6 +249,12 @@ namespace Dune
        */
       void getCoarsestAggregatesOnFinest(std::vector<std::size_t>& data) const;
 
+      /**
+       * @brief Get the memory held by the matrices, the aggregates maps and the redistributions.
+       * @return The memory of each level, starting with the finest one.
+       */
+      std::vector<LevelMemoryUsage> memoryUsage() const;
+
     private:
       typedef typename ConstructionTraits<MatrixOperator>::Arguments MatrixArgs;
       typedef typename ConstructionTraits<ParallelInformation>::Arguments CommunicationArgs;
@@ -824,6 +877,24 @@ namespace Dune
       return redistributes_;
     }
 
+    template<class M, class IS, class A>
+    std::vector<LevelMemoryUsage> MatrixHierarchy<M,IS,A>::memoryUsage() const
+    {
+      std::vector<LevelMemoryUsage> usage(matrices_.levels());
+      typename ParallelMatrixHierarchy::ConstIterator matrix = matrices_.finest();
+      typename AggregatesMapList::const_iterator aggregates = aggregatesMaps_.begin();
+      for(std::size_t level=0; level < usage.size(); ++level, ++matrix) {
+        usage[level].matrix = Dune::memoryUsage(matrix->getmat());
+        if(matrix.isRedistributed())
+          usage[level].redistribution = Dune::memoryUsage(matrix.getRedistributed().getmat());
+        if(aggregates != aggregatesMaps_.end()) {
+          usage[level].aggregates = (*aggregates)->noVertices()*sizeof(typename AggregatesMap::AggregateDescriptor);
+          ++aggregates;
+        }
+      }
+      return usage;
+    }
+
     template<class M, class IS, class A>
     MatrixHierarchy<M,IS,A>::~MatrixHierarchy()
     {
@@ -934,6 +1005,29 @@ namespace Dune
       }
     }
 
+    template<class M, class IS, class A>
+    void MatrixHierarchy<M,IS,A>::replaceFineMatrix(std::shared_ptr<MatrixOperator> fineMatrix)
+    {
+      const Matrix& oldMatrix = matrices_.finest()->getmat();
+      const Matrix& newMatrix = fineMatrix->getmat();
+      if (SolverCategory::category(*fineMatrix) != SolverCategory::category(*matrices_.finest()))
+        DUNE_THROW(ISTLError, "The new fine matrix operator has to belong to the same category!");
+      bool samePattern = newMatrix.N() == oldMatrix.N() && newMatrix.M() == oldMatrix.M()
+        && newMatrix.nonzeroes() == oldMatrix.nonzeroes();
+      // the Galerkin products only visit the coarse entries of the old pattern
+      for (auto oldRow = oldMatrix.begin(), newRow = newMatrix.begin();
+           samePattern && &oldMatrix != &newMatrix && oldRow != oldMatrix.end(); ++oldRow, ++newRow)
+      {
+        samePattern = oldRow->size() == newRow->size();
+        for (auto oldEntry = oldRow->begin(), newEntry = newRow->begin();
+             samePattern && oldEntry != oldRow->end(); ++oldEntry, ++newEntry)
+          samePattern = oldEntry.index() == newEntry.index();
+      }
+      if (!samePattern)
+        DUNE_THROW(ISTLError, "The new fine matrix has to have the sparsity pattern of the old one!");
+      matrices_.replaceFinest(fineMatrix);
+    }
+
     template<class M, class IS, class A>
     std::size_t MatrixHierarchy<M,IS,A>::levels() const
     {
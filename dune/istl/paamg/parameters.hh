@@ -94,7 +94,7 @@ namespace Dune
        */
       AggregationParameters()
         : maxDistance_(2), minAggregateSize_(4), maxAggregateSize_(6),
-          connectivity_(15), skipiso_(false)
+          connectivity_(15), skipiso_(false), threadedAggregation_(false)
       {}
 
       /**
@@ -218,9 +218,34 @@ namespace Dune
        */
       void setMaxConnectivity(std::size_t connectivity){ connectivity_ = connectivity;}
 
+      /**
+       * @brief Whether the aggregates are built by the threaded MISAggregator.
+       * @return True if the threaded aggregation is used.
+       */
+      bool threadedAggregation() const
+      {
+        return threadedAggregation_;
+      }
+
+      /**
+       * @brief Set whether the aggregates are built by the threaded MISAggregator.
+       *
+       * The MISAggregator uses the threads of the global ThreadPool (see
+       * DUNE_ISTL_NUM_THREADS) and yields the same aggregates for any number
+       * of threads. These differ from the ones of the sequential Aggregator,
+       * and the limits for the size and the connectivity of the aggregates
+       * are not enforced. The default is false.
+       * @param threaded True if the threaded aggregation should be used.
+       */
+      void setThreadedAggregation(bool threaded)
+      {
+        threadedAggregation_ = threaded;
+      }
+
     private:
       std::size_t maxDistance_, minAggregateSize_, maxAggregateSize_, connectivity_;
       bool skipiso_;
+      bool threadedAggregation_;
 
     };
 
@@ -82,6 +82,18 @@ namespace Dune
         return x.two_norm();
       }
 
+      template<class T1, class T2>
+      void localDot (const T1& x, const T1& y, T2& result) const
+      {
+        result = x.dot(y);
+      }
+
+      template<class T1>
+      typename FieldTraits<typename T1::field_type>::real_type localNorm2 (const T1& x) const
+      {
+        return x.two_norm2();
+      }
+
       template<class T>
       SequentialInformation(const Communication<T>&)
       {}
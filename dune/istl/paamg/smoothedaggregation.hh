@@ -0,0 +1,782 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_AMG_SMOOTHEDAGGREGATION_HH
+#define DUNE_AMG_SMOOTHEDAGGREGATION_HH
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/ftraits.hh>
+#include <dune/common/timer.hh>
+
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/istlexception.hh>
+#include <dune/istl/matrixindexset.hh>
+#include <dune/istl/matrixmatrix.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/preconditioner.hh>
+#include <dune/istl/scalarproducts.hh>
+#include <dune/istl/solvers.hh>
+#include <dune/istl/common/instrumentation.hh>
+#include <dune/istl/paamg/aggregates.hh>
+#include <dune/istl/paamg/amg.hh>
+#include <dune/istl/paamg/graph.hh>
+#include <dune/istl/paamg/matrixhierarchy.hh>
+#include <dune/istl/paamg/parameters.hh>
+#include <dune/istl/paamg/smoother.hh>
+
+/** @file
+ * @brief A sequential algebraic multigrid with smoothed aggregation.
+ *
+ * In contrast to AMG, the prolongation is not piecewise constant on the
+ * aggregates but built from a set of near-nullspace vectors, e.g. the rigid
+ * body modes of an elasticity problem, and smoothed by a damped Jacobi step.
+ * The prolongation and restriction matrices are stored explicitly.
+ */
+
+namespace Dune
+{
+  namespace Amg
+  {
+    /**
+     * @addtogroup ISTL_PAAMG
+     *
+     * @{
+     */
+
+    namespace SmoothedAggregationImpl
+    {
+      //! Store the transposed of a sparse matrix with transposed blocks
+      template<class K, int n, int m, class A, class AT>
+      void transposeMatrix(const BCRSMatrix<FieldMatrix<K,n,m>,A>& matrix,
+                           BCRSMatrix<FieldMatrix<K,m,n>,AT>& transposed)
+      {
+        MatrixIndexSet pattern(matrix.M(), matrix.N());
+        for (auto row = matrix.begin(); row != matrix.end(); ++row)
+          for (auto entry = row->begin(); entry != row->end(); ++entry)
+            pattern.add(entry.index(), row.index());
+        pattern.exportIdx(transposed);
+
+        for (auto row = matrix.begin(); row != matrix.end(); ++row)
+          for (auto entry = row->begin(); entry != row->end(); ++entry)
+          {
+            auto& block = transposed[entry.index()][row.index()];
+            for (int i=0; i<n; ++i)
+              for (int j=0; j<m; ++j)
+                block[j][i] = (*entry)[i][j];
+          }
+      }
+
+      //! The inverses of the diagonal blocks of a matrix
+      template<class K, int n, class A>
+      std::vector<FieldMatrix<K,n,n> > invertedDiagonal(const BCRSMatrix<FieldMatrix<K,n,n>,A>& matrix)
+      {
+        std::vector<FieldMatrix<K,n,n> > diagonal(matrix.N());
+        for (auto row = matrix.begin(); row != matrix.end(); ++row)
+        {
+          auto entry = row->find(row.index());
+          if (entry == row->end())
+            DUNE_THROW(ISTLError, "Smoothed aggregation needs the diagonal entry of row " << row.index());
+          diagonal[row.index()] = *entry;
+          diagonal[row.index()].invert();
+        }
+        return diagonal;
+      }
+    } // end namespace SmoothedAggregationImpl
+
+    /**
+     * @brief The rigid body modes of a displacement field, as near-nullspace for elasticity problems.
+     *
+     * In two dimensions these are the two translations and one rotation, in
+     * three dimensions the three translations and three rotations.
+     *
+     * @param coordinates The coordinates of the nodes, one block of the displacement per node.
+     * @return The dim*(dim+1)/2 modes.
+     */
+    template<class K, int dim>
+    std::vector<BlockVector<FieldVector<K,dim> > > rigidBodyModes(const std::vector<FieldVector<K,dim> >& coordinates)
+    {
+      static_assert(dim == 2 || dim == 3, "Rigid body modes are only implemented in two and three dimensions");
+      const std::size_t modes = dim*(dim+1)/2;
+      std::vector<BlockVector<FieldVector<K,dim> > > nullspace(modes, BlockVector<FieldVector<K,dim> >(coordinates.size()));
+      for (std::size_t i=0; i<coordinates.size(); ++i)
+      {
+        const auto& x = coordinates[i];
+        for (int d=0; d<dim; ++d)
+        {
+          nullspace[d][i] = 0;
+          nullspace[d][i][d] = 1;
+        }
+        if constexpr (dim == 2)
+        {
+          nullspace[2][i][0] = -x[1];
+          nullspace[2][i][1] = x[0];
+        }
+        else
+        {
+          nullspace[3][i] = {0, -x[2], x[1]};
+          nullspace[4][i] = {x[2], 0, -x[0]};
+          nullspace[5][i] = {-x[1], x[0], 0};
+        }
+      }
+      return nullspace;
+    }
+
+    /**
+     * @brief Build the tentative prolongation of smoothed aggregation.
+     *
+     * The k near-nullspace vectors restricted to an aggregate are
+     * orthonormalized by a QR decomposition. The orthonormal columns become
+     * the blocks of the prolongation in the rows of the aggregate and the
+     * triangular factor becomes the block of the coarse near-nullspace
+     * vectors. Columns that are linearly dependent on an aggregate, e.g.
+     * if the aggregate has fewer scalar unknowns than k, are set to zero.
+     *
+     * @param aggregates The mapping of the unknowns onto the aggregates.
+     * @param noAggregates The number of aggregates.
+     * @param nullspace The k near-nullspace vectors of the fine level.
+     * @param prolongation Filled with the tentative prolongation.
+     * @param coarseNullspace Filled with the k near-nullspace vectors of the coarse level.
+     */
+    template<class V, class K, int n, int k, class AN, class AP, class AC>
+    void buildTentativeProlongation(const AggregatesMap<V>& aggregates, std::size_t noAggregates,
+                                    const std::vector<BlockVector<FieldVector<K,n>,AN> >& nullspace,
+                                    BCRSMatrix<FieldMatrix<K,n,k>,AP>& prolongation,
+                                    std::vector<BlockVector<FieldVector<K,k>,AC> >& coarseNullspace)
+    {
+      using std::sqrt;
+      typedef BCRSMatrix<FieldMatrix<K,n,k>,AP> Prolongation;
+      typedef typename FieldTraits<K>::real_type real_type;
+
+      if (nullspace.size() != std::size_t(k))
+        DUNE_THROW(ISTLError, "Smoothed aggregation needs " << k << " near-nullspace vectors, got " << nullspace.size());
+      const std::size_t rows = nullspace[0].N();
+
+      // the unknowns of each aggregate
+      std::vector<std::size_t> offsets(noAggregates+1, 0);
+      for (std::size_t i=0; i<rows; ++i)
+        if (std::size_t(aggregates[i]) < noAggregates)
+          ++offsets[aggregates[i]+1];
+      for (std::size_t a=0; a<noAggregates; ++a)
+        offsets[a+1] += offsets[a];
+      std::vector<std::size_t> members(offsets.back());
+      {
+        std::vector<std::size_t> position(offsets.begin(), offsets.end()-1);
+        for (std::size_t i=0; i<rows; ++i)
+          if (std::size_t(aggregates[i]) < noAggregates)
+            members[position[aggregates[i]]++] = i;
+      }
+
+      // one entry per row in the column of its aggregate, none for unaggregated rows
+      prolongation.setSize(rows, noAggregates);
+      prolongation.setBuildMode(Prolongation::random);
+      for (std::size_t i=0; i<rows; ++i)
+        prolongation.setrowsize(i, std::size_t(aggregates[i]) < noAggregates ? 1 : 0);
+      prolongation.endrowsizes();
+      for (std::size_t i=0; i<rows; ++i)
+        if (std::size_t(aggregates[i]) < noAggregates)
+          prolongation.addindex(i, aggregates[i]);
+      prolongation.endindices();
+      prolongation = 0;
+
+      coarseNullspace.assign(k, BlockVector<FieldVector<K,k>,AC>(noAggregates));
+      for (auto& vector : coarseNullspace)
+        vector = 0;
+
+      // the near-nullspace on an aggregate, column by column
+      std::vector<K> q;
+      for (std::size_t a=0; a<noAggregates; ++a)
+      {
+        const std::size_t size = offsets[a+1] - offsets[a];
+        const std::size_t length = size*n;
+        q.assign(length*k, K(0));
+        for (int c=0; c<k; ++c)
+          for (std::size_t p=0; p<size; ++p)
+            for (int r=0; r<n; ++r)
+              q[c*length + p*n + r] = nullspace[c][members[offsets[a]+p]][r];
+
+        // modified Gram-Schmidt
+        for (int c=0; c<k; ++c)
+        {
+          K* column = q.data() + c*length;
+          real_type original = 0;
+          for (std::size_t i=0; i<length; ++i)
+            original += column[i]*column[i];
+          for (int d=0; d<c; ++d)
+          {
+            const K* other = q.data() + d*length;
+            K product = 0;
+            for (std::size_t i=0; i<length; ++i)
+              product += other[i]*column[i];
+            for (std::size_t i=0; i<length; ++i)
+              column[i] -= product*other[i];
+            coarseNullspace[c][a][d] = product;
+          }
+          real_type norm = 0;
+          for (std::size_t i=0; i<length; ++i)
+            norm += column[i]*column[i];
+          if (norm <= 1e-20*original || norm == real_type(0))
+          {
+            std::fill(column, column+length, K(0));
+            continue;
+          }
+          norm = sqrt(norm);
+          for (std::size_t i=0; i<length; ++i)
+            column[i] /= norm;
+          coarseNullspace[c][a][c] = norm;
+        }
+
+        for (std::size_t p=0; p<size; ++p)
+        {
+          auto& block = prolongation[members[offsets[a]+p]][a];
+          for (int r=0; r<n; ++r)
+            for (int c=0; c<k; ++c)
+              block[r][c] = q[c*length + p*n + r];
+        }
+      }
+    }
+
+    /**
+     * @brief An upper bound of the spectral radius of the Jacobi iteration matrix \f$D^{-1}A\f$.
+     *
+     * Uses the maximal row sum of \f$|D^{-1}A|\f$, i.e. Gershgorin's theorem.
+     */
+    template<class K, int n, class A>
+    typename FieldTraits<K>::real_type jacobiSpectralRadiusBound(const BCRSMatrix<FieldMatrix<K,n,n>,A>& matrix)
+    {
+      using std::abs;
+      using std::max;
+      typedef typename FieldTraits<K>::real_type real_type;
+      const auto diagonal = SmoothedAggregationImpl::invertedDiagonal(matrix);
+      real_type bound = 0;
+      std::vector<real_type> sums(n);
+      FieldMatrix<K,n,n> block;
+      for (auto row = matrix.begin(); row != matrix.end(); ++row)
+      {
+        std::fill(sums.begin(), sums.end(), real_type(0));
+        for (auto entry = row->begin(); entry != row->end(); ++entry)
+        {
+          block = diagonal[row.index()];
+          block.rightmultiply(*entry);
+          for (int i=0; i<n; ++i)
+            for (int j=0; j<n; ++j)
+              sums[i] += abs(block[i][j]);
+        }
+        for (int i=0; i<n; ++i)
+          bound = max(bound, sums[i]);
+      }
+      return bound;
+    }
+
+    /**
+     * @brief Smooth a tentative prolongation by a damped Jacobi step.
+     *
+     * Computes \f$P = (I - \omega D^{-1} A) P_0\f$ with the block diagonal D of A.
+     *
+     * @param matrix The matrix A.
+     * @param tentative The tentative prolongation \f$P_0\f$.
+     * @param prolongation An empty matrix filled with the smoothed prolongation P.
+     * @param omega The damping factor, usually \f$4/(3\rho(D^{-1}A))\f$.
+     */
+    template<class K, int n, int k, class A, class AP>
+    void smoothProlongation(const BCRSMatrix<FieldMatrix<K,n,n>,A>& matrix,
+                            const BCRSMatrix<FieldMatrix<K,n,k>,AP>& tentative,
+                            BCRSMatrix<FieldMatrix<K,n,k>,AP>& prolongation,
+                            typename FieldTraits<K>::real_type omega)
+    {
+      // the pattern of A*P_0 contains the one of P_0 as A has a diagonal
+      matMultMat(prolongation, matrix, tentative);
+      const auto diagonal = SmoothedAggregationImpl::invertedDiagonal(matrix);
+      FieldMatrix<K,n,k> block;
+      for (auto row = prolongation.begin(); row != prolongation.end(); ++row)
+      {
+        const auto& inverse = diagonal[row.index()];
+        for (auto entry = row->begin(); entry != row->end(); ++entry)
+        {
+          block = 0;
+          for (int i=0; i<n; ++i)
+            for (int l=0; l<n; ++l)
+              for (int j=0; j<k; ++j)
+                block[i][j] += inverse[i][l]*(*entry)[l][j];
+          *entry = block;
+          *entry *= -omega;
+        }
+        const auto& tentativeRow = tentative[row.index()];
+        for (auto entry = tentativeRow.begin(); entry != tentativeRow.end(); ++entry)
+          (*row)[entry.index()] += *entry;
+      }
+    }
+
+    /**
+     * @brief Compute the Galerkin product \f$P^TAP\f$ with explicit sparse products.
+     *
+     * Diagonal entries of the coarse matrix that vanish because the
+     * corresponding columns of the prolongation are zero are set to one,
+     * which decouples these unknowns.
+     *
+     * @param matrix The fine matrix A.
+     * @param prolongation The prolongation P.
+     * @param coarse An empty matrix filled with the coarse matrix.
+     */
+    template<class K, int n, int k, class A, class AP, class AC>
+    void galerkinProduct(const BCRSMatrix<FieldMatrix<K,n,n>,A>& matrix,
+                         const BCRSMatrix<FieldMatrix<K,n,k>,AP>& prolongation,
+                         BCRSMatrix<FieldMatrix<K,k,k>,AC>& coarse)
+    {
+      BCRSMatrix<FieldMatrix<K,n,k>,AP> product;
+      matMultMat(product, matrix, prolongation);
+      transposeMatMultMat(coarse, prolongation, product);
+      for (auto row = coarse.begin(); row != coarse.end(); ++row)
+      {
+        auto& diagonal = (*row)[row.index()];
+        for (int i=0; i<k; ++i)
+          if (diagonal[i][i] == K(0))
+            diagonal[i][i] = 1;
+      }
+    }
+
+    namespace Impl
+    {
+      /**
+       * @brief The levels of a multigrid hierarchy with explicitly stored transfer operators and their V-cycle.
+       *
+       * Used by SmoothedAggregationAMG for its coarse levels and by ClassicalAMG
+       * for all levels. All levels but the last one are smoothed before the
+       * restriction of the defect and after the prolongation of the coarse
+       * correction, the last one is solved with the coarse solver.
+       *
+       * \tparam M The matrix type of the levels and of the transfer operators.
+       * \tparam V The vector type of the levels.
+       * \tparam S The smoother of the levels.
+       */
+      template<class M, class V, class S>
+      struct ExplicitTransferLevels
+      {
+        typedef typename SmootherTraits<S>::Arguments SmootherArgs;
+
+        //! The matrices of the levels, starting with the finest one
+        std::vector<std::shared_ptr<const M> > matrices;
+        //! The prolongation from level l+1 to level l
+        std::vector<std::shared_ptr<const M> > prolongations;
+        //! The restriction from level l to level l+1, empty to apply the transposed prolongations
+        std::vector<std::shared_ptr<const M> > restrictions;
+        //! The smoothers of all levels but the last one
+        std::vector<std::shared_ptr<S> > smoothers;
+        std::shared_ptr<InverseOperator<V,V> > coarseSolver;
+
+        std::vector<V> defects;
+        std::vector<V> corrections;
+        std::vector<V> updates;
+
+        //! Construct the smoother of a matrix
+        static std::shared_ptr<S> createSmoother(const M& matrix, const SmootherArgs& smootherArgs)
+        {
+          typename ConstructionTraits<S>::Arguments args;
+          args.setMatrix(matrix);
+          args.setArgs(smootherArgs);
+          return ConstructionTraits<S>::construct(args);
+        }
+
+        /**
+         * @brief Create the solver of the last level and the vectors of all levels.
+         *
+         * The last level is solved with a direct solver if one is available,
+         * otherwise with BiCGSTAB preconditioned with the smoother.
+         */
+        void finish(const SmootherArgs& smootherArgs)
+        {
+          typedef DirectSolverSelector<M,V> SolverSelector;
+          if constexpr (SolverSelector::isDirectSolver)
+            coarseSolver.reset(SolverSelector::create(*matrices.back(), false, false));
+          else
+            coarseSolver = std::make_shared<BiCGSTABSolver<V> >(
+              std::make_shared<MatrixAdapter<M,V,V> >(matrices.back()),
+              std::make_shared<SeqScalarProduct<V> >(),
+              createSmoother(*matrices.back(), smootherArgs), 1e-2, 1000, 0);
+
+          for (const auto& matrix : matrices)
+          {
+            defects.emplace_back(matrix->N());
+            corrections.emplace_back(matrix->N());
+            updates.emplace_back(matrix->N());
+          }
+        }
+
+        //! Apply a number of smoothing steps to v and update the defect d, w is used as temporary
+        template<class Sm, class Mat, class Vec>
+        static void smooth(Sm& smoother, const Mat& matrix, Vec& v, Vec& d, Vec& w,
+                           std::size_t steps, const char* name)
+        {
+          Instrumentation::Scope scope(name);
+          for (std::size_t i=0; i<steps; ++i)
+          {
+            w = 0;
+            smoother.apply(w, d);
+            v += w;
+            matrix.mmv(w, d);
+          }
+        }
+
+        /**
+         * @brief Compute the correction on level l for the defect in defects[l].
+         *
+         * @param offset The number of finer levels not stored here, used as offset of the level in the instrumentation.
+         */
+        void cycle(std::size_t l, std::size_t preSteps, std::size_t postSteps, std::size_t offset)
+        {
+          Instrumentation::Scope scope("level", l+offset);
+          V& v = corrections[l];
+          V& d = defects[l];
+          v = 0;
+          if (l+1 == matrices.size())
+          {
+            Instrumentation::Scope solve("coarse solve");
+            InverseOperatorResult result;
+            coarseSolver->apply(v, d, result);
+            return;
+          }
+          const M& A = *matrices[l];
+          smooth(*smoothers[l], A, v, d, updates[l], preSteps, "presmooth");
+          {
+            Instrumentation::Scope restriction("restriction");
+            if (restrictions.empty())
+              prolongations[l]->mtv(d, defects[l+1]);
+            else
+              restrictions[l]->mv(d, defects[l+1]);
+          }
+          cycle(l+1, preSteps, postSteps, offset);
+          {
+            Instrumentation::Scope prolongation("prolongation");
+            prolongations[l]->mv(corrections[l+1], updates[l]);
+            v += updates[l];
+            A.mmv(updates[l], d);
+          }
+          smooth(*smoothers[l], A, v, d, updates[l], postSteps, "postsmooth");
+        }
+      };
+    } // end namespace Impl
+
+    /**
+     * @brief A sequential algebraic multigrid with smoothed aggregation.
+     *
+     * The aggregates are built like in AMG, using the Frobenius norm of the
+     * blocks to determine the strong couplings. On each aggregate the
+     * near-nullspace vectors are orthonormalized to form the tentative
+     * prolongation, which is smoothed by one Jacobi step damped with
+     * \f$4/(3\rho)\f$, where \f$\rho\f$ is the Gershgorin bound of the
+     * spectral radius of \f$D^{-1}A\f$. The prolongations, the restrictions
+     * (their transposes) and the coarse matrices are stored as BCRSMatrix
+     * and computed with matMultMat() and transposeMatMultMat().
+     *
+     * With k near-nullspace vectors the coarse levels have blocks of size k,
+     * e.g. 6 for the rigid body modes of three-dimensional elasticity, see
+     * rigidBodyModes(). The coarse levels use the smoother CS and the
+     * coarsest level a direct solver if one is available, otherwise
+     * BiCGSTAB preconditioned with CS. The hierarchy always has at least
+     * two levels. One V-cycle is performed per application.
+     *
+     * \tparam M The matrix operator type, e.g. MatrixAdapter, its matrix has to be
+     *           a BCRSMatrix with square FieldMatrix blocks of a real field type.
+     * \tparam X The vector type.
+     * \tparam S The smoother on the finest level, e.g. SeqSSOR or SeqILU.
+     * \tparam k The number of near-nullspace vectors, by default the block size.
+     * \tparam CS The smoother on the coarse levels.
+     */
+    template<class M, class X, class S, int k = X::block_type::dimension,
+             class CS = SeqSSOR<BCRSMatrix<FieldMatrix<typename X::field_type,k,k> >,
+                                BlockVector<FieldVector<typename X::field_type,k> >,
+                                BlockVector<FieldVector<typename X::field_type,k> > > >
+    class SmoothedAggregationAMG : public Preconditioner<X,X>
+    {
+    public:
+      /** @brief The matrix operator type. */
+      typedef M Operator;
+      /** @brief The matrix type. */
+      typedef typename M::matrix_type Matrix;
+      /** @brief The domain type. */
+      typedef X Domain;
+      /** @brief The range type. */
+      typedef X Range;
+      typedef typename X::field_type field_type;
+      typedef typename FieldTraits<field_type>::real_type real_type;
+      /** @brief The near-nullspace vectors of the fine level. */
+      typedef std::vector<X> Nullspace;
+      /** @brief The smoother on the finest level. */
+      typedef S Smoother;
+      typedef typename SmootherTraits<Smoother>::Arguments SmootherArgs;
+      /** @brief The smoother on the coarse levels. */
+      typedef CS CoarseSmoother;
+      typedef typename SmootherTraits<CoarseSmoother>::Arguments CoarseSmootherArgs;
+
+      enum {
+        //! @brief The block size of the fine level.
+        blocksize = Matrix::block_type::rows,
+        //! @brief The block size of the coarse levels, the number of near-nullspace vectors.
+        coarseBlocksize = k
+      };
+
+      typedef BCRSMatrix<FieldMatrix<field_type,k,k> > CoarseMatrix;
+      typedef BlockVector<FieldVector<field_type,k> > CoarseVector;
+      typedef BCRSMatrix<FieldMatrix<field_type,blocksize,k> > FineProlongation;
+      typedef BCRSMatrix<FieldMatrix<field_type,k,blocksize> > FineRestriction;
+      typedef CoarseMatrix CoarseProlongation;
+      typedef CoarseMatrix CoarseRestriction;
+
+      static_assert(std::is_same_v<Matrix, BCRSMatrix<FieldMatrix<field_type,blocksize,blocksize>, typename Matrix::allocator_type> >,
+                    "Smoothed aggregation needs a BCRSMatrix with square FieldMatrix blocks");
+
+      /**
+       * @brief Set up the multigrid hierarchy.
+       *
+       * @param fineOperator The operator on the fine level.
+       * @param nullspace The k near-nullspace vectors, e.g. the constant vectors or rigidBodyModes().
+       * @param parameters The parameters of the aggregation and the cycle.
+       * @param smootherArgs The arguments of the smoother on the finest level.
+       * @param coarseSmootherArgs The arguments of the smoothers on the coarse levels.
+       */
+      SmoothedAggregationAMG(std::shared_ptr<const Operator> fineOperator,
+                             const Nullspace& nullspace,
+                             const Parameters& parameters,
+                             const SmootherArgs& smootherArgs = SmootherArgs(),
+                             const CoarseSmootherArgs& coarseSmootherArgs = CoarseSmootherArgs())
+        : operator_(std::move(fineOperator)), parameters_(parameters),
+          smootherArgs_(smootherArgs), coarseSmootherArgs_(coarseSmootherArgs)
+      {
+        build(nullspace);
+      }
+
+      /**
+       * @copydoc SmoothedAggregationAMG(std::shared_ptr<const Operator>,const Nullspace&,const Parameters&,const SmootherArgs&,const CoarseSmootherArgs&)
+       *
+       * The operator has to live as long as the preconditioner.
+       */
+      SmoothedAggregationAMG(const Operator& fineOperator,
+                             const Nullspace& nullspace,
+                             const Parameters& parameters,
+                             const SmootherArgs& smootherArgs = SmootherArgs(),
+                             const CoarseSmootherArgs& coarseSmootherArgs = CoarseSmootherArgs())
+        : SmoothedAggregationAMG(stackobject_to_shared_ptr(fineOperator), nullspace,
+                                 parameters, smootherArgs, coarseSmootherArgs)
+      {}
+
+      /**
+       * @brief The near-nullspace of the constant vectors, one per component of the blocks.
+       *
+       * Only available if k equals the block size.
+       */
+      static Nullspace constantNullspace(std::size_t size)
+      {
+        static_assert(k == blocksize, "The constant near-nullspace has one vector per component");
+        Nullspace nullspace(k, X(size));
+        for (int c=0; c<k; ++c)
+          for (std::size_t i=0; i<size; ++i)
+          {
+            nullspace[c][i] = 0;
+            nullspace[c][i][c] = 1;
+          }
+        return nullspace;
+      }
+
+      /** \copydoc Preconditioner::pre */
+      void pre(Domain& x, Range& b) override
+      {
+        smoother_->pre(x, b);
+        for (std::size_t c=0; c<coarse_.smoothers.size(); ++c)
+          coarse_.smoothers[c]->pre(coarse_.corrections[c], coarse_.defects[c]);
+      }
+
+      /** \copydoc Preconditioner::apply */
+      void apply(Domain& v, const Range& d) override
+      {
+        defect_ = d;
+        v = 0;
+        Instrumentation::Scope scope("level", std::size_t(0));
+        CoarseLevels::smooth(*smoother_, matrix(), v, defect_, update_, parameters_.getNoPreSmoothSteps(), "presmooth");
+        {
+          Instrumentation::Scope restriction("restriction");
+          restriction_.mv(defect_, coarse_.defects[0]);
+        }
+        coarse_.cycle(0, parameters_.getNoPreSmoothSteps(), parameters_.getNoPostSmoothSteps(), 1);
+        {
+          Instrumentation::Scope prolongation("prolongation");
+          prolongation_.mv(coarse_.corrections[0], update_);
+          v += update_;
+          matrix().mmv(update_, defect_);
+        }
+        CoarseLevels::smooth(*smoother_, matrix(), v, defect_, update_, parameters_.getNoPostSmoothSteps(), "postsmooth");
+      }
+
+      /** \copydoc Preconditioner::post */
+      void post(Domain& x) override
+      {
+        smoother_->post(x);
+        for (std::size_t c=0; c<coarse_.smoothers.size(); ++c)
+          coarse_.smoothers[c]->post(coarse_.corrections[c]);
+      }
+
+      //! Category of the preconditioner (see SolverCategory::Category)
+      SolverCategory::Category category() const override
+      {
+        return SolverCategory::sequential;
+      }
+
+      //! @brief The number of levels including the finest one.
+      std::size_t levels() const
+      {
+        return coarse_.matrices.size() + 1;
+      }
+
+      //! @brief The prolongation from the first coarse level to the finest level.
+      const FineProlongation& fineProlongation() const
+      {
+        return prolongation_;
+      }
+
+      /**
+       * @brief The matrix of a coarse level.
+       * @param level The level, from 1 for the first coarse level to levels()-1.
+       */
+      const CoarseMatrix& coarseMatrix(std::size_t level) const
+      {
+        return *coarse_.matrices.at(level-1);
+      }
+
+      /**
+       * @brief The prolongation to a coarse level from the next coarser level.
+       * @param level The finer level, from 1 to levels()-2.
+       */
+      const CoarseProlongation& coarseProlongation(std::size_t level) const
+      {
+        return *coarse_.prolongations.at(level-1);
+      }
+
+    private:
+      typedef Impl::ExplicitTransferLevels<CoarseMatrix,CoarseVector,CoarseSmoother> CoarseLevels;
+
+      const Matrix& matrix() const
+      {
+        return operator_->getmat();
+      }
+
+      // The aggregates of a matrix, the number of aggregates is returned
+      template<class Mat>
+      std::size_t aggregate(const Mat& matrix, std::unique_ptr<AggregatesMap<std::size_t> >& aggregates, bool finestLevel) const
+      {
+        typedef MatrixGraph<const Mat> Graph;
+        typedef SubGraph<Graph,std::vector<bool> > SubGraphType;
+        typedef PropertiesGraph<SubGraphType,VertexProperties,EdgeProperties,IdentityMap,
+            typename SubGraphType::EdgeIndexMap> PropertiesGraphType;
+        typedef CoarsenCriterion<SymmetricCriterion<Mat,FrobeniusNorm> > Criterion;
+
+        Graph graph(matrix);
+        std::vector<bool> excluded(matrix.N(), false);
+        SubGraphType subGraph(graph, excluded);
+        PropertiesGraphType propertiesGraph(subGraph, IdentityMap(), subGraph.getEdgeIndexMap());
+        aggregates = std::make_unique<AggregatesMap<std::size_t> >(propertiesGraph.noVertices());
+        Criterion criterion(parameters_);
+        int noAggregates, isoAggregates, oneAggregates, skipped;
+        std::tie(noAggregates, isoAggregates, oneAggregates, skipped)
+          = aggregates->buildAggregates(matrix, propertiesGraph, criterion, finestLevel);
+        return noAggregates;
+      }
+
+      // The smoothed prolongation, its transposed and the coarse matrix of a level
+      template<class Mat, class Nullspace1, class P, class R>
+      std::shared_ptr<CoarseMatrix> coarsen(const Mat& matrix, const Nullspace1& nullspace,
+                                            P& prolongation, R& restriction,
+                                            std::vector<CoarseVector>& coarseNullspace,
+                                            std::size_t noAggregates,
+                                            const AggregatesMap<std::size_t>& aggregates) const
+      {
+        P tentative;
+        buildTentativeProlongation(aggregates, noAggregates, nullspace, tentative, coarseNullspace);
+        const real_type omega = real_type(4)/(real_type(3)*jacobiSpectralRadiusBound(matrix));
+        smoothProlongation(matrix, tentative, prolongation, omega);
+        SmoothedAggregationImpl::transposeMatrix(prolongation, restriction);
+        auto coarse = std::make_shared<CoarseMatrix>();
+        galerkinProduct(matrix, prolongation, *coarse);
+        return coarse;
+      }
+
+      void build(const Nullspace& nullspace)
+      {
+        Timer watch;
+        if (nullspace.empty() || nullspace[0].N() != matrix().N())
+          DUNE_THROW(ISTLError, "The near-nullspace vectors have to match the matrix");
+
+        typename ConstructionTraits<Smoother>::Arguments fineArgs;
+        fineArgs.setMatrix(matrix());
+        fineArgs.setArgs(smootherArgs_);
+        smoother_ = ConstructionTraits<Smoother>::construct(fineArgs);
+
+        std::unique_ptr<AggregatesMap<std::size_t> > aggregates;
+        std::size_t noAggregates = aggregate(matrix(), aggregates, true);
+        if (noAggregates == 0 || noAggregates >= matrix().N())
+          DUNE_THROW(ISTLError, "Smoothed aggregation could not coarsen the matrix");
+        std::vector<CoarseVector> coarseNullspace;
+        coarse_.matrices.push_back(coarsen(matrix(), nullspace, prolongation_, restriction_,
+                                           coarseNullspace, noAggregates, *aggregates));
+        aggregates->free();
+
+        while (levels() < std::size_t(parameters_.maxLevel())
+               && coarse_.matrices.back()->N() > std::size_t(parameters_.coarsenTarget()))
+        {
+          const CoarseMatrix& fine = *coarse_.matrices.back();
+          noAggregates = aggregate(fine, aggregates, false);
+          if (noAggregates == 0 || double(fine.N())/noAggregates < parameters_.minCoarsenRate())
+            break;
+          std::vector<CoarseVector> fineNullspace;
+          std::swap(fineNullspace, coarseNullspace);
+          auto prolongation = std::make_shared<CoarseProlongation>();
+          auto restriction = std::make_shared<CoarseRestriction>();
+          auto coarse = coarsen(fine, fineNullspace, *prolongation, *restriction,
+                                coarseNullspace, noAggregates, *aggregates);
+          aggregates->free();
+
+          coarse_.smoothers.push_back(CoarseLevels::createSmoother(fine, coarseSmootherArgs_));
+          coarse_.prolongations.push_back(prolongation);
+          coarse_.restrictions.push_back(restriction);
+          coarse_.matrices.push_back(coarse);
+        }
+
+        coarse_.finish(coarseSmootherArgs_);
+        defect_.resize(matrix().N());
+        update_.resize(matrix().N());
+
+        if (parameters_.debugLevel() > 0)
+          std::cout << "Building smoothed aggregation hierarchy of " << levels() << " levels took "
+                    << watch.elapsed() << " seconds." << std::endl;
+      }
+
+      std::shared_ptr<const Operator> operator_;
+      Parameters parameters_;
+      SmootherArgs smootherArgs_;
+      CoarseSmootherArgs coarseSmootherArgs_;
+
+      std::shared_ptr<Smoother> smoother_;
+      FineProlongation prolongation_;
+      FineRestriction restriction_;
+      //! The coarse levels, starting with the first coarse level
+      CoarseLevels coarse_;
+
+      X defect_;
+      X update_;
+    };
+
+    /** @} */
+  } // namespace Amg
+} // namespace Dune
+
+#endif // DUNE_AMG_SMOOTHEDAGGREGATION_HH
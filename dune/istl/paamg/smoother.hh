@@ -245,6 +245,73 @@ namespace Dune
     };
 
 
+    /**
+     * @brief Policy for the construction of the SeqMulticolorSSOR smoother
+     */
+    template<class M, class X, class Y>
+    struct ConstructionTraits<SeqMulticolorSSOR<M,X,Y> >
+    {
+      typedef DefaultConstructionArgs<SeqMulticolorSSOR<M,X,Y> > Arguments;
+
+      static inline std::shared_ptr<SeqMulticolorSSOR<M,X,Y>> construct(Arguments& args)
+      {
+        return std::make_shared<SeqMulticolorSSOR<M,X,Y>>
+          (args.getMatrix(), args.getArgs().iterations, args.getArgs().relaxationFactor);
+      }
+    };
+
+
+    /**
+     * @brief Policy for the construction of the SeqMulticolorSOR smoother
+     */
+    template<class M, class X, class Y>
+    struct ConstructionTraits<SeqMulticolorSOR<M,X,Y> >
+    {
+      typedef DefaultConstructionArgs<SeqMulticolorSOR<M,X,Y> > Arguments;
+
+      static inline std::shared_ptr<SeqMulticolorSOR<M,X,Y>> construct(Arguments& args)
+      {
+        return std::make_shared<SeqMulticolorSOR<M,X,Y>>
+          (args.getMatrix(), args.getArgs().iterations, args.getArgs().relaxationFactor);
+      }
+    };
+
+
+    /**
+     * @brief Policy for the construction of the SeqChebyshev smoother
+     *
+     * The number of iterations is used as the degree of the polynomial.
+     */
+    template<class M, class X, class Y>
+    struct ConstructionTraits<SeqChebyshev<M,X,Y> >
+    {
+      typedef DefaultConstructionArgs<SeqChebyshev<M,X,Y> > Arguments;
+
+      static inline std::shared_ptr<SeqChebyshev<M,X,Y>> construct(Arguments& args)
+      {
+        return std::make_shared<SeqChebyshev<M,X,Y>>
+          (args.getMatrix(), args.getArgs().iterations);
+      }
+    };
+
+
+    /**
+     * @brief Policy for the construction of the SeqFSAI smoother
+     *
+     * The pattern of the approximate inverse is the lower triangular part of the pattern of the matrix.
+     */
+    template<class M, class X, class Y>
+    struct ConstructionTraits<SeqFSAI<M,X,Y> >
+    {
+      typedef DefaultConstructionArgs<SeqFSAI<M,X,Y> > Arguments;
+
+      static inline std::shared_ptr<SeqFSAI<M,X,Y>> construct(Arguments& args)
+      {
+        return std::make_shared<SeqFSAI<M,X,Y>>
+          (args.getMatrix(), 1, args.getArgs().relaxationFactor);
+      }
+    };
+
     /**
      * @brief Policy for the construction of the SeqJac smoother
      */
@@ -459,6 +526,25 @@ namespace Dune
       }
     };
 
+    template<class M, class X, class Y>
+    struct SmootherApplier<SeqMulticolorSOR<M,X,Y> >
+    {
+      typedef SeqMulticolorSOR<M,X,Y> Smoother;
+      typedef typename Smoother::range_type Range;
+      typedef typename Smoother::domain_type Domain;
+
+      static void preSmooth(Smoother& smoother, Domain& v, Range& d)
+      {
+        smoother.template apply<true>(v,d);
+      }
+
+
+      static void postSmooth(Smoother& smoother, Domain& v, Range& d)
+      {
+        smoother.template apply<false>(v,d);
+      }
+    };
+
     template<class M, class X, class Y, class C, int l>
     struct SmootherApplier<BlockPreconditioner<X,Y,C,SeqSOR<M,X,Y,l> > >
     {
@@ -539,10 +625,13 @@ namespace Dune
 
       Overlap overlap;
       bool onthefly;
+      /** @brief Whether the subdomains are solved by the threads of the ThreadPool. */
+      bool threaded;
 
       SeqOverlappingSchwarzSmootherArgs(Overlap overlap_=vertex,
-                                        bool onthefly_=false)
-        : overlap(overlap_), onthefly(onthefly_)
+                                        bool onthefly_=false,
+                                        bool threaded_=false)
+        : overlap(overlap_), onthefly(onthefly_), threaded(threaded_)
       {}
     };
 
@@ -860,7 +949,8 @@ namespace Dune
           (args.getMatrix(),
            args.getSubDomains(),
            args.getArgs().relaxationFactor,
-           args.getArgs().onthefly);
+           args.getArgs().onthefly,
+           args.getArgs().threaded);
       }
     };
 
@@ -0,0 +1,94 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+/** \file \brief Tests the memory report of the AMG.
+ */
+
+#include <cstddef>
+#include <vector>
+
+#include <dune/common/test/testsuite.hh>
+
+#include <dune/istl/memoryusage.hh>
+#include <dune/istl/paamg/amg.hh>
+#include <dune/istl/paamg/pinfo.hh>
+
+#include "anisotropic.hh"
+
+typedef Dune::BCRSMatrix<Dune::FieldMatrix<double,1,1> > BCRSMat;
+typedef Dune::BlockVector<Dune::FieldVector<double,1> > Vector;
+typedef Dune::MatrixAdapter<BCRSMat,Vector,Vector> Operator;
+typedef Dune::SeqILU<BCRSMat,Vector,Vector> Smoother;
+typedef Dune::Amg::AMG<Operator,Vector,Smoother> AMG;
+typedef Dune::Amg::CoarsenCriterion<Dune::Amg::SymmetricCriterion<BCRSMat,Dune::Amg::FirstDiagonal> > Criterion;
+
+const int N = 40;
+
+void testContainers(Dune::TestSuite& t)
+{
+  const BCRSMat A = setupLaplacian2d(N);
+  t.check(Dune::memoryUsage(A) >= A.nonzeroes()*(sizeof(double) + sizeof(std::size_t)));
+
+  Vector v(A.N());
+  t.check(Dune::memoryUsage(v) == A.N()*sizeof(double));
+
+  // the decomposition of the ILU is reported, a preconditioner without own storage reports 0
+  Smoother ilu(A, 1.0);
+  t.check(Dune::memoryUsage(ilu) >= A.nonzeroes()*sizeof(double));
+  Dune::SeqSSOR<BCRSMat,Vector,Vector> ssor(A, 1, 1.0);
+  t.check(Dune::memoryUsage(ssor) == 0);
+}
+
+void testAMG(Dune::TestSuite& t)
+{
+  const BCRSMat A = setupLaplacian2d(N);
+  Operator op(A);
+  Criterion criterion(15, 50);
+  criterion.setDefaultValuesIsotropic(2);
+  criterion.setDebugLevel(0);
+  Dune::Amg::SmootherTraits<Smoother>::Arguments smootherArgs;
+  smootherArgs.iterations = 1;
+  AMG amg(op, criterion, smootherArgs);
+  t.require(amg.levels() > 2) << "the test needs a hierarchy with several levels";
+
+  auto usage = amg.memoryUsage();
+  t.require(usage.size() == amg.levels());
+  t.check(usage[0].matrix == Dune::memoryUsage(A));
+  for (std::size_t level=0; level+1 < usage.size(); ++level)
+  {
+    t.check(usage[level].matrix > usage[level+1].matrix) << "level " << level;
+    t.check(usage[level].aggregates > 0) << "no aggregates on level " << level;
+    t.check(usage[level].smoother > 0) << "no ILU decomposition on level " << level;
+    t.check(usage[level].vectors == 0) << "vectors before pre()";
+    t.check(usage[level].coarseSolver == 0);
+    t.check(usage[level].total() >= usage[level].matrix + usage[level].smoother);
+  }
+  // with a direct coarse solver no smoother is kept for the coarsest level
+  if (amg.usesDirectCoarseLevelSolver())
+    t.check(usage.back().coarseSolver == 0);
+  else
+    t.check(usage.back().coarseSolver > 0);
+
+  // the vectors of the cycle only exist between pre() and post()
+  Vector x(A.N()), b(A.N());
+  x = 0;
+  b = 1;
+  amg.pre(x, b);
+  usage = amg.memoryUsage();
+  for (std::size_t level=0; level < usage.size(); ++level)
+    t.check(usage[level].vectors > 0) << "no vectors on level " << level;
+  amg.post(x);
+  t.check(amg.memoryUsage()[0].vectors == 0);
+}
+
+int main()
+{
+  Dune::TestSuite t;
+
+  testContainers(t);
+  testAMG(t);
+
+  return t.exit();
+}
@@ -0,0 +1,159 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+/** \file \brief Tests updating an AMG for new entries of the fine level matrix.
+ */
+
+#include <memory>
+
+#include <dune/common/test/testsuite.hh>
+
+#include <dune/istl/matrixindexset.hh>
+#include <dune/istl/paamg/amg.hh>
+#include <dune/istl/paamg/pinfo.hh>
+#include <dune/istl/solvers.hh>
+
+#include "anisotropic.hh"
+
+typedef Dune::BCRSMatrix<Dune::FieldMatrix<double,1,1> > BCRSMat;
+typedef Dune::BlockVector<Dune::FieldVector<double,1> > Vector;
+typedef Dune::MatrixAdapter<BCRSMat,Vector,Vector> Operator;
+typedef Dune::SeqILU<BCRSMat,Vector,Vector> Smoother;
+typedef Dune::Amg::AMG<Operator,Vector,Smoother> AMG;
+typedef Dune::Amg::CoarsenCriterion<Dune::Amg::SymmetricCriterion<BCRSMat,Dune::Amg::FirstDiagonal> > Criterion;
+
+const int N = 40;
+
+std::unique_ptr<AMG> makeAMG(const Operator& op)
+{
+  Criterion criterion(15, 50);
+  criterion.setDefaultValuesIsotropic(2);
+  criterion.setAlpha(.67);
+  criterion.setBeta(1.0e-4);
+  criterion.setSkipIsolated(false);
+  Dune::Amg::SmootherTraits<Smoother>::Arguments smootherArgs;
+  smootherArgs.iterations = 1;
+  smootherArgs.relaxationFactor = 1;
+  return std::make_unique<AMG>(op, criterion, smootherArgs);
+}
+
+// One application of the preconditioner to d
+Vector applyAMG(AMG& amg, const Vector& d)
+{
+  Vector x(d.N()), b(d), v(d.N());
+  x = 0;
+  v = 0;
+  amg.pre(x, b);
+  amg.apply(v, d);
+  amg.post(x);
+  return v;
+}
+
+Vector defect(std::size_t n)
+{
+  Vector d(n);
+  for (std::size_t i=0; i<n; ++i)
+    d[i] = 1.0 + (i%7);
+  return d;
+}
+
+double difference(const Vector& a, const Vector& b)
+{
+  Vector c(a);
+  c -= b;
+  return c.infinity_norm()/a.infinity_norm();
+}
+
+// An update for a new matrix behaves like a new AMG if the aggregates do not change
+void testNewMatrix(Dune::TestSuite& t)
+{
+  BCRSMat A = setupLaplacian2d(N);
+  Operator opA(A);
+  auto amg = makeAMG(opA);
+  t.require(amg->levels() > 2) << "the test needs a hierarchy with several levels";
+  const Vector d = defect(A.N());
+  const Vector oldCorrection = applyAMG(*amg, d);
+
+  // scaling keeps the aggregates
+  auto B = std::make_shared<BCRSMat>(A);
+  *B *= 2.0;
+  auto opB = std::make_shared<Operator>(B);
+  amg->updateMatrix(opB);
+  // the old matrix is no longer used
+  A = 0.0;
+
+  Operator opReference(*B);
+  auto reference = makeAMG(opReference);
+  t.check(amg->levels() == reference->levels());
+
+  const Vector correction = applyAMG(*amg, d);
+  t.check(difference(applyAMG(*reference, d), correction) < 1e-8)
+    << "the updated AMG differs from a new one";
+  Vector halved(oldCorrection);
+  halved *= 0.5;
+  t.check(difference(halved, correction) < 1e-8)
+    << "the update did not reach all levels";
+}
+
+// An update after changing the entries in place
+void testInPlace(Dune::TestSuite& t)
+{
+  BCRSMat A = setupLaplacian2d(N);
+  Operator op(A);
+  auto amg = makeAMG(op);
+  const Vector d = defect(A.N());
+
+  A *= 3.0;
+  amg->updateMatrix();
+  auto reference = makeAMG(op);
+  t.check(difference(applyAMG(*reference, d), applyAMG(*amg, d)) < 1e-8)
+    << "the updated AMG differs from a new one";
+
+  // a different matrix with the same pattern, the aggregates are only reused
+  for (auto row = A.begin(); row != A.end(); ++row)
+    (*row)[row.index()] += 0.1*(row.index()%5);
+  amg->updateMatrix();
+  Vector x(A.N()), b(d);
+  x = 0;
+  Dune::CGSolver<Vector> solver(op, *amg, 1e-8, 100, 0);
+  Dune::InverseOperatorResult res;
+  solver.apply(x, b, res);
+  t.check(res.converged) << "no convergence with the updated AMG";
+}
+
+void testPatternMismatch(Dune::TestSuite& t)
+{
+  BCRSMat A = setupLaplacian2d(N);
+  Operator op(A);
+  auto amg = makeAMG(op);
+  auto B = std::make_shared<BCRSMat>(setupLaplacian2d(N+1));
+  t.checkThrow<Dune::ISTLError>([&]{ amg->updateMatrix(std::make_shared<Operator>(B)); })
+    << "a matrix of a different size was accepted";
+
+  // the same sizes and number of nonzeroes, but another column in the first row
+  Dune::MatrixIndexSet pattern(A.N(), A.M());
+  for (auto row = A.begin(); row != A.end(); ++row)
+    for (auto entry = row->begin(); entry != row->end(); ++entry)
+      if (row.index() != 0 || entry.index() != 1)
+        pattern.add(row.index(), entry.index());
+  pattern.add(0, A.M()-1);
+  auto C = std::make_shared<BCRSMat>();
+  pattern.exportIdx(*C);
+  *C = 1.0;
+  t.require(C->nonzeroes() == A.nonzeroes());
+  t.checkThrow<Dune::ISTLError>([&]{ amg->updateMatrix(std::make_shared<Operator>(C)); })
+    << "a matrix with a different pattern of the same size was accepted";
+}
+
+int main()
+{
+  Dune::TestSuite t;
+
+  testNewMatrix(t);
+  testInPlace(t);
+  testPatternMismatch(t);
+
+  return t.exit();
+}
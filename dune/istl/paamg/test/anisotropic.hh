@@ -195,4 +195,17 @@ Dune::BCRSMatrix<MatrixEntry> setupAnisotropic2d(int N, Dune::ParallelIndexSet<G
 
   return mat;
 }
+
+/**
+ * \brief The sequential isotropic Laplacian on a N x N grid, built with setupAnisotropic2d.
+ * \tparam MatrixEntry The block type of the matrix
+ */
+template<class MatrixEntry = Dune::FieldMatrix<double,1,1> >
+Dune::BCRSMatrix<MatrixEntry> setupLaplacian2d(int N)
+{
+  Dune::ParallelIndexSet<int,LocalIndex,512> indices;
+  Dune::Communication<void*> comm;
+  int n;
+  return setupAnisotropic2d<MatrixEntry>(N, indices, comm, &n, 1.0);
+}
 #endif
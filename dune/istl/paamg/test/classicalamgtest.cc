@@ -0,0 +1,205 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+/** \file \brief Tests the C/F splittings, the interpolations and the solver of classical AMG.
+ */
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include <dune/common/test/testsuite.hh>
+
+#include <dune/istl/operators.hh>
+#include <dune/istl/solvers.hh>
+#include <dune/istl/paamg/classicalamg.hh>
+
+#include "anisotropic.hh"
+
+typedef Dune::BCRSMatrix<Dune::FieldMatrix<double,1,1> > Matrix;
+typedef Dune::BlockVector<Dune::FieldVector<double,1> > Vector;
+typedef Dune::MatrixAdapter<Matrix,Vector,Vector> Operator;
+typedef Dune::SeqSSOR<Matrix,Vector,Vector> Smoother;
+typedef Dune::Amg::ClassicalAMG<Operator,Vector,Smoother> AMG;
+
+using Dune::Amg::CFMarker;
+
+const int N = 40;
+
+// A Laplacian whose coefficients jump by several orders of magnitude
+Matrix jumpingCoefficients(int n)
+{
+  Matrix A = setupLaplacian2d(n);
+  std::vector<double> coefficient(A.N());
+  for (std::size_t i=0; i<A.N(); ++i)
+    coefficient[i] = ((i%n) < std::size_t(n/2)) == ((i/n) < std::size_t(n/2)) ? 1.0 : 1e3;
+  // harmonic average on the edges keeps the matrix symmetric
+  for (auto row = A.begin(); row != A.end(); ++row)
+  {
+    double diagonal = 0;
+    for (auto entry = row->begin(); entry != row->end(); ++entry)
+      if (entry.index() != row.index())
+      {
+        const double a = coefficient[row.index()], b = coefficient[entry.index()];
+        *entry = -2*a*b/(a+b);
+        diagonal -= (*entry)[0][0];
+      }
+    // the Dirichlet boundary
+    (*row)[row.index()] = diagonal + (4-(row->size()-1))*coefficient[row.index()];
+  }
+  return A;
+}
+
+Dune::Amg::ClassicalCriterion criterion(Dune::Amg::ClassicalCoarsening coarsening,
+                                        Dune::Amg::ClassicalInterpolation interpolation)
+{
+  Dune::Amg::ClassicalCriterion criterion(10, 50);
+  criterion.setCoarsening(coarsening);
+  criterion.setInterpolation(interpolation);
+  criterion.setDebugLevel(0);
+  return criterion;
+}
+
+// Each fine point with strong connections strongly depends on a coarse point
+bool interpolatable(const Dune::Amg::StrongConnections& s, const std::vector<CFMarker>& marker)
+{
+  for (std::size_t i=0; i<s.size(); ++i)
+  {
+    if (marker[i] == CFMarker::undecided)
+      return false;
+    if (marker[i] == CFMarker::coarse || s.count(i) == 0)
+      continue;
+    bool found = false;
+    for (const std::size_t* j=s.begin(i); j!=s.end(i); ++j)
+      found = found || marker[*j] == CFMarker::coarse;
+    if (!found)
+      return false;
+  }
+  return true;
+}
+
+// Strongly connected fine points share a coarse point
+bool rugeStuebenProperty(const Dune::Amg::StrongConnections& s, const std::vector<CFMarker>& marker)
+{
+  for (std::size_t i=0; i<s.size(); ++i)
+    for (const std::size_t* j=s.begin(i); marker[i] == CFMarker::fine && j!=s.end(i); ++j)
+    {
+      if (marker[*j] != CFMarker::fine)
+        continue;
+      bool common = false;
+      for (const std::size_t* k=s.begin(i); k!=s.end(i); ++k)
+        for (const std::size_t* l=s.begin(*j); l!=s.end(*j); ++l)
+          common = common || (*k == *l && marker[*k] == CFMarker::coarse);
+      if (!common)
+        return false;
+    }
+  return true;
+}
+
+void testSplitting(Dune::TestSuite& t)
+{
+  const Matrix A = jumpingCoefficients(N);
+  const auto s = Dune::Amg::strongConnections(A, 0.25);
+  t.check(s.size() == A.N());
+  const auto st = s.transposed();
+  t.check(st.columns.size() == s.columns.size());
+
+  const auto rs = Dune::Amg::rugeStuebenSplitting(s);
+  t.check(interpolatable(s, rs)) << "Ruge-Stueben left a fine point without coarse neighbour";
+  t.check(rugeStuebenProperty(s, rs)) << "Ruge-Stueben second pass incomplete";
+
+  const auto pmis = Dune::Amg::pmisSplitting(s);
+  t.check(interpolatable(s, pmis)) << "PMIS left a fine point without coarse neighbour";
+  // PMIS coarsens more aggressively
+  std::size_t rsCoarse, pmisCoarse;
+  Dune::Amg::coarseIndices(rs, rsCoarse);
+  Dune::Amg::coarseIndices(pmis, pmisCoarse);
+  t.check(pmisCoarse <= rsCoarse) << pmisCoarse << " PMIS and " << rsCoarse << " RS coarse points";
+  t.check(rsCoarse < A.N() && pmisCoarse > 0);
+}
+
+// The interpolation is the identity on coarse points and preserves constants away from the boundary
+template<class Interpolation>
+void testInterpolation(Dune::TestSuite& t, Interpolation interpolation, Dune::Amg::ClassicalCoarsening coarsening)
+{
+  const Matrix A = jumpingCoefficients(N);
+  const auto s = Dune::Amg::strongConnections(A, 0.25);
+  const auto marker = coarsening == Dune::Amg::ClassicalCoarsening::rugeStueben
+    ? Dune::Amg::rugeStuebenSplitting(s) : Dune::Amg::pmisSplitting(s);
+  std::size_t coarseSize;
+  const auto index = Dune::Amg::coarseIndices(marker, coarseSize);
+
+  Matrix P;
+  interpolation(A, s, marker, P);
+  t.require(P.N() == A.N() && P.M() == coarseSize);
+
+  Vector one(coarseSize), y(A.N());
+  one = 1.0;
+  P.mv(one, y);
+  for (std::size_t i=0; i<A.N(); ++i)
+  {
+    if (marker[i] == CFMarker::coarse)
+    {
+      t.check(P[i].size() == 1 && P[i][index[i]][0][0] == 1.0) << "coarse row " << i << " is not the identity";
+      continue;
+    }
+    // rows of A without boundary contribution sum to zero
+    double sum = 0;
+    for (auto entry = A[i].begin(); entry != A[i].end(); ++entry)
+      sum += (*entry)[0][0];
+    if (std::abs(sum) < 1e-10*A[i][i][0][0])
+      t.check(std::abs(y[i][0] - 1.0) < 1e-10) << "constant not interpolated in row " << i;
+  }
+}
+
+void testSolver(Dune::TestSuite& t, Dune::Amg::ClassicalCoarsening coarsening,
+                Dune::Amg::ClassicalInterpolation interpolation)
+{
+  const Matrix A = jumpingCoefficients(N);
+  Operator op(A);
+  AMG::SmootherArgs smootherArgs;
+  smootherArgs.iterations = 1;
+  AMG amg(op, criterion(coarsening, interpolation), smootherArgs);
+  t.check(amg.levels() > 2) << "only " << amg.levels() << " levels";
+  for (std::size_t l=0; l+1<amg.levels(); ++l)
+    t.check(amg.prolongation(l).N() == amg.matrix(l).N()
+            && amg.prolongation(l).M() == amg.matrix(l+1).N());
+
+  Vector x(A.N()), b(A.N());
+  x = 0;
+  for (std::size_t i=0; i<b.N(); ++i)
+    b[i] = 1.0 + (i%5);
+  Dune::CGSolver<Vector> solver(op, amg, 1e-8, 100, 0);
+  Dune::InverseOperatorResult res;
+  solver.apply(x, b, res);
+  t.check(res.converged) << "no convergence with classical AMG";
+  t.check(res.iterations < 30) << res.iterations << " iterations";
+}
+
+int main()
+{
+  Dune::TestSuite t;
+  typedef Dune::Amg::ClassicalCoarsening Coarsening;
+  typedef Dune::Amg::ClassicalInterpolation Interpolation;
+
+  testSplitting(t);
+  testInterpolation(t, [](auto&&... args) { Dune::Amg::directInterpolation(args...); },
+                    Coarsening::rugeStueben);
+  testInterpolation(t, [](auto&&... args) { Dune::Amg::extendedPlusIInterpolation(args...); },
+                    Coarsening::pmis);
+  testSolver(t, Coarsening::rugeStueben, Interpolation::direct);
+  testSolver(t, Coarsening::pmis, Interpolation::extendedPlusI);
+
+  // a matrix without off-diagonal couplings cannot be coarsened
+  Matrix D = jumpingCoefficients(4);
+  for (auto row = D.begin(); row != D.end(); ++row)
+    for (auto entry = row->begin(); entry != row->end(); ++entry)
+      if (entry.index() != row.index())
+        *entry = 0.0;
+  Operator op(D);
+  t.checkThrow<Dune::ISTLError>([&]{ AMG amg(op, criterion(Coarsening::rugeStueben, Interpolation::direct)); });
+
+  return t.exit();
+}
@@ -287,6 +287,42 @@ int testEdge()
 
 }
 
+int testFlagAccess()
+{
+  int ret=0;
+
+  // The properties are stored once per vertex and matrix entry.
+  static_assert(sizeof(Dune::Amg::EdgeProperties)==1);
+  static_assert(sizeof(Dune::Amg::VertexProperties)==1);
+
+  Dune::Amg::EdgeProperties edge;
+  edge[Dune::Amg::EdgeProperties::DEPEND] = true;
+  if(!edge.depends() || edge.influences() || !edge.isOneWay()) {
+    std::cerr<<"Setting the depends bit directly failed!"<<__FILE__ ":"<<__LINE__
+             <<std::endl;
+    ret++;
+  }
+  edge[Dune::Amg::EdgeProperties::INFLUENCE] = edge[Dune::Amg::EdgeProperties::DEPEND];
+  edge[Dune::Amg::EdgeProperties::DEPEND] = false;
+  if(edge.depends() || !edge[Dune::Amg::EdgeProperties::INFLUENCE]) {
+    std::cerr<<"Copying a bit failed!"<<__FILE__ ":"<<__LINE__
+             <<std::endl;
+    ret++;
+  }
+
+  Dune::Amg::VertexProperties vertex;
+  vertex[Dune::Amg::VertexProperties::VISITED].flip();
+  if(!vertex.visited() || vertex.front() || ~vertex[Dune::Amg::VertexProperties::VISITED]) {
+    std::cerr<<"Flipping the visited bit failed!"<<__FILE__ ":"<<__LINE__
+             <<std::endl;
+    ret++;
+  }
+  vertex.reset();
+  ret+=testVertexReset(vertex);
+
+  return ret;
+}
+
 template<int N, class M>
 void setupSparsityPattern(M& A)
 {
@@ -547,7 +583,7 @@ int main (int argc , char ** argv)
   try {
     testGraph();
     testAggregate();
-    exit(testEdge());
+    exit(testEdge()+testVertex()+testFlagAccess());
   }
   catch(std::exception& e)
   {
@@ -0,0 +1,94 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+/** \file \brief Tests building and applying a parallel AMG while an instrumentation is active.
+ *
+ * The setup communicates std::vector and the global aggregate numbers, which
+ * do not have a block_type, so this also checks that the communication
+ * statistics compile for all types communicated by the AMG.
+ */
+
+#include <string>
+#include <vector>
+
+#include <dune/common/parallel/indexset.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/common/test/testsuite.hh>
+
+#include <dune/istl/owneroverlapcopy.hh>
+#include <dune/istl/schwarz.hh>
+#include <dune/istl/solvers.hh>
+#include <dune/istl/common/instrumentation.hh>
+#include <dune/istl/paamg/amg.hh>
+#include <dune/istl/paamg/pinfo.hh>
+
+#include "anisotropic.hh"
+
+typedef Dune::Instrumentation::Node Node;
+
+// The number of bytes recorded by all communication scopes below a node
+double communicatedBytes(const Node& node)
+{
+  double bytes = node.name == "communication" ? node.bytes : 0.0;
+  for (const Node& child : node.children)
+    bytes += communicatedBytes(child);
+  return bytes;
+}
+
+int main(int argc, char** argv)
+{
+  Dune::MPIHelper& helper = Dune::MPIHelper::instance(argc, argv);
+  Dune::TestSuite t;
+
+  typedef Dune::FieldMatrix<double,1,1> MatrixBlock;
+  typedef Dune::BCRSMatrix<MatrixBlock> BCRSMat;
+  typedef Dune::BlockVector<Dune::FieldVector<double,1> > Vector;
+  typedef Dune::OwnerOverlapCopyCommunication<int> Communication;
+  typedef Dune::OverlappingSchwarzOperator<BCRSMat,Vector,Vector,Communication> Operator;
+  typedef Dune::SeqSSOR<BCRSMat,Vector,Vector> Smoother;
+  typedef Dune::BlockPreconditioner<Vector,Vector,Communication,Smoother> ParSmoother;
+  typedef Dune::Amg::CoarsenCriterion<Dune::Amg::SymmetricCriterion<BCRSMat,Dune::Amg::FirstDiagonal> > Criterion;
+  typedef Dune::Amg::AMG<Operator,Vector,ParSmoother,Communication> AMG;
+
+  const int N = 60;
+  int n;
+  Communication comm(MPI_COMM_WORLD);
+  BCRSMat mat = setupAnisotropic2d<MatrixBlock>(N, comm.indexSet(), comm.communicator(), &n, 1);
+  comm.remoteIndices().template rebuild<false>();
+
+  Vector b(mat.N()), x(mat.M());
+  b = 0;
+  x = 100;
+  setBoundary(x, b, N, comm.indexSet());
+
+  Dune::Instrumentation instrumentation("parallel AMG");
+  {
+    Dune::Instrumentation::Activation activation(instrumentation);
+
+    Operator op(mat, comm);
+    Dune::OverlappingSchwarzScalarProduct<Vector,Communication> sp(comm);
+    Criterion criterion(15, 100);
+    criterion.setDefaultValuesIsotropic(2);
+    criterion.setDebugLevel(0);
+    Dune::Amg::SmootherTraits<ParSmoother>::Arguments smootherArgs;
+    smootherArgs.iterations = 1;
+    AMG amg(op, criterion, smootherArgs, comm);
+
+    Dune::CGSolver<Vector> solver(op, sp, amg, 1e-8, 300, 0);
+    Dune::InverseOperatorResult res;
+    solver.apply(x, b, res);
+    t.check(res.converged) << "no convergence of the instrumented parallel AMG";
+
+    // a communicated type without block_type
+    std::vector<int> flags(mat.N(), helper.rank());
+    comm.copyOwnerToAll(flags, flags);
+  }
+
+  if (helper.size() > 1)
+    t.check(communicatedBytes(instrumentation.root()) > 0.0)
+      << "no communicated bytes recorded";
+
+  return t.exit();
+}
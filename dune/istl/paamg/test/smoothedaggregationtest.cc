@@ -0,0 +1,192 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+/** \file \brief Tests the transfer operators and the solver of smoothed aggregation.
+ */
+
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include <dune/common/test/testsuite.hh>
+
+#include <dune/istl/matrixmatrix.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/solvers.hh>
+#include <dune/istl/paamg/smoothedaggregation.hh>
+
+#include "anisotropic.hh"
+
+typedef Dune::BCRSMatrix<Dune::FieldMatrix<double,1,1> > ScalarMatrix;
+typedef Dune::BlockVector<Dune::FieldVector<double,1> > ScalarVector;
+typedef Dune::BCRSMatrix<Dune::FieldMatrix<double,2,2> > BlockMatrix;
+typedef Dune::BlockVector<Dune::FieldVector<double,2> > BlockVector;
+
+const int N = 40;
+
+// A vector-valued Laplacian whose components are weakly coupled
+BlockMatrix vectorLaplacian(int n)
+{
+  BlockMatrix A = setupLaplacian2d<Dune::FieldMatrix<double,2,2> >(n);
+  for (auto row = A.begin(); row != A.end(); ++row)
+  {
+    auto& diagonal = (*row)[row.index()];
+    diagonal[0][1] = diagonal[1][0] = 0.5;
+  }
+  return A;
+}
+
+std::vector<Dune::FieldVector<double,2> > coordinates(int n)
+{
+  std::vector<Dune::FieldVector<double,2> > x(n*n);
+  for (int i=0; i<n*n; ++i)
+    x[i] = {double(i%n)/n, double(i/n)/n};
+  return x;
+}
+
+Dune::Amg::Parameters parameters()
+{
+  Dune::Amg::Parameters parameters(10, 50);
+  parameters.setDefaultValuesIsotropic(2);
+  parameters.setSkipIsolated(false);
+  parameters.setDebugLevel(0);
+  return parameters;
+}
+
+// The tentative prolongation has orthonormal columns and reproduces the near-nullspace
+template<class Matrix, class Vector, int k>
+void testTentativeProlongation(Dune::TestSuite& t, const Matrix& A, const std::vector<Vector>& nullspace)
+{
+  typedef Dune::Amg::MatrixGraph<const Matrix> MatrixGraph;
+  typedef Dune::Amg::SubGraph<MatrixGraph,std::vector<bool> > SubGraph;
+  typedef Dune::Amg::PropertiesGraph<SubGraph,Dune::Amg::VertexProperties,
+      Dune::Amg::EdgeProperties, Dune::IdentityMap, typename SubGraph::EdgeIndexMap> PropertiesGraph;
+  typedef Dune::Amg::CoarsenCriterion<Dune::Amg::SymmetricCriterion<Matrix,Dune::Amg::FrobeniusNorm> > Criterion;
+  constexpr int n = Matrix::block_type::rows;
+  typedef Dune::FieldMatrix<double,n,k> Block;
+
+  MatrixGraph mg(A);
+  std::vector<bool> excluded(A.N(), false);
+  SubGraph sg(mg, excluded);
+  PropertiesGraph pg(sg, Dune::IdentityMap(), sg.getEdgeIndexMap());
+  Dune::Amg::AggregatesMap<std::size_t> aggregates(pg.noVertices());
+  int noAggregates, isoAggregates, oneAggregates, skipped;
+  std::tie(noAggregates, isoAggregates, oneAggregates, skipped)
+    = aggregates.buildAggregates(A, pg, Criterion(parameters()), true);
+  t.require(noAggregates > 0 && std::size_t(noAggregates) < A.N()) << "no aggregates built";
+
+  Dune::BCRSMatrix<Block> P;
+  std::vector<Dune::BlockVector<Dune::FieldVector<double,k> > > coarseNullspace;
+  Dune::Amg::buildTentativeProlongation(aggregates, noAggregates, nullspace, P, coarseNullspace);
+  t.check(P.N() == A.N() && P.M() == std::size_t(noAggregates));
+  t.check(coarseNullspace.size() == std::size_t(k));
+
+  for (int c=0; c<k; ++c)
+  {
+    Vector y(A.N());
+    P.mv(coarseNullspace[c], y);
+    y -= nullspace[c];
+    t.check(y.infinity_norm() < 1e-12) << "near-nullspace vector " << c << " not reproduced";
+  }
+
+  Dune::BCRSMatrix<Dune::FieldMatrix<double,k,k> > PtP;
+  Dune::transposeMatMultMat(PtP, P, P);
+  for (auto row = PtP.begin(); row != PtP.end(); ++row)
+    for (auto entry = row->begin(); entry != row->end(); ++entry)
+      for (int i=0; i<k; ++i)
+        for (int j=0; j<k; ++j)
+        {
+          const bool diagonal = row.index() == entry.index() && i == j;
+          // dependent columns of small aggregates are zero
+          t.check(std::abs((*entry)[i][j] - (diagonal ? 1.0 : 0.0)) < 1e-12
+                  || (diagonal && (*entry)[i][j] == 0.0))
+            << "columns of the tentative prolongation are not orthonormal";
+        }
+}
+
+template<class AMG, class Matrix, class Vector>
+int solve(Dune::TestSuite& t, const Matrix& A, AMG& amg)
+{
+  typedef Dune::MatrixAdapter<Matrix,Vector,Vector> Operator;
+  Operator op(A);
+  Vector x(A.N()), b(A.N());
+  x = 0;
+  for (std::size_t i=0; i<b.N(); ++i)
+    b[i] = 1.0 + (i%5);
+  Dune::CGSolver<Vector> solver(op, amg, 1e-8, 100, 0);
+  Dune::InverseOperatorResult res;
+  solver.apply(x, b, res);
+  t.check(res.converged) << "no convergence with smoothed aggregation";
+
+  // the solution satisfies the equation
+  for (std::size_t i=0; i<b.N(); ++i)
+    b[i] = 1.0 + (i%5);
+  A.mmv(x, b);
+  t.check(b.two_norm() < 1e-6*A.N()) << "wrong solution";
+  return res.iterations;
+}
+
+void testScalar(Dune::TestSuite& t)
+{
+  typedef Dune::MatrixAdapter<ScalarMatrix,ScalarVector,ScalarVector> Operator;
+  typedef Dune::SeqSSOR<ScalarMatrix,ScalarVector,ScalarVector> Smoother;
+  typedef Dune::Amg::SmoothedAggregationAMG<Operator,ScalarVector,Smoother> AMG;
+
+  ScalarMatrix A = setupLaplacian2d(N);
+  const auto nullspace = AMG::constantNullspace(A.N());
+  testTentativeProlongation<ScalarMatrix,ScalarVector,1>(t, A, nullspace);
+
+  Operator op(A);
+  AMG::SmootherArgs smootherArgs;
+  smootherArgs.iterations = 1;
+  AMG amg(op, nullspace, parameters(), smootherArgs);
+  t.check(amg.levels() > 2) << "only " << amg.levels() << " levels";
+
+  // the smoothed prolongation is denser than the tentative one
+  t.check(amg.fineProlongation().nonzeroes() > A.N());
+  const auto& coarse = amg.coarseMatrix(1);
+  t.check(coarse.N() == amg.fineProlongation().M() && coarse.M() == coarse.N());
+
+  const int iterations = solve<AMG,ScalarMatrix,ScalarVector>(t, A, amg);
+  t.check(iterations < 25) << iterations << " iterations";
+}
+
+void testBlock(Dune::TestSuite& t)
+{
+  typedef Dune::MatrixAdapter<BlockMatrix,BlockVector,BlockVector> Operator;
+  typedef Dune::SeqSSOR<BlockMatrix,BlockVector,BlockVector> Smoother;
+  typedef Dune::Amg::SmoothedAggregationAMG<Operator,BlockVector,Smoother,3> AMG;
+
+  BlockMatrix A = vectorLaplacian(N);
+  const auto nullspace = Dune::Amg::rigidBodyModes(coordinates(N));
+  t.require(nullspace.size() == 3);
+  testTentativeProlongation<BlockMatrix,BlockVector,3>(t, A, nullspace);
+
+  Operator op(A);
+  AMG amg(op, nullspace, parameters());
+  t.check(amg.levels() > 1);
+  // the coarse levels have one unknown per near-nullspace vector
+  t.check(amg.fineProlongation().N() == A.N());
+  static_assert(AMG::CoarseMatrix::block_type::rows == 3);
+
+  solve<AMG,BlockMatrix,BlockVector>(t, A, amg);
+
+  // the number of near-nullspace vectors is checked
+  auto wrong = nullspace;
+  wrong.pop_back();
+  t.checkThrow<Dune::ISTLError>([&]{ AMG other(op, wrong, parameters()); });
+}
+
+int main()
+{
+  Dune::TestSuite t;
+
+  testScalar(t);
+  testBlock(t);
+
+  return t.exit();
+}
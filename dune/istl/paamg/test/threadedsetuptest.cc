@@ -0,0 +1,135 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+/** \file \brief Tests the threaded aggregation and Galerkin product of the AMG setup.
+ */
+
+#include <cstddef>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include <dune/common/propertymap.hh>
+#include <dune/common/test/testsuite.hh>
+
+#include <dune/istl/common/threadpool.hh>
+#include <dune/istl/paamg/amg.hh>
+#include <dune/istl/paamg/galerkin.hh>
+#include <dune/istl/paamg/pinfo.hh>
+#include <dune/istl/solvers.hh>
+
+#include "anisotropic.hh"
+
+typedef Dune::BCRSMatrix<Dune::FieldMatrix<double,1,1> > BCRSMat;
+typedef Dune::BlockVector<Dune::FieldVector<double,1> > Vector;
+typedef Dune::Amg::MatrixGraph<BCRSMat> MatrixGraph;
+typedef Dune::Amg::SubGraph<MatrixGraph,std::vector<bool> > SubGraph;
+typedef Dune::Amg::PropertiesGraph<SubGraph,Dune::Amg::VertexProperties,
+    Dune::Amg::EdgeProperties, Dune::IdentityMap, typename SubGraph::EdgeIndexMap> PropertiesGraph;
+typedef PropertiesGraph::VertexDescriptor Vertex;
+typedef Dune::Amg::CoarsenCriterion<Dune::Amg::SymmetricCriterion<BCRSMat,Dune::Amg::FirstDiagonal> > Criterion;
+
+// Build the aggregates and the coarse matrix with the given number of threads
+int coarsen(const BCRSMat& mat, const Criterion& criterion, std::size_t threads,
+            std::vector<Vertex>& aggregates, std::shared_ptr<BCRSMat>& coarse)
+{
+  Dune::ThreadPool::instance().setNumThreads(threads);
+
+  MatrixGraph mg(mat);
+  std::vector<bool> excluded(mat.N(), false);
+  SubGraph sg(mg, excluded);
+  PropertiesGraph pg(sg, Dune::IdentityMap(), sg.getEdgeIndexMap());
+  Dune::Amg::AggregatesMap<Vertex> aggregatesMap(pg.noVertices());
+  int noAggregates, isoAggregates, oneAggregates, skipped;
+  std::tie(noAggregates, isoAggregates, oneAggregates, skipped) = aggregatesMap.buildAggregates(mat, pg, criterion, true);
+  aggregates.assign(aggregatesMap.begin(), aggregatesMap.end());
+
+  std::vector<bool> visited(mat.N(), false);
+  typedef Dune::IteratorPropertyMap<std::vector<bool>::iterator, Dune::IdentityMap> VisitedMap;
+  VisitedMap visitedMap(visited.begin(), Dune::IdentityMap());
+  Dune::Amg::SequentialInformation pinfo;
+  Dune::Amg::GalerkinProduct<Dune::Amg::SequentialInformation> productBuilder;
+  typedef Dune::EnumItem<GridFlag,GridAttributes::copy> CopyFlags;
+  coarse.reset(productBuilder.build(mg, visitedMap, pinfo, aggregatesMap, noAggregates, CopyFlags()));
+  productBuilder.calculate(mat, aggregatesMap, *coarse, pinfo, CopyFlags());
+
+  Dune::ThreadPool::instance().setNumThreads(1);
+  return noAggregates;
+}
+
+int solve(const BCRSMat& mat, const Criterion& criterion)
+{
+  typedef Dune::MatrixAdapter<BCRSMat,Vector,Vector> Operator;
+  typedef Dune::SeqSSOR<BCRSMat,Vector,Vector> Smoother;
+  Operator op(mat);
+  Dune::Amg::SmootherTraits<Smoother>::Arguments smootherArgs;
+  smootherArgs.iterations = 1;
+  smootherArgs.relaxationFactor = 1;
+  Dune::Amg::AMG<Operator,Vector,Smoother> amg(op, criterion, smootherArgs);
+
+  Vector x(mat.N()), b(mat.N());
+  x = 1.0;
+  mat.mv(x, b);
+  x = 0;
+  Dune::CGSolver<Vector> cg(op, amg, 1e-8, 100, 0);
+  Dune::InverseOperatorResult res;
+  cg.apply(x, b, res);
+  return res.converged ? res.iterations : 1000;
+}
+
+int main()
+{
+  Dune::TestSuite t;
+  const int N = 100;
+  BCRSMat mat = setupLaplacian2d(N);
+
+  Criterion criterion;
+  criterion.setDefaultValuesIsotropic(2);
+  criterion.setCoarsenTarget(100);
+  criterion.setThreadedAggregation(true);
+
+  // the threaded aggregation does not depend on the number of threads
+  std::vector<Vertex> aggregates1, aggregates4;
+  std::shared_ptr<BCRSMat> coarse1, coarse4;
+  int noAggregates = coarsen(mat, criterion, 1, aggregates1, coarse1);
+  coarsen(mat, criterion, 4, aggregates4, coarse4);
+  t.check(aggregates1 == aggregates4) << "aggregates depend on the number of threads";
+
+  // all vertices are aggregated and the aggregates are numbered by their first vertex
+  Vertex next = 0;
+  for (Vertex aggregate : aggregates1)
+  {
+    t.check(aggregate != Dune::Amg::AggregatesMap<Vertex>::UNAGGREGATED) << "vertex not aggregated";
+    if (aggregate == next)
+      ++next;
+    else
+      t.check(aggregate < next) << "aggregates are not numbered by their first vertex";
+  }
+  t.check(int(next) == noAggregates);
+
+  // the threaded Galerkin product yields the same coarse matrix
+  *coarse4 -= *coarse1;
+  t.check(coarse4->infinity_norm() == 0.0) << "threaded Galerkin product differs";
+
+  // the coarsening rate is comparable to the sequential aggregation
+  Criterion sequential(criterion);
+  sequential.setThreadedAggregation(false);
+  std::vector<Vertex> aggregatesSeq;
+  std::shared_ptr<BCRSMat> coarseSeq;
+  int noAggregatesSeq = coarsen(mat, sequential, 1, aggregatesSeq, coarseSeq);
+  t.check(noAggregates < 2*noAggregatesSeq && noAggregatesSeq < 2*noAggregates)
+    << noAggregates << " threaded aggregates, " << noAggregatesSeq << " sequential aggregates";
+
+  // the convergence of AMG is comparable
+  Dune::ThreadPool::instance().setNumThreads(4);
+  int iterations = solve(mat, criterion);
+  Dune::ThreadPool::instance().setNumThreads(1);
+  int iterationsSeq = solve(mat, sequential);
+  t.check(iterations <= 2*iterationsSeq)
+    << "AMG with threaded aggregation needed " << iterations << " iterations, "
+    << iterationsSeq << " with sequential aggregation";
+
+  return t.exit();
+}
@@ -5,12 +5,18 @@
 #ifndef DUNE_ISTL_PRECONDITIONERS_HH
 #define DUNE_ISTL_PRECONDITIONERS_HH
 
+#include <algorithm>
 #include <cmath>
 #include <complex>
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
 #include <iomanip>
+#include <initializer_list>
+#include <limits>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <dune/common/simd/simd.hh>
 #include <dune/common/parametertree.hh>
@@ -20,9 +26,13 @@
 #include "solver.hh"
 #include "solvercategory.hh"
 #include "istlexception.hh"
+#include "matrixindexset.hh"
 #include "matrixutils.hh"
+#include "memoryusage.hh"
+#include "foreach.hh"
 #include "gsetc.hh"
 #include "dilu.hh"
+#include "fsai.hh"
 #include "ildl.hh"
 #include "ilu.hh"
 
@@ -399,6 +409,286 @@ namespace Dune {
   using SeqGS = SeqSOR<M,X,Y,l>;
   DUNE_REGISTER_PRECONDITIONER("gs", defaultPreconditionerBlockLevelCreator<Dune::SeqGS>());
 
+
+  /*!
+     \brief Sequential multicoloured SSOR preconditioner.
+
+     The rows of the matrix are coloured once on construction such that rows of
+     the same colour are not coupled. Each iteration updates the colours in
+     ascending and then in descending order, the rows of each colour are
+     processed by the threads of the ThreadPool. The result differs from SeqSSOR
+     due to the different ordering of the rows, but does not depend on the
+     number of threads.
+
+     \tparam M The matrix type to operate on
+     \tparam X Type of the update
+     \tparam Y Type of the defect
+   */
+  template<class M, class X, class Y>
+  class SeqMulticolorSSOR : public Preconditioner<X,Y> {
+  public:
+    //! \brief The matrix type the preconditioner is for.
+    typedef M matrix_type;
+    //! \brief The domain type of the preconditioner.
+    typedef X domain_type;
+    //! \brief The range type of the preconditioner.
+    typedef Y range_type;
+    //! \brief The field type of the preconditioner.
+    typedef typename X::field_type field_type;
+    //! \brief scalar type underlying the field_type
+    typedef Simd::Scalar<field_type> scalar_field_type;
+    //! \brief real scalar type underlying the field_type
+    typedef typename FieldTraits<scalar_field_type>::real_type real_field_type;
+
+    /*! \brief Constructor.
+
+       constructor gets all parameters to operate the prec.
+       \param A The matrix to operate on.
+       \param n The number of iterations to perform.
+       \param w The relaxation factor.
+     */
+    SeqMulticolorSSOR (const M& A, int n, real_field_type w)
+      : _A_(A), _n(n), _w(w)
+    {
+      CheckIfDiagonalPresent<M,1>::check(_A_);
+      computeColoring(_A_, _coloring);
+    }
+
+    /*!
+       \brief Constructor.
+
+       \param A The assembled linear operator to use.
+       \param configuration ParameterTree containing preconditioner parameters.
+
+       ParameterTree Key | Meaning
+       ------------------|------------
+       iterations        | The number of iterations to perform. default=1
+       relaxation        | The relaxation factor. default=1.0
+
+       See \ref ISTL_Factory for the ParameterTree layout and examples.
+     */
+    SeqMulticolorSSOR (const std::shared_ptr<const AssembledLinearOperator<M,X,Y>>& A, const ParameterTree& configuration)
+      : SeqMulticolorSSOR(A->getmat(), configuration)
+    {}
+
+    /*!
+       \brief Constructor.
+
+       \param A The matrix to operate on.
+       \param configuration ParameterTree containing preconditioner parameters.
+
+       ParameterTree Key | Meaning
+       ------------------|------------
+       iterations        | The number of iterations to perform. default=1
+       relaxation        | The relaxation factor. default=1.0
+
+       See \ref ISTL_Factory for the ParameterTree layout and examples.
+     */
+    SeqMulticolorSSOR (const M& A, const ParameterTree& configuration)
+      : SeqMulticolorSSOR(A, configuration.get<int>("iterations",1), configuration.get<real_field_type>("relaxation",1.0))
+    {}
+
+    /*!
+       \brief Prepare the preconditioner.
+
+       \copydoc Preconditioner::pre(X&,Y&)
+     */
+    virtual void pre ([[maybe_unused]] X& x, [[maybe_unused]] Y& b)
+    {}
+
+    /*!
+       \brief Apply the preconditioner
+
+       \copydoc Preconditioner::apply(X&,const Y&)
+     */
+    virtual void apply (X& v, const Y& d)
+    {
+      for (int i=0; i<_n; i++) {
+        bsorf(_A_,v,d,_w,_coloring);
+        bsorb(_A_,v,d,_w,_coloring);
+      }
+    }
+
+    /*!
+       \brief Clean up.
+
+       \copydoc Preconditioner::post(X&)
+     */
+    virtual void post ([[maybe_unused]] X& x)
+    {}
+
+    //! Category of the preconditioner (see SolverCategory::Category)
+    virtual SolverCategory::Category category() const
+    {
+      return SolverCategory::sequential;
+    }
+
+    //! \brief The colouring of the matrix rows.
+    const MatrixColoring& coloring() const
+    {
+      return _coloring;
+    }
+
+  private:
+    //! \brief The matrix we operate on.
+    const M& _A_;
+    //! \brief The number of steps to do in apply
+    int _n;
+    //! \brief The relaxation factor to use
+    real_field_type _w;
+    //! \brief The colouring of the matrix rows
+    MatrixColoring _coloring;
+  };
+  DUNE_REGISTER_PRECONDITIONER("multicolorssor", defaultPreconditionerCreator<Dune::SeqMulticolorSSOR>());
+
+
+  /*!
+     \brief Sequential multicoloured SOR preconditioner.
+
+     The rows of the matrix are coloured once on construction such that rows of
+     the same colour are not coupled. A forward sweep updates the colours in
+     ascending, a backward sweep in descending order, the rows of each colour
+     are processed by the threads of the ThreadPool. The result differs from
+     SeqSOR due to the different ordering of the rows, but does not depend on
+     the number of threads.
+
+     \tparam M The matrix type to operate on
+     \tparam X Type of the update
+     \tparam Y Type of the defect
+   */
+  template<class M, class X, class Y>
+  class SeqMulticolorSOR : public Preconditioner<X,Y> {
+  public:
+    //! \brief The matrix type the preconditioner is for.
+    typedef M matrix_type;
+    //! \brief The domain type of the preconditioner.
+    typedef X domain_type;
+    //! \brief The range type of the preconditioner.
+    typedef Y range_type;
+    //! \brief The field type of the preconditioner.
+    typedef typename X::field_type field_type;
+    //! \brief scalar type underlying the field_type
+    typedef Simd::Scalar<field_type> scalar_field_type;
+    //! \brief real scalar type underlying the field_type
+    typedef typename FieldTraits<scalar_field_type>::real_type real_field_type;
+
+    /*! \brief Constructor.
+
+       constructor gets all parameters to operate the prec.
+       \param A The matrix to operate on.
+       \param n The number of iterations to perform.
+       \param w The relaxation factor.
+     */
+    SeqMulticolorSOR (const M& A, int n, real_field_type w)
+      : _A_(A), _n(n), _w(w)
+    {
+      CheckIfDiagonalPresent<M,1>::check(_A_);
+      computeColoring(_A_, _coloring);
+    }
+
+    /*!
+       \brief Constructor.
+
+       \param A The assembled linear operator to use.
+       \param configuration ParameterTree containing preconditioner parameters.
+
+       ParameterTree Key | Meaning
+       ------------------|------------
+       iterations        | The number of iterations to perform. default=1
+       relaxation        | The relaxation factor. default=1.0
+
+       See \ref ISTL_Factory for the ParameterTree layout and examples.
+     */
+    SeqMulticolorSOR (const std::shared_ptr<const AssembledLinearOperator<M,X,Y>>& A, const ParameterTree& configuration)
+      : SeqMulticolorSOR(A->getmat(), configuration)
+    {}
+
+    /*!
+       \brief Constructor.
+
+       \param A The matrix to operate on.
+       \param configuration ParameterTree containing preconditioner parameters.
+
+       ParameterTree Key | Meaning
+       ------------------|------------
+       iterations        | The number of iterations to perform. default=1
+       relaxation        | The relaxation factor. default=1.0
+
+       See \ref ISTL_Factory for the ParameterTree layout and examples.
+     */
+    SeqMulticolorSOR (const M& A, const ParameterTree& configuration)
+      : SeqMulticolorSOR(A, configuration.get<int>("iterations",1), configuration.get<real_field_type>("relaxation",1.0))
+    {}
+
+    /*!
+       \brief Prepare the preconditioner.
+
+       \copydoc Preconditioner::pre(X&,Y&)
+     */
+    virtual void pre ([[maybe_unused]] X& x, [[maybe_unused]] Y& b)
+    {}
+
+    /*!
+       \brief Apply the preconditioner.
+
+       \copydoc Preconditioner::apply(X&,const Y&)
+     */
+    virtual void apply (X& v, const Y& d)
+    {
+      this->template apply<true>(v,d);
+    }
+
+    /*!
+       \brief Apply the preconditioner in a special direction.
+
+       If forward is true the colours are updated in ascending, otherwise
+       in descending order.
+     */
+    template<bool forward>
+    void apply(X& v, const Y& d)
+    {
+      if(forward)
+        for (int i=0; i<_n; i++) {
+          bsorf(_A_,v,d,_w,_coloring);
+        }
+      else
+        for (int i=0; i<_n; i++) {
+          bsorb(_A_,v,d,_w,_coloring);
+        }
+    }
+
+    /*!
+       \brief Clean up.
+
+       \copydoc Preconditioner::post(X&)
+     */
+    virtual void post ([[maybe_unused]] X& x)
+    {}
+
+    //! Category of the preconditioner (see SolverCategory::Category)
+    virtual SolverCategory::Category category() const
+    {
+      return SolverCategory::sequential;
+    }
+
+    //! \brief The colouring of the matrix rows.
+    const MatrixColoring& coloring() const
+    {
+      return _coloring;
+    }
+
+  private:
+    //! \brief The matrix we operate on.
+    const M& _A_;
+    //! \brief The number of steps to do in apply
+    int _n;
+    //! \brief The relaxation factor to use
+    real_field_type _w;
+    //! \brief The colouring of the matrix rows
+    MatrixColoring _coloring;
+  };
+  DUNE_REGISTER_PRECONDITIONER("multicolorsor", defaultPreconditionerCreator<Dune::SeqMulticolorSOR>());
+
   /*! \brief The sequential jacobian preconditioner.
 
      Wraps the naked ISTL generic block Jacobi preconditioner into the
@@ -516,6 +806,452 @@ namespace Dune {
   };
   DUNE_REGISTER_PRECONDITIONER("jac", defaultPreconditionerBlockLevelCreator<Dune::SeqJac>());
 
+  namespace Impl {
+
+    //! largest eigenvalue of the symmetric tridiagonal matrix with diagonal a and off-diagonal b, computed by bisection
+    template<class K>
+    K tridiagonalMaxEigenvalue (const std::vector<K>& a, const std::vector<K>& b)
+    {
+      using std::abs;
+      const std::size_t m = a.size();
+
+      // Gershgorin bounds of the spectrum
+      K lower = a[0];
+      K upper = a[0];
+      for (std::size_t i=0; i<m; ++i)
+      {
+        const K radius = (i>0 ? abs(b[i-1]) : K(0)) + (i+1<m ? abs(b[i]) : K(0));
+        lower = std::min(lower, a[i] - radius);
+        upper = std::max(upper, a[i] + radius);
+      }
+
+      // the number of eigenvalues below x is the number of negative pivots of T - xI (Sturm sequence)
+      auto countBelow = [&](K x)
+      {
+        std::size_t count = 0;
+        K q = 1;
+        for (std::size_t i=0; i<m; ++i)
+        {
+          q = a[i] - x - (i>0 ? b[i-1]*b[i-1]/q : K(0));
+          if (q == K(0))
+            q = std::numeric_limits<K>::min();
+          if (q < K(0))
+            ++count;
+        }
+        return count;
+      };
+
+      for (int i=0; i<100 && upper-lower > std::numeric_limits<K>::epsilon()*(abs(lower)+abs(upper)); ++i)
+      {
+        const K middle = (lower + upper)/2;
+        if (countBelow(middle) == m)
+          upper = middle;
+        else
+          lower = middle;
+      }
+      return upper;
+    }
+
+  } // end namespace Impl
+
+  /*!
+     \brief Sequential Chebyshev polynomial preconditioner.
+
+     Applies a Chebyshev polynomial in the Jacobi preconditioned matrix \f$ D^{-1}A \f$,
+     which only needs matrix-vector products, vector updates and the inverse diagonal
+     blocks. The polynomial damps the eigenvalues of \f$ D^{-1}A \f$ in the interval
+     \f$ [r\lambda_{max}, \lambda_{max}] \f$, which makes it a smoother for AMG when r is
+     not too small.
+
+     The largest eigenvalue is estimated on construction by a few steps of the Jacobi
+     preconditioned conjugate gradient method, i.e. by the Lanczos method, from a
+     pseudo-random start vector. Hence the matrix has to be symmetric positive definite.
+     The estimate is enlarged by 10% to safely bound the spectrum.
+
+     \tparam M The matrix type to operate on
+     \tparam X Type of the update
+     \tparam Y Type of the defect
+   */
+  template<class M, class X, class Y>
+  class SeqChebyshev : public Preconditioner<X,Y> {
+  public:
+    //! \brief The matrix type the preconditioner is for.
+    typedef M matrix_type;
+    //! \brief The domain type of the preconditioner.
+    typedef X domain_type;
+    //! \brief The range type of the preconditioner.
+    typedef Y range_type;
+    //! \brief The field type of the preconditioner.
+    typedef typename X::field_type field_type;
+    //! \brief scalar type underlying the field_type
+    typedef Simd::Scalar<field_type> scalar_field_type;
+    //! \brief real scalar type underlying the field_type
+    typedef typename FieldTraits<scalar_field_type>::real_type real_field_type;
+
+    /*! \brief Constructor.
+
+       \param A The matrix to operate on.
+       \param degree The degree of the polynomial, i.e. the number of matrix-vector products per application.
+       \param eigenvalueRatio The ratio r of the lower and the upper end of the damped part of the spectrum.
+       \param estimationSteps The number of Lanczos steps for the estimate of the largest eigenvalue.
+     */
+    SeqChebyshev (const M& A, int degree, real_field_type eigenvalueRatio = real_field_type(1)/30,
+                  int estimationSteps = 10)
+      : _A_(A), _degree(degree), _inverseDiagonal(A.N())
+    {
+      for (auto i=A.begin(); i!=A.end(); ++i)
+      {
+        auto ii = (*i).find(i.index());
+        if (ii == (*i).end())
+          DUNE_THROW(ISTLError, "diagonal entry missing");
+        _inverseDiagonal[i.index()] = *ii;
+        try {
+          Impl::asMatrix(_inverseDiagonal[i.index()]).invert();
+        }
+        catch (Dune::FMatrixError & e) {
+          DUNE_THROW(MatrixBlockError, "Chebyshev failed to invert matrix block A["
+                     << i.index() << "][" << i.index() << "]" << e.what();
+                     th__ex.r=i.index(); th__ex.c=i.index(););
+        }
+      }
+
+      _lambdaMax = real_field_type(1.1)*estimateMaxEigenvalue(estimationSteps);
+      _lambdaMin = eigenvalueRatio*_lambdaMax;
+    }
+
+    /*!
+       \brief Constructor.
+
+       \param A The assembled linear operator to use.
+       \param configuration ParameterTree containing preconditioner parameters.
+
+       ParameterTree Key | Meaning
+       ------------------|------------
+       degree            | The degree of the polynomial. default=3
+       eigenvalueRatio   | The ratio of the lower and the upper end of the damped spectrum. default=1/30
+       estimationSteps   | The number of Lanczos steps to estimate the largest eigenvalue. default=10
+
+       See \ref ISTL_Factory for the ParameterTree layout and examples.
+     */
+    SeqChebyshev (const std::shared_ptr<const AssembledLinearOperator<M,X,Y>>& A, const ParameterTree& configuration)
+      : SeqChebyshev(A->getmat(), configuration)
+    {}
+
+    /*!
+       \brief Constructor.
+
+       \param A The matrix to operate on.
+       \param configuration ParameterTree containing preconditioner parameters.
+
+       ParameterTree Key | Meaning
+       ------------------|------------
+       degree            | The degree of the polynomial. default=3
+       eigenvalueRatio   | The ratio of the lower and the upper end of the damped spectrum. default=1/30
+       estimationSteps   | The number of Lanczos steps to estimate the largest eigenvalue. default=10
+
+       See \ref ISTL_Factory for the ParameterTree layout and examples.
+     */
+    SeqChebyshev (const M& A, const ParameterTree& configuration)
+      : SeqChebyshev(A, configuration.get<int>("degree",3),
+                     configuration.get<real_field_type>("eigenvalueRatio",real_field_type(1)/30),
+                     configuration.get<int>("estimationSteps",10))
+    {}
+
+    /*!
+       \brief Prepare the preconditioner.
+
+       \copydoc Preconditioner::pre(X&,Y&)
+     */
+    virtual void pre ([[maybe_unused]] X& x, [[maybe_unused]] Y& b)
+    {}
+
+    /*!
+       \brief Apply the preconditioner.
+
+       \copydoc Preconditioner::apply(X&,const Y&)
+     */
+    virtual void apply (X& v, const Y& d)
+    {
+      if (_degree < 1)
+        return;
+
+      // three-term recurrence of the Chebyshev iteration (see Y. Saad, Iterative methods for sparse linear systems)
+      const real_field_type theta = (_lambdaMax + _lambdaMin)/2;
+      const real_field_type delta = (_lambdaMax - _lambdaMin)/2;
+      const real_field_type sigma = theta/delta;
+
+      Y r(d);
+      _A_.mmv(v, r);                  // r = d - Av
+      X z(v);
+      applyInverseDiagonal(r, z);     // z = D^{-1} r
+      X w(z);
+      w *= real_field_type(1)/theta;
+      v += w;
+
+      real_field_type rhoOld = 1/sigma;
+      for (int k=1; k<_degree; ++k)
+      {
+        _A_.mmv(w, r);
+        applyInverseDiagonal(r, z);
+        const real_field_type rho = 1/(2*sigma - rhoOld);
+        w *= rho*rhoOld;
+        w.axpy(2*rho/delta, z);
+        v += w;
+        rhoOld = rho;
+      }
+    }
+
+    /*!
+       \brief Clean up.
+
+       \copydoc Preconditioner::post(X&)
+     */
+    virtual void post ([[maybe_unused]] X& x)
+    {}
+
+    //! Category of the preconditioner (see SolverCategory::Category)
+    virtual SolverCategory::Category category() const
+    {
+      return SolverCategory::sequential;
+    }
+
+    //! \brief The upper bound of the spectrum of the Jacobi preconditioned matrix.
+    real_field_type maxEigenvalue() const
+    {
+      return _lambdaMax;
+    }
+
+  private:
+    //! \brief z = D^{-1} r
+    template<class R, class Z>
+    void applyInverseDiagonal (const R& r, Z& z) const
+    {
+      // rows per thread below which the work is not split
+      const std::size_t minChunkSize = 1024;
+      ThreadPool::instance().parallelFor(0, r.N(), [&](std::size_t first, std::size_t last)
+      {
+        for (std::size_t i=first; i<last; ++i)
+        {
+          auto&& zi = Impl::asVector(z[i]);
+          Impl::asMatrix(_inverseDiagonal[i]).mv(Impl::asVector(r[i]), zi);
+        }
+      }, minChunkSize);
+    }
+
+    //! \brief Estimate the largest eigenvalue of D^{-1}A by the Lanczos coefficients of the Jacobi preconditioned CG method
+    real_field_type estimateMaxEigenvalue (int steps) const
+    {
+      // pseudo-random right hand side, the solution starts with zero
+      X r(_A_.N());
+      flatVectorForEach(r, [](auto&& entry, std::size_t i)
+      {
+        std::uint64_t h = (i+1) * 0x9E3779B97F4A7C15ull;
+        h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+        h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+        h ^= h >> 31;
+        entry = real_field_type(h >> 11) / real_field_type(1ull << 53) - real_field_type(0.5);
+      });
+      X z(r), p(r), q(r);
+      applyInverseDiagonal(r, z);
+      p = z;
+      field_type rho = r.dot(z);
+
+      std::vector<field_type> alphas, betas;
+      for (int k=0; k<steps && !Simd::anyTrue(rho == field_type(0)); ++k)
+      {
+        _A_.mv(p, q);
+        const field_type pq = p.dot(q);
+        if (Simd::anyTrue(pq == field_type(0)))
+          break;
+        alphas.push_back(rho/pq);
+        r.axpy(-alphas.back(), q);
+        applyInverseDiagonal(r, z);
+        const field_type rhoNew = r.dot(z);
+        betas.push_back(rhoNew/rho);
+        rho = rhoNew;
+        p *= betas.back();
+        p += z;
+      }
+      if (alphas.empty())
+        DUNE_THROW(ISTLError, "Chebyshev failed to estimate the largest eigenvalue");
+
+      // largest eigenvalue of the Lanczos matrix of each lane
+      using std::real;
+      using std::sqrt;
+      real_field_type lambdaMax = 0;
+      const std::size_t m = alphas.size();
+      for (std::size_t l=0; l<Simd::lanes<field_type>(); ++l)
+      {
+        std::vector<real_field_type> a(m), b(m);
+        for (std::size_t j=0; j<m; ++j)
+        {
+          const real_field_type alpha = real(Simd::lane(l, alphas[j]));
+          const real_field_type beta = real(Simd::lane(l, betas[j]));
+          a[j] = 1/alpha + (j>0 ? real(Simd::lane(l, betas[j-1]))/real(Simd::lane(l, alphas[j-1])) : 0);
+          b[j] = sqrt(beta)/alpha;
+        }
+        lambdaMax = std::max(lambdaMax, Impl::tridiagonalMaxEigenvalue(a, b));
+      }
+      return lambdaMax;
+    }
+
+    //! \brief The matrix we operate on.
+    const M& _A_;
+    //! \brief The degree of the polynomial.
+    int _degree;
+    //! \brief The inverse diagonal blocks.
+    std::vector<typename M::block_type> _inverseDiagonal;
+    //! \brief The damped part of the spectrum.
+    real_field_type _lambdaMin, _lambdaMax;
+  };
+  DUNE_REGISTER_PRECONDITIONER("chebyshev", defaultPreconditionerCreator<Dune::SeqChebyshev>());
+
+  /*!
+     \brief Sequential factorized sparse approximate inverse (FSAI) preconditioner.
+
+     Approximates the inverse of a symmetric positive definite matrix by
+     \f$ G^T D^{-1} G \f$ with a sparse lower triangular matrix G and a block
+     diagonal matrix D (see FSAI::decompose). The application consists of two
+     sparse matrix-vector products without triangular solves, which are
+     distributed among the threads of the ThreadPool like the setup.
+
+     The pattern of G is the lower triangular part of the pattern of \f$ A^{level} \f$
+     or of a given MatrixIndexSet.
+
+     \tparam M The matrix type to operate on
+     \tparam X Type of the update
+     \tparam Y Type of the defect
+   */
+  template<class M, class X, class Y>
+  class SeqFSAI : public Preconditioner<X,Y> {
+  public:
+    //! \brief The matrix type the preconditioner is for.
+    typedef std::remove_const_t<M> matrix_type;
+    //! \brief The domain type of the preconditioner.
+    typedef X domain_type;
+    //! \brief The range type of the preconditioner.
+    typedef Y range_type;
+    //! \brief The field type of the preconditioner.
+    typedef typename X::field_type field_type;
+    //! \brief scalar type underlying the field_type
+    typedef Simd::Scalar<field_type> scalar_field_type;
+    //! \brief real scalar type underlying the field_type
+    typedef typename FieldTraits<scalar_field_type>::real_type real_field_type;
+
+    /*! \brief Constructor.
+
+       \param A The matrix to operate on.
+       \param level The pattern of G is the lower triangular part of the pattern of A^level.
+       \param w The relaxation factor.
+     */
+    SeqFSAI (const M& A, int level = 1, real_field_type w = 1.0)
+      : _w(w), _t(A.N())
+    {
+      MatrixIndexSet pattern;
+      FSAI::lowerPattern(A, level, pattern);
+      FSAI::decompose(A, pattern, _G, _H);
+    }
+
+    /*! \brief Constructor.
+
+       \param A The matrix to operate on.
+       \param indices The pattern of G, only its lower triangular part and the diagonal are used.
+       \param w The relaxation factor.
+     */
+    SeqFSAI (const M& A, const MatrixIndexSet& indices, real_field_type w = 1.0)
+      : _w(w), _t(A.N())
+    {
+      MatrixIndexSet pattern;
+      FSAI::lowerPattern(indices, pattern);
+      FSAI::decompose(A, pattern, _G, _H);
+    }
+
+    /*!
+       \brief Constructor.
+
+       \param A The assembled linear operator to use.
+       \param configuration ParameterTree containing preconditioner parameters.
+
+       ParameterTree Key | Meaning
+       ------------------|------------
+       level             | The pattern of G is the lower triangular part of the pattern of A^level. default=1
+       relaxation        | The relaxation factor. default=1.0
+
+       See \ref ISTL_Factory for the ParameterTree layout and examples.
+     */
+    SeqFSAI (const std::shared_ptr<const AssembledLinearOperator<M,X,Y>>& A, const ParameterTree& configuration)
+      : SeqFSAI(A->getmat(), configuration)
+    {}
+
+    /*!
+       \brief Constructor.
+
+       \param A The matrix to operate on.
+       \param configuration ParameterTree containing preconditioner parameters.
+
+       ParameterTree Key | Meaning
+       ------------------|------------
+       level             | The pattern of G is the lower triangular part of the pattern of A^level. default=1
+       relaxation        | The relaxation factor. default=1.0
+
+       See \ref ISTL_Factory for the ParameterTree layout and examples.
+     */
+    SeqFSAI (const M& A, const ParameterTree& configuration)
+      : SeqFSAI(A, configuration.get<int>("level",1), configuration.get<real_field_type>("relaxation",1.0))
+    {}
+
+    /*!
+       \brief Prepare the preconditioner.
+
+       \copydoc Preconditioner::pre(X&,Y&)
+     */
+    virtual void pre ([[maybe_unused]] X& x, [[maybe_unused]] Y& b)
+    {}
+
+    /*!
+       \brief Apply the preconditioner.
+
+       \copydoc Preconditioner::apply(X&,const Y&)
+     */
+    virtual void apply (X& v, const Y& d)
+    {
+      _G.mv(d, _t);
+      _H.mv(_t, v);
+      v *= _w;
+    }
+
+    /*!
+       \brief Clean up.
+
+       \copydoc Preconditioner::post(X&)
+     */
+    virtual void post ([[maybe_unused]] X& x)
+    {}
+
+    //! Category of the preconditioner (see SolverCategory::Category)
+    virtual SolverCategory::Category category() const
+    {
+      return SolverCategory::sequential;
+    }
+
+    //! \brief The lower triangular factor G.
+    const matrix_type& lowerFactor() const
+    {
+      return _G;
+    }
+
+  private:
+    //! \brief The lower factor G.
+    matrix_type _G;
+    //! \brief The upper factor G^T D^{-1}.
+    matrix_type _H;
+    //! \brief The relaxation factor to use.
+    real_field_type _w;
+    //! \brief Temporary vector G d.
+    X _t;
+  };
+  DUNE_REGISTER_PRECONDITIONER("fsai", defaultPreconditionerCreator<Dune::SeqFSAI>());
+
   /*!
      \brief Sequential DILU preconditioner.
 
@@ -722,9 +1458,10 @@ namespace Dune {
        \param A The matrix to operate on.
        \param w The relaxation factor.
        \param resort true if a resort of the computed ILU for improved performance should be done.
+       \param levelScheduling true if the triangular solves should be level scheduled and multithreaded (implies resort).
      */
-    SeqILU (const M& A, real_field_type w, const bool resort = false )
-      : SeqILU( A, 0, w, resort ) // construct ILU(0)
+    SeqILU (const M& A, real_field_type w, const bool resort = false, const bool levelScheduling = false )
+      : SeqILU( A, 0, w, resort, levelScheduling ) // construct ILU(0)
     {
     }
 
@@ -739,6 +1476,9 @@ namespace Dune {
       n                 | The order of the ILU decomposition. default=0
       relaxation        | The relaxation factor. default=1.0
       resort            | True if a resort of the computed ILU for improved performance should be done. default=false
+      levelScheduling   | True if the triangular solves should be level scheduled and multithreaded (implies resort). default=false
+      factorizationSweeps | Number of sweeps of the parallel iterative factorization, 0 for the exact factorization. default=0
+      triangularSweeps  | Number of parallel Jacobi sweeps replacing each triangular solve, 0 for exact solves. default=0
 
       See \ref ISTL_Factory for the ParameterTree layout and examples.
     */
@@ -757,13 +1497,19 @@ namespace Dune {
       n                 | The order of the ILU decomposition. default=0
       relaxation        | The relaxation factor. default=1.0
       resort            | True if a resort of the computed ILU for improved performance should be done. default=false
+      levelScheduling   | True if the triangular solves should be level scheduled and multithreaded (implies resort). default=false
+      factorizationSweeps | Number of sweeps of the parallel iterative factorization, 0 for the exact factorization. default=0
+      triangularSweeps  | Number of parallel Jacobi sweeps replacing each triangular solve, 0 for exact solves. default=0
 
        See \ref ISTL_Factory for the ParameterTree layout and examples.
      */
     SeqILU(const M& A, const ParameterTree& config)
       : SeqILU(A, config.get("n", 0),
                config.get<real_field_type>("relaxation", 1.0),
-               config.get("resort", false))
+               config.get("resort", false),
+               config.get("levelScheduling", false),
+               config.get("factorizationSweeps", 0),
+               config.get("triangularSweeps", 0))
     {}
 
    /*! \brief Constructor.
@@ -773,12 +1519,27 @@ namespace Dune {
        \param n The order of the ILU decomposition.
        \param w The relaxation factor.
        \param resort true if a resort of the computed ILU for improved performance should be done.
+       \param levelScheduling true if the triangular solves should be level scheduled and multithreaded (implies resort).
+       \param factorizationSweeps number of sweeps of the iterative factorization, 0 for the exact factorization.
+       \param triangularSweeps number of Jacobi sweeps replacing each triangular solve, 0 for exact solves.
+
+       The level schedule groups the rows of the triangular factors into levels of
+       independent rows. The rows of each level are distributed among the threads of
+       the ThreadPool, the result of apply does not depend on the number of threads.
+
+       The iterative factorization (see ILU::blockILUIterativeDecomposition) and the
+       Jacobi triangular solves (see ILU::blockILUJacobiBacksolve) are fully parallel
+       and approximate the exact ones with an increasing number of sweeps. Jacobi
+       triangular solves use the matrix storage, resort and levelScheduling are ignored.
      */
-    SeqILU (const M& A, int n, real_field_type w, const bool resort = false )
+    SeqILU (const M& A, int n, real_field_type w, const bool resort = false, const bool levelScheduling = false,
+            const int factorizationSweeps = 0, const int triangularSweeps = 0 )
       : ILU_(),
         lower_(),
         upper_(),
         inv_(),
+        levelScheduling_(levelScheduling && triangularSweeps == 0),
+        triangularSweeps_(triangularSweeps),
         w_(w),
         wNotIdentity_([w]{using std::abs; return abs(w - real_field_type(1)) > 1e-15;}() )
     {
@@ -787,22 +1548,40 @@ namespace Dune {
         // copy A
         ILU_.reset( new matrix_type( A ) );
         // create ILU(0) decomposition
-        ILU::blockILU0Decomposition( *ILU_ );
+        if( factorizationSweeps > 0 )
+          ILU::blockILUIterativeDecomposition( *ILU_, factorizationSweeps );
+        else
+          ILU::blockILU0Decomposition( *ILU_ );
       }
       else
       {
         // create matrix in build mode
         ILU_.reset( new matrix_type(  A.N(), A.M(), matrix_type::row_wise) );
         // create ILU(n) decomposition
-        ILU::blockILUDecomposition( A, n, *ILU_ );
+        if( factorizationSweeps > 0 )
+        {
+          ILU::blockILUSymbolicDecomposition( A, n, *ILU_ );
+          ILU::blockILUIterativeDecomposition( *ILU_, factorizationSweeps );
+        }
+        else
+          ILU::blockILUDecomposition( A, n, *ILU_ );
       }
 
-      if( resort )
+      if( triangularSweeps_ > 0 )
+        return;
+
+      if( resort || levelScheduling )
       {
         // store ILU in simple CRS format
         ILU::convertToCRS( *ILU_, lower_, upper_, inv_ );
         ILU_.reset();
       }
+
+      if( levelScheduling )
+      {
+        ILU::buildLevelSchedule( lower_, lowerSchedule_, false );
+        ILU::buildLevelSchedule( upper_, upperSchedule_, true );
+      }
     }
 
     /*!
@@ -820,10 +1599,18 @@ namespace Dune {
      */
     virtual void apply (X& v, const Y& d)
     {
-      if( ILU_ )
+      if( ILU_ && triangularSweeps_ > 0 )
+      {
+        ILU::blockILUJacobiBacksolve( *ILU_, v, d, triangularSweeps_ );
+      }
+      else if( ILU_ )
       {
         ILU::blockILUBacksolve( *ILU_, v, d);
       }
+      else if( levelScheduling_ )
+      {
+        ILU::blockILUBacksolve(lower_, upper_, inv_, lowerSchedule_, upperSchedule_, v, d);
+      }
       else
       {
         ILU::blockILUBacksolve(lower_, upper_, inv_, v, d);
@@ -849,6 +1636,18 @@ namespace Dune {
       return SolverCategory::sequential;
     }
 
+    //! \brief The memory in bytes allocated for the decomposition, see Dune::memoryUsage.
+    std::size_t memoryUsage () const
+    {
+      std::size_t size = ILU_ ? Dune::memoryUsage(*ILU_) : 0;
+      for (const CRS* factor : { &lower_, &upper_ })
+        size += Dune::memoryUsage(factor->rows_) + Dune::memoryUsage(factor->values_)
+          + Dune::memoryUsage(factor->cols_);
+      for (const ILU::LevelSchedule* schedule : { &lowerSchedule_, &upperSchedule_ })
+        size += Dune::memoryUsage(schedule->levels_) + Dune::memoryUsage(schedule->rows_);
+      return size + Dune::memoryUsage(inv_);
+    }
+
   protected:
     //! \brief The ILU(n) decomposition of the matrix. As storage a BCRSMatrix is used.
     std::unique_ptr< matrix_type > ILU_;
@@ -858,6 +1657,15 @@ namespace Dune {
     CRS upper_;
     std::vector< block_type, typename matrix_type::allocator_type > inv_;
 
+    //! \brief true if the triangular solves are level scheduled
+    const bool levelScheduling_;
+    //! \brief The level schedules of the lower and upper triangular factor.
+    ILU::LevelSchedule lowerSchedule_;
+    ILU::LevelSchedule upperSchedule_;
+
+    //! \brief The number of Jacobi sweeps replacing each triangular solve.
+    const int triangularSweeps_;
+
     //! \brief The relaxation factor to use.
     const real_field_type w_;
     //! \brief true if w != 1.0
@@ -996,6 +1804,7 @@ namespace Dune {
        ParameterTree Key | Meaning
        ------------------|------------
        relaxation        | relaxation factor
+       levelScheduling   | level schedule and multithread the triangular solves
 
        See \ref ISTL_Factory for the ParameterTree layout and examples.
      */
@@ -1012,11 +1821,13 @@ namespace Dune {
        ParameterTree Key | Meaning
        ------------------|------------
        relaxation        | relaxation factor. default=1.0
+       levelScheduling   | level schedule and multithread the triangular solves. default=false
 
        See \ref ISTL_Factory for the ParameterTree layout and examples.
      */
     SeqILDL(const matrix_type& A, const ParameterTree& config)
-      : SeqILDL(A, config.get<real_field_type>("relaxation", 1.0))
+      : SeqILDL(A, config.get<real_field_type>("relaxation", 1.0),
+                config.get("levelScheduling", false))
     {}
 
     /**
@@ -1024,38 +1835,46 @@ namespace Dune {
      *
      * The constructor copies the matrix A and computes its ILDL decomposition.
      *
-     * \param[in]  A      matrix to operate on
-     * \param[in]  relax  relaxation factor
+     * If levelScheduling is true, the decomposition is stored in CRS format and
+     * the rows of the triangular solves are grouped into levels of independent
+     * rows, which are distributed among the threads of the ThreadPool.
+     *
+     * \param[in]  A                matrix to operate on
+     * \param[in]  relax            relaxation factor
+     * \param[in]  levelScheduling  level schedule the triangular solves
      **/
-    explicit SeqILDL ( const matrix_type &A, real_field_type relax = real_field_type( 1 ) )
-      : decomposition_( A.N(), A.M(), matrix_type::random ),
-        relax_( relax )
+    explicit SeqILDL ( const matrix_type &A, real_field_type relax = real_field_type( 1 ), bool levelScheduling = false )
+      : decomposition_( new matrix_type( A.N(), A.M(), matrix_type::random ) ),
+        relax_( relax ),
+        levelScheduling_( levelScheduling )
     {
+      matrix_type &decomposition = *decomposition_;
+
       // setup row sizes for lower triangular matrix
       for( auto i = A.begin(), iend = A.end(); i != iend; ++i )
       {
         const auto &A_i = *i;
         const auto ij = A_i.find( i.index() );
         if( ij != A_i.end() )
-          decomposition_.setrowsize( i.index(), ij.offset()+1 );
+          decomposition.setrowsize( i.index(), ij.offset()+1 );
         else
           DUNE_THROW( ISTLError, "diagonal entry missing" );
       }
-      decomposition_.endrowsizes();
+      decomposition.endrowsizes();
 
       // setup row indices for lower triangular matrix
       for( auto i = A.begin(), iend = A.end(); i != iend; ++i )
       {
         const auto &A_i = *i;
         for( auto ij = A_i.begin(); ij.index() < i.index() ; ++ij )
-          decomposition_.addindex( i.index(), ij.index() );
-        decomposition_.addindex( i.index(), i.index() );
+          decomposition.addindex( i.index(), ij.index() );
+        decomposition.addindex( i.index(), i.index() );
       }
-      decomposition_.endindices();
+      decomposition.endindices();
 
       // copy values of lower triangular matrix
       auto i = A.begin();
-      for( auto row = decomposition_.begin(), rowend = decomposition_.end(); row != rowend; ++row, ++i )
+      for( auto row = decomposition.begin(), rowend = decomposition.end(); row != rowend; ++row, ++i )
       {
         auto ij = i->begin();
         for( auto col = row->begin(), colend = row->end(); col != colend; ++col, ++ij )
@@ -1063,7 +1882,16 @@ namespace Dune {
       }
 
       // perform ILDL decomposition
-      bildl_decompose( decomposition_ );
+      bildl_decompose( decomposition );
+
+      if( levelScheduling_ )
+      {
+        // the triangular solves only use the CRS format
+        bildl_convertToCRS( decomposition, lower_, upper_, inv_ );
+        decomposition_.reset();
+        ILU::buildLevelSchedule( lower_, lowerSchedule_, false );
+        ILU::buildLevelSchedule( upper_, upperSchedule_, true );
+      }
     }
 
     /** \copydoc Preconditioner::pre(X&,Y&) **/
@@ -1073,7 +1901,10 @@ namespace Dune {
     /** \copydoc Preconditioner::apply(X&,const Y&) **/
     void apply ( X &v, const Y &d ) override
     {
-      bildl_backsolve( decomposition_, v, d, true );
+      if( levelScheduling_ )
+        bildl_backsolve( lower_, upper_, inv_, lowerSchedule_, upperSchedule_, v, d );
+      else
+        bildl_backsolve( *decomposition_, v, d, true );
       v *= relax_;
     }
 
@@ -1084,9 +1915,30 @@ namespace Dune {
     /** \copydoc Preconditioner::category() **/
     SolverCategory::Category category () const override { return SolverCategory::sequential; }
 
+    //! \brief The memory in bytes allocated for the decomposition, see Dune::memoryUsage.
+    std::size_t memoryUsage () const
+    {
+      std::size_t size = decomposition_ ? Dune::memoryUsage(*decomposition_) : 0;
+      for (const CRS* factor : { &lower_, &upper_ })
+        size += Dune::memoryUsage(factor->rows_) + Dune::memoryUsage(factor->values_)
+          + Dune::memoryUsage(factor->cols_);
+      for (const ILU::LevelSchedule* schedule : { &lowerSchedule_, &upperSchedule_ })
+        size += Dune::memoryUsage(schedule->levels_) + Dune::memoryUsage(schedule->rows_);
+      return size + Dune::memoryUsage(inv_);
+    }
+
   private:
-    matrix_type decomposition_;
+    typedef typename matrix_type::block_type block_type;
+    typedef ILU::CRS< block_type, typename matrix_type::allocator_type > CRS;
+
+    std::unique_ptr< matrix_type > decomposition_;
     real_field_type relax_;
+    bool levelScheduling_;
+    CRS lower_;
+    CRS upper_;
+    std::vector< block_type, typename matrix_type::allocator_type > inv_;
+    ILU::LevelSchedule lowerSchedule_;
+    ILU::LevelSchedule upperSchedule_;
   };
   DUNE_REGISTER_PRECONDITIONER("ildl", defaultPreconditionerCreator<Dune::SeqILDL>());
 
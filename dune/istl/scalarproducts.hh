@@ -7,13 +7,17 @@
 
 #include <cmath>
 #include <complex>
+#include <functional>
 #include <iostream>
 #include <iomanip>
 #include <string>
 #include <memory>
+#include <vector>
 
 #include <dune/common/exceptions.hh>
 #include <dune/common/shared_ptr.hh>
+#include <dune/common/parallel/future.hh>
+#include <dune/common/std/type_traits.hh>
 
 #include "bvector.hh"
 #include "solvercategory.hh"
@@ -73,6 +77,90 @@ namespace Dune {
       return x.two_norm();
     }
 
+    /*! \brief Update x and compute its norm, same as `x.axpy(a,y); return norm(x);`
+
+       Krylov solvers use this to compute the norm of the updated defect.
+       Derived classes may provide an implementation that reads the vectors
+       only once.
+     */
+    virtual real_type axpyNorm (X& x, const field_type& a, const X& y) const
+    {
+      x.axpy(a,y);
+      return norm(x);
+    }
+
+    /*! \brief Update x and compute a dot product with it, same as `x.axpy(a,y); return dot(z,x);`
+
+       Derived classes may provide an implementation that reads the vectors
+       only once.
+     */
+    virtual field_type axpyDot (X& x, const field_type& a, const X& y, const X& z) const
+    {
+      x.axpy(a,y);
+      return dot(z,x);
+    }
+
+    /*! \brief Dot products of x with several vectors, `result[k] = dot(x,*y[k])`
+
+       Derived classes may provide an implementation that reads x only once.
+     */
+    virtual void multiDot (const X& x, const std::vector<const X*>& y, std::vector<field_type>& result) const
+    {
+      result.resize(y.size());
+      for (std::size_t k=0; k<y.size(); ++k)
+        result[k] = dot(x,*y[k]);
+    }
+
+    /*! \brief Start the computation of several dot products and norms.
+
+       Computes `dot(*x[k],*y[k])` for all k and the squared norms `norm(*z[l])^2`
+       for all l. The future returns them in this order, i.e. the squared norm of
+       `*z[l]` is stored at position `x.size()+l`.
+
+       Parallel scalar products start a single non-blocking reduction for all
+       values and return immediately. The reduction can then be overlapped with
+       local work, e.g. the application of the preconditioner and the operator,
+       until `get()` is called on the future. The local contributions are computed
+       before idot() returns, hence the vectors may be changed afterwards.
+
+       The default implementation uses dot() and norm() and returns a ready future.
+     */
+    virtual Future<std::vector<field_type>> idot (const std::vector<const X*>& x, const std::vector<const X*>& y,
+                                                  const std::vector<const X*>& z) const
+    {
+      std::vector<field_type> result(x.size()+z.size());
+      for (std::size_t k=0; k<x.size(); ++k)
+        result[k] = dot(*x[k],*y[k]);
+      for (std::size_t l=0; l<z.size(); ++l)
+      {
+        const real_type norm_l = norm(*z[l]);
+        result[x.size()+l] = norm_l*norm_l;
+      }
+      return Future<std::vector<field_type>>(PseudoFuture<std::vector<field_type>>(std::move(result)));
+    }
+
+    /*! \brief Dot products of all pairs of two sets of vectors, `result[i*y.size()+j] = dot(*x[i],*y[j])`
+
+       This is the Gram matrix of a block of vectors as needed by s-step
+       Krylov methods. Parallel scalar products compute all values with a
+       single global reduction.
+
+       The default implementation uses idot().
+     */
+    virtual void blockDot (const std::vector<const X*>& x, const std::vector<const X*>& y, std::vector<field_type>& result) const
+    {
+      std::vector<const X*> left, right;
+      left.reserve(x.size()*y.size());
+      right.reserve(x.size()*y.size());
+      for (const X* xi : x)
+        for (const X* yj : y)
+        {
+          left.push_back(xi);
+          right.push_back(yj);
+        }
+      result = idot(left,right,{}).get();
+    }
+
     //! Category of the scalar product (see SolverCategory::Category)
     virtual SolverCategory::Category category() const
     {
@@ -94,6 +182,17 @@ namespace Dune {
    * This must either be OwnerOverlapCopyCommunication or a type
    * implementing the same interface.
    */
+  namespace Impl {
+
+    //! The local reductions of a communication used by ParallelScalarProduct::idot()
+    template<class C, class X>
+    using LocalReductions = decltype(
+      std::declval<const C&>().localDot(std::declval<const X&>(), std::declval<const X&>(), std::declval<typename X::field_type&>()),
+      std::declval<const C&>().localNorm2(std::declval<const X&>()),
+      std::declval<const C&>().communicator());
+
+  } // end namespace Impl
+
   template<class X, class C>
   class ParallelScalarProduct : public ScalarProduct<X>
   {
@@ -109,7 +208,9 @@ namespace Dune {
     //! \brief The type of the communication object.
     //!
     //! This must either be OwnerOverlapCopyCommunication or a type
-    //! implementing the same interface.
+    //! implementing the same interface. The methods `localDot`,
+    //! `localNorm2` and `communicator` are optional, without them
+    //! idot() computes blocking reductions with dot() and norm().
     typedef C communication_type;
 
     /*!
@@ -151,6 +252,30 @@ namespace Dune {
       return _communication->norm(x);
     }
 
+    /*! \brief Start the computation of several dot products and norms, see ScalarProduct::idot().
+
+       The local contributions of all values are combined by a single
+       non-blocking reduction (`MPI_Iallreduce` for MPI communicators).
+       If the communication does not provide `localDot` and `localNorm2`,
+       the blocking default implementation of ScalarProduct is used.
+     */
+    virtual Future<std::vector<field_type>> idot (const std::vector<const X*>& x, const std::vector<const X*>& y,
+                                                  const std::vector<const X*>& z) const override
+    {
+      if constexpr (Std::is_detected_v<Impl::LocalReductions, communication_type, X>)
+      {
+        std::vector<field_type> local(x.size()+z.size());
+        for (std::size_t k=0; k<x.size(); ++k)
+          _communication->localDot(*x[k],*y[k],local[k]);
+        for (std::size_t l=0; l<z.size(); ++l)
+          local[x.size()+l] = _communication->localNorm2(*z[l]);
+        auto communicator = _communication->communicator();
+        return Future<std::vector<field_type>>(communicator.template iallreduce<std::plus<field_type>>(std::move(local)));
+      }
+      else
+        return ScalarProduct<X>::idot(x, y, z);
+    }
+
     //! Category of the scalar product (see SolverCategory::Category)
     virtual SolverCategory::Category category() const override
     {
@@ -162,11 +287,77 @@ namespace Dune {
     SolverCategory::Category _category;
   };
 
-  //! Default implementation for the scalar case
+  namespace Impl {
+
+    template<class X>
+    using FusedAxpyTwoNorm2 = decltype(std::declval<X&>().axpy_two_norm2(std::declval<typename X::field_type>(), std::declval<const X&>()));
+
+    template<class X>
+    using FusedAxpyDot = decltype(std::declval<X&>().axpy_dot(std::declval<typename X::field_type>(), std::declval<const X&>(), std::declval<const X&>()));
+
+    template<class X>
+    using FusedMultiDot = decltype(std::declval<const X&>().multi_dot(std::declval<const X* const*>(), std::size_t(0), std::declval<typename X::field_type*>()));
+
+  } // end namespace Impl
+
+  /*! \brief Default implementation for the sequential case
+
+     Uses the fused vector operations `axpy_two_norm2`, `axpy_dot`, and
+     `multi_dot` of BlockVector for axpyNorm(), axpyDot(), multiDot(), and
+     blockDot(), if the vector type provides them.
+   */
   template<class X>
   class SeqScalarProduct : public ScalarProduct<X>
   {
-    using ScalarProduct<X>::ScalarProduct;
+    using Base = ScalarProduct<X>;
+
+  public:
+    using typename Base::field_type;
+    using typename Base::real_type;
+
+    using Base::Base;
+
+    real_type axpyNorm (X& x, const field_type& a, const X& y) const override
+    {
+      if constexpr (Std::is_detected_v<Impl::FusedAxpyTwoNorm2, X>)
+      {
+        using std::sqrt;
+        return sqrt(x.axpy_two_norm2(a,y));
+      }
+      else
+        return Base::axpyNorm(x,a,y);
+    }
+
+    field_type axpyDot (X& x, const field_type& a, const X& y, const X& z) const override
+    {
+      if constexpr (Std::is_detected_v<Impl::FusedAxpyDot, X>)
+        return x.axpy_dot(a,y,z);
+      else
+        return Base::axpyDot(x,a,y,z);
+    }
+
+    void multiDot (const X& x, const std::vector<const X*>& y, std::vector<field_type>& result) const override
+    {
+      if constexpr (Std::is_detected_v<Impl::FusedMultiDot, X>)
+      {
+        result.resize(y.size());
+        x.multi_dot(y.data(), y.size(), result.data());
+      }
+      else
+        Base::multiDot(x,y,result);
+    }
+
+    void blockDot (const std::vector<const X*>& x, const std::vector<const X*>& y, std::vector<field_type>& result) const override
+    {
+      if constexpr (Std::is_detected_v<Impl::FusedMultiDot, X>)
+      {
+        result.resize(x.size()*y.size());
+        for (std::size_t i=0; i<x.size(); ++i)
+          x[i]->multi_dot(y.data(), y.size(), result.data() + i*y.size());
+      }
+      else
+        Base::blockDot(x,y,result);
+    }
   };
 
   /**
@@ -227,7 +418,7 @@ namespace Dune {
     {
       case SolverCategory::sequential:
         return
-          std::make_shared<ScalarProduct<X>>();
+          std::make_shared<SeqScalarProduct<X>>();
       default:
         return
           std::make_shared<ParallelScalarProduct<X,Comm>>(comm,category);
@@ -0,0 +1,345 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_ISTL_SELLCSIGMAMATRIX_HH
+#define DUNE_ISTL_SELLCSIGMAMATRIX_HH
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include <dune/common/ftraits.hh>
+#include <dune/common/scalarmatrixview.hh>
+#include <dune/common/scalarvectorview.hh>
+#include <dune/common/typetraits.hh>
+
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/istlexception.hh>
+#include <dune/istl/common/threadpool.hh>
+
+/** \file
+ * \brief A read-only sparse matrix in sliced ELLPACK (SELL-C-sigma) format
+ */
+
+namespace Dune {
+
+  /**
+   * @addtogroup ISTL_SPMV
+   * @{
+   */
+
+  namespace Impl {
+
+    //! Whether the blocks of a matrix are scalars or 1x1 matrices.
+    template<class B, class = void>
+    struct IsScalarBlock : std::bool_constant<IsNumber<B>::value> {};
+
+    template<class B>
+    struct IsScalarBlock<B, std::void_t<decltype(B::rows), decltype(B::cols)>>
+      : std::bool_constant<B::rows == 1 && B::cols == 1> {};
+
+    //! Whether the blocks of a vector are scalars or vectors of size one, e.g. FieldVector<K,1>.
+    template<class B, class = void>
+    struct IsScalarVectorBlock : std::bool_constant<IsNumber<B>::value> {};
+
+    template<class B>
+    struct IsScalarVectorBlock<B, std::void_t<decltype(B::dimension)>>
+      : std::bool_constant<B::dimension == 1> {};
+
+    //! Whether the product of matrix blocks B and vectors with blocks YBlock uses the scalar kernel.
+    template<class B, class YBlock>
+    constexpr bool useScalarSellKernel = IsScalarBlock<B>::value && IsScalarVectorBlock<YBlock>::value;
+
+    template<class B>
+    decltype(auto) scalarBlockValue (const B& b)
+    {
+      if constexpr (IsNumber<B>::value)
+        return b;
+      else
+        return b[0][0];
+    }
+
+  } // end namespace Impl
+
+  /**
+   * \brief A sparse matrix stored in the sliced ELLPACK format SELL-C-\f$\sigma\f$.
+   *
+   * The rows are grouped into chunks of C consecutive rows. Inside a chunk
+   * all rows are padded to the length of the longest row, and the entries are
+   * stored column-major, i.e. the k-th entries of all C rows of a chunk are
+   * contiguous in memory. Hence the inner loop of the matrix-vector product
+   * runs over the C rows of a chunk with unit stride and can be vectorized by
+   * the compiler. To reduce the padding, the rows are sorted by decreasing
+   * length within windows of \f$\sigma\f$ rows before they are cut into chunks.
+   *
+   * C should match the SIMD width of the target, e.g. 4 (AVX2) or 8 (AVX-512)
+   * for double. The format pays off for scalar or small blocks; the structure
+   * is fixed at construction from a BCRSMatrix.
+   *
+   * The matrix provides mv, umv, mmv, and usmv and can therefore be used with
+   * MatrixAdapter, e.g. as the operator of CGSolver or BiCGSTABSolver.
+   * Preconditioners that need access to the matrix entries have to be built from
+   * the original BCRSMatrix.
+   *
+   * Padded entries hold a zero block and the column index of a stored entry of
+   * the same row, so they only contribute `0*x`.
+   *
+   * \tparam B The block type, as in BCRSMatrix.
+   * \tparam C The chunk size (number of rows processed simultaneously).
+   * \tparam A The allocator used for the entries.
+   */
+  template<class B, int C = 8, class A = std::allocator<B> >
+  class SellCSigmaMatrix
+  {
+    static_assert(C > 0, "The chunk size has to be positive");
+
+  public:
+    //! export the type representing the field
+    using field_type = typename Imp::BlockTraits<B>::field_type;
+
+    //! export the type representing the components
+    typedef B block_type;
+
+    //! export the allocator type
+    typedef A allocator_type;
+
+    //! The type for the index access and the size
+    typedef typename A::size_type size_type;
+
+    //! The number of rows per chunk
+    static constexpr int chunkSize = C;
+
+    //! Create an empty matrix.
+    SellCSigmaMatrix ()
+      : n_(0), m_(0), nnz_(0), sigma_(1)
+    {}
+
+    /**
+     * \brief Convert a BCRSMatrix.
+     *
+     * \param matrix The matrix to convert, has to be fully built.
+     * \param sigma The size of the sorting window (rounded up to a multiple of C).
+     *              A value of 1 disables sorting.
+     */
+    template<class BA>
+    explicit SellCSigmaMatrix (const BCRSMatrix<B,BA>& matrix, size_type sigma = 32*C)
+      : SellCSigmaMatrix()
+    {
+      assign(matrix, sigma);
+    }
+
+    //! \copydoc SellCSigmaMatrix(const BCRSMatrix<B,BA>&,size_type)
+    template<class BA>
+    void assign (const BCRSMatrix<B,BA>& matrix, size_type sigma = 32*C)
+    {
+      if (matrix.buildStage() != BCRSMatrix<B,BA>::built)
+        DUNE_THROW(ISTLError, "Only fully built matrices can be converted to SELL-C-sigma");
+
+      n_ = matrix.N();
+      m_ = matrix.M();
+      nnz_ = 0;
+      sigma_ = std::max<size_type>(sigma, 1);
+      if (sigma_ > 1)
+        sigma_ = ((sigma_ + C - 1) / C) * C;
+
+      // sort rows by decreasing length within each window
+      perm_.resize(n_);
+      std::iota(perm_.begin(), perm_.end(), size_type(0));
+      if (sigma_ > 1)
+        for (size_type begin = 0; begin < n_; begin += sigma_)
+          std::stable_sort(perm_.begin() + begin, perm_.begin() + std::min(begin + sigma_, n_),
+                           [&](size_type i, size_type j){ return matrix[i].getsize() > matrix[j].getsize(); });
+
+      // compute chunk layout
+      const size_type chunks = (n_ + C - 1) / C;
+      chunkOffset_.assign(chunks + 1, 0);
+      chunkLength_.assign(chunks, 0);
+      for (size_type c = 0; c < chunks; ++c)
+      {
+        size_type length = 0;
+        for (size_type l = 0; l < size_type(C) && c*C + l < n_; ++l)
+          length = std::max<size_type>(length, matrix[perm_[c*C + l]].getsize());
+        chunkLength_[c] = length;
+        chunkOffset_[c+1] = chunkOffset_[c] + length * C;
+      }
+
+      // fill entries, padding with zero blocks
+      col_.assign(chunkOffset_[chunks], 0);
+      val_.assign(chunkOffset_[chunks], B(field_type(0)));
+      for (size_type c = 0; c < chunks; ++c)
+        for (size_type l = 0; l < size_type(C) && c*C + l < n_; ++l)
+        {
+          const auto& row = matrix[perm_[c*C + l]];
+          size_type k = 0;
+          size_type lastCol = 0;
+          for (auto it = row.begin(); it != row.end(); ++it, ++k)
+          {
+            col_[chunkOffset_[c] + k*C + l] = it.index();
+            val_[chunkOffset_[c] + k*C + l] = *it;
+            lastCol = it.index();
+          }
+          for (; k < chunkLength_[c]; ++k)
+            col_[chunkOffset_[c] + k*C + l] = lastCol;
+          nnz_ += row.getsize();
+        }
+    }
+
+    //! number of rows (counted in blocks)
+    size_type N () const
+    {
+      return n_;
+    }
+
+    //! number of columns (counted in blocks)
+    size_type M () const
+    {
+      return m_;
+    }
+
+    //! number of blocks of the original matrix
+    size_type nonzeroes () const
+    {
+      return nnz_;
+    }
+
+    //! number of stored blocks including the padding
+    size_type storedEntries () const
+    {
+      return val_.size();
+    }
+
+    //! the size of the sorting window
+    size_type sigma () const
+    {
+      return sigma_;
+    }
+
+    //! y = A x
+    template<class X, class Y>
+    void mv (const X& x, Y& y) const
+    {
+      checkSizes(x, y);
+      apply(x, y, [](auto& yi, const auto& sum){ yi = sum; });
+    }
+
+    //! y += A x
+    template<class X, class Y>
+    void umv (const X& x, Y& y) const
+    {
+      checkSizes(x, y);
+      apply(x, y, [](auto& yi, const auto& sum){ yi += sum; });
+    }
+
+    //! y -= A x
+    template<class X, class Y>
+    void mmv (const X& x, Y& y) const
+    {
+      checkSizes(x, y);
+      apply(x, y, [](auto& yi, const auto& sum){ yi -= sum; });
+    }
+
+    //! y += alpha A x
+    template<class X, class Y, class F>
+    void usmv (F&& alpha, const X& x, Y& y) const
+    {
+      checkSizes(x, y);
+      apply(x, y, [&](auto& yi, const auto& sum){
+        Impl::asVector(yi).axpy(alpha, Impl::asVector(sum));
+      });
+    }
+
+  private:
+    template<class X, class Y>
+    void checkSizes ([[maybe_unused]] const X& x, [[maybe_unused]] const Y& y) const
+    {
+#ifdef DUNE_ISTL_WITH_CHECKING
+      if (x.N()!=M()) DUNE_THROW(ISTLError,"index out of range");
+      if (y.N()!=N()) DUNE_THROW(ISTLError,"index out of range");
+#endif
+    }
+
+    /**
+     * \brief Compute the products of all chunks and pass them to `update(y[i], (Ax)_i)`.
+     *
+     * Chunks are distributed over the threads of the global ThreadPool. Each row
+     * is computed by one thread, so the result does not depend on the number of threads.
+     */
+    template<class X, class Y, class Update>
+    void apply (const X& x, Y& y, Update&& update) const
+    {
+      using YBlock = typename Y::block_type;
+      const size_type chunks = chunkLength_.size();
+
+      ThreadPool::instance().parallelFor(0, chunks, [&](std::size_t first, std::size_t last)
+      {
+        for (size_type c = first; c < last; ++c)
+        {
+          const size_type* col = col_.data() + chunkOffset_[c];
+          const B* val = val_.data() + chunkOffset_[c];
+          const size_type length = chunkLength_[c];
+          const size_type lanes = std::min<size_type>(C, n_ - c*C);
+
+          if constexpr (Impl::useScalarSellKernel<B, YBlock>)
+          {
+            // scalar kernel: the lane loop is a plain gather-multiply-add
+            std::array<field_type, C> sum;
+            sum.fill(field_type(0));
+            for (size_type k = 0; k < length; ++k, col += C, val += C)
+              for (size_type l = 0; l < size_type(C); ++l)
+                sum[l] += Impl::scalarBlockValue(val[l]) * Impl::asVector(x[col[l]])[0];
+            for (size_type l = 0; l < lanes; ++l)
+            {
+              YBlock s(sum[l]);
+              update(y[perm_[c*C + l]], s);
+            }
+          }
+          else
+          {
+            std::array<YBlock, C> sum;
+            for (auto& s : sum)
+              s = 0;
+            for (size_type k = 0; k < length; ++k, col += C, val += C)
+              for (size_type l = 0; l < size_type(C); ++l)
+              {
+                auto&& sl = Impl::asVector(sum[l]);
+                Impl::asMatrix(val[l]).umv(Impl::asVector(x[col[l]]), sl);
+              }
+            for (size_type l = 0; l < lanes; ++l)
+              update(y[perm_[c*C + l]], sum[l]);
+          }
+        }
+      }, 64);
+    }
+
+    size_type n_;
+    size_type m_;
+    size_type nnz_;
+    size_type sigma_;
+
+    // perm_[k] is the original index of the k-th stored row
+    std::vector<size_type> perm_;
+    // start of the entries of each chunk in col_ and val_
+    std::vector<size_type> chunkOffset_;
+    // number of entries per row of each chunk, including padding
+    std::vector<size_type> chunkLength_;
+    // column indices, column-major within each chunk
+    std::vector<size_type> col_;
+    // the blocks, in the same order as col_
+    std::vector<B, typename std::allocator_traits<A>::template rebind_alloc<B> > val_;
+  };
+
+  template<class B, int C, class A>
+  struct FieldTraits< SellCSigmaMatrix<B, C, A> >
+  {
+    using field_type = typename SellCSigmaMatrix<B, C, A>::field_type;
+    using real_type = typename FieldTraits<field_type>::real_type;
+  };
+
+  /** @} end documentation */
+
+} // end namespace Dune
+
+#endif
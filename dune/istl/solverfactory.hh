@@ -15,6 +15,7 @@
 
 #include "solverregistry.hh"
 #include <dune/istl/solver.hh>
+#include <dune/istl/instrumented.hh>
 #include <dune/istl/schwarz.hh>
 #include <dune/istl/novlpschwarz.hh>
 
@@ -124,6 +125,14 @@ namespace Dune{
      relaxation = 1
      \endverbatim
 
+     Setting `instrumentation = true` records the time, the calls and the
+     estimated FLOPs and memory traffic of the operator, the preconditioner and
+     the scalar product, and of everything they instrument themselves, e.g. the
+     levels of AMG and the communication. The returned solver is then an
+     InstrumentedInverseOperator providing a JSON report of the last solve. If
+     `instrumentationfile` is given, the report of every solve is appended to
+     this file.
+
      \tparam Operator type of the operator, necessary to deduce the matrix type etc.
    */
   template<class Operator>
@@ -162,6 +171,8 @@ namespace Dune{
             DUNE_THROW(NotImplemented, "The solver factory does not support parallel direct solvers!");
           }
           result = DirectSolverFactory<matrix_type, Domain, Range>::instance().create(type, *mat, config);
+          if (config.get("instrumentation", false))
+            result = std::make_shared<InstrumentedInverseOperator<Domain,Range>>(result, type, config.get("instrumentationfile", std::string()));
           return result;
         }
       }
@@ -178,6 +189,19 @@ namespace Dune{
           prec = wrapPreconditioner4Parallel(prec, op);
       }
       std::shared_ptr<ScalarProduct<Domain>> sp = createScalarProduct(op);
+      if (config.get("instrumentation", false)) {
+        std::shared_ptr<LinearOperator<Domain,Range>> iop;
+        if constexpr (isAssembled) {
+          if (mat)
+            iop = std::make_shared<InstrumentedOperator<Domain,Range>>(op, *mat);
+        }
+        if (!iop)
+          iop = std::make_shared<InstrumentedOperator<Domain,Range>>(op);
+        prec = std::make_shared<InstrumentedPreconditioner<Domain,Range>>(prec);
+        sp = std::make_shared<InstrumentedScalarProduct<Domain>>(sp);
+        result = IterativeSolverFactory<Domain, Range>::instance().create(type, iop, sp, prec, config);
+        return std::make_shared<InstrumentedInverseOperator<Domain,Range>>(result, type, config.get("instrumentationfile", std::string()));
+      }
       result = IterativeSolverFactory<Domain, Range>::instance().create(type, op, sp, prec, config);
       return result;
     }
@@ -6,10 +6,12 @@
 #ifndef DUNE_ISTL_SOLVERS_HH
 #define DUNE_ISTL_SOLVERS_HH
 
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <complex>
 #include <iostream>
+#include <limits>
 #include <memory>
 #include <type_traits>
 #include <vector>
@@ -36,6 +38,52 @@ namespace Dune {
       @{
    */
 
+  namespace Impl {
+
+    template<class X>
+    using FusedAxpby = decltype(std::declval<X&>().axpby(std::declval<typename X::field_type>(), std::declval<const X&>(), std::declval<typename X::field_type>()));
+
+    //! x = b*x + a*y, in one sweep if the vector type provides axpby
+    template<class X, class F>
+    void axpby (X& x, const F& a, const X& y, const F& b)
+    {
+      if constexpr (Std::is_detected_v<FusedAxpby, X>)
+        x.axpby(a,y,b);
+      else
+      {
+        x *= b;
+        x.axpy(a,y);
+      }
+    }
+
+    //! the real part of a number, without using std::real for non-complex (e.g. SIMD) types
+    template<class F>
+    auto realPart (const F& f)
+    {
+      if constexpr (std::is_same_v<F, typename FieldTraits<F>::real_type>)
+        return f;
+      else
+      {
+        using std::real;
+        return real(f);
+      }
+    }
+
+    //! the complex conjugate, without using std::conj for non-complex (e.g. SIMD) types
+    template<class F>
+    F conjugate (const F& f)
+    {
+      if constexpr (std::is_same_v<F, typename FieldTraits<F>::real_type>)
+        return f;
+      else
+      {
+        using std::conj;
+        return conj(f);
+      }
+    }
+
+  } // end namespace Impl
+
   /** \file
 
       \brief   Implementations of the inverse operator interface.
@@ -316,10 +364,9 @@ namespace Dune {
           if (condition_estimate_)
             lambdas.push_back(std::real(lambda));
         x.axpy(lambda,p);           // update solution
-        b.axpy(-lambda,q);          // update defect
+        def=_sp->axpyNorm(b,-lambda,q); // update defect and comp defect norm
 
         // convergence test
-        def=_sp->norm(b); // comp defect norm
         if(iteration.step(i, def))
           break;
 
@@ -331,8 +378,7 @@ namespace Dune {
         if constexpr (enableConditionEstimate)
           if (condition_estimate_)
             betas.push_back(std::real(beta));
-        p *= beta;                  // scale old search direction
-        p += q;                     // orthogonalization with correction
+        Impl::axpby(p,field_type(1),q,beta); // p = beta*p + q, orthogonalization with correction
         rholast = rho;              // remember rho for recurrence
       }
 
@@ -413,6 +459,520 @@ namespace Dune {
   };
   DUNE_REGISTER_ITERATIVE_SOLVER("cgsolver", defaultIterativeSolverCreator<Dune::CGSolver>());
 
+  /*!
+     \brief Pipelined conjugate gradient method
+
+     Implements the pipelined preconditioned CG method of P. Ghysels and
+     W. Vanroose, 'Hiding global synchronization latency in the preconditioned
+     Conjugate Gradient algorithm', Parallel Computing 40 (2014). It is
+     mathematically equivalent to CGSolver, but the two dot products and the
+     defect norm of an iteration are computed by a single non-blocking global
+     reduction (ScalarProduct::idot()). The reduction is overlapped with the
+     application of the preconditioner and of the operator, which hides its
+     latency in parallel runs on many processes.
+
+     The method needs five additional vectors and more vector updates than
+     CGSolver, and the recurrences for the defect accumulate rounding errors
+     differently, so the attainable accuracy is slightly lower. The defect norm
+     used for the convergence test is that of the recursively updated defect.
+     It is only available one iteration later, so the iteration after the
+     converged one is partially computed and discarded.
+   */
+  template<class X>
+  class PipelinedCGSolver : public IterativeSolver<X,X> {
+  public:
+    using typename IterativeSolver<X,X>::domain_type;
+    using typename IterativeSolver<X,X>::range_type;
+    using typename IterativeSolver<X,X>::field_type;
+    using typename IterativeSolver<X,X>::real_type;
+
+    // copy base class constructors
+    using IterativeSolver<X,X>::IterativeSolver;
+
+    // don't shadow four-argument version of apply defined in the base class
+    using IterativeSolver<X,X>::apply;
+
+    /*!
+       \brief Apply inverse operator.
+
+       \copydoc InverseOperator::apply(X&,Y&,InverseOperatorResult&)
+     */
+    virtual void apply (X& x, X& b, InverseOperatorResult& res)
+    {
+      using std::sqrt;
+      Iteration iteration(*this,res);
+      _prec->pre(x,b);             // prepare preconditioner
+
+      _op->applyscaleadd(-1,x,b);  // overwrite b with defect
+      X& r = b;
+
+      real_type def = _sp->norm(r); // compute norm
+      if(iteration.step(0, def)){
+        _prec->post(x);
+        return;
+      }
+
+      X u(x);              // preconditioned defect u = M^-1 r
+      X w(x);              // w = A u
+      X m(x);              // m = M^-1 w
+      X n(x);              // n = A m
+      X p(x);              // the search direction
+      X s(x);              // s = A p
+      X q(x);              // q = M^-1 s
+      X z(x);              // z = A q
+
+      u = 0;
+      _prec->apply(u,r);
+      _op->apply(u,w);
+      p = 0; s = 0; q = 0; z = 0;
+
+      // gamma = <u,r>, delta = <u,w> and |r|^2 are computed by one reduction
+      const std::vector<const X*> left{&u, &u};
+      const std::vector<const X*> right{&r, &w};
+      const std::vector<const X*> norms{&r};
+
+      field_type gamma, gammalast(0), delta, alpha, alphalast(0), beta;
+
+      bool stopped = false;
+      for (int i=1; i<=_maxit; i++)
+      {
+        auto reduction = _sp->idot(left, right, norms);
+
+        // overlap the reduction with preconditioner and operator
+        m = 0;
+        _prec->apply(m,w);           // m = M^-1 w
+        _op->apply(m,n);             // n = A m
+
+        auto result = reduction.get();
+        gamma = result[0];
+        delta = result[1];
+
+        // convergence test for the defect of the previous iteration
+        if (i > 1)
+        {
+          def = sqrt(Impl::realPart(result[2]));
+          if(iteration.step(i-1, def)){
+            stopped = true;
+            break;
+          }
+        }
+
+        if (i > 1)
+        {
+          beta = Simd::cond(gammalast==field_type(0.), field_type(0.), gamma/gammalast);
+          alpha = Simd::cond(gamma==field_type(0.), field_type(0.), gamma/(delta - beta*gamma/alphalast));
+        }
+        else
+        {
+          beta = 0;
+          alpha = Simd::cond(gamma==field_type(0.), field_type(0.), gamma/delta);
+        }
+
+        Impl::axpby(z,field_type(1),n,beta); // z = n + beta z
+        Impl::axpby(q,field_type(1),m,beta); // q = m + beta q
+        Impl::axpby(s,field_type(1),w,beta); // s = w + beta s
+        Impl::axpby(p,field_type(1),u,beta); // p = u + beta p
+
+        x.axpy(alpha,p);             // update solution
+        r.axpy(-alpha,s);            // update defect
+        u.axpy(-alpha,q);            // update preconditioned defect
+        w.axpy(-alpha,z);            // update w = A u
+
+        gammalast = gamma;
+        alphalast = alpha;
+      }
+
+      // the defect of the last iteration has not been checked yet
+      if (!stopped)
+        iteration.step(_maxit, _sp->norm(r));
+
+      _prec->post(x);                  // postprocess preconditioner
+    }
+
+  protected:
+    using IterativeSolver<X,X>::_op;
+    using IterativeSolver<X,X>::_prec;
+    using IterativeSolver<X,X>::_sp;
+    using IterativeSolver<X,X>::_maxit;
+    using Iteration = typename IterativeSolver<X,X>::template Iteration<unsigned int>;
+  };
+  DUNE_REGISTER_ITERATIVE_SOLVER("pipelinedcgsolver", defaultIterativeSolverCreator<Dune::PipelinedCGSolver>());
+
+  namespace Impl {
+
+    /* \brief Cholesky factorization G = L L^H of a small Hermitian positive semi-definite matrix
+
+       Only the lower triangle of G is used. The factorization stops at the
+       first column whose pivot is below `tolerance` times its diagonal entry
+       in any SIMD lane, i.e. at the first column that is numerically linearly
+       dependent on the previous ones. Lanes with a vanishing diagonal entry
+       (e.g. converged lanes with a zero defect) get a unit pivot.
+
+       \returns the number of factorized columns
+     */
+    template<class F, class T>
+    std::size_t gramCholesky (const std::vector<std::vector<F>>& G, std::size_t n,
+                              std::vector<std::vector<F>>& L, const T& tolerance)
+    {
+      using std::abs;
+      using std::sqrt;
+      using R = typename FieldTraits<F>::real_type;
+      for (std::size_t i=0; i<n; ++i)
+      {
+        const R diagonal = realPart(G[i][i]);
+        R d = diagonal;
+        for (std::size_t k=0; k<i; ++k)
+          d -= abs(L[i][k])*abs(L[i][k]);
+        const auto zero = (diagonal == R(0));
+        if (!Simd::allTrue(zero || d > tolerance*diagonal))
+          return i;
+        L[i][i] = Simd::cond(zero, R(1), R(sqrt(d)));
+        for (std::size_t j=i+1; j<n; ++j)
+        {
+          F t = G[j][i];
+          for (std::size_t k=0; k<i; ++k)
+            t -= L[j][k]*conjugate(L[i][k]);
+          L[j][i] = t/L[i][i];
+        }
+      }
+      return n;
+    }
+
+    //! Solve L L^H y = b in place for the first n components, with a factor from gramCholesky()
+    template<class F>
+    void choleskySolve (const std::vector<std::vector<F>>& L, std::size_t n, std::vector<F>& b)
+    {
+      for (std::size_t i=0; i<n; ++i)
+      {
+        for (std::size_t k=0; k<i; ++k)
+          b[i] -= L[i][k]*b[k];
+        b[i] /= L[i][i];
+      }
+      for (std::size_t i=n; i-- > 0;)
+      {
+        for (std::size_t k=i+1; k<n; ++k)
+          b[i] -= conjugate(L[k][i])*b[k];
+        b[i] /= L[i][i];
+      }
+    }
+
+    /* \brief Polynomial basis of the s-step Krylov solvers
+
+       The basis vectors \f$ k_j = p_j(B) k_0 \f$ of a block satisfy the three-term
+       recurrence \f$ B k_j = \sigma_j k_{j+1} + \theta_j k_j + \rho_j k_{j-1} \f$.
+       Initially, this is the monomial basis \f$ k_{j+1} = B k_j \f$. Once an
+       estimate of the largest eigenvalue of B is available, the scaled and
+       shifted Chebyshev polynomials for \f$ [0,\lambda_{max}] \f$ are used, which
+       keep the basis much better conditioned for larger s.
+     */
+    template<class R>
+    class SStepBasis
+    {
+    public:
+      //! Whether the estimate of the largest eigenvalue is still missing
+      bool monomial () const
+      {
+        return monomial_;
+      }
+
+      /* \brief Switch to the Chebyshev basis, with an estimate of the largest eigenvalue
+
+         The estimate is the largest Rayleigh quotient \f$ G_{j,j+1}/G_{j,j} \f$
+         in the Gram matrix \f$ G_{ij} = \langle k_i, D k_j \rangle \f$ of the first
+         n vectors of a monomial basis, for some inner product matrix D. It is
+         enlarged a bit, as the Chebyshev polynomials grow quickly above
+         the interval. Lanes without a positive estimate keep the monomial basis.
+       */
+      template<class F>
+      void estimate (const std::vector<std::vector<F>>& G, std::size_t n)
+      {
+        using std::max;
+        R lambda(0);
+        for (std::size_t j=0; j+1<n; ++j)
+        {
+          const R gjj = realPart(G[j][j]);
+          lambda = max(lambda, Simd::cond(gjj > R(0), R(realPart(G[j][j+1])/gjj), R(0)));
+        }
+        halfWidth_ = Simd::cond(lambda > R(0), R(0.55)*lambda, R(0));
+        monomial_ = false;
+      }
+
+      R sigma (std::size_t j) const
+      {
+        return Simd::cond(halfWidth_ > R(0), j == 0 ? halfWidth_ : R(0.5*halfWidth_), R(1));
+      }
+
+      R theta (std::size_t) const
+      {
+        return halfWidth_;
+      }
+
+      R rho (std::size_t j) const
+      {
+        return j == 0 ? R(0) : R(0.5*halfWidth_);
+      }
+
+    private:
+      // half of the length of the Chebyshev interval, zero for the monomial basis
+      R halfWidth_ = R(0);
+      bool monomial_ = true;
+    };
+
+  } // end namespace Impl
+
+  /*!
+     \brief s-step (communication-avoiding) conjugate gradient method
+
+     Performs s iterations of the preconditioned CG method at once, following
+     A. T. Chronopoulos and C. W. Gear, 's-step iterative methods for symmetric
+     linear systems', J. Comput. Appl. Math. 25 (1989). Each block computes
+     s basis vectors \f$ p_j(M^{-1}A) M^{-1} r \f$ of the Krylov space, makes
+     them A-conjugate to the search directions of the previous block and
+     minimizes the energy norm of the error over them. All dot products of
+     a block are computed by a single global reduction with
+     ScalarProduct::blockDot(), so the number of global synchronizations is
+     reduced by a factor of s compared to CGSolver.
+
+     The first block uses the monomial basis, afterwards a Chebyshev basis for
+     an eigenvalue estimate from the first block is used (see the Newton and
+     Chebyshev bases in M. Hoemmen, 'Communication-avoiding Krylov subspace
+     methods', PhD thesis, UC Berkeley, 2010). Still, the basis becomes
+     ill-conditioned for large s; directions that are numerically linearly
+     dependent are dropped, which slows down convergence. Values of s up to
+     about 8 are recommended.
+
+     The defect is only checked once per block, so the iteration count is a
+     multiple of s (or `maxit`). The solver needs 4s additional vectors.
+   */
+  template<class X>
+  class SStepCGSolver : public IterativeSolver<X,X> {
+  public:
+    using typename IterativeSolver<X,X>::domain_type;
+    using typename IterativeSolver<X,X>::range_type;
+    using typename IterativeSolver<X,X>::field_type;
+    using typename IterativeSolver<X,X>::real_type;
+
+    // copy base class constructors, they use s = 4
+    using IterativeSolver<X,X>::IterativeSolver;
+
+  private:
+    using typename IterativeSolver<X,X>::scalar_real_type;
+
+  public:
+
+    // don't shadow four-argument version of apply defined in the base class
+    using IterativeSolver<X,X>::apply;
+
+    /*!
+       \brief Set up SStepCGSolver solver.
+
+       \copydoc LoopSolver::LoopSolver(const L&,P&,double,int,int)
+       \param steps number s of iterations per block
+     */
+    SStepCGSolver (const LinearOperator<X,X>& op, Preconditioner<X,X>& prec,
+                   scalar_real_type reduction, int steps, int maxit, int verbose) :
+      IterativeSolver<X,X>(op,prec,reduction,maxit,verbose),
+      _steps(checkSteps(steps))
+    {}
+
+    /*!
+       \brief Set up SStepCGSolver solver.
+
+       \copydoc LoopSolver::LoopSolver(const L&, const S&,P&,double,int,int)
+       \param steps number s of iterations per block
+     */
+    SStepCGSolver (const LinearOperator<X,X>& op, const ScalarProduct<X>& sp, Preconditioner<X,X>& prec,
+                   scalar_real_type reduction, int steps, int maxit, int verbose) :
+      IterativeSolver<X,X>(op,sp,prec,reduction,maxit,verbose),
+      _steps(checkSteps(steps))
+    {}
+
+    /*!
+       \brief Set up SStepCGSolver solver.
+
+       \copydoc LoopSolver::LoopSolver(std::shared_ptr<const L>,std::shared_ptr<const S>,std::shared_ptr<P>,double,int,int)
+       \param steps number s of iterations per block
+     */
+    SStepCGSolver (std::shared_ptr<const LinearOperator<X,X>> op,
+                   std::shared_ptr<const ScalarProduct<X>> sp,
+                   std::shared_ptr<Preconditioner<X,X>> prec,
+                   scalar_real_type reduction, int steps, int maxit, int verbose) :
+      IterativeSolver<X,X>(op,sp,prec,reduction,maxit,verbose),
+      _steps(checkSteps(steps))
+    {}
+
+    /*!
+       \brief Constructor.
+
+       \copydoc IterativeSolver::IterativeSolver(const L&, const S&,P&,const ParameterTree&)
+
+       Additional parameter:
+       ParameterTree Key | Meaning
+       ------------------|------------
+       steps             | number s of iterations per block (default 4)
+
+       See \ref ISTL_Factory for the ParameterTree layout and examples.
+     */
+    SStepCGSolver (std::shared_ptr<const LinearOperator<X,X> > op, std::shared_ptr<Preconditioner<X,X> > prec, const ParameterTree& configuration) :
+      IterativeSolver<X,X>(op,prec,configuration),
+      _steps(checkSteps(configuration.get<int>("steps",4)))
+    {}
+
+    SStepCGSolver (std::shared_ptr<const LinearOperator<X,X> > op, std::shared_ptr<const ScalarProduct<X> > sp, std::shared_ptr<Preconditioner<X,X> > prec, const ParameterTree& configuration) :
+      IterativeSolver<X,X>(op,sp,prec,configuration),
+      _steps(checkSteps(configuration.get<int>("steps",4)))
+    {}
+
+    /*!
+       \brief Apply inverse operator.
+
+       \copydoc InverseOperator::apply(X&,Y&,InverseOperatorResult&)
+
+       \note The SStepCGSolver aborts when no search direction of a block
+             is linearly independent of the previous ones.
+     */
+    virtual void apply (X& x, X& b, InverseOperatorResult& res)
+    {
+      using std::sqrt;
+      using Matrix = std::vector<std::vector<field_type>>;
+      // below this relative size, a search direction is considered linearly dependent
+      const Simd::Scalar<real_type> tolerance = sqrt(std::numeric_limits<Simd::Scalar<real_type>>::epsilon());
+      const std::size_t s = _steps;
+
+      Iteration iteration(*this,res);
+      _prec->pre(x,b);             // prepare preconditioner
+
+      _op->applyscaleadd(-1,x,b);  // overwrite b with defect
+      X& r = b;
+
+      std::vector<X> R(s,x), AR(s,x);  // the Krylov basis of the block and its image
+      std::vector<X> P(s,x), AP(s,x);  // the search directions and their image
+      std::size_t np = 0;              // the number of search directions of the previous block
+
+      Matrix G(s, std::vector<field_type>(s));   // R^H A R, then P^H A P
+      Matrix C(s, std::vector<field_type>(s));   // P_prev^H A R
+      Matrix L(s, std::vector<field_type>(s)), Lprev(L);
+      std::vector<field_type> g(s), gprev(s), column(s), dots;
+      std::vector<const X*> left, right;
+      Impl::SStepBasis<real_type> basis;
+
+      int i = 0;
+      while (true)
+      {
+        const std::size_t sb = std::min<std::size_t>(s, std::max(_maxit - i, 0));
+
+        // the Krylov basis R[j] = p_j(M^-1 A) M^-1 r and AR[j] = A R[j]
+        for (std::size_t j=0; j<sb; j++)
+        {
+          R[j] = 0;
+          if (j == 0)
+            _prec->apply(R[j],r);
+          else
+          {
+            _prec->apply(R[j],AR[j-1]);
+            R[j].axpy(-basis.theta(j-1),R[j-1]);
+            if (j > 1)
+              R[j].axpy(-basis.rho(j-1),R[j-2]);
+            R[j] *= real_type(1.0)/basis.sigma(j-1);
+          }
+          _op->apply(R[j],AR[j]);
+        }
+
+        // all dot products of the block with a single reduction:
+        // [R, P_prev, r]^H [AR, r]
+        left.clear();
+        right.clear();
+        for (std::size_t j=0; j<sb; j++)
+        {
+          left.push_back(&R[j]);
+          right.push_back(&AR[j]);
+        }
+        for (std::size_t l=0; l<np; l++)
+          left.push_back(&P[l]);
+        left.push_back(&r);
+        right.push_back(&r);
+        _sp->blockDot(left,right,dots);
+
+        const std::size_t n = sb+1;
+        const real_type def = sqrt(Impl::realPart(dots[(sb+np)*n + sb]));
+        if (iteration.step(i, def) || sb == 0)
+          break;
+
+        for (std::size_t j=0; j<sb; j++)
+        {
+          for (std::size_t k=0; k<sb; k++)
+            G[j][k] = dots[j*n + k];
+          g[j] = dots[j*n + sb];
+        }
+        for (std::size_t l=0; l<np; l++)
+        {
+          for (std::size_t k=0; k<sb; k++)
+            C[l][k] = dots[(sb+l)*n + k];
+          gprev[l] = dots[(sb+l)*n + sb];
+        }
+
+        if (basis.monomial())
+          basis.estimate(G,sb);
+
+        // make the basis A-conjugate to the previous search directions,
+        // P = R - P_prev B with B = (P_prev^H A P_prev)^-1 P_prev^H A R
+        for (std::size_t k=0; k<sb; k++)
+        {
+          for (std::size_t l=0; l<np; l++)
+            column[l] = C[l][k];
+          Impl::choleskySolve(Lprev,np,column);
+          for (std::size_t l=0; l<np; l++)
+          {
+            R[k].axpy(-column[l],P[l]);
+            AR[k].axpy(-column[l],AP[l]);
+          }
+          // G = P^H A P = R^H A R - C^H B and g = P^H r = R^H r - B^H P_prev^H r
+          for (std::size_t j=0; j<sb; j++)
+            for (std::size_t l=0; l<np; l++)
+              G[j][k] -= Impl::conjugate(C[l][j])*column[l];
+          for (std::size_t l=0; l<np; l++)
+            g[k] -= Impl::conjugate(column[l])*gprev[l];
+        }
+        std::swap(R,P);
+        std::swap(AR,AP);
+
+        // minimize the energy norm of the error over the new search directions
+        np = Impl::gramCholesky(G,sb,L,tolerance);
+        if (np == 0)
+          DUNE_THROW(SolverAbort,
+                     "breakdown in s-step CG - no independent search direction after " << i << " iterations");
+        Impl::choleskySolve(L,np,g);
+        for (std::size_t l=0; l<np; l++)
+        {
+          x.axpy(g[l],P[l]);         // update solution
+          r.axpy(-g[l],AP[l]);       // update defect
+        }
+        std::swap(L,Lprev);
+
+        i += sb;
+      }
+
+      _prec->post(x);                  // postprocess preconditioner
+    }
+
+  private:
+    static int checkSteps (int steps)
+    {
+      if (steps < 1)
+        DUNE_THROW(ISTLError, "s-step CG needs at least one step per block, got " << steps);
+      return steps;
+    }
+
+  protected:
+    using IterativeSolver<X,X>::_op;
+    using IterativeSolver<X,X>::_prec;
+    using IterativeSolver<X,X>::_sp;
+    using IterativeSolver<X,X>::_maxit;
+    using Iteration = typename IterativeSolver<X,X>::template Iteration<unsigned int>;
+    int _steps = 4;
+  };
+  DUNE_REGISTER_ITERATIVE_SOLVER("sstepcgsolver", defaultIterativeSolverCreator<Dune::SStepCGSolver>());
+
   // Ronald Kriemanns BiCG-STAB implementation from Sumo
   //! \brief Bi-conjugate Gradient Stabilized (BiCG-STAB)
   template<class X>
@@ -455,6 +1015,10 @@ namespace Dune {
       X y(x);
       X rt(x);
 
+      // vectors for the fused computation of < t, t > and < t, r >
+      const std::vector<const X*> tr{&t, &r};
+      std::vector<field_type> dots(2);
+
       //
       // begin iteration
       //
@@ -511,8 +1075,7 @@ namespace Dune {
                             field_type(0.), // no need for orthogonalization if norm is already 0
                             ( rho_new / rho ) * ( alpha / omega ));
           p.axpy(-omega,v); // p = r + beta (p - omega*v)
-          p *= beta;
-          p += r;
+          Impl::axpby(p,field_type(1),r,beta);
         }
 
         // y = W^-1 * p
@@ -539,13 +1102,12 @@ namespace Dune {
         x.axpy(alpha,y);
 
         // r = r - alpha*v
-        r.axpy(-alpha,v);
+        norm = _sp->axpyNorm(r,-alpha,v);
 
         //
         // test stop criteria
         //
 
-        norm = _sp->norm(r);
         if(iteration.step(it, norm)){
           break;
         }
@@ -560,17 +1122,18 @@ namespace Dune {
         _op->apply(y,t);
 
         // omega = < t, r > / < t, t >
-        h = _sp->dot(t,t);
+        _sp->multiDot(t,tr,dots);
+        h = dots[0];
         omega = Simd::cond(norm==field_type(0.),
                            field_type(0.),
-                           _sp->dot(t,r)/h);
+                           dots[1]/h);
 
         // apply second correction to x
         // x <- x + omega y
         x.axpy(omega,y);
 
         // r = s - omega*t (remember : r = s)
-        r.axpy(-omega,t);
+        norm = _sp->axpyNorm(r,-omega,t);
 
         rho = rho_new;
 
@@ -578,7 +1141,6 @@ namespace Dune {
         // test stop criteria
         //
 
-        norm = _sp->norm(r);
         if(iteration.step(it, norm)){
           break;
         }
@@ -968,16 +1530,17 @@ namespace Dune {
           // do Arnoldi algorithm
           _op->apply(v[i],v[i+1]);
           _prec->apply(w,v[i+1]);
-          for(int k=0; k<i+1; k++) {
-            // notice that _sp->dot(v[k],w) = v[k]\adjoint w
-            // so one has to pay attention to the order
-            // in the scalar product for the complex case
-            // doing the modified Gram-Schmidt algorithm
-            H[k][i] = _sp->dot(v[k],w);
-            // w -= H[k][i] * v[k]
-            w.axpy(-H[k][i],v[k]);
+          // notice that _sp->dot(v[k],w) = v[k]\adjoint w
+          // so one has to pay attention to the order
+          // in the scalar product for the complex case
+          // doing the modified Gram-Schmidt algorithm
+          H[0][i] = _sp->dot(v[0],w);
+          for(int k=0; k<i; k++) {
+            // w -= H[k][i] * v[k], fused with the next scalar product
+            H[k+1][i] = _sp->axpyDot(w,-H[k][i],v[k],v[k+1]);
           }
-          H[i+1][i] = _sp->norm(w);
+          // w -= H[i][i] * v[i], fused with the norm
+          H[i+1][i] = _sp->axpyNorm(w,-H[i][i],v[i]);
           if(Simd::allTrue(abs(H[i+1][i]) < EPSILON))
             DUNE_THROW(SolverAbort,
                        "breakdown in GMRes - |w| == 0.0 after " << j << " iterations");
@@ -1121,6 +1684,540 @@ namespace Dune {
   };
   DUNE_REGISTER_ITERATIVE_SOLVER("restartedgmressolver", defaultIterativeSolverCreator<Dune::RestartedGMResSolver>());
 
+  /**
+     \brief Pipelined restarted GMRes method (p(1)-GMRes)
+
+     Left preconditioned GMRes where the dot products and the norm of an
+     Arnoldi step are computed by a single non-blocking global reduction
+     (ScalarProduct::idot()), which is overlapped with the application of the
+     preconditioner and the operator for the next step. This follows the p(1)-GMRes
+     method of P. Ghysels, T. J. Ashby, K. Meerbergen, and W. Vanroose,
+     'Hiding global communication latency in the GMRES algorithm on massively
+     parallel machines', SIAM J. Sci. Comput. 35 (2013).
+
+     With \f$ B = M^{-1}A \f$, the vectors \f$ z_k = B v_k \f$ are kept along with
+     the Krylov basis \f$ v_k \f$. While the reduction for the coefficients
+     \f$ h_{k,i} = \langle v_k, z_i \rangle \f$ is in progress, \f$ B z_i \f$ is
+     computed, from which \f$ z_{i+1} = B v_{i+1} \f$ follows by a linear combination.
+     The norm \f$ h_{i+1,i} \f$ is obtained from \f$ \|z_i\| \f$ by Pythagoras, and
+     computed explicitly (with a blocking reduction) if that suffers from cancellation.
+
+     The orthogonalization is classical Gram-Schmidt, which is less stable than
+     the modified Gram-Schmidt of RestartedGMResSolver. The solver needs m
+     additional vectors for restart length m.
+
+     \tparam X vector type of the solution and the right hand side
+   */
+  template<class X>
+  class PipelinedGMResSolver : public RestartedGMResSolver<X>
+  {
+    using Base = RestartedGMResSolver<X>;
+
+  public:
+    using typename Base::domain_type;
+    using typename Base::range_type;
+    using typename Base::field_type;
+    using typename Base::real_type;
+
+  private:
+    using typename Base::fAlloc;
+    using typename Base::rAlloc;
+
+  public:
+    // copy base class constructors
+    using Base::Base;
+
+    // don't shadow four-argument version of apply defined in the base class
+    using Base::apply;
+
+    /*!
+       \brief Apply inverse operator.
+
+       \copydoc InverseOperator::apply(X&,Y&,double,InverseOperatorResult&)
+
+       \note Currently, the PipelinedGMResSolver aborts when it detects a
+             breakdown.
+     */
+    void apply (X& x, X& b, [[maybe_unused]] double reduction, InverseOperatorResult& res) override
+    {
+      using std::abs;
+      using std::sqrt;
+      const Simd::Scalar<real_type> EPSILON = 1e-80;
+      // below this relative size, h_{i+1,i} is computed explicitly
+      const Simd::Scalar<real_type> tolerance = sqrt(std::numeric_limits<Simd::Scalar<real_type>>::epsilon());
+      const int m = _restart;
+      real_type norm = 0.0;
+      int j = 1;
+      std::vector<field_type,fAlloc> s(m+1), sn(m), h(m+1);
+      std::vector<real_type,rAlloc> cs(m);
+      // need copy of rhs if GMRes has to be restarted
+      X b2(b);
+      // helper vectors
+      X w(b), tmp(b);
+      std::vector< std::vector<field_type,fAlloc> > H(m+1,s);
+      std::vector<X> v(m+1,b);
+      // z[k] = M^-1 A v[k]
+      std::vector<X> z(m,b);
+      std::vector<const X*> basis, image;
+
+      Iteration iteration(*this,res);
+
+      // clear solver statistics and set res.converged to false
+      _prec->pre(x,b);
+
+      // calculate defect and overwrite rhs with it
+      _op->applyscaleadd(-1.0,x,b); // b -= Ax
+      // calculate preconditioned defect
+      v[0] = 0.0; _prec->apply(v[0],b); // r = W^-1 b
+      norm = _sp->norm(v[0]);
+      if(iteration.step(0, norm)){
+        _prec->post(x);
+        return;
+      }
+
+      while(j <= _maxit && res.converged != true) {
+
+        v[0] *= Simd::cond(norm==real_type(0.),
+                           real_type(0.),
+                           real_type(1.0)/norm);
+        s[0] = norm;
+        for(int k=1; k<m+1; k++)
+          s[k] = 0.0;
+
+        // start the first reduction and overlap it with w = B z[0]
+        applyPreconditionedOperator(v[0],z[0],tmp);
+        auto dots = startReduction(v,z[0],0,basis,image);
+        applyPreconditionedOperator(z[0],w,tmp);
+
+        int i = 0;
+        while(i < m && j <= _maxit && res.converged != true) {
+          // h[k] = <v[k],z[i]> for k <= i, followed by |z[i]|^2
+          auto result = dots.get();
+          const real_type zz = Impl::realPart(result[i+1]);
+          real_type hh = zz;
+          for(int k=0; k<=i; k++) {
+            h[k] = result[k];
+            hh -= abs(h[k])*abs(h[k]);
+          }
+
+          // v[i+1] = z[i] - sum_k h[k] v[k], normalized
+          v[i+1] = z[i];
+          for(int k=0; k<=i; k++)
+            v[i+1].axpy(-h[k],v[k]);
+          if(Simd::allTrue(hh > tolerance*zz))
+            h[i+1] = sqrt(hh);
+          else
+            h[i+1] = _sp->norm(v[i+1]);
+          if(Simd::allTrue(abs(h[i+1]) < EPSILON))
+            DUNE_THROW(SolverAbort,
+                       "breakdown in pipelined GMRes - |w| == 0.0 after " << j << " iterations");
+          v[i+1] *= real_type(1.0)/h[i+1];
+
+          // update QR factorization of the new column
+          for(int k=0; k<=i+1; k++)
+            H[k][i] = h[k];
+          for(int k=0; k<i; k++)
+            this->applyPlaneRotation(H[k][i],H[k+1][i],cs[k],sn[k]);
+          this->generatePlaneRotation(H[i][i],H[i+1][i],cs[i],sn[i]);
+          this->applyPlaneRotation(H[i][i],H[i+1][i],cs[i],sn[i]);
+          this->applyPlaneRotation(s[i],s[i+1],cs[i],sn[i]);
+
+          // norm of the defect is the last component the vector s
+          norm = abs(s[i+1]);
+          iteration.step(j, norm);
+          i++; j++;
+
+          if(i < m && j <= _maxit && res.converged != true) {
+            // z[i] = B v[i] = (B z[i-1] - sum_k h[k] z[k]) / h[i]
+            z[i] = w;
+            for(int k=0; k<i; k++)
+              z[i].axpy(-h[k],z[k]);
+            z[i] *= real_type(1.0)/h[i];
+
+            // start the reduction for the next column and overlap it with w = B z[i]
+            dots = startReduction(v,z[i],i,basis,image);
+            applyPreconditionedOperator(z[i],w,tmp);
+          }
+        }
+
+        // calculate update vector
+        w = 0.0;
+        this->update(w,i,H,s,v);
+        // and current iterate
+        x += w;
+
+        // restart GMRes if convergence was not achieved,
+        // i.e. linear defect has not reached desired reduction
+        // and if j < _maxit (do not restart on last iteration)
+        if( res.converged != true && j < _maxit ) {
+
+          if(_verbose > 0)
+            std::cout << "=== GMRes::restart" << std::endl;
+          // get saved rhs
+          b = b2;
+          // calculate new defect
+          _op->applyscaleadd(-1.0,x,b); // b -= Ax;
+          // calculate preconditioned defect
+          v[0] = 0.0;
+          _prec->apply(v[0],b);
+          norm = _sp->norm(v[0]);
+        }
+
+      } //end while
+
+      // postprocess preconditioner
+      _prec->post(x);
+    }
+
+  private:
+    // result = M^-1 A v
+    void applyPreconditionedOperator (const X& v, X& result, X& tmp)
+    {
+      _op->apply(v,tmp);
+      result = 0.0;
+      _prec->apply(result,tmp);
+    }
+
+    // start the reduction for <v[k],zi>, k <= i, and |zi|^2
+    auto startReduction (const std::vector<X>& v, const X& zi, int i,
+                         std::vector<const X*>& basis, std::vector<const X*>& image)
+    {
+      basis.clear();
+      image.clear();
+      for(int k=0; k<=i; k++) {
+        basis.push_back(&v[k]);
+        image.push_back(&zi);
+      }
+      return _sp->idot(basis,image,{&zi});
+    }
+
+  protected:
+    using Base::_op;
+    using Base::_prec;
+    using Base::_sp;
+    using Base::_maxit;
+    using Base::_verbose;
+    using Base::_restart;
+    using Iteration = typename Base::Iteration;
+  };
+  DUNE_REGISTER_ITERATIVE_SOLVER("pipelinedgmressolver", defaultIterativeSolverCreator<Dune::PipelinedGMResSolver>());
+
+  /**
+     \brief s-step (communication-avoiding) restarted GMRes method
+
+     Left preconditioned GMRes that extends the Krylov basis by s vectors at
+     once, following the CA-GMRES method in M. Hoemmen, 'Communication-avoiding
+     Krylov subspace methods', PhD thesis, UC Berkeley, 2010. From the last
+     basis vector \f$ v_i \f$, the vectors \f$ k_j = p_j(B) v_i \f$, j = 1,...,s with
+     \f$ B = M^{-1}A \f$ are computed without any global communication. They are
+     orthonormalized against the previous basis by block classical Gram-Schmidt and
+     among each other by a Cholesky QR factorization. Both need the dot products
+     \f$ \langle v_c, k_j \rangle \f$ and \f$ \langle k_l, k_j \rangle \f$ only,
+     which are computed by a single global reduction with ScalarProduct::blockDot().
+     The Hessenberg matrix of the Arnoldi relation is reconstructed from the
+     coefficients of the orthonormalization and of the polynomial basis. This
+     reduces the number of global synchronizations by a factor of s compared to
+     RestartedGMResSolver.
+
+     The first block uses the monomial basis, afterwards a Chebyshev basis for
+     an eigenvalue estimate from the first block is used. Basis vectors that are
+     numerically linearly dependent on the previous ones are dropped from a block.
+     The orthogonality of the basis is worse than with modified Gram-Schmidt,
+     values of s up to about 8 are recommended. The convergence test is performed
+     after each basis vector, just like for RestartedGMResSolver.
+
+     \tparam X vector type of the solution and the right hand side
+   */
+  template<class X>
+  class SStepGMResSolver : public RestartedGMResSolver<X>
+  {
+    using Base = RestartedGMResSolver<X>;
+
+  public:
+    using typename Base::domain_type;
+    using typename Base::range_type;
+    using typename Base::field_type;
+    using typename Base::real_type;
+
+  private:
+    using typename Base::scalar_real_type;
+    using typename Base::fAlloc;
+    using typename Base::rAlloc;
+
+  public:
+    // copy base class constructors, they use s = 4
+    using Base::Base;
+
+    // don't shadow four-argument version of apply defined in the base class
+    using Base::apply;
+
+    /*!
+       \brief Set up SStepGMResSolver solver.
+
+       \copydoc LoopSolver::LoopSolver(const L&,P&,double,int,int)
+       \param restart number of GMRes cycles before restart
+       \param steps number s of basis vectors computed at once
+     */
+    SStepGMResSolver (const LinearOperator<X,X>& op, Preconditioner<X,X>& prec, scalar_real_type reduction,
+                      int restart, int steps, int maxit, int verbose) :
+      Base(op,prec,reduction,restart,maxit,verbose),
+      _steps(checkSteps(steps))
+    {}
+
+    /*!
+       \brief Set up SStepGMResSolver solver.
+
+       \copydoc LoopSolver::LoopSolver(const L&, const S&,P&,double,int,int)
+       \param restart number of GMRes cycles before restart
+       \param steps number s of basis vectors computed at once
+     */
+    SStepGMResSolver (const LinearOperator<X,X>& op, const ScalarProduct<X>& sp, Preconditioner<X,X>& prec,
+                      scalar_real_type reduction, int restart, int steps, int maxit, int verbose) :
+      Base(op,sp,prec,reduction,restart,maxit,verbose),
+      _steps(checkSteps(steps))
+    {}
+
+    /*!
+       \brief Set up SStepGMResSolver solver.
+
+       \copydoc LoopSolver::LoopSolver(std::shared_ptr<const L>,std::shared_ptr<const S>,std::shared_ptr<P>,double,int,int)
+       \param restart number of GMRes cycles before restart
+       \param steps number s of basis vectors computed at once
+     */
+    SStepGMResSolver (std::shared_ptr<const LinearOperator<X,X>> op,
+                      std::shared_ptr<const ScalarProduct<X>> sp,
+                      std::shared_ptr<Preconditioner<X,X>> prec,
+                      scalar_real_type reduction, int restart, int steps, int maxit, int verbose) :
+      Base(op,sp,prec,reduction,restart,maxit,verbose),
+      _steps(checkSteps(steps))
+    {}
+
+    /*!
+       \brief Constructor.
+
+       \copydoc IterativeSolver::IterativeSolver(const L&, const S&,P&,const ParameterTree&)
+
+       Additional parameters:
+       ParameterTree Key | Meaning
+       ------------------|------------
+       restart           | number of GMRes cycles before restart
+       steps             | number s of basis vectors computed at once (default 4)
+
+       See \ref ISTL_Factory for the ParameterTree layout and examples.
+     */
+    SStepGMResSolver (std::shared_ptr<const LinearOperator<X,X> > op, std::shared_ptr<Preconditioner<X,X> > prec, const ParameterTree& configuration) :
+      Base(op,prec,configuration),
+      _steps(checkSteps(configuration.get<int>("steps",4)))
+    {}
+
+    SStepGMResSolver (std::shared_ptr<const LinearOperator<X,X> > op, std::shared_ptr<const ScalarProduct<X> > sp, std::shared_ptr<Preconditioner<X,X> > prec, const ParameterTree& configuration) :
+      Base(op,sp,prec,configuration),
+      _steps(checkSteps(configuration.get<int>("steps",4)))
+    {}
+
+    /*!
+       \brief Apply inverse operator.
+
+       \copydoc InverseOperator::apply(X&,Y&,double,InverseOperatorResult&)
+
+       \note Currently, the SStepGMResSolver aborts when it detects a
+             breakdown.
+     */
+    void apply (X& x, X& b, [[maybe_unused]] double reduction, InverseOperatorResult& res) override
+    {
+      using std::abs;
+      using std::sqrt;
+      using Matrix = std::vector<std::vector<field_type>>;
+      // below this relative size, a basis vector is considered linearly dependent
+      const Simd::Scalar<real_type> tolerance = sqrt(std::numeric_limits<Simd::Scalar<real_type>>::epsilon());
+      const int m = _restart;
+      real_type norm = 0.0;
+      int j = 1;
+      std::vector<field_type,fAlloc> s(m+1), sn(m);
+      std::vector<real_type,rAlloc> cs(m);
+      // need copy of rhs if GMRes has to be restarted
+      X b2(b);
+      // helper vectors
+      X w(b), tmp(b);
+      // the Hessenberg matrix with and without the Givens rotations applied
+      std::vector< std::vector<field_type,fAlloc> > H(m+1,s), Hraw(m+1,s);
+      std::vector<X> v(m+1,b);
+
+      const std::size_t maxSteps = std::min(_steps, m);
+      Matrix C(m+1, std::vector<field_type>(maxSteps));
+      Matrix G(maxSteps, std::vector<field_type>(maxSteps)), L(G);
+      // coordinates of the block basis k_l with respect to v
+      Matrix coefficients(maxSteps+1, std::vector<field_type>(m+1));
+      std::vector<field_type> column(m+1), dots;
+      std::vector<const X*> left, right;
+      Impl::SStepBasis<real_type> basis;
+
+      Iteration iteration(*this,res);
+
+      // clear solver statistics and set res.converged to false
+      _prec->pre(x,b);
+
+      // calculate defect and overwrite rhs with it
+      _op->applyscaleadd(-1.0,x,b); // b -= Ax
+      // calculate preconditioned defect
+      v[0] = 0.0; _prec->apply(v[0],b); // r = W^-1 b
+      norm = _sp->norm(v[0]);
+      if(iteration.step(0, norm)){
+        _prec->post(x);
+        return;
+      }
+
+      while(j <= _maxit && res.converged != true) {
+
+        v[0] *= Simd::cond(norm==real_type(0.),
+                           real_type(0.),
+                           real_type(1.0)/norm);
+        s[0] = norm;
+        for(int k=1; k<m+1; k++)
+          s[k] = 0.0;
+
+        int i = 0;
+        while(i < m && j <= _maxit && res.converged != true) {
+          // the block basis k_l = p_l(B) v[i], stored in v[i+l]
+          const std::size_t sb = std::min<std::size_t>(maxSteps, m-i);
+          for(std::size_t l=1; l<=sb; l++) {
+            _op->apply(v[i+l-1],tmp);
+            v[i+l] = 0.0;
+            _prec->apply(v[i+l],tmp);
+            v[i+l].axpy(-basis.theta(l-1),v[i+l-1]);
+            if(l > 1)
+              v[i+l].axpy(-basis.rho(l-1),v[i+l-2]);
+            v[i+l] *= real_type(1.0)/basis.sigma(l-1);
+          }
+
+          // <v[c],k_l> and <k_k,k_l> with a single reduction
+          left.clear();
+          right.clear();
+          for(std::size_t c=0; c<=i+sb; c++)
+            left.push_back(&v[c]);
+          for(std::size_t l=1; l<=sb; l++)
+            right.push_back(&v[i+l]);
+          _sp->blockDot(left,right,dots);
+          for(int c=0; c<=i; c++)
+            for(std::size_t l=0; l<sb; l++)
+              C[c][l] = dots[c*sb + l];
+          for(std::size_t k=0; k<sb; k++)
+            for(std::size_t l=0; l<sb; l++)
+              G[k][l] = dots[(i+1+k)*sb + l];
+
+          // the basis of this block is needed for the Hessenberg matrix below
+          Impl::SStepBasis<real_type> nextBasis(basis);
+          if(basis.monomial())
+            nextBasis.estimate(G,sb);
+
+          // block classical Gram-Schmidt, G = K^H K - C^H C, and Cholesky QR
+          for(std::size_t k=0; k<sb; k++)
+            for(std::size_t l=0; l<sb; l++)
+              for(int c=0; c<=i; c++)
+                G[k][l] -= Impl::conjugate(C[c][k])*C[c][l];
+          const std::size_t sr = Impl::gramCholesky(G,sb,L,tolerance);
+          if(sr == 0)
+            DUNE_THROW(SolverAbort,
+                       "breakdown in s-step GMRes - no independent basis vector after " << j << " iterations");
+          for(std::size_t l=0; l<sr; l++) {
+            X& vl = v[i+1+l];
+            for(int c=0; c<=i; c++)
+              vl.axpy(-C[c][l],v[c]);
+            for(std::size_t k=0; k<l; k++)
+              vl.axpy(-Impl::conjugate(L[l][k]),v[i+1+k]);
+            vl *= real_type(1.0)/Impl::realPart(L[l][l]);
+          }
+
+          // k_0 = v[i] and k_l = sum_c coefficients[l][c] v[c]
+          for(std::size_t l=0; l<=sr; l++)
+            std::fill(coefficients[l].begin(), coefficients[l].end(), field_type(0.0));
+          coefficients[0][i] = 1.0;
+          for(std::size_t l=1; l<=sr; l++) {
+            for(int c=0; c<=i; c++)
+              coefficients[l][c] = C[c][l-1];
+            for(std::size_t k=0; k<l; k++)
+              coefficients[l][i+1+k] = Impl::conjugate(L[l-1][k]);
+          }
+
+          for(std::size_t l=0; l<sr && j <= _maxit && res.converged != true; l++, i++, j++) {
+            // B k_l = sigma_l k_{l+1} + theta_l k_l + rho_l k_{l-1}, and
+            // B k_l = sum_{c<i} coefficients[l][c] B v[c] + coefficients[l][i] B v[i]
+            for(int r=0; r<=i+1; r++) {
+              column[r] = basis.sigma(l)*coefficients[l+1][r] + basis.theta(l)*coefficients[l][r];
+              if(l > 0)
+                column[r] += basis.rho(l)*coefficients[l-1][r];
+            }
+            for(int c=0; c<i; c++)
+              for(int r=0; r<=c+1; r++)
+                column[r] -= coefficients[l][c]*Hraw[r][c];
+            for(int r=0; r<=i+1; r++)
+              H[r][i] = Hraw[r][i] = column[r]/coefficients[l][i];
+
+            // update QR factorization
+            for(int k=0; k<i; k++)
+              this->applyPlaneRotation(H[k][i],H[k+1][i],cs[k],sn[k]);
+            // compute new givens rotation
+            this->generatePlaneRotation(H[i][i],H[i+1][i],cs[i],sn[i]);
+            // finish updating QR factorization
+            this->applyPlaneRotation(H[i][i],H[i+1][i],cs[i],sn[i]);
+            this->applyPlaneRotation(s[i],s[i+1],cs[i],sn[i]);
+
+            // norm of the defect is the last component the vector s
+            norm = abs(s[i+1]);
+            iteration.step(j, norm);
+          }
+          basis = nextBasis;
+        }
+
+        // calculate update vector
+        w = 0.0;
+        this->update(w,i,H,s,v);
+        // and current iterate
+        x += w;
+
+        // restart GMRes if convergence was not achieved,
+        // i.e. linear defect has not reached desired reduction
+        // and if j < _maxit (do not restart on last iteration)
+        if( res.converged != true && j < _maxit ) {
+
+          if(_verbose > 0)
+            std::cout << "=== GMRes::restart" << std::endl;
+          // get saved rhs
+          b = b2;
+          // calculate new defect
+          _op->applyscaleadd(-1.0,x,b); // b -= Ax;
+          // calculate preconditioned defect
+          v[0] = 0.0;
+          _prec->apply(v[0],b);
+          norm = _sp->norm(v[0]);
+        }
+
+      } //end while
+
+      // postprocess preconditioner
+      _prec->post(x);
+    }
+
+  private:
+    static int checkSteps (int steps)
+    {
+      if (steps < 1)
+        DUNE_THROW(ISTLError, "s-step GMRes needs at least one step per block, got " << steps);
+      return steps;
+    }
+
+  protected:
+    using Base::_op;
+    using Base::_prec;
+    using Base::_sp;
+    using Base::_maxit;
+    using Base::_verbose;
+    using Base::_restart;
+    using Iteration = typename Base::Iteration;
+    int _steps = 4;
+  };
+  DUNE_REGISTER_ITERATIVE_SOLVER("sstepgmressolver", defaultIterativeSolverCreator<Dune::SStepGMResSolver>());
+
   /**
      \brief implements the Flexible Generalized Minimal Residual (FGMRes) method (right preconditioned)
 
@@ -0,0 +1,146 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+/** \file \brief Tests repeated assembly into a BCRSMatrix with an AssemblyPattern.
+ */
+
+#include <array>
+#include <cmath>
+#include <vector>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/test/testsuite.hh>
+
+#include <dune/istl/assemblypattern.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/matrixindexset.hh>
+
+// The elements of a structured grid of N x N quadrilaterals with bilinear elements
+std::vector<std::array<std::size_t,4>> gridElements(std::size_t N)
+{
+  std::vector<std::array<std::size_t,4>> elements;
+  for (std::size_t i=0; i<N; ++i)
+    for (std::size_t j=0; j<N; ++j)
+    {
+      std::size_t v = i*(N+1) + j;
+      elements.push_back({v, v+1, v+N+1, v+N+2});
+    }
+  return elements;
+}
+
+// A nonsymmetric local matrix depending on the element and the time step
+template<class Block>
+std::array<std::array<Block,4>,4> localMatrix(std::size_t e, int step)
+{
+  std::array<std::array<Block,4>,4> local;
+  for (std::size_t i=0; i<4; ++i)
+    for (std::size_t j=0; j<4; ++j)
+    {
+      local[i][j] = 0.0;
+      for (int k=0; k<Block::rows; ++k)
+        for (int l=0; l<Block::cols; ++l)
+          local[i][j][k][l] = std::sin(1.0 + e + 4*i + j + 0.5*k + 0.25*l + step);
+    }
+  return local;
+}
+
+template<class Block>
+void testAssemblyPattern(Dune::TestSuite& t, std::size_t N)
+{
+  using Matrix = Dune::BCRSMatrix<Block>;
+  auto elements = gridElements(N);
+  const std::size_t n = (N+1)*(N+1);
+
+  Dune::MatrixIndexSet indexSet(n, n);
+  for (const auto& dofs : elements)
+    for (auto row : dofs)
+      for (auto col : dofs)
+        indexSet.add(row, col);
+
+  Matrix A, reference;
+  indexSet.exportIdx(A);
+  indexSet.exportIdx(reference);
+
+  Dune::AssemblyPattern<Matrix> pattern(A);
+  for (const auto& dofs : elements)
+    pattern.addElement(A, dofs);
+  t.check(pattern.size() == elements.size());
+  t.check(pattern.rows(0) == 4 && pattern.cols(0) == 4);
+
+  for (int step = 0; step < 3; ++step)
+  {
+    A = 0.0;
+    reference = 0.0;
+    for (std::size_t e=0; e<elements.size(); ++e)
+    {
+      auto local = localMatrix<Block>(e, step);
+      pattern.scatterAdd(A, e, local);
+      for (std::size_t i=0; i<4; ++i)
+        for (std::size_t j=0; j<4; ++j)
+          reference[elements[e][i]][elements[e][j]] += local[i][j];
+    }
+
+    // the same summation order, hence the results agree exactly
+    reference -= A;
+    t.check(reference.infinity_norm() == 0.0)
+      << "assembly with pattern differs in step " << step;
+  }
+
+  // the pattern can be used with a copy of the matrix
+  Matrix B(A);
+  B = 0.0;
+  pattern.scatterAdd(B, 0, localMatrix<Block>(0, 0));
+  t.check(B[elements[0][1]][elements[0][2]] == localMatrix<Block>(0, 0)[1][2]);
+
+  // a pattern with the same sizes but a different column is detected by matches()
+  t.check(pattern.matches(B));
+  Dune::MatrixIndexSet shifted(n, n);
+  for (const auto& dofs : elements)
+    for (auto row : dofs)
+      for (auto col : dofs)
+        if (row != 0 || col != 1)
+          shifted.add(row, col);
+  shifted.add(0, n-1);
+  Matrix C;
+  shifted.exportIdx(C);
+  t.require(C.nonzeroes() == A.nonzeroes());
+  t.check(!pattern.matches(C)) << "a different pattern with the same sizes was not detected";
+
+  // rectangular element blocks
+  Dune::AssemblyPattern<Matrix> couplingPattern(A);
+  std::array<std::size_t,2> rows{elements[0][0], elements[0][3]};
+  std::array<std::size_t,1> cols{elements[0][1]};
+  auto e = couplingPattern.addElement(A, rows, cols);
+  t.check(couplingPattern.rows(e) == 2 && couplingPattern.cols(e) == 1);
+
+  // entries outside of the sparsity pattern are rejected
+  std::array<std::size_t,2> notCoupled{0, n-1};
+  t.checkThrow<Dune::BCRSMatrixError>([&]{ pattern.addElement(A, notCoupled); })
+    << "entry outside of the pattern was not detected";
+
+  // a rejected element leaves no entries behind, the next element is still scattered correctly
+  std::array<std::size_t,2> partlyCoupled{elements[0][0], n-1};
+  const std::size_t size = pattern.size();
+  t.checkThrow<Dune::BCRSMatrixError>([&]{ pattern.addElement(A, partlyCoupled); });
+  t.require(pattern.size() == size);
+  e = pattern.addElement(A, elements[0]);
+  t.check(pattern.rows(e) == 4 && pattern.cols(e) == 4);
+  B = 0.0;
+  pattern.scatterAdd(B, e, localMatrix<Block>(0, 0));
+  for (std::size_t i=0; i<4; ++i)
+    for (std::size_t j=0; j<4; ++j)
+      t.check(B[elements[0][i]][elements[0][j]] == localMatrix<Block>(0, 0)[i][j])
+        << "wrong entry (" << i << "," << j << ") after a rejected element";
+}
+
+int main()
+{
+  Dune::TestSuite t;
+
+  testAssemblyPattern<Dune::FieldMatrix<double,1,1>>(t, 8);
+  testAssemblyPattern<Dune::FieldMatrix<double,2,2>>(t, 5);
+
+  return t.exit();
+}
@@ -0,0 +1,130 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+/** \file \brief Tests the batched LU decomposition and the overlapping Schwarz subdomain solver based on it.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include <dune/common/dynmatrix.hh>
+#include <dune/common/dynvector.hh>
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/test/testsuite.hh>
+
+#include <dune/istl/batchedlu.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/overlappingschwarz.hh>
+#include <dune/istl/common/threadpool.hh>
+
+#include "laplacian.hh"
+
+// matrices of different sizes, some of them needing pivoting, are solved accurately
+void testBatchedLU(Dune::TestSuite& t, std::size_t threads)
+{
+  Dune::ThreadPool::instance().setNumThreads(threads);
+
+  std::vector<std::size_t> sizes;
+  for (std::size_t m=0; m<37; ++m)
+    sizes.push_back(m%3 == 0 ? 5 : (m%3 == 1 ? 20 : 1));
+
+  Dune::BatchedLU<double> batch;
+  batch.resize(sizes);
+  std::vector<Dune::DynamicMatrix<double> > matrices;
+  for (std::size_t m=0; m<sizes.size(); ++m)
+  {
+    const std::size_t n = sizes[m];
+    Dune::DynamicMatrix<double> A(n, n);
+    for (std::size_t i=0; i<n; ++i)
+      for (std::size_t j=0; j<n; ++j)
+        A[i][j] = (i == (j+1)%n ? 2.0 : 0.0) + std::sin(1.0 + m + 0.7*i + 0.3*j*j);
+    for (std::size_t i=0; i<n; ++i)
+      for (std::size_t j=0; j<n; ++j)
+        batch.entry(m, i, j) = A[i][j];
+    matrices.push_back(A);
+  }
+  t.check(batch.size() == sizes.size());
+  batch.decompose();
+
+  for (std::size_t m=0; m<sizes.size(); ++m)
+  {
+    const std::size_t n = sizes[m];
+    t.check(batch.size(m) == n);
+    Dune::DynamicVector<double> b(n), x(n);
+    for (std::size_t i=0; i<n; ++i)
+      b[i] = std::cos(0.5*i + m);
+    batch.solve(m, x, b);
+    matrices[m].mmv(x, b);
+    t.check(b.infinity_norm() < 1e-10)
+      << "inaccurate solution for matrix " << m << " of size " << n << " with " << threads << " threads";
+  }
+
+  // a singular matrix is detected
+  Dune::BatchedLU<double> singular;
+  singular.resize({3, 2});
+  singular.entry(1, 0, 0) = singular.entry(1, 1, 1) = 1.0;
+  t.checkThrow<Dune::FMatrixError>([&]{ singular.decompose(); }) << "singular matrix not detected";
+
+  Dune::ThreadPool::instance().setNumThreads(1);
+}
+
+// the Schwarz method with the batched subdomain solver agrees with the DynamicMatrix subdomain solver
+template<class Mode>
+void testSchwarz(Dune::TestSuite& t)
+{
+  using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double,2,2>>;
+  using Vector = Dune::BlockVector<Dune::FieldVector<double,2>>;
+  using Dynamic = Dune::SeqOverlappingSchwarz<Matrix,Vector,Mode,
+    Dune::DynamicMatrixSubdomainSolver<Matrix,Vector,Vector>>;
+  using Batched = Dune::SeqOverlappingSchwarz<Matrix,Vector,Mode,
+    Dune::BatchedLUSubdomainSolver<Matrix,Vector,Vector>>;
+
+  const int N = 12;
+  Matrix A;
+  setupLaplacian(A, N);
+
+  // overlapping vertex patches of varying sizes
+  typename Dynamic::subdomain_vector domains(N*N/4);
+  for (int j=0; j<N; ++j)
+    for (int i=0; i<N; ++i)
+      for (int d=std::max(0, (j*N+i-3)/4); d<=std::min(N*N/4-1, (j*N+i+1)/4); ++d)
+        domains[d].insert(j*N+i);
+
+  Vector d(A.N());
+  for (std::size_t i=0; i<d.N(); ++i)
+    d[i] = std::sin(0.1*i);
+
+  Vector reference(A.N());
+  reference = 0;
+  Dynamic dynamic(A, domains, 1.0, true);
+  dynamic.apply(reference, d);
+
+  for (bool onTheFly : {true, false})
+  {
+    Vector v(A.N());
+    v = 0;
+    Batched batched(A, domains, 1.0, onTheFly);
+    batched.apply(v, d);
+    v -= reference;
+    t.check(v.infinity_norm() < 1e-12*reference.infinity_norm())
+      << "batched subdomain solver differs, on the fly: " << onTheFly;
+  }
+}
+
+int main()
+{
+  Dune::TestSuite t;
+
+  testBatchedLU(t, 1);
+  testBatchedLU(t, 4);
+  testSchwarz<Dune::AdditiveSchwarzMode>(t);
+  testSchwarz<Dune::MultiplicativeSchwarzMode>(t);
+
+  return t.exit();
+}
@@ -9,6 +9,11 @@
 #include <dune/common/fmatrix.hh>
 #include <dune/common/exceptions.hh>
 #include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/common/threadpool.hh>
+
+#include <iterator>
+#include <thread>
+#include <vector>
 
 typedef Dune::BCRSMatrix<Dune::FieldMatrix<double,1,1> > ScalarMatrix;
 
@@ -340,6 +345,73 @@ void testImplicitMatrixBuilderExtendedConstructor()
   setMatrix(m);
 }
 
+void testConcurrentImplicitMatrixBuilder()
+{
+  ScalarMatrix m;
+  Dune::ConcurrentImplicitMatrixBuilder<ScalarMatrix> b(m,10,10,3,0.1);
+  setMatrix(b);
+  ScalarMatrix::CompressionStatistics stats = b.compress();
+  assert(m.buildStage() == ScalarMatrix::built);
+  assert(Dune::FloatCmp::eq(stats.avg,33.0/10.0));
+  assert(stats.maximum == 4);
+  assert(stats.overflow_total == 4);
+  setMatrix(m);
+
+  ScalarMatrix reference(10,10,3,0.1,ScalarMatrix::implicit);
+  buildMatrix(reference);
+  reference.compress();
+  for (auto row = reference.begin(); row != reference.end(); ++row)
+  {
+    assert(m[row.index()].size() == row->size());
+    for (auto col = row->begin(); col != row->end(); ++col)
+      assert(m.exists(row.index(), col.index()));
+  }
+}
+
+void testConcurrentImplicitMatrixBuilderThreaded()
+{
+  const int N = 2000;
+  const int threads = 4;
+
+  // all threads insert overlapping parts of a pentadiagonal pattern,
+  // some of them too wide for the slots to force overflow entries
+  ScalarMatrix m;
+  Dune::ConcurrentImplicitMatrixBuilder<ScalarMatrix> b(m,N,N,3,0.5);
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t)
+    workers.emplace_back([&b,t,N]{
+      for (int i = t; i < N + t; ++i)
+      {
+        int row = i % N;
+        for (int offset : {0, 1, -1, 2, -2})
+          if (row+offset >= 0 && row+offset < N && (offset*offset < 4 || row % 3 == 0))
+            b.entry(row, row+offset);
+      }
+    });
+  for (auto& worker : workers)
+    worker.join();
+
+  Dune::ThreadPool::instance().setNumThreads(threads);
+  b.compress();
+  Dune::ThreadPool::instance().setNumThreads(1);
+
+  for (int row = 0; row < N; ++row)
+  {
+    std::size_t expected = 0;
+    for (int offset : {0, 1, -1, 2, -2})
+      if (row+offset >= 0 && row+offset < N && (offset*offset < 4 || row % 3 == 0))
+      {
+        assert(m.exists(row, row+offset));
+        ++expected;
+      }
+    assert(m[row].size() == expected);
+    // columns have to be sorted
+    auto col = m[row].begin();
+    for (auto next = std::next(col); next != m[row].end(); ++col, ++next)
+      assert(col.index() < next.index());
+  }
+}
+
 int main()
 {
   int ret=0;
@@ -362,6 +434,8 @@ int main()
     ret+=testConstBracketOperatorBeforeCompress();
     testImplicitMatrixBuilder();
     testImplicitMatrixBuilderExtendedConstructor();
+    testConcurrentImplicitMatrixBuilder();
+    testConcurrentImplicitMatrixBuilderThreaded();
     testZeroSizeImplicitBuild();
   }catch(Dune::Exception& e) {
     std::cerr << e <<std::endl;
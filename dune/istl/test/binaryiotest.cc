@@ -0,0 +1,164 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+/** \file \brief Tests storing and loading matrices and vectors in the binary format.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/common/test/testsuite.hh>
+
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/binaryio.hh>
+#include <dune/istl/bvector.hh>
+
+#include "laplacian.hh"
+
+template<class Matrix>
+void testMatrix(Dune::TestSuite& t, const std::string& fileName)
+{
+  Matrix A;
+  setupLaplacian(A, 10);
+  // distinguish the entries of the blocks
+  for (auto row = A.begin(); row != A.end(); ++row)
+    for (auto entry = row->begin(); entry != row->end(); ++entry)
+      *entry *= 1.0 + row.index() + 0.5*entry.index();
+
+  Dune::storeBinary(A, fileName);
+
+  Matrix B;
+  Dune::loadBinary(B, fileName);
+  t.check(B.N() == A.N() && B.M() == A.M() && B.nonzeroes() == A.nonzeroes());
+  for (auto row = A.begin(); row != A.end(); ++row)
+    for (auto entry = row->begin(); entry != row->end(); ++entry)
+      t.check(B.exists(row.index(), entry.index()) && B[row.index()][entry.index()] == *entry)
+        << "entry (" << row.index() << "," << entry.index() << ") differs";
+
+  // the compressed row storage is available without copying
+  Dune::BinaryFile file(fileName);
+  t.check(file.isMatrix() && file.N() == A.N() && file.nonzeroes() == A.nonzeroes());
+  t.check(file.rowPointers()[0] == 0 && file.rowPointers()[A.N()] == A.nonzeroes());
+  std::size_t k = 0;
+  for (auto entry = A[0].begin(); entry != A[0].end(); ++entry, ++k)
+    t.check(file.columnIndices()[k] == entry.index());
+  t.check(file.rowPointers()[1] == k);
+  t.check(file.values<typename Matrix::block_type>() != nullptr);
+
+  // blocks of a different type are rejected
+  Dune::BCRSMatrix<Dune::FieldMatrix<float,1,1> > C;
+  t.checkThrow<Dune::BinaryFormatError>([&]{ Dune::readBinary(C, file); }) << "field type not checked";
+  Dune::BCRSMatrix<Dune::FieldMatrix<double,3,3> > D;
+  t.checkThrow<Dune::BinaryFormatError>([&]{ Dune::readBinary(D, file); }) << "block size not checked";
+  Dune::BlockVector<Dune::FieldVector<double,1> > v;
+  t.checkThrow<Dune::BinaryFormatError>([&]{ Dune::readBinary(v, file); }) << "matrix read as vector";
+
+  std::remove(fileName.c_str());
+}
+
+template<class Vector>
+void testVector(Dune::TestSuite& t, const std::string& fileName)
+{
+  Vector x(100);
+  for (std::size_t i=0; i<x.N(); ++i)
+    x[i] = 0.25*i;
+  Dune::storeBinary(x, fileName);
+
+  Vector y;
+  Dune::loadBinary(y, fileName);
+  t.check(y.N() == x.N());
+  for (std::size_t i=0; i<x.N(); ++i)
+    t.check(y[i] == x[i]) << "block " << i << " differs";
+
+  // a view of the mapped file
+  Dune::BinaryFile file(fileName);
+  Dune::BinaryVectorView<typename Vector::block_type> view = file.template vector<typename Vector::block_type>();
+  t.check(view.N() == x.N());
+  for (std::size_t i=0; i<x.N(); ++i)
+    t.check(view[i] == x[i]) << "block " << i << " of the view differs";
+
+  // changes of the view do not reach the file
+  view[0] = 42.0;
+  Vector z;
+  Dune::loadBinary(z, fileName);
+  t.check(z[0] == x[0]);
+
+  std::remove(fileName.c_str());
+}
+
+// Overwrite the entry at offset of a stored file
+void corrupt(const std::string& fileName, std::uint64_t offset, std::uint64_t value)
+{
+  std::fstream file(fileName, std::ios::binary | std::ios::in | std::ios::out);
+  file.seekp(offset);
+  file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void testCorruptMatrix(Dune::TestSuite& t)
+{
+  typedef Dune::BCRSMatrix<Dune::FieldMatrix<double,1,1> > Matrix;
+  const std::string fileName = "binaryiotest_corrupt.bin";
+  Matrix A;
+  setupLaplacian(A, 4);
+
+  Dune::storeBinary(A, fileName);
+  const Dune::BinaryIOImpl::Layout layout(Dune::BinaryFile(fileName).header());
+  const std::uint64_t rowPointer = sizeof(std::uint64_t);
+
+  auto check = [&](std::uint64_t offset, std::uint64_t value, const char* message) {
+    Dune::storeBinary(A, fileName);
+    corrupt(fileName, offset, value);
+    Dune::BinaryFile file(fileName);
+    Matrix B;
+    t.checkThrow<Dune::BinaryFormatError>([&]{ Dune::readBinary(B, file); }) << message;
+  };
+  check(layout.rowPointers, 1, "first row pointer not checked");
+  check(layout.rowPointers + 2*rowPointer, 0, "decreasing row pointers not checked");
+  check(layout.rowPointers + A.N()*rowPointer, A.nonzeroes()-1, "last row pointer not checked");
+  check(layout.columnIndices + rowPointer, A.M(), "column indices not checked");
+  // the first row holds the columns 0, 1 and 4
+  check(layout.columnIndices + rowPointer, 0, "duplicate column indices not checked");
+  check(layout.columnIndices + 2*rowPointer, 0, "unsorted column indices not checked");
+
+  std::remove(fileName.c_str());
+}
+
+void testInvalidFile(Dune::TestSuite& t)
+{
+  const std::string fileName = "binaryiotest_invalid.bin";
+  {
+    std::ofstream file(fileName);
+    file << "%%MatrixMarket matrix coordinate real general\n";
+  }
+  t.checkThrow<Dune::BinaryFormatError>([&]{ Dune::BinaryFile file(fileName); });
+  std::remove(fileName.c_str());
+
+  t.checkThrow<Dune::IOError>([]{ Dune::BinaryFile file("binaryiotest_missing.bin"); });
+}
+
+int main(int argc, char** argv)
+{
+  Dune::MPIHelper::instance(argc, argv);
+  Dune::TestSuite t;
+
+  testMatrix<Dune::BCRSMatrix<double> >(t, "binaryiotest_scalar.bin");
+  testMatrix<Dune::BCRSMatrix<Dune::FieldMatrix<double,1,1> > >(t, "binaryiotest_fm1.bin");
+  testMatrix<Dune::BCRSMatrix<Dune::FieldMatrix<double,2,2> > >(t, "binaryiotest_fm2.bin");
+  testMatrix<Dune::BCRSMatrix<Dune::FieldMatrix<float,2,3> > >(t, "binaryiotest_fm23.bin");
+
+  testVector<Dune::BlockVector<double> >(t, "binaryiotest_vscalar.bin");
+  testVector<Dune::BlockVector<Dune::FieldVector<double,1> > >(t, "binaryiotest_v1.bin");
+  testVector<Dune::BlockVector<Dune::FieldVector<double,3> > >(t, "binaryiotest_v3.bin");
+
+  testCorruptMatrix(t);
+  testInvalidFile(t);
+
+  return t.exit();
+}
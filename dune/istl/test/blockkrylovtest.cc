@@ -0,0 +1,189 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+/** \file \brief Compares the block CG and GMRes solvers with solving for each right hand side independently.
+ */
+
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/common/simd/loop.hh>
+#include <dune/common/test/testsuite.hh>
+
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/blockkrylov.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/preconditioners.hh>
+#include <dune/istl/scalarproducts.hh>
+#include <dune/istl/solvers.hh>
+#include <dune/istl/paamg/pinfo.hh>
+
+#include "laplacian.hh"
+
+using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double,1,1>>;
+
+// right hand sides in the lanes, optionally with a repeated and a vanishing one
+template<class Vector>
+Vector rightHandSide(std::size_t n, bool dependent)
+{
+  constexpr std::size_t k = Dune::Simd::lanes<typename Vector::field_type>();
+  Vector b(n);
+  for (std::size_t i=0; i<n; ++i)
+    for (std::size_t a=0; a<k; ++a)
+      Dune::Simd::lane(a, b[i][0]) = std::sin(0.1*(a+1)*i) + 0.01*a;
+  if (dependent)
+    for (std::size_t i=0; i<n; ++i)
+    {
+      Dune::Simd::lane(2, b[i][0]) = Dune::Simd::lane(0, b[i][0]);
+      Dune::Simd::lane(3, b[i][0]) = 0.0;
+    }
+  return b;
+}
+
+template<class Solver, class Vector>
+Dune::InverseOperatorResult solve(Solver& solver, const Matrix& A, Vector& x, bool dependent)
+{
+  Vector b = rightHandSide<Vector>(A.N(), dependent);
+  x = 0;
+  Dune::InverseOperatorResult res;
+  solver.apply(x, b, res);
+  return res;
+}
+
+// check the defect of each right hand side
+template<class Vector>
+void checkResidual(Dune::TestSuite& t, const Matrix& A, const Vector& x, bool dependent, const std::string& name)
+{
+  constexpr std::size_t k = Dune::Simd::lanes<typename Vector::field_type>();
+  Vector r = rightHandSide<Vector>(A.N(), dependent);
+  Vector b(r);
+  A.mmv(x, r);
+  for (std::size_t a=0; a<k; ++a)
+  {
+    double norm = 0.0, norm0 = 0.0;
+    for (std::size_t i=0; i<r.N(); ++i)
+    {
+      norm += std::pow(Dune::Simd::lane(a, r[i][0]), 2);
+      norm0 += std::pow(Dune::Simd::lane(a, b[i][0]), 2);
+    }
+    t.check(std::sqrt(norm) <= 1e-8*std::sqrt(norm0))
+      << name << " solution for right hand side " << a << " is not accurate";
+  }
+}
+
+template<std::size_t k>
+void testSolvers(Dune::TestSuite& t, bool parallel, bool dependent)
+{
+  using Vector = Dune::BlockVector<Dune::FieldVector<Dune::LoopSIMD<double,k>,1>>;
+  using Operator = Dune::MatrixAdapter<Matrix,Vector,Vector>;
+
+  Matrix A;
+  setupLaplacian(A, 20);
+  auto op = std::make_shared<Operator>(A);
+  auto prec = std::make_shared<Dune::SeqSSOR<Matrix,Vector,Vector>>(A, 1, 1.0);
+  Dune::Amg::SequentialInformation info;
+  std::shared_ptr<const Dune::ScalarProduct<Vector>> sp;
+  if (parallel)
+    sp = std::make_shared<Dune::ParallelScalarProduct<Vector,Dune::Amg::SequentialInformation>>(info, Dune::SolverCategory::sequential);
+  else
+    sp = std::make_shared<Dune::SeqScalarProduct<Vector>>();
+
+  Vector x(A.N()), xRef(A.N());
+
+  // the lanes of the reference solvers are independent systems, which they cannot solve
+  // for a vanishing right hand side
+  {
+    Dune::CGSolver<Vector> cg(op, sp, prec, 1e-10, 500, 0);
+    Dune::BlockCGSolver<Vector> bcg(op, sp, prec, 1e-10, 500, 0);
+    auto res = solve(bcg, A, x, dependent);
+    t.check(res.converged) << "block CG did not converge";
+    if (!dependent)
+    {
+      auto resRef = solve(cg, A, xRef, dependent);
+      t.check(res.iterations <= resRef.iterations)
+        << "block CG needed " << res.iterations << " iterations, CG " << resRef.iterations;
+    }
+    checkResidual(t, A, x, dependent, "block CG");
+  }
+  {
+    Dune::RestartedGMResSolver<Vector> gmres(op, sp, prec, 1e-10, 30, 500, 0);
+    Dune::BlockGMResSolver<Vector> bgmres(op, sp, prec, 1e-10, 30, 500, 0);
+    auto res = solve(bgmres, A, x, dependent);
+    t.check(res.converged) << "block GMRes did not converge";
+    if (!dependent)
+    {
+      auto resRef = solve(gmres, A, xRef, dependent);
+      t.check(res.iterations <= resRef.iterations)
+        << "block GMRes needed " << res.iterations << " iterations, GMRes " << resRef.iterations;
+    }
+    checkResidual(t, A, x, dependent, "block GMRes");
+  }
+}
+
+// the lane-wise dot products of the LaneBlock helper
+template<std::size_t k>
+void testProducts(Dune::TestSuite& t)
+{
+  using Vector = Dune::BlockVector<Dune::FieldVector<Dune::LoopSIMD<double,k>,1>>;
+  using Block = Dune::Impl::LaneBlock<Vector>;
+
+  Vector x = rightHandSide<Vector>(50, false);
+  Vector y(x);
+  for (std::size_t i=0; i<y.N(); ++i)
+    y[i] *= 1.0 + i;
+
+  Dune::Amg::SequentialInformation info;
+  Dune::SeqScalarProduct<Vector> seq;
+  Dune::ParallelScalarProduct<Vector,Dune::Amg::SequentialInformation> par(info, Dune::SolverCategory::sequential);
+  Block seqBlock(seq), parBlock(par);
+  std::vector<typename Block::Matrix> seqGram, parGram;
+  std::vector<typename Vector::field_type> seqNorms, parNorms;
+  seqBlock.products({&x}, {&y}, {&x}, seqGram, seqNorms);
+  parBlock.products({&x}, {&y}, {&x}, parGram, parNorms);
+
+  for (std::size_t a=0; a<k; ++a)
+  {
+    double norm2 = 0.0;
+    for (std::size_t i=0; i<x.N(); ++i)
+      norm2 += std::pow(Dune::Simd::lane(a, x[i][0]), 2);
+    t.check(std::abs(Dune::Simd::lane(a, seqNorms[0]) - norm2) <= 1e-12*norm2);
+    t.check(std::abs(Dune::Simd::lane(a, parNorms[0]) - norm2) <= 1e-12*norm2);
+    for (std::size_t b=0; b<k; ++b)
+    {
+      double dot = 0.0;
+      for (std::size_t i=0; i<x.N(); ++i)
+        dot += Dune::Simd::lane(a, x[i][0])*Dune::Simd::lane(b, y[i][0]);
+      t.check(std::abs(seqGram[0][a][b] - dot) <= 1e-12*(1.0 + std::abs(dot)))
+        << "wrong sequential lane product (" << a << ", " << b << ")";
+      t.check(std::abs(parGram[0][a][b] - dot) <= 1e-12*(1.0 + std::abs(dot)))
+        << "wrong parallel lane product (" << a << ", " << b << ")";
+    }
+  }
+}
+
+int main(int argc, char** argv)
+{
+  Dune::MPIHelper::instance(argc, argv);
+  Dune::TestSuite t;
+
+  testProducts<4>(t);
+
+  for (bool parallel : {false, true})
+  {
+    testSolvers<4>(t, parallel, false);
+    testSolvers<8>(t, parallel, false);
+    // deflation of a repeated and a vanishing right hand side
+    testSolvers<4>(t, parallel, true);
+  }
+
+  return t.exit();
+}
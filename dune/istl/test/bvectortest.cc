@@ -15,6 +15,7 @@
 #include <cstdlib>
 #include <iostream>
 #include <memory>
+#include <vector>
 
 #include <dune/common/classname.hh>
 #include <dune/common/debugallocator.hh>
@@ -96,6 +97,58 @@ int testVector()
   return 0;
 }
 
+template<class VectorBlock>
+void testFusedOperations()
+{
+  typedef Dune::BlockVector<VectorBlock> Vector;
+  typedef typename Vector::field_type field_type;
+
+  Vector x(17), y(17), z(17);
+  for(typename Vector::size_type i=0; i < x.N(); ++i) {
+    assign(x[i], std::sin(1.0+i));
+    assign(y[i], std::cos(2.0*i));
+    assign(z[i], 0.5+i);
+  }
+  const field_type a(-0.7), b(1.3);
+
+  // the fused operations have to give exactly the results of the separate ones
+  {
+    Vector u(x), w(x);
+    u *= b; u.axpy(a,y);
+    w.axpby(a,y,b);
+    for(typename Vector::size_type i=0; i < x.N(); ++i)
+      assert(u[i] == w[i]);
+  }
+  {
+    Vector u(x), w(x);
+    u.axpy(a,y);
+    auto dot = z.dot(u);
+    assert(w.axpy_dot(a,y,z) == dot);
+    for(typename Vector::size_type i=0; i < x.N(); ++i)
+      assert(u[i] == w[i]);
+  }
+  {
+    Vector u(x), w(x);
+    u.axpy(a,y);
+    auto norm2 = u.two_norm2();
+    assert(w.axpy_two_norm2(a,y) == norm2);
+    for(typename Vector::size_type i=0; i < x.N(); ++i)
+      assert(u[i] == w[i]);
+  }
+  {
+    // more than one group of four vectors
+    std::vector<Vector> vectors{x, y, z, x, y, z};
+    vectors[3] *= 2.0;
+    std::vector<const Vector*> ptr;
+    for (const auto& v : vectors)
+      ptr.push_back(&v);
+    std::vector<field_type> dots(ptr.size());
+    x.multi_dot(ptr.data(), ptr.size(), dots.data());
+    for(std::size_t k=0; k < ptr.size(); ++k)
+      assert(dots[k] == x.dot(vectors[k]));
+  }
+}
+
 void testCapacity()
 {
   typedef Dune::FieldVector<double,2> SmallVector;
@@ -231,5 +284,10 @@ int main()
 
   testCapacity();
 
+  testFusedOperations<double>();
+  testFusedOperations<std::complex<double> >();
+  testFusedOperations<Dune::FieldVector<double,3> >();
+  testFusedOperations<Dune::FieldVector<std::complex<double>,2> >();
+
   return ret;
 }
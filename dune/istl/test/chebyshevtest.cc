@@ -0,0 +1,106 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+/** \file \brief Tests the Chebyshev preconditioner and smoother.
+ */
+
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/common/parametertree.hh>
+#include <dune/common/test/testsuite.hh>
+
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/preconditioners.hh>
+
+#include "laplacian.hh"
+#include "smoothertest.hh"
+
+using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double,1,1>>;
+using Vector = Dune::BlockVector<Dune::FieldVector<double,1>>;
+using Operator = Dune::MatrixAdapter<Matrix,Vector,Vector>;
+
+// the eigenvalues of tridiag(-1,2,-1) are 2 - 2cos(k pi/(m+1))
+void testTridiagonal(Dune::TestSuite& t)
+{
+  const std::size_t m = 10;
+  std::vector<double> a(m, 2.0), b(m, -1.0);
+  const double lambdaMax = Dune::Impl::tridiagonalMaxEigenvalue(a, b);
+  t.check(std::abs(lambdaMax - 2.0 - 2.0*std::cos(M_PI/(m+1))) < 1e-12)
+    << "wrong largest eigenvalue " << lambdaMax << " of the tridiagonal matrix";
+}
+
+void testPreconditioner(Dune::TestSuite& t, int N)
+{
+  Matrix A;
+  setupLaplacian(A, N);
+
+  // the largest eigenvalue of the Jacobi preconditioned Laplacian is 1 + cos(pi/(N+1))
+  Dune::SeqChebyshev<Matrix,Vector,Vector> chebyshev(A, 4, 1.0/100);
+  const double lambdaMax = 1.0 + std::cos(M_PI/(N+1));
+  t.check(chebyshev.maxEigenvalue() >= lambdaMax && chebyshev.maxEigenvalue() <= 1.1*lambdaMax)
+    << "eigenvalue bound " << chebyshev.maxEigenvalue() << " for the largest eigenvalue " << lambdaMax;
+
+  Dune::SeqJac<Matrix,Vector,Vector> jacobi(A, 1, 1.0);
+  const int iterations = cgIterations(A, chebyshev);
+  const int jacobiIterations = cgIterations(A, jacobi);
+  t.check(2*iterations <= jacobiIterations)
+    << "CG with Chebyshev needed " << iterations << " iterations, with Jacobi " << jacobiIterations;
+}
+
+void testSmoother(Dune::TestSuite& t, int N)
+{
+  Matrix A;
+  setupLaplacian(A, N);
+  Operator op(A);
+
+  auto ssorAmg = smoothedAMG<Dune::SeqSSOR<Matrix,Vector,Vector>>(op, 1);
+  auto chebyshevAmg = smoothedAMG<Dune::SeqChebyshev<Matrix,Vector,Vector>>(op, 2);
+
+  const int iterations = cgIterations(A, chebyshevAmg);
+  const int ssorIterations = cgIterations(A, ssorAmg);
+  t.check(iterations <= 2*ssorIterations)
+    << "AMG with Chebyshev smoothing needed " << iterations << " iterations, with SSOR " << ssorIterations;
+}
+
+void testFactory(Dune::TestSuite& t, int N)
+{
+  Matrix A;
+  setupLaplacian(A, N);
+  auto op = std::make_shared<Operator>(A);
+
+  for (std::string type : {"chebyshev", "amg"})
+  {
+    Dune::ParameterTree config;
+    config["type"] = "cgsolver";
+    config["preconditioner.type"] = type;
+    config["preconditioner.degree"] = "3";
+    config["preconditioner.smoother"] = "chebyshev";
+    config["preconditioner.smootherIterations"] = "2";
+    config["preconditioner.verbosity"] = "0";
+    t.check(factorySolve(op, config).converged) << "CG with " << type << " from the solver factory did not converge";
+  }
+}
+
+int main(int argc, char** argv)
+{
+  Dune::MPIHelper::instance(argc, argv);
+  Dune::TestSuite t;
+
+  testTridiagonal(t);
+  testPreconditioner(t, 50);
+  testSmoother(t, 100);
+  testFactory(t, 30);
+
+  return t.exit();
+}
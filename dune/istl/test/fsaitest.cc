@@ -0,0 +1,144 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+/** \file \brief Tests the factorized sparse approximate inverse preconditioner and smoother.
+ */
+
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/common/parametertree.hh>
+#include <dune/common/test/testsuite.hh>
+
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/matrixindexset.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/preconditioners.hh>
+#include <dune/istl/common/threadpool.hh>
+
+#include "laplacian.hh"
+#include "smoothertest.hh"
+
+// with the full lower triangular pattern the approximate inverse is exact
+template<class Block>
+void testExact(Dune::TestSuite& t)
+{
+  using Matrix = Dune::BCRSMatrix<Block>;
+  using Vector = Dune::BlockVector<Dune::FieldVector<double,Block::rows>>;
+
+  Matrix A;
+  setupLaplacian(A, 4);
+  Dune::MatrixIndexSet full(A.N(), A.N());
+  for (std::size_t i=0; i<A.N(); ++i)
+    for (std::size_t j=0; j<=i; ++j)
+      full.add(i, j);
+
+  Dune::SeqFSAI<Matrix,Vector,Vector> fsai(A, full);
+  Vector v(A.N()), d(A.N());
+  for (std::size_t i=0; i<d.N(); ++i)
+    d[i] = std::sin(0.3*i);
+  fsai.apply(v, d);
+  A.mmv(v, d);
+  t.check(d.two_norm() < 1e-12) << "FSAI with the full pattern is not exact";
+}
+
+void testPreconditioner(Dune::TestSuite& t)
+{
+  using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double,1,1>>;
+  using Vector = Dune::BlockVector<Dune::FieldVector<double,1>>;
+
+  Matrix A;
+  setupLaplacian(A, 40);
+
+  // the pattern of level 1 is the lower triangle of A, level 2 adds the neighbours of the neighbours
+  Dune::SeqFSAI<Matrix,Vector,Vector> fsai1(A, 1), fsai2(A, 2);
+  std::size_t lower = 0;
+  for (auto i=A.begin(); i!=A.end(); ++i)
+    for (auto j=i->begin(); j!=i->end() && j.index()<=i.index(); ++j)
+      ++lower;
+  t.check(fsai1.lowerFactor().nonzeroes() == lower) << "wrong pattern of level 1";
+  t.check(fsai2.lowerFactor().nonzeroes() > lower) << "wrong pattern of level 2";
+
+  Dune::SeqJac<Matrix,Vector,Vector> jacobi(A, 1, 1.0);
+  const int jacobiIterations = cgIterations(A, jacobi);
+  const int iterations1 = cgIterations(A, fsai1);
+  const int iterations2 = cgIterations(A, fsai2);
+  t.check(iterations1 < jacobiIterations && iterations2 < iterations1)
+    << "CG needed " << jacobiIterations << " iterations with Jacobi, "
+    << iterations1 << " with FSAI of level 1 and " << iterations2 << " with level 2";
+
+  // the setup and the application do not depend on the number of threads
+  Vector d(A.N()), v1(A.N()), v4(A.N());
+  for (std::size_t i=0; i<d.N(); ++i)
+    d[i] = std::sin(0.1*i);
+  fsai2.apply(v1, d);
+  Dune::ThreadPool::instance().setNumThreads(4);
+  Dune::SeqFSAI<Matrix,Vector,Vector> fsai4(A, 2);
+  fsai4.apply(v4, d);
+  Dune::ThreadPool::instance().setNumThreads(1);
+  v4 -= v1;
+  t.check(v4.infinity_norm() == 0.0) << "FSAI depends on the number of threads";
+}
+
+void testSmoother(Dune::TestSuite& t)
+{
+  using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double,1,1>>;
+  using Vector = Dune::BlockVector<Dune::FieldVector<double,1>>;
+  using Operator = Dune::MatrixAdapter<Matrix,Vector,Vector>;
+
+  Matrix A;
+  setupLaplacian(A, 100);
+  Operator op(A);
+
+  auto jacobiAmg = smoothedAMG<Dune::SeqJac<Matrix,Vector,Vector>>(op, 1);
+  auto fsaiAmg = smoothedAMG<Dune::SeqFSAI<Matrix,Vector,Vector>>(op, 1);
+
+  const int iterations = cgIterations(A, fsaiAmg);
+  const int jacobiIterations = cgIterations(A, jacobiAmg);
+  t.check(iterations <= jacobiIterations)
+    << "AMG with FSAI smoothing needed " << iterations << " iterations, with Jacobi " << jacobiIterations;
+}
+
+void testFactory(Dune::TestSuite& t)
+{
+  using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double,1,1>>;
+  using Vector = Dune::BlockVector<Dune::FieldVector<double,1>>;
+  using Operator = Dune::MatrixAdapter<Matrix,Vector,Vector>;
+
+  Matrix A;
+  setupLaplacian(A, 30);
+  auto op = std::make_shared<Operator>(A);
+
+  for (std::string type : {"fsai", "amg"})
+  {
+    Dune::ParameterTree config;
+    config["type"] = "cgsolver";
+    config["preconditioner.type"] = type;
+    config["preconditioner.level"] = "2";
+    config["preconditioner.smoother"] = "fsai";
+    config["preconditioner.verbosity"] = "0";
+    t.check(factorySolve(op, config).converged) << "CG with " << type << " from the solver factory did not converge";
+  }
+}
+
+int main(int argc, char** argv)
+{
+  Dune::MPIHelper::instance(argc, argv);
+  Dune::TestSuite t;
+
+  testExact<Dune::FieldMatrix<double,1,1>>(t);
+  testExact<Dune::FieldMatrix<double,2,2>>(t);
+  testPreconditioner(t);
+  testSmoother(t);
+  testFactory(t);
+
+  return t.exit();
+}
@@ -0,0 +1,184 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+/** \file \brief Tests the instrumentation of solves and its activation by the solver factory.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/common/parametertree.hh>
+#include <dune/common/test/testsuite.hh>
+
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/instrumented.hh>
+#include <dune/istl/matrixutils.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/preconditioners.hh>
+#include <dune/istl/solvers.hh>
+#include <dune/istl/common/instrumentation.hh>
+#include <dune/istl/paamg/amg.hh>
+
+#include "laplacian.hh"
+#include "smoothertest.hh"
+
+using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double,1,1>>;
+using Vector = Dune::BlockVector<Dune::FieldVector<double,1>>;
+using Operator = Dune::MatrixAdapter<Matrix,Vector,Vector>;
+using Node = Dune::Instrumentation::Node;
+
+void testScopes(Dune::TestSuite& t)
+{
+  Dune::Instrumentation instrumentation("root");
+
+  // scopes without an active instrumentation do nothing
+  {
+    Dune::Instrumentation::Scope scope("inactive", 1.0, 1.0);
+    t.check(!scope);
+  }
+  t.check(Dune::Instrumentation::active() == nullptr);
+
+  {
+    Dune::Instrumentation::Activation activation(instrumentation);
+    t.check(Dune::Instrumentation::active() == &instrumentation);
+    for (std::size_t i=0; i<2; ++i)
+    {
+      Dune::Instrumentation::Scope scope("a", 10.0, 8.0);
+      Dune::Instrumentation::Scope level("level", i);
+      level.addFlops(1.0);
+    }
+  }
+  t.check(Dune::Instrumentation::active() == nullptr);
+
+  const Node& root = instrumentation.root();
+  t.check(root.name == "root" && root.calls == 1);
+  t.check(root.find("inactive") == nullptr);
+  const Node* a = root.find("a");
+  t.require(a != nullptr) << "scope a not recorded";
+  t.check(a->calls == 2 && a->flops == 20.0 && a->bytes == 16.0);
+  t.check(a->children.size() == 2);
+  for (std::size_t i=0; i<2; ++i)
+  {
+    const Node* level = a->find("level " + std::to_string(i));
+    t.require(level != nullptr) << "scope level " << i << " not recorded";
+    t.check(level->calls == 1 && level->flops == 1.0);
+    t.check(level->time <= a->time);
+  }
+  t.check(a->time <= root.time);
+
+  const std::string json = instrumentation.json();
+  t.check(json.find("{\"name\": \"root\", \"calls\": 1,") == 0) << json;
+  t.check(json.find("\"name\": \"level 1\"") != std::string::npos) << json;
+
+  // JSON has no literals for nan and inf
+  std::ostringstream numbers;
+  Dune::Instrumentation::writeJSONNumber(numbers, std::numeric_limits<double>::quiet_NaN());
+  numbers << " ";
+  Dune::Instrumentation::writeJSONNumber(numbers, -std::numeric_limits<double>::infinity());
+  numbers << " ";
+  Dune::Instrumentation::writeJSONNumber(numbers, 0.5);
+  t.check(numbers.str() == "null null 0.5") << numbers.str();
+
+  instrumentation.reset();
+  t.check(instrumentation.root().name == "root");
+  t.check(instrumentation.root().calls == 0 && instrumentation.root().children.empty());
+}
+
+void testFactory(Dune::TestSuite& t)
+{
+  Matrix A;
+  setupLaplacian(A, 20);
+  auto op = std::make_shared<Operator>(A);
+
+  const std::string fileName = "instrumentationtest.json";
+  std::remove(fileName.c_str());
+
+  Dune::ParameterTree config;
+  config["type"] = "cgsolver";
+  config["instrumentation"] = "true";
+  config["instrumentationfile"] = fileName;
+  config["preconditioner.type"] = "amg";
+  config["preconditioner.coarsenTarget"] = "50";
+  auto solver = factorySolver(op, config);
+  auto instrumented = std::dynamic_pointer_cast<Dune::InstrumentedInverseOperator<Vector,Vector>>(solver);
+  t.require(instrumented != nullptr) << "the solver factory did not attach the instrumentation";
+
+  Vector x(A.N()), b(A.N());
+  for (int solve=0; solve<2; ++solve)
+  {
+    x = 0;
+    b = 1;
+    Dune::InverseOperatorResult res;
+    solver->apply(x, b, res);
+    t.check(res.converged);
+
+    // every solve starts a new tree
+    const Node& root = instrumented->instrumentation().root();
+    t.check(root.calls == 1);
+
+    const Node* apply = root.find("operator apply");
+    t.require(apply != nullptr) << "operator applications not recorded";
+    t.check(apply->calls >= std::size_t(res.iterations));
+    t.check(apply->flops == 2.0*Dune::countNonZeros(A)*apply->calls);
+    t.check(apply->bytes > apply->calls*A.nonzeroes()*sizeof(double));
+
+    const Node* norm = root.find("norm");
+    t.check(norm != nullptr && norm->calls > 0 && norm->flops > 0.0);
+
+    const Node* prec = root.find("preconditioner apply");
+    t.require(prec != nullptr) << "preconditioner applications not recorded";
+    t.check(prec->calls > 0 && prec->time <= root.time);
+    t.check(root.find("preconditioner pre") != nullptr && root.find("preconditioner post") != nullptr);
+
+    // the multigrid cycle is recorded level by level
+    const Node* level0 = prec->find("level 0");
+    t.require(level0 != nullptr) << "AMG levels not recorded";
+    t.check(level0->calls == prec->calls);
+    t.check(level0->find("presmooth") != nullptr && level0->find("postsmooth") != nullptr);
+    const Node* level1 = level0->find("level 1");
+    t.require(level1 != nullptr) << "AMG coarse level not recorded";
+    t.check(level1->time <= level0->time);
+  }
+
+  const std::string report = instrumented->report();
+  t.check(report.find("{\"solver\": \"cgsolver\", \"iterations\": ") == 0) << report;
+  t.check(report.find("\"timers\": {\"name\": \"solve\"") != std::string::npos) << report;
+
+  // one line per solve in the report file
+  std::ifstream file(fileName);
+  std::string line;
+  int lines = 0;
+  while (std::getline(file, line))
+  {
+    t.check(line.find("{\"solver\": \"cgsolver\"") == 0);
+    ++lines;
+  }
+  t.check(lines == 2) << lines << " reports written instead of 2";
+  std::remove(fileName.c_str());
+
+  // without the key the solver is not decorated
+  config["instrumentation"] = "false";
+  auto plain = factorySolver(op, config);
+  t.check(std::dynamic_pointer_cast<Dune::InstrumentedInverseOperator<Vector,Vector>>(plain) == nullptr);
+}
+
+int main(int argc, char** argv)
+{
+  Dune::MPIHelper::instance(argc, argv);
+  Dune::TestSuite t;
+
+  testScopes(t);
+  testFactory(t);
+
+  return t.exit();
+}
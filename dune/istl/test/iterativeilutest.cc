@@ -0,0 +1,124 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+/** \file \brief Tests the iterative ILU decomposition and the Jacobi triangular solves.
+ */
+
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/parametertree.hh>
+#include <dune/common/test/testsuite.hh>
+
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/ilu.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/preconditioners.hh>
+#include <dune/istl/common/threadpool.hh>
+
+#include "laplacian.hh"
+#include "smoothertest.hh"
+
+template<class Matrix>
+double difference(const Matrix& A, const Matrix& B)
+{
+  Matrix C(A);
+  C -= B;
+  return C.infinity_norm();
+}
+
+template<int BS>
+void testDecomposition(Dune::TestSuite& t, int N)
+{
+  using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double,BS,BS>>;
+  using Vector = Dune::BlockVector<Dune::FieldVector<double,BS>>;
+
+  Matrix A;
+  setupLaplacian(A, N);
+  for (int n : {0, 1})
+  {
+    Matrix exact(A.N(), A.M(), Matrix::row_wise);
+    Dune::ILU::blockILUDecomposition(A, n, exact);
+
+    // the fixed-point iteration reaches the exact decomposition after a finite number of sweeps
+    Matrix pattern(A.N(), A.M(), Matrix::row_wise);
+    Dune::ILU::blockILUSymbolicDecomposition(A, n, pattern);
+    Matrix iterative(pattern);
+    Dune::ILU::blockILUIterativeDecomposition(iterative, 4*N);
+    t.check(difference(iterative, exact) < 1e-12)
+      << "iterative ILU(" << n << ") does not match the exact decomposition for BS=" << BS;
+
+    // a few sweeps do not depend on the number of threads
+    Matrix reference(pattern);
+    Dune::ThreadPool::instance().setNumThreads(1);
+    Dune::ILU::blockILUIterativeDecomposition(reference, 3);
+    Dune::ThreadPool::instance().setNumThreads(4);
+    Matrix threaded(pattern);
+    Dune::ILU::blockILUIterativeDecomposition(threaded, 3);
+    Dune::ThreadPool::instance().setNumThreads(1);
+    t.check(difference(threaded, reference) == 0.0)
+      << "iterative ILU(" << n << ") depends on the number of threads for BS=" << BS;
+
+    // the Jacobi triangular solves converge to the exact backsolve
+    Vector d(A.N()), v(A.N()), vJacobi(A.N());
+    for (std::size_t i=0; i<d.N(); ++i)
+      d[i] = std::sin(0.1*i);
+    Dune::ILU::blockILUBacksolve(exact, v, d);
+    Dune::ILU::blockILUJacobiBacksolve(exact, vJacobi, d, 4*N);
+    vJacobi -= v;
+    t.check(vJacobi.infinity_norm() < 1e-10*v.infinity_norm())
+      << "Jacobi backsolve for ILU(" << n << ") does not match the exact backsolve for BS=" << BS;
+  }
+}
+
+// a few sweeps give a preconditioner comparable to the exact one
+void testPreconditioner(Dune::TestSuite& t, int N)
+{
+  using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double,1,1>>;
+  using Vector = Dune::BlockVector<Dune::FieldVector<double,1>>;
+  using Operator = Dune::MatrixAdapter<Matrix,Vector,Vector>;
+
+  Matrix A;
+  setupLaplacian(A, N);
+  auto op = std::make_shared<Operator>(A);
+
+  auto solve = [&](int factorizationSweeps, int triangularSweeps)
+  {
+    Dune::ParameterTree config;
+    config["type"] = "bicgstabsolver";
+    config["maxit"] = "500";
+    config["preconditioner.type"] = "ilu";
+    config["preconditioner.factorizationSweeps"] = std::to_string(factorizationSweeps);
+    config["preconditioner.triangularSweeps"] = std::to_string(triangularSweeps);
+    auto res = factorySolve(op, config);
+    t.check(res.converged) << "BiCGSTAB with " << factorizationSweeps << " factorization and "
+                           << triangularSweeps << " triangular sweeps did not converge";
+    return res.iterations;
+  };
+
+  Dune::ThreadPool::instance().setNumThreads(4);
+  const int iterations = solve(3, 3);
+  Dune::ThreadPool::instance().setNumThreads(1);
+  const int exactIterations = solve(0, 0);
+  t.check(iterations <= 2*exactIterations)
+    << "parallel ILU needed " << iterations << " iterations, exact ILU " << exactIterations;
+}
+
+int main()
+{
+  Dune::TestSuite t;
+
+  testDecomposition<1>(t, 20);
+  testDecomposition<2>(t, 10);
+
+  testPreconditioner(t, 50);
+
+  return t.exit();
+}
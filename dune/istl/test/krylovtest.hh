@@ -0,0 +1,90 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_ISTL_TEST_KRYLOVTEST_HH
+#define DUNE_ISTL_TEST_KRYLOVTEST_HH
+
+/** \file \brief Compares variants of the Krylov solvers, e.g. pipelined or s-step ones, with the standard solvers.
+ */
+
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <dune/common/test/testsuite.hh>
+
+#include <dune/istl/scalarproducts.hh>
+#include <dune/istl/solver.hh>
+#include <dune/istl/paamg/pinfo.hh>
+
+//! The right hand side of the compared solves
+template<class Vector>
+Vector krylovRhs(std::size_t n)
+{
+  Vector b(n);
+  for (std::size_t i=0; i<b.N(); ++i)
+    b[i] = std::sin(0.1*i);
+  return b;
+}
+
+//! The norm of the residual of A x = krylovRhs()
+template<class Matrix, class Vector>
+double krylovResidual(const Matrix& A, const Vector& x)
+{
+  Vector r = krylovRhs<Vector>(A.N());
+  A.mmv(x, r);
+  return r.two_norm();
+}
+
+//! The results of a solver variant and of the standard solver it is compared to
+struct KrylovComparison
+{
+  Dune::InverseOperatorResult variant;
+  Dune::InverseOperatorResult reference;
+};
+
+/**
+ * \brief Solve A x = krylovRhs() with both solvers and check that the variant converges to an accurate solution.
+ *
+ * The caller checks the iteration counts, which depend on the variant.
+ */
+template<class Matrix, class Vector>
+KrylovComparison compareKrylov(Dune::TestSuite& t, const Matrix& A,
+                               Dune::InverseOperator<Vector,Vector>& reference,
+                               Dune::InverseOperator<Vector,Vector>& variant,
+                               const std::string& name)
+{
+  Vector x(A.N());
+  x = 0;
+  const double b0 = krylovResidual(A, x);
+
+  KrylovComparison results;
+  Vector b = krylovRhs<Vector>(A.N());
+  reference.apply(x, b, results.reference);
+  x = 0;
+  b = krylovRhs<Vector>(A.N());
+  variant.apply(x, b, results.variant);
+  t.check(results.variant.converged) << name << " did not converge";
+  t.check(krylovResidual(A, x) < 1e-8*b0) << name << " solution is not accurate";
+  return results;
+}
+
+/**
+ * \brief The scalar products the variants are tested with.
+ *
+ * SeqScalarProduct uses the default implementation of ScalarProduct::idot(),
+ * the ParallelScalarProduct its non-blocking reduction.
+ */
+template<class Vector>
+std::vector<std::shared_ptr<const Dune::ScalarProduct<Vector> > > krylovScalarProducts()
+{
+  typedef Dune::Amg::SequentialInformation Communication;
+  return {std::make_shared<Dune::SeqScalarProduct<Vector> >(),
+          std::make_shared<Dune::ParallelScalarProduct<Vector,Communication> >(std::make_shared<const Communication>(),
+                                                                              Dune::SolverCategory::sequential)};
+}
+
+#endif
@@ -0,0 +1,116 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+/** \file \brief Checks that the level scheduled ILU and ILDL backsolves match the sequential ones bitwise.
+ */
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/test/testsuite.hh>
+
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/ilu.hh>
+#include <dune/istl/preconditioners.hh>
+#include <dune/istl/common/threadpool.hh>
+
+#include "laplacian.hh"
+
+template<class Prec, class Vector>
+Vector apply(Prec& prec, const Vector& d)
+{
+  Vector v(d.N());
+  v = 0;
+  prec.apply(v, d);
+  return v;
+}
+
+template<class Vector>
+bool equal(const Vector& x, const Vector& y)
+{
+  bool result = true;
+  for (std::size_t i=0; i<x.N(); ++i)
+    result = result && (x[i] == y[i]);
+  return result;
+}
+
+template<int BS>
+void testLevelScheduling(Dune::TestSuite& t, int N)
+{
+  using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double,BS,BS>>;
+  using Vector = Dune::BlockVector<Dune::FieldVector<double,BS>>;
+
+  Matrix A;
+  setupLaplacian(A, N);
+  Vector d(A.N());
+  for (std::size_t i=0; i<d.N(); ++i)
+    d[i] = std::sin(0.1*i);
+
+  Dune::ThreadPool::instance().setNumThreads(1);
+  Dune::SeqILU<Matrix,Vector,Vector> ilu0(A, 0, 0.9, true);
+  Dune::SeqILU<Matrix,Vector,Vector> ilu1(A, 1, 0.9, true);
+  Dune::SeqILDL<Matrix,Vector,Vector> ildl(A, 0.9);
+  const Vector ilu0Ref = apply(ilu0, d);
+  const Vector ilu1Ref = apply(ilu1, d);
+  const Vector ildlRef = apply(ildl, d);
+
+  for (std::size_t threads : {1, 2, 4, 7})
+  {
+    Dune::ThreadPool::instance().setNumThreads(threads);
+    Dune::SeqILU<Matrix,Vector,Vector> levelIlu0(A, 0, 0.9, false, true);
+    Dune::SeqILU<Matrix,Vector,Vector> levelIlu1(A, 1, 0.9, false, true);
+    Dune::SeqILDL<Matrix,Vector,Vector> levelIldl(A, 0.9, true);
+    t.check(equal(apply(levelIlu0, d), ilu0Ref))
+      << "level scheduled ILU(0) differs for BS=" << BS << " and " << threads << " threads";
+    t.check(equal(apply(levelIlu1, d), ilu1Ref))
+      << "level scheduled ILU(1) differs for BS=" << BS << " and " << threads << " threads";
+    t.check(equal(apply(levelIldl, d), ildlRef))
+      << "level scheduled ILDL differs for BS=" << BS << " and " << threads << " threads";
+  }
+  Dune::ThreadPool::instance().setNumThreads(1);
+}
+
+// the rows of an N x N five point stencil are scheduled along the 2N-1 anti-diagonals
+void testSchedule(Dune::TestSuite& t, int N)
+{
+  using Matrix = Dune::BCRSMatrix<double>;
+
+  Matrix A;
+  setupLaplacian(A, N);
+  Dune::ILU::CRS<double> lower, upper;
+  std::vector<double> inv;
+  Dune::ILU::convertToCRS(A, lower, upper, inv);
+
+  Dune::ILU::LevelSchedule lowerSchedule, upperSchedule;
+  Dune::ILU::buildLevelSchedule(lower, lowerSchedule, false);
+  Dune::ILU::buildLevelSchedule(upper, upperSchedule, true);
+  t.check(lowerSchedule.levels() == std::size_t(2*N-1)) << "wrong number of lower levels";
+  t.check(upperSchedule.levels() == std::size_t(2*N-1)) << "wrong number of upper levels";
+
+  // each row of a level only depends on rows of previous levels
+  std::vector<std::size_t> level(A.N());
+  for (std::size_t l=0; l<lowerSchedule.levels(); ++l)
+    for (std::size_t k=lowerSchedule.levels_[l]; k<lowerSchedule.levels_[l+1]; ++k)
+      level[lowerSchedule.rows_[k]] = l;
+  for (std::size_t i=0; i<A.N(); ++i)
+    for (std::size_t col=lower.rows_[i]; col<lower.rows_[i+1]; ++col)
+      t.check(level[lower.cols_[col]] < level[i]) << "row " << i << " depends on a row of the same level";
+}
+
+int main()
+{
+  Dune::TestSuite t;
+
+  testSchedule(t, 20);
+
+  testLevelScheduling<1>(t, 100);
+  testLevelScheduling<2>(t, 50);
+
+  return t.exit();
+}
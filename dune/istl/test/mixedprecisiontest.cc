@@ -0,0 +1,114 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+/** \file \brief Tests matrices stored in single precision applied to double precision vectors.
+ */
+
+#include <cmath>
+#include <type_traits>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/test/testsuite.hh>
+
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/mixedprecision.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/preconditioners.hh>
+#include <dune/istl/solvers.hh>
+#include <dune/istl/paamg/amg.hh>
+
+#include "laplacian.hh"
+
+template<int BS>
+void testMixedPrecision(Dune::TestSuite& t, int N)
+{
+  using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double,BS,BS>>;
+  using FloatMatrix = Dune::MixedPrecisionMatrix<Matrix>;
+  using Vector = Dune::BlockVector<Dune::FieldVector<double,BS>>;
+
+  static_assert(std::is_same<FloatMatrix, Dune::BCRSMatrix<Dune::FieldMatrix<float,BS,BS>>>::value,
+                "MixedPrecisionMatrix should store float blocks");
+
+  Matrix A;
+  setupLaplacian(A, N);
+  FloatMatrix Af = Dune::toMixedPrecision(A);
+  t.check(Af.nonzeroes() == A.nonzeroes());
+
+  // the products with the float matrix accumulate in double precision
+  Vector x(A.M()), y(A.N()), yf(A.N());
+  for (std::size_t i=0; i<x.N(); ++i)
+    x[i] = 1.0 + 1e-9*i;
+  A.mv(x, y);
+  Af.mv(x, yf);
+  yf -= y;
+  t.check(yf.infinity_norm() < 1e-6) << "mixed precision mv differs";
+
+  // updating the entries keeps the pattern
+  A *= 2.0;
+  Dune::convertMatrixEntries(A, Af);
+  Af.mv(x, yf);
+  A.mv(x, y);
+  yf -= y;
+  t.check(yf.infinity_norm() < 1e-6) << "convertMatrixEntries did not update the entries";
+
+  using Operator = Dune::MatrixAdapter<Matrix,Vector,Vector>;
+  using FloatOperator = Dune::MatrixAdapter<FloatMatrix,Vector,Vector>;
+  Operator op(A);
+  FloatOperator opf(Af);
+
+  Vector b(A.N());
+  Dune::InverseOperatorResult r;
+
+  // float operator with double precision CG
+  {
+    Dune::SeqJac<FloatMatrix,Vector,Vector> prec(Af, 1, 1.0);
+    Dune::CGSolver<Vector> solver(opf, prec, 1e-8, 1000, 0);
+    x = 0; b = 1;
+    solver.apply(x, b, r);
+    t.check(r.converged) << "CG with float operator did not converge";
+  }
+
+  // float preconditioners for the double precision operator
+  {
+    Dune::SeqILU<FloatMatrix,Vector,Vector> prec(Af, 1.0);
+    Dune::CGSolver<Vector> solver(op, prec, 1e-10, 1000, 0);
+    x = 0; b = 1;
+    solver.apply(x, b, r);
+    t.check(r.converged) << "CG with float SeqILU did not converge";
+  }
+  {
+    Dune::SeqSSOR<FloatMatrix,Vector,Vector> prec(Af, 1, 1.0);
+    Dune::CGSolver<Vector> solver(op, prec, 1e-10, 1000, 0);
+    x = 0; b = 1;
+    solver.apply(x, b, r);
+    t.check(r.converged) << "CG with float SeqSSOR did not converge";
+  }
+  {
+    using Smoother = Dune::SeqSSOR<FloatMatrix,Vector,Vector>;
+    using Criterion = Dune::Amg::CoarsenCriterion<Dune::Amg::SymmetricCriterion<FloatMatrix,Dune::Amg::FirstDiagonal>>;
+    typename Dune::Amg::SmootherTraits<Smoother>::Arguments smootherArgs;
+    smootherArgs.iterations = 1;
+    Criterion criterion(15, 50);
+    criterion.setDefaultValuesIsotropic(2);
+
+    Dune::Amg::AMG<FloatOperator,Vector,Smoother> amg(opf, criterion, smootherArgs);
+    Dune::CGSolver<Vector> solver(op, amg, 1e-10, 200, 0);
+    x = 0; b = 1;
+    solver.apply(x, b, r);
+    t.check(r.converged) << "CG with float AMG did not converge";
+  }
+}
+
+int main()
+{
+  Dune::TestSuite t;
+
+  testMixedPrecision<1>(t, 30);
+  testMixedPrecision<2>(t, 20);
+
+  return t.exit();
+}
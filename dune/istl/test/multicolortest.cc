@@ -0,0 +1,136 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+/** \file \brief Tests the matrix colouring and the multicoloured SOR and SSOR preconditioners and smoothers.
+ */
+
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/test/testsuite.hh>
+
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/gsetc.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/preconditioners.hh>
+#include <dune/istl/common/threadpool.hh>
+
+#include "laplacian.hh"
+#include "smoothertest.hh"
+
+template<class Matrix>
+void testColoring(Dune::TestSuite& t, const Matrix& A, std::size_t expectedColors)
+{
+  Dune::MatrixColoring coloring;
+  Dune::computeColoring(A, coloring);
+  t.check(coloring.colors() == expectedColors)
+    << coloring.colors() << " colours instead of " << expectedColors;
+
+  std::vector<std::size_t> color(A.N(), A.N());
+  for (std::size_t c=0; c<coloring.colors(); ++c)
+    for (std::size_t k=coloring.colors_[c]; k<coloring.colors_[c+1]; ++k)
+      color[coloring.rows_[k]] = c;
+  for (std::size_t i=0; i<A.N(); ++i)
+    t.check(color[i] < coloring.colors()) << "row " << i << " is not coloured";
+
+  for (auto i=A.begin(); i!=A.end(); ++i)
+    for (auto j=(*i).begin(); j!=(*i).end(); ++j)
+      if (j.index() != i.index())
+        t.check(color[i.index()] != color[j.index()])
+          << "coupled rows " << i.index() << " and " << j.index() << " have the same colour";
+}
+
+template<int BS>
+void testThreads(Dune::TestSuite& t, int N)
+{
+  using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double,BS,BS>>;
+  using Vector = Dune::BlockVector<Dune::FieldVector<double,BS>>;
+
+  Matrix A;
+  setupLaplacian(A, N);
+  Vector d(A.N());
+  for (std::size_t i=0; i<d.N(); ++i)
+    d[i] = std::sin(0.1*i);
+
+  auto apply = [&](auto& prec)
+  {
+    Vector v(A.N());
+    v = 0;
+    prec.apply(v, d);
+    return v;
+  };
+
+  Dune::ThreadPool::instance().setNumThreads(1);
+  Dune::SeqMulticolorSSOR<Matrix,Vector,Vector> ssor(A, 2, 1.2);
+  Dune::SeqMulticolorSOR<Matrix,Vector,Vector> sor(A, 2, 0.8);
+  const Vector ssorRef = apply(ssor);
+  const Vector sorRef = apply(sor);
+
+  for (std::size_t threads : {2, 4, 7})
+  {
+    Dune::ThreadPool::instance().setNumThreads(threads);
+    Vector diff = apply(ssor);
+    diff -= ssorRef;
+    t.check(diff.infinity_norm() == 0.0)
+      << "multicoloured SSOR depends on the number of threads for BS=" << BS;
+    diff = apply(sor);
+    diff -= sorRef;
+    t.check(diff.infinity_norm() == 0.0)
+      << "multicoloured SOR depends on the number of threads for BS=" << BS;
+  }
+  Dune::ThreadPool::instance().setNumThreads(1);
+}
+
+// the multicoloured preconditioners and smoothers converge like the lexicographic ones
+void testConvergence(Dune::TestSuite& t, int N)
+{
+  using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double,1,1>>;
+  using Vector = Dune::BlockVector<Dune::FieldVector<double,1>>;
+  using Operator = Dune::MatrixAdapter<Matrix,Vector,Vector>;
+
+  Matrix A;
+  setupLaplacian(A, N);
+  Operator op(A);
+
+  Dune::ThreadPool::instance().setNumThreads(4);
+
+  Dune::SeqSSOR<Matrix,Vector,Vector> ssor(A, 1, 1.0);
+  Dune::SeqMulticolorSSOR<Matrix,Vector,Vector> multicolorSsor(A, 1, 1.0);
+  const int ssorIterations = cgIterations(A, ssor);
+  const int multicolorIterations = cgIterations(A, multicolorSsor);
+  t.check(multicolorIterations <= 2*ssorIterations)
+    << "CG with multicoloured SSOR needed " << multicolorIterations << " iterations, with SSOR " << ssorIterations;
+
+  auto amg = smoothedAMG<Dune::SeqSOR<Matrix,Vector,Vector>>(op, 1);
+  auto multicolorAmg = smoothedAMG<Dune::SeqMulticolorSOR<Matrix,Vector,Vector>>(op, 1);
+  const int amgIterations = cgIterations(A, amg);
+  const int multicolorAmgIterations = cgIterations(A, multicolorAmg);
+  t.check(multicolorAmgIterations <= 2*amgIterations)
+    << "AMG with multicoloured SOR needed " << multicolorAmgIterations << " iterations, with SOR " << amgIterations;
+
+  Dune::ThreadPool::instance().setNumThreads(1);
+}
+
+int main()
+{
+  Dune::TestSuite t;
+
+  // the five point stencil is red-black
+  Dune::BCRSMatrix<double> A;
+  setupLaplacian(A, 10);
+  testColoring(t, A, 2);
+
+  testThreads<1>(t, 100);
+  testThreads<2>(t, 50);
+
+  testConvergence(t, 100);
+
+  return t.exit();
+}
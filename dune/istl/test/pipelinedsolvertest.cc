@@ -0,0 +1,64 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+/** \file \brief Compares the pipelined CG and GMRes solvers with their standard variants.
+ *
+ * The solver factory keys are tested by solverfactorytest.
+ */
+
+#include <cstdlib>
+#include <memory>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/common/test/testsuite.hh>
+
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/preconditioners.hh>
+#include <dune/istl/solvers.hh>
+
+#include "krylovtest.hh"
+#include "laplacian.hh"
+
+using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double,1,1>>;
+using Vector = Dune::BlockVector<Dune::FieldVector<double,1>>;
+using Operator = Dune::MatrixAdapter<Matrix,Vector,Vector>;
+
+void testSolvers(Dune::TestSuite& t, const std::shared_ptr<const Dune::ScalarProduct<Vector>>& sp)
+{
+  Matrix A;
+  setupLaplacian(A, 20);
+  auto op = std::make_shared<Operator>(A);
+  auto prec = std::make_shared<Dune::SeqSSOR<Matrix,Vector,Vector>>(A, 1, 1.0);
+
+  {
+    Dune::CGSolver<Vector> cg(op, sp, prec, 1e-10, 500, 0);
+    Dune::PipelinedCGSolver<Vector> pcg(op, sp, prec, 1e-10, 500, 0);
+    auto res = compareKrylov(t, A, cg, pcg, "pipelined CG");
+    t.check(std::abs(int(res.variant.iterations) - int(res.reference.iterations)) <= 1)
+      << "pipelined CG needed " << res.variant.iterations << " iterations, CG " << res.reference.iterations;
+  }
+  {
+    Dune::RestartedGMResSolver<Vector> gmres(op, sp, prec, 1e-10, 15, 500, 0);
+    Dune::PipelinedGMResSolver<Vector> pgmres(op, sp, prec, 1e-10, 15, 500, 0);
+    auto res = compareKrylov(t, A, gmres, pgmres, "pipelined GMRes");
+    t.check(std::abs(int(res.variant.iterations) - int(res.reference.iterations)) <= 1)
+      << "pipelined GMRes needed " << res.variant.iterations << " iterations, GMRes " << res.reference.iterations;
+  }
+}
+
+int main(int argc, char** argv)
+{
+  Dune::MPIHelper::instance(argc, argv);
+  Dune::TestSuite t;
+
+  for (const auto& sp : krylovScalarProducts<Vector>())
+    testSolvers(t, sp);
+
+  return t.exit();
+}
@@ -62,6 +62,21 @@ TestSuite scalarProductTest(const ScalarProduct& scalarProduct,
   return t;
 }
 
+// A communication providing only dot() and norm() of the communication interface
+struct DotNormCommunication
+{
+  template<class X>
+  void dot (const X& x, const X& y, typename X::field_type& result) const
+  {
+    result = x.dot(y);
+  }
+
+  template<class X>
+  typename FieldTraits<typename X::field_type>::real_type norm (const X& x) const
+  {
+    return x.two_norm();
+  }
+};
 
 int main(int argc, char** argv)
 {
@@ -115,6 +130,21 @@ int main(int argc, char** argv)
     scalarProductTest<ScalarProduct, Vector>(scalarProduct,numBlocks);
   }
 
+  // ParallelScalarProduct::idot falls back to dot() and norm() of the communication
+  {
+    using Vector = BlockVector<FieldVector<double,BlockSize> >;
+    using ScalarProduct = ParallelScalarProduct<Vector, DotNormCommunication>;
+    static_assert(!Std::is_detected_v<Impl::LocalReductions, DotNormCommunication, Vector>);
+    ScalarProduct scalarProduct(std::make_shared<const DotNormCommunication>(), SolverCategory::overlapping);
+    scalarProductTest<ScalarProduct, Vector>(scalarProduct,numBlocks);
+
+    Vector one(numBlocks);
+    one = 1.0;
+    const auto values = scalarProduct.idot({&one}, {&one}, {&one}).get();
+    t.require(values.size() == 2);
+    t.check(values[0] == double(numBlocks*BlockSize) && std::abs(values[1] - double(numBlocks*BlockSize)) < 1e-12);
+  }
+
 #if HAVE_MPI
   // Test the ParallelScalarProduct class
   {
@@ -0,0 +1,120 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+/** \file \brief Tests the SELL-C-sigma matrix against BCRSMatrix.
+ */
+
+#include <cmath>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/test/testsuite.hh>
+
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/preconditioners.hh>
+#include <dune/istl/sellcsigmamatrix.hh>
+#include <dune/istl/solvers.hh>
+
+#include "laplacian.hh"
+
+template<class Vector>
+double maxDifference(const Vector& a, const Vector& b)
+{
+  Vector d(a);
+  d -= b;
+  return d.infinity_norm();
+}
+
+template<class Block, int C>
+void testProducts(Dune::TestSuite& t, int N, std::size_t sigma)
+{
+  using Matrix = Dune::BCRSMatrix<Block>;
+  using Vector = Dune::BlockVector<Dune::FieldVector<double,Block::rows>>;
+
+  Matrix A;
+  // boundary rows of the Laplacian are shorter, so rows have varying lengths
+  setupLaplacian(A, N);
+
+  Dune::SellCSigmaMatrix<Block,C> S(A, sigma);
+  t.check(S.N() == A.N() && S.M() == A.M());
+  t.check(S.nonzeroes() == A.nonzeroes());
+  t.check(S.storedEntries() >= A.nonzeroes());
+
+  Vector x(A.M()), y0(A.N()), y1(A.N());
+  for (std::size_t i=0; i<x.N(); ++i)
+    x[i] = std::cos(0.3*i);
+
+  A.mv(x, y0);
+  S.mv(x, y1);
+  t.check(maxDifference(y0, y1) < 1e-12) << "mv differs for C=" << C << ", sigma=" << sigma;
+
+  A.umv(x, y0);
+  S.umv(x, y1);
+  t.check(maxDifference(y0, y1) < 1e-12) << "umv differs for C=" << C << ", sigma=" << sigma;
+
+  A.mmv(x, y0);
+  S.mmv(x, y1);
+  t.check(maxDifference(y0, y1) < 1e-12) << "mmv differs for C=" << C << ", sigma=" << sigma;
+
+  A.usmv(-0.5, x, y0);
+  S.usmv(-0.5, x, y1);
+  t.check(maxDifference(y0, y1) < 1e-12) << "usmv differs for C=" << C << ", sigma=" << sigma;
+}
+
+template<int C>
+void testSolvers(Dune::TestSuite& t, int N)
+{
+  using Block = Dune::FieldMatrix<double,1,1>;
+  using Matrix = Dune::BCRSMatrix<Block>;
+  using Vector = Dune::BlockVector<Dune::FieldVector<double,1>>;
+  using SellMatrix = Dune::SellCSigmaMatrix<Block,C>;
+
+  Matrix A;
+  setupLaplacian(A, N);
+  SellMatrix S(A);
+
+  Dune::MatrixAdapter<SellMatrix,Vector,Vector> op(S);
+  Dune::SeqJac<Matrix,Vector,Vector> prec(A, 1, 1.0);
+
+  Vector x(A.N()), b(A.N());
+  Dune::InverseOperatorResult r;
+
+  {
+    x = 0; b = 1;
+    Dune::CGSolver<Vector> solver(op, prec, 1e-8, 500, 0);
+    solver.apply(x, b, r);
+    t.check(r.converged) << "CG with SELL-C-sigma operator did not converge";
+  }
+  {
+    x = 0; b = 1;
+    Dune::BiCGSTABSolver<Vector> solver(op, prec, 1e-8, 500, 0);
+    solver.apply(x, b, r);
+    t.check(r.converged) << "BiCGSTAB with SELL-C-sigma operator did not converge";
+  }
+}
+
+// The scalar kernel is used for 1x1 blocks, in particular with the vector blocks FieldVector<K,1>
+static_assert(Dune::Impl::useScalarSellKernel<Dune::FieldMatrix<double,1,1>, Dune::FieldVector<double,1> >);
+static_assert(Dune::Impl::useScalarSellKernel<double, double>);
+static_assert(!Dune::Impl::useScalarSellKernel<Dune::FieldMatrix<double,2,2>, Dune::FieldVector<double,2> >);
+static_assert(!Dune::Impl::useScalarSellKernel<Dune::FieldMatrix<double,1,1>, Dune::FieldVector<double,2> >);
+
+int main()
+{
+  Dune::TestSuite t;
+
+  testProducts<Dune::FieldMatrix<double,1,1>,4>(t, 17, 1);
+  testProducts<Dune::FieldMatrix<double,1,1>,4>(t, 17, 64);
+  testProducts<Dune::FieldMatrix<double,1,1>,8>(t, 17, 256);
+  testProducts<Dune::FieldMatrix<double,2,2>,4>(t, 9, 32);
+  testProducts<Dune::FieldMatrix<double,3,3>,8>(t, 5, 1);
+
+  testSolvers<4>(t, 20);
+  testSolvers<8>(t, 20);
+
+  return t.exit();
+}
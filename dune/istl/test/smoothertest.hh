@@ -0,0 +1,85 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_ISTL_TEST_SMOOTHERTEST_HH
+#define DUNE_ISTL_TEST_SMOOTHERTEST_HH
+
+/** \file \brief Compares preconditioners and AMG smoothers by the iterations of a preconditioned CG,
+ * and solves with solvers created by the solver factory.
+ */
+
+#include <memory>
+
+#include <dune/common/parametertree.hh>
+
+#include <dune/istl/operators.hh>
+#include <dune/istl/preconditioner.hh>
+#include <dune/istl/solverfactory.hh>
+#include <dune/istl/solvers.hh>
+#include <dune/istl/paamg/amg.hh>
+
+//! The number of CG iterations to reduce the residual of A x = 1 by 1e-8, 10000 if CG does not converge
+template<class Matrix, class Vector>
+int cgIterations(const Matrix& A, Dune::Preconditioner<Vector,Vector>& prec)
+{
+  Dune::MatrixAdapter<Matrix,Vector,Vector> op(A);
+  Vector x(A.N()), b(A.N());
+  x = 0;
+  b = 1;
+  Dune::CGSolver<Vector> cg(op, prec, 1e-8, 1000, 0);
+  Dune::InverseOperatorResult res;
+  cg.apply(x, b, res);
+  return res.converged ? res.iterations : 10000;
+}
+
+//! An AMG for the isotropic operator op, coarsened down to 100 unknowns and using the given number of smoothing steps
+template<class Smoother, class Operator>
+Dune::Amg::AMG<Operator,typename Operator::domain_type,Smoother>
+smoothedAMG(const Operator& op, int smootherIterations)
+{
+  typedef typename Operator::matrix_type Matrix;
+  Dune::Amg::CoarsenCriterion<Dune::Amg::SymmetricCriterion<Matrix,Dune::Amg::FirstDiagonal> > criterion;
+  criterion.setDefaultValuesIsotropic(2);
+  criterion.setCoarsenTarget(100);
+  criterion.setDebugLevel(0);
+
+  typename Dune::Amg::SmootherTraits<Smoother>::Arguments smootherArgs;
+  smootherArgs.iterations = smootherIterations;
+  smootherArgs.relaxationFactor = 1.0;
+  return Dune::Amg::AMG<Operator,typename Operator::domain_type,Smoother>(op, criterion, smootherArgs);
+}
+
+/**
+ * \brief A solver for op created by the solver factory.
+ *
+ * The keys verbose, maxit and reduction default to 0, 1000 and 1e-8 if the configuration does not set them.
+ */
+template<class Operator>
+auto factorySolver(const std::shared_ptr<Operator>& op, Dune::ParameterTree config)
+{
+  if (!config.hasKey("verbose"))
+    config["verbose"] = "0";
+  if (!config.hasKey("maxit"))
+    config["maxit"] = "1000";
+  if (!config.hasKey("reduction"))
+    config["reduction"] = "1e-8";
+  Dune::initSolverFactories<Operator>();
+  return Dune::getSolverFromFactory(op, config);
+}
+
+//! Solve op x = 1 from x = 0 with the solver created by factorySolver()
+template<class Operator>
+Dune::InverseOperatorResult factorySolve(const std::shared_ptr<Operator>& op, const Dune::ParameterTree& config)
+{
+  typedef typename Operator::domain_type Vector;
+  auto solver = factorySolver(op, config);
+  Vector x(op->getmat().N()), b(op->getmat().N());
+  x = 0;
+  b = 1;
+  Dune::InverseOperatorResult res;
+  solver->apply(x, b, res);
+  return res;
+}
+
+#endif
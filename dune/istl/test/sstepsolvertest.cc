@@ -0,0 +1,94 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+/** \file \brief Compares the s-step CG and GMRes solvers with their standard variants.
+ *
+ * The solver factory keys are tested by solverfactorytest.
+ */
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/common/test/testsuite.hh>
+
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/preconditioners.hh>
+#include <dune/istl/solvers.hh>
+
+#include "krylovtest.hh"
+#include "laplacian.hh"
+
+using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double,1,1>>;
+using Vector = Dune::BlockVector<Dune::FieldVector<double,1>>;
+using Operator = Dune::MatrixAdapter<Matrix,Vector,Vector>;
+
+void testBlockDot(Dune::TestSuite& t, const Dune::ScalarProduct<Vector>& sp)
+{
+  std::vector<Vector> x(3, Vector(17)), y(2, Vector(17));
+  for (std::size_t k=0; k<17; ++k)
+  {
+    for (std::size_t i=0; i<x.size(); ++i)
+      x[i][k] = std::cos(1.0 + i + 0.3*k);
+    for (std::size_t j=0; j<y.size(); ++j)
+      y[j][k] = std::sin(2.0 + j + 0.7*k);
+  }
+  std::vector<const Vector*> left{&x[0], &x[1], &x[2]}, right{&y[0], &y[1]};
+  std::vector<double> result;
+  sp.blockDot(left, right, result);
+  t.check(result.size() == 6);
+  for (std::size_t i=0; i<x.size(); ++i)
+    for (std::size_t j=0; j<y.size(); ++j)
+      t.check(std::abs(result[i*2+j] - sp.dot(x[i], y[j])) < 1e-14)
+        << "blockDot differs from dot for (" << i << ", " << j << ")";
+}
+
+void testSolvers(Dune::TestSuite& t, const std::shared_ptr<const Dune::ScalarProduct<Vector>>& sp)
+{
+  Matrix A;
+  setupLaplacian(A, 20);
+  auto op = std::make_shared<Operator>(A);
+  auto prec = std::make_shared<Dune::SeqSSOR<Matrix,Vector,Vector>>(A, 1, 1.0);
+
+  for (int s : {1, 2, 4, 8})
+  {
+    {
+      Dune::CGSolver<Vector> cg(op, sp, prec, 1e-10, 500, 0);
+      Dune::SStepCGSolver<Vector> scg(op, sp, prec, 1e-10, s, 500, 0);
+      auto res = compareKrylov(t, A, cg, scg, "s-step CG with s = " + std::to_string(s));
+      // the defect is checked every s iterations only
+      t.check(res.variant.iterations % s == 0 && int(res.variant.iterations) <= int(res.reference.iterations) + 2*s)
+        << "s-step CG with s = " << s << " needed " << res.variant.iterations << " iterations, CG " << res.reference.iterations;
+    }
+    {
+      Dune::RestartedGMResSolver<Vector> gmres(op, sp, prec, 1e-10, 16, 500, 0);
+      Dune::SStepGMResSolver<Vector> sgmres(op, sp, prec, 1e-10, 16, s, 500, 0);
+      auto res = compareKrylov(t, A, gmres, sgmres, "s-step GMRes with s = " + std::to_string(s));
+      t.check(int(res.variant.iterations) <= int(res.reference.iterations) + s)
+        << "s-step GMRes with s = " << s << " needed " << res.variant.iterations << " iterations, GMRes " << res.reference.iterations;
+    }
+  }
+}
+
+int main(int argc, char** argv)
+{
+  Dune::MPIHelper::instance(argc, argv);
+  Dune::TestSuite t;
+
+  // the fused blockDot of SeqScalarProduct and the default implementation using idot
+  for (const auto& sp : krylovScalarProducts<Vector>())
+  {
+    testBlockDot(t, *sp);
+    testSolvers(t, sp);
+  }
+
+  return t.exit();
+}
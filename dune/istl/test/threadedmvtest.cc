@@ -0,0 +1,75 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+/** \file \brief Checks that the threaded BCRSMatrix products match the sequential ones bitwise.
+ */
+
+#include <cmath>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/test/testsuite.hh>
+
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/common/threadpool.hh>
+
+#include "laplacian.hh"
+
+template<class Matrix, class Vector>
+std::vector<Vector> applyAll(const Matrix& A, const Vector& x)
+{
+  Dune::MatrixAdapter<Matrix,Vector,Vector> op(A);
+  std::vector<Vector> results(5, x);
+  A.mv(x, results[0]);
+  A.umv(x, results[1]);
+  A.mmv(x, results[2]);
+  A.usmv(0.3, x, results[3]);
+  op.applyscaleadd(-1.7, x, results[4]);
+  return results;
+}
+
+template<int BS>
+void testThreadedProducts(Dune::TestSuite& t, int N)
+{
+  using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double,BS,BS>>;
+  using Vector = Dune::BlockVector<Dune::FieldVector<double,BS>>;
+
+  Matrix A;
+  setupLaplacian(A, N);
+  Vector x(A.M());
+  for (std::size_t i=0; i<x.N(); ++i)
+    x[i] = std::sin(0.1*i);
+
+  Dune::ThreadPool::instance().setNumThreads(1);
+  auto reference = applyAll(A, x);
+
+  for (std::size_t threads : {2, 3, 4, 7})
+  {
+    Dune::ThreadPool::instance().setNumThreads(threads);
+    auto results = applyAll(A, x);
+    for (std::size_t k=0; k<results.size(); ++k)
+    {
+      bool equal = true;
+      for (std::size_t i=0; i<x.N(); ++i)
+        equal = equal && (results[k][i] == reference[k][i]);
+      t.check(equal) << "threaded product " << k << " differs for BS=" << BS
+                     << " and " << threads << " threads";
+    }
+  }
+  Dune::ThreadPool::instance().setNumThreads(1);
+}
+
+int main()
+{
+  Dune::TestSuite t;
+
+  testThreadedProducts<1>(t, 100);
+  testThreadedProducts<2>(t, 60);
+  testThreadedProducts<3>(t, 5);
+
+  return t.exit();
+}
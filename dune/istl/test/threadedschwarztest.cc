@@ -0,0 +1,134 @@
+// SPDX-FileCopyrightText: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+/** \file \brief Tests the threaded application of the overlapping Schwarz methods.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <string>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/test/testsuite.hh>
+
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/overlappingschwarz.hh>
+#include <dune/istl/solvers.hh>
+#include <dune/istl/common/threadpool.hh>
+
+#include "laplacian.hh"
+
+using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double,1,1>>;
+using Vector = Dune::BlockVector<Dune::FieldVector<double,1>>;
+
+// square subdomains of the N x N grid, extended by one row of unknowns in each direction
+template<class Schwarz>
+typename Schwarz::subdomain_vector subdomains(int N, int size)
+{
+  const int perDim = (N+size-1)/size;
+  typename Schwarz::subdomain_vector domains(perDim*perDim);
+  for (int j=0; j<N; ++j)
+    for (int i=0; i<N; ++i)
+      for (int dj=std::max(0,(j-1)/size); dj<=std::min(perDim-1,(j+1)/size); ++dj)
+        for (int di=std::max(0,(i-1)/size); di<=std::min(perDim-1,(i+1)/size); ++di)
+          domains[dj*perDim+di].insert(j*N+i);
+  return domains;
+}
+
+template<class Schwarz>
+Vector applyOnce(const Matrix& A, const typename Schwarz::subdomain_vector& domains,
+                 bool onTheFly, bool threaded, std::size_t threads)
+{
+  Dune::ThreadPool::instance().setNumThreads(threads);
+  Schwarz schwarz(A, domains, 1.0, onTheFly, threaded);
+  Vector v(A.N()), d(A.N());
+  for (std::size_t i=0; i<d.N(); ++i)
+    d[i] = std::sin(0.1*i);
+  v = 0;
+  schwarz.apply(v, d);
+  Dune::ThreadPool::instance().setNumThreads(1);
+  return v;
+}
+
+template<class Schwarz>
+int solve(const Matrix& A, const typename Schwarz::subdomain_vector& domains,
+          bool onTheFly, bool threaded)
+{
+  Dune::ThreadPool::instance().setNumThreads(4);
+  Dune::MatrixAdapter<Matrix,Vector,Vector> op(A);
+  Schwarz schwarz(A, domains, 1.0, onTheFly, threaded);
+  Vector x(A.N()), b(A.N());
+  x = 0;
+  b = 1;
+  Dune::CGSolver<Vector> cg(op, schwarz, 1e-8, 500, 0);
+  Dune::InverseOperatorResult res;
+  cg.apply(x, b, res);
+  Dune::ThreadPool::instance().setNumThreads(1);
+  return res.converged ? res.iterations : 1000;
+}
+
+// the threaded additive method yields the same result as the sequential one
+template<class Solver>
+void testAdditive(Dune::TestSuite& t, const Matrix& A, int N, bool onTheFly, const std::string& name)
+{
+  using Schwarz = Dune::SeqOverlappingSchwarz<Matrix,Vector,Dune::AdditiveSchwarzMode,Solver>;
+  auto domains = subdomains<Schwarz>(N, 4);
+
+  Vector sequential = applyOnce<Schwarz>(A, domains, onTheFly, false, 1);
+  for (std::size_t threads : {1, 4})
+  {
+    Vector v = applyOnce<Schwarz>(A, domains, onTheFly, true, threads);
+    v -= sequential;
+    t.check(v.infinity_norm() == 0.0)
+      << "threaded additive Schwarz with " << name << " and " << threads << " threads differs";
+  }
+}
+
+// the threaded multiplicative method sweeps by colours, independent of the number of threads
+template<class Solver>
+void testMultiplicative(Dune::TestSuite& t, const Matrix& A, int N, bool onTheFly, const std::string& name)
+{
+  using Schwarz = Dune::SeqOverlappingSchwarz<Matrix,Vector,Dune::SymmetricMultiplicativeSchwarzMode,Solver>;
+  auto domains = subdomains<Schwarz>(N, 4);
+
+  Schwarz schwarz(A, domains, 1.0, onTheFly, true);
+  t.check(schwarz.colors() > 1 && schwarz.colors() <= 9)
+    << "multiplicative Schwarz with " << name << " uses " << schwarz.colors() << " colours";
+
+  Vector v1 = applyOnce<Schwarz>(A, domains, onTheFly, true, 1);
+  Vector v4 = applyOnce<Schwarz>(A, domains, onTheFly, true, 4);
+  v4 -= v1;
+  t.check(v4.infinity_norm() == 0.0)
+    << "threaded multiplicative Schwarz with " << name << " depends on the number of threads";
+
+  const int iterations = solve<Schwarz>(A, domains, onTheFly, true);
+  const int sequentialIterations = solve<Schwarz>(A, domains, onTheFly, false);
+  t.check(iterations <= 2*sequentialIterations)
+    << "CG with threaded multiplicative Schwarz with " << name << " needed " << iterations
+    << " iterations, with the sequential one " << sequentialIterations;
+}
+
+int main()
+{
+  Dune::TestSuite t;
+
+  const int N = 32;
+  Matrix A;
+  setupLaplacian(A, N);
+
+  using DynamicSolver = Dune::DynamicMatrixSubdomainSolver<Matrix,Vector,Vector>;
+  using ILUSolver = Dune::ILU0SubdomainSolver<Matrix,Vector,Vector>;
+
+  testAdditive<DynamicSolver>(t, A, N, true, "DynamicMatrixSubdomainSolver");
+  testAdditive<ILUSolver>(t, A, N, false, "ILU0SubdomainSolver");
+  testMultiplicative<DynamicSolver>(t, A, N, true, "DynamicMatrixSubdomainSolver");
+  testMultiplicative<ILUSolver>(t, A, N, false, "ILU0SubdomainSolver");
+
+  return t.exit();
+}